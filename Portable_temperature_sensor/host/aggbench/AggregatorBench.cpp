@@ -0,0 +1,268 @@
+// Benchmarks the gateway's fleet aggregator (host/gateway/FleetAggregator.h)
+// A synthetic fleet, each device a random walk around its own base temperature,
+// is cut into storage-sized batches up front. The same batches then run through a
+// fresh aggregator once per thread count, timing ingest() (sliding windows, group
+// and fleet views, alert rules) and hottest(). Each run's alerts, views and
+// hottest list are hashed: every thread count has to give the same digest. The
+// views and hottest list are also checked once against a plain recomputation over
+// the last AGG_WINDOW samples of every device.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CycleCounter.h"
+#include "DeviceRegistry.h"
+#include "FleetAggregator.h"
+#include "WorkStealingPool.h"
+
+#define AGGBENCH_BATCH 1024      // GATEWAY_POP in GatewayMain.cpp
+#define AGGBENCH_PATTERN 256     // Distinct batches, replayed in turn
+
+namespace {
+
+const char* USAGE =
+  "usage: aggbench [options]\n"
+  "  --devices N         fleet size (default 10000)\n"
+  "  --groups G          devices are spread over G groups (default 16)\n"
+  "  --samples N         samples per run (default 20000000)\n"
+  "  --threads A,B,...   thread counts to run (default 1,2,4,... up to the hardware threads)\n"
+  "  --alert RULE        alert rule, repeatable (default device:max>90 group:mean>60 fleet:spread>70)\n"
+  "  --hottest N         size of the hottest list (default 10)\n";
+
+struct Settings {
+  uint32_t devices = 10000;
+  uint32_t groups = 16;
+  uint64_t samples = 20000000;
+  std::vector<unsigned> threads;
+  std::vector<std::string> rules;
+  uint32_t hottest = 10;
+};
+
+uint64_t mix(uint64_t h, uint64_t v) {
+  h ^= v + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+  return h;
+}
+
+struct Run {
+  double seconds;
+  double hottestMs;
+  uint64_t events;
+  uint64_t stolen;
+  uint64_t digest;
+  bool matches;
+};
+
+// The group views and hottest list worked out directly from each device's last
+// AGG_WINDOW samples, with the aggregator's rounding of the device means
+bool matches(const Settings& settings, const std::vector<std::vector<IngestSample>>& batches,
+             const FleetAggregator& aggregator, const std::vector<FleetAggregator::Hot>& hot) {
+  std::vector<std::vector<int16_t>> history(settings.devices);
+  std::vector<int16_t> latest(settings.devices, SAMPLE_FAULT);
+  uint64_t done = 0;
+  for (size_t b = 0; done < settings.samples; b = (b + 1) % batches.size()) {
+    for (const IngestSample& s : batches[b]) {
+      history[s.device].push_back(s.value);
+      if (s.value != SAMPLE_FAULT) latest[s.device] = s.value;
+    }
+    done += batches[b].size();
+  }
+  std::vector<int64_t> meanSum(settings.groups, 0);
+  std::vector<uint32_t> devices(settings.groups, 0);
+  std::vector<int16_t> max(settings.groups, INT16_MIN);
+  std::vector<int16_t> min(settings.groups, INT16_MAX);
+  std::vector<FleetAggregator::Hot> expected;
+  for (uint32_t d = 0; d < settings.devices; d++) {
+    const std::vector<int16_t>& h = history[d];
+    int32_t sum = 0;
+    int32_t valid = 0;
+    uint32_t g = d % settings.groups;
+    for (size_t i = h.size() > AGG_WINDOW ? h.size() - AGG_WINDOW : 0; i < h.size(); i++) {
+      if (h[i] == SAMPLE_FAULT) continue;
+      sum += h[i];
+      valid++;
+      max[g] = std::max(max[g], h[i]);
+      min[g] = std::min(min[g], h[i]);
+    }
+    if (valid > 0) {
+      meanSum[g] += sum * 64 / valid;
+      devices[g]++;
+    }
+    if (latest[d] != SAMPLE_FAULT) expected.push_back({ d, latest[d] });
+  }
+  std::sort(expected.begin(), expected.end(), [](const FleetAggregator::Hot& a, const FleetAggregator::Hot& b) {
+    return a.value != b.value ? a.value > b.value : a.device < b.device;
+  });
+  if (expected.size() > hot.size()) expected.resize(hot.size());
+  for (size_t i = 0; i < hot.size(); i++) {
+    if (i >= expected.size() || hot[i].device != expected[i].device || hot[i].value != expected[i].value) return false;
+  }
+  for (uint32_t g = 0; g < settings.groups; g++) {
+    char name[16];
+    snprintf(name, sizeof(name), "line%02u", g);
+    uint32_t index = 0;
+    while (index < aggregator.groups() && strcmp(aggregator.groupName(index), name) != 0) index++;
+    if (index == aggregator.groups()) return devices[g] == 0;
+    AggStats s = aggregator.groupStats(index);
+    if (s.devices != devices[g]) return false;
+    if (devices[g] > 0 && (s.mean != meanSum[g] / 256.0 / devices[g] || s.min != min[g] / 4.0 || s.max != max[g] / 4.0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Run run(const Settings& settings, unsigned threads, const std::vector<std::vector<IngestSample>>& batches,
+        bool check) {
+  DeviceRegistry registry(settings.devices);
+  for (uint32_t d = 0; d < settings.devices; d++) {
+    char id[16];
+    snprintf(id, sizeof(id), "%06X", 0x100000 + d);
+    registry.find(id, strlen(id));
+  }
+  WorkStealingPool pool(threads);
+  FleetAggregator aggregator(registry, pool);
+  for (uint32_t d = 0; d < settings.devices; d++) {
+    char group[16];
+    snprintf(group, sizeof(group), "line%02u", d % settings.groups);
+    aggregator.assign(registry.name(d), group);
+  }
+  for (const std::string& rule : settings.rules) aggregator.addRule(rule.c_str());
+
+  Run r = {};
+  std::vector<AlertEvent> events;
+  uint64_t digest = 0;
+  uint64_t done = 0;
+  size_t next = 0;
+  double start = monotonicSeconds();
+  while (done < settings.samples) {
+    const std::vector<IngestSample>& batch = batches[next];
+    next = (next + 1) % batches.size();
+    aggregator.ingest(batch.data(), batch.size(), events);
+    for (const AlertEvent& e : events) {
+      digest = mix(digest, ((uint64_t)e.rule << 40) | ((uint64_t)e.raised << 32) | e.target);
+    }
+    r.events += events.size();
+    done += batch.size();
+  }
+  r.seconds = monotonicSeconds() - start;
+
+  std::vector<FleetAggregator::Hot> hot;
+  double best = 1e30;
+  for (int i = 0; i < 5; i++) {
+    double t = monotonicSeconds();
+    aggregator.hottest(settings.hottest, hot);
+    best = std::min(best, monotonicSeconds() - t);
+  }
+  r.hottestMs = best * 1e3;
+  for (const FleetAggregator::Hot& h : hot) digest = mix(digest, ((uint64_t)h.device << 16) | (uint16_t)h.value);
+  for (uint32_t g = 0; g < aggregator.groups(); g++) {
+    AggStats s = aggregator.groupStats(g);
+    digest = mix(digest, s.devices);
+    digest = mix(digest, (uint64_t)(int64_t)(s.mean * 4096));
+    digest = mix(digest, (uint64_t)(int64_t)(s.max * 4));
+  }
+  r.digest = digest;
+  r.stolen = pool.stolen();
+  r.matches = !check || matches(settings, batches, aggregator, hot);
+  return r;
+}
+
+std::vector<unsigned> parseThreads(const char* list) {
+  std::vector<unsigned> threads;
+  for (const char* p = list; *p;) {
+    char* end;
+    long n = strtol(p, &end, 10);
+    if (end == p || n < 1) return std::vector<unsigned>();
+    threads.push_back((unsigned)n);
+    p = *end == ',' ? end + 1 : end;
+    if (*end != ',' && *end != '\0') return std::vector<unsigned>();
+  }
+  return threads;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    if (!strcmp(arg, "--help")) { fputs(USAGE, stdout); return 0; }
+    if (value == NULL) { fprintf(stderr, "aggbench: bad argument '%s'\n%s", arg, USAGE); return 2; }
+    if (!strcmp(arg, "--devices")) settings.devices = (uint32_t)atoi(value);
+    else if (!strcmp(arg, "--groups")) settings.groups = (uint32_t)atoi(value);
+    else if (!strcmp(arg, "--samples")) settings.samples = strtoull(value, NULL, 10);
+    else if (!strcmp(arg, "--threads")) settings.threads = parseThreads(value);
+    else if (!strcmp(arg, "--alert")) settings.rules.push_back(value);
+    else if (!strcmp(arg, "--hottest")) settings.hottest = (uint32_t)atoi(value);
+    else { fprintf(stderr, "aggbench: bad argument '%s'\n%s", arg, USAGE); return 2; }
+    i++;
+  }
+  if (settings.rules.empty()) settings.rules = { "device:max>90", "group:mean>60", "fleet:spread>70" };
+  if (settings.threads.empty()) {
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 1; t < hardware; t *= 2) settings.threads.push_back(t);
+    settings.threads.push_back(hardware);
+  }
+  AlertRule check;
+  for (const std::string& rule : settings.rules) {
+    if (!AlertRule::parse(rule.c_str(), check)) {
+      fprintf(stderr, "aggbench: bad rule '%s'\n", rule.c_str());
+      return 2;
+    }
+  }
+  if (settings.devices < 1 || settings.groups < 1 || settings.samples < 1) {
+    fprintf(stderr, "%s", USAGE);
+    return 2;
+  }
+
+  // Random walks between 20 and 100 °C, turning back at either end
+  std::vector<int16_t> level(settings.devices);
+  uint32_t seed = 0x2545F491;
+  auto next = [&seed]() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+  };
+  for (uint32_t d = 0; d < settings.devices; d++) level[d] = (int16_t)(80 + next() % 240);
+  std::vector<std::vector<IngestSample>> batches(AGGBENCH_PATTERN);
+  for (std::vector<IngestSample>& batch : batches) {
+    batch.resize(AGGBENCH_BATCH);
+    for (IngestSample& s : batch) {
+      uint32_t d = next() % settings.devices;
+      int16_t v = level[d] + (int16_t)(next() % 17) - 8;
+      level[d] = v < 80 ? 160 - v : v > 400 ? 800 - v : v;
+      memset(&s, 0, sizeof(s));
+      s.device = d;
+      s.value = next() % 5000 == 0 ? SAMPLE_FAULT : level[d];
+      s.source = SOURCE_BATCH;
+    }
+  }
+
+  printf("aggbench: %u devices in %u groups, %llu samples per run in batches of %u, %zu rules\n",
+         settings.devices, settings.groups, (unsigned long long)settings.samples, AGGBENCH_BATCH,
+         settings.rules.size());
+  double base = 0;
+  uint64_t digest = 0;
+  bool same = true;
+  for (size_t i = 0; i < settings.threads.size(); i++) {
+    unsigned t = settings.threads[i];
+    Run r = run(settings, t, batches, i == 0);
+    double rate = settings.samples / r.seconds;
+    if (i == 0) {
+      base = rate / t;
+      digest = r.digest;
+    }
+    same = same && r.digest == digest && r.matches;
+    printf("aggbench: %3u threads %8.2fM samples/s %7.1fns/sample  speedup %5.2fx  hottest %7.3fms  "
+           "%llu alerts, %llu steals, digest %016llx\n",
+           t, rate / 1e6, r.seconds * 1e9 / settings.samples, rate / base, r.hottestMs,
+           (unsigned long long)r.events, (unsigned long long)r.stolen, (unsigned long long)r.digest);
+  }
+  printf("aggbench: results %s across thread counts and with the recomputed views\n",
+         same ? "identical" : "DIFFER");
+  return same ? 0 : 1;
+}
@@ -0,0 +1,475 @@
+// Serial log collector: wired units' softSerial output into the time-series store
+// Units without WiFi print one line per reading on softSerial (serialOutput() in
+// main.cpp); in log mode "%02d,%02d,%04d,%02d,%02d,%02d,%.2f", otherwise "%.2f".
+// The collector reads any number of serial ports (USB adapters, or PTYs) from one
+// EventLoop, parses the lines in place (SerialPort.h) and appends the samples to
+// the same store the gateway writes (SeriesStore.h), one series per port, so
+// storebench, SeriesReader and the gateway's own data sit side by side.
+// The write-ahead log is written once per loop pass rather than per line and the
+// store is checkpointed every --checkpoint seconds; a port that goes away is
+// retried every second.
+//
+// Log-mode lines carry the device's local time, which becomes UTC through
+// --utc-offset; lines with no date, or a date from before the clock was set, are
+// stamped with their arrival time. The firmware has no binary framing on
+// softSerial, so text is all there is to read.
+//
+// --bench opens --ports PTY pairs instead, and a writer thread feeds the master
+// sides log-mode lines as fast as they drain (or at --rate lines/s per port). At
+// the end the store is read back with SeriesReader: what the bench series gained
+// has to be exactly the lines written, value for value.
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CycleCounter.h"
+#include "EventLoop.h"
+#include "SerialPort.h"
+#include "SeriesReader.h"
+#include "SeriesStore.h"
+
+#define COLLECTOR_BENCH_START 1767225600  // 2026-01-01 00:00:00, first bench line
+#define COLLECTOR_BENCH_CHUNK 2048        // Bytes the bench writer formats per port at a time
+
+namespace {
+
+const char* USAGE =
+  "usage: collector [options] PORT[=ID]...\n"
+  "  PORT                serial device or PTY; the series is named ID, or the device's file name\n"
+  "  --out DIR           time-series store directory (default data)\n"
+  "  --baud B            line speed (default 9600, softSerial.begin() in main.cpp)\n"
+  "  --clock device|host timestamp log-mode lines with the unit's clock or the arrival time (default device)\n"
+  "  --utc-offset S      seconds the unit's clock is ahead of UTC (default 19800, gmtOffset_sec in main.cpp)\n"
+  "  --checkpoint S      seconds between store checkpoints (default 300)\n"
+  "  --max-devices N     series the store has room for (default 4096)\n"
+  "  --stats S           seconds between stats lines (default 1)\n"
+  "  --bench S           no ports: feed PTYs from a writer thread for S seconds\n"
+  "  --ports N           bench PTYs (default 16)\n"
+  "  --rate L            bench lines per second per PTY (default 0, as fast as they drain)\n";
+
+struct Settings {
+  std::vector<std::string> ports;
+  std::string out = "data";
+  uint32_t baud = 9600;
+  bool hostClock = false;
+  int64_t utcOffset = 19800;
+  double checkpoint = 300;
+  uint32_t maxDevices = 4096;
+  double stats = 1;
+  double bench = 0;
+  uint32_t benchPorts = 16;
+  double benchRate = 0;
+};
+
+std::atomic<bool> running{true};
+
+void onSignal(int) {
+  running = false;
+}
+
+bool baudSpeed(uint32_t baud, speed_t& speed) {
+  switch (baud) {
+    case 1200: speed = B1200; return true;
+    case 2400: speed = B2400; return true;
+    case 4800: speed = B4800; return true;
+    case 9600: speed = B9600; return true;
+    case 19200: speed = B19200; return true;
+    case 38400: speed = B38400; return true;
+    case 57600: speed = B57600; return true;
+    case 115200: speed = B115200; return true;
+    case 230400: speed = B230400; return true;
+    case 460800: speed = B460800; return true;
+    case 921600: speed = B921600; return true;
+  }
+  return false;
+}
+
+// Master side of one bench PTY and what has been written to it
+struct BenchLine {
+  int master = -1;
+  std::string slave;
+  char chunk[COLLECTOR_BENCH_CHUNK];
+  size_t size = 0;
+  size_t sent = 0;
+  uint64_t lines = 0;
+  uint64_t faults = 0;
+  int64_t sum = 0;
+  int16_t level = 0;
+  uint32_t seed = 0;
+};
+
+bool openPty(BenchLine& b) {
+  b.master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (b.master < 0 || grantpt(b.master) != 0 || unlockpt(b.master) != 0) return false;
+  char name[64];
+  if (ptsname_r(b.master, name, sizeof(name)) != 0) return false;
+  b.slave = name;
+  return true;
+}
+
+// Queue up to `lines` log-mode lines: a random walk between 20 and 100 °C in the
+// MAX6675's quarter degrees, one reading per second of device time
+void fill(BenchLine& b, uint64_t lines) {
+  b.size = 0;
+  b.sent = 0;
+  while (lines-- > 0 && COLLECTOR_BENCH_CHUNK - b.size >= 40) {
+    b.seed ^= b.seed << 13;
+    b.seed ^= b.seed >> 17;
+    b.seed ^= b.seed << 5;
+    int16_t v = b.level + (int16_t)(b.seed % 17) - 8;
+    b.level = v < 80 ? 160 - v : v > 400 ? 800 - v : v;
+    bool fault = b.seed % 5000 == 0;
+    time_t t = (time_t)(COLLECTOR_BENCH_START + b.lines);
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    int n = snprintf(b.chunk + b.size, COLLECTOR_BENCH_CHUNK - b.size, "%02d,%02d,%04d,%02d,%02d,%02d,%.2f\n",
+                     tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                     fault ? (double)NAN : b.level * 0.25);
+    b.size += (size_t)n;
+    b.lines++;
+    if (fault) b.faults++;
+    else b.sum += b.level;
+  }
+}
+
+// Bench writer thread: keep every master side full until the time is up
+void benchWriter(std::vector<BenchLine>* lines, double seconds, double rate, std::atomic<bool>* done) {
+  std::vector<pollfd> fds(lines->size());
+  double start = monotonicSeconds();
+  for (;;) {
+    double now = monotonicSeconds();
+    if (!running || now - start >= seconds) break;
+    uint64_t due = rate > 0 ? (uint64_t)((now - start) * rate) : UINT64_MAX;
+    bool blocked = true;
+    for (size_t i = 0; i < lines->size(); i++) {
+      BenchLine& b = (*lines)[i];
+      fds[i].fd = -1;
+      if (b.sent == b.size) {
+        if (b.lines >= due) continue;
+        fill(b, due - b.lines);
+      }
+      ssize_t n = write(b.master, b.chunk + b.sent, b.size - b.sent);
+      if (n > 0) {
+        b.sent += (size_t)n;
+        blocked = false;
+      } else {
+        fds[i].fd = b.master;
+        fds[i].events = POLLOUT;
+      }
+    }
+    if (blocked) {
+      if (rate > 0) usleep(1000);
+      else poll(fds.data(), fds.size(), 10);
+    }
+  }
+  // Finish the lines already formatted, so none is cut in two
+  for (BenchLine& b : *lines) {
+    while (b.sent < b.size && running) {
+      ssize_t n = write(b.master, b.chunk + b.sent, b.size - b.sent);
+      if (n > 0) b.sent += (size_t)n;
+      else usleep(1000);
+    }
+  }
+  *done = true;
+}
+
+// Samples, faults and the sum of the rest in each bench series, read off disk
+struct Stored {
+  uint64_t samples = 0;
+  uint64_t faults = 0;
+  int64_t sum = 0;
+};
+
+bool readBack(const std::string& dir, uint32_t ports, std::vector<Stored>& stored) {
+  SeriesReader reader;
+  if (!reader.open(dir)) {
+    fprintf(stderr, "collector: %s\n", reader.error().c_str());
+    return false;
+  }
+  stored.assign(ports, Stored());
+  for (uint32_t i = 0; i < ports; i++) {
+    char name[24];
+    snprintf(name, sizeof(name), "serial%02u", i);
+    int32_t d = reader.find(name);
+    if (d < 0) continue;
+    Stored& s = stored[i];
+    reader.scan((uint32_t)d, INT64_MIN, INT64_MAX, [&s](int64_t, int16_t value) {
+      s.samples++;
+      if (value == SAMPLE_FAULT) s.faults++;
+      else s.sum += value;
+    });
+  }
+  return true;
+}
+
+struct Reporter {
+  PortCounters last;
+  double lastAt;
+  double start;
+
+  Reporter() : lastAt(monotonicSeconds()), start(lastAt) {}
+
+  static PortCounters total(const std::vector<std::unique_ptr<SerialPort>>& ports, uint32_t& open) {
+    PortCounters t;
+    open = 0;
+    for (const std::unique_ptr<SerialPort>& p : ports) {
+      const PortCounters& c = p->counters();
+      t.bytes += c.bytes;
+      t.reads += c.reads;
+      t.lines += c.lines;
+      t.samples += c.samples;
+      t.arrival += c.arrival;
+      t.faults += c.faults;
+      t.bad += c.bad;
+      t.overlong += c.overlong;
+      t.parseNs += c.parseNs;
+      t.opens += c.opens;
+      t.sum += c.sum;
+      if (p->isOpen()) open++;
+    }
+    return t;
+  }
+
+  void report(const std::vector<std::unique_ptr<SerialPort>>& ports) {
+    uint32_t open;
+    PortCounters c = total(ports, open);
+    double now = monotonicSeconds();
+    double seconds = now - lastAt;
+    uint64_t lines = c.lines - last.lines;
+    uint64_t reads = c.reads - last.reads;
+    printf("%7.1fs %4u/%zu ports  %9.0f lines/s  %7.2f MB/s  %6.1f lines/read  %6.1fns/line  "
+           "arrival %llu bad %llu overlong %llu\n",
+           now - start, open, ports.size(), lines / seconds, (c.bytes - last.bytes) / seconds / 1e6,
+           reads > 0 ? (double)lines / reads : 0.0, lines > 0 ? (double)(c.parseNs - last.parseNs) / lines : 0.0,
+           (unsigned long long)(c.arrival - last.arrival), (unsigned long long)(c.bad - last.bad),
+           (unsigned long long)(c.overlong - last.overlong));
+    fflush(stdout);
+    last = c;
+    lastAt = now;
+  }
+
+  void summary(const std::vector<std::unique_ptr<SerialPort>>& ports, double cpuNs) {
+    uint32_t open;
+    PortCounters c = total(ports, open);
+    double seconds = monotonicSeconds() - start;
+    printf("collected  %llu lines in %.1fs (%.0f lines/s), %llu samples, %llu faults, %llu stamped on arrival\n",
+           (unsigned long long)c.lines, seconds, c.lines / seconds, (unsigned long long)c.samples,
+           (unsigned long long)c.faults, (unsigned long long)c.arrival);
+    printf("rejected   %llu bad lines, %llu overlong\n", (unsigned long long)c.bad,
+           (unsigned long long)c.overlong);
+    printf("reads      %llu, %.1f lines each, %.1fns/line framing, parsing and appending, "
+           "%.1fns/line collector CPU, %llu reopens\n",
+           (unsigned long long)c.reads, c.reads > 0 ? (double)c.lines / c.reads : 0.0,
+           c.lines > 0 ? (double)c.parseNs / c.lines : 0.0, c.lines > 0 ? cpuNs / c.lines : 0.0,
+           (unsigned long long)(c.opens - std::min<uint64_t>(c.opens, ports.size())));
+  }
+};
+
+uint64_t threadCpuNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    bool ok = true;
+    if (!strcmp(arg, "--help")) { fputs(USAGE, stdout); return 0; }
+    else if (strncmp(arg, "--", 2) != 0) { settings.ports.push_back(arg); continue; }
+    else if (value == NULL) ok = false;
+    else if (!strcmp(arg, "--out")) { settings.out = value; i++; }
+    else if (!strcmp(arg, "--baud")) { settings.baud = (uint32_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--clock")) {
+      ok = !strcmp(value, "device") || !strcmp(value, "host");
+      settings.hostClock = !strcmp(value, "host");
+      i++;
+    }
+    else if (!strcmp(arg, "--utc-offset")) { settings.utcOffset = atoll(value); i++; }
+    else if (!strcmp(arg, "--checkpoint")) { settings.checkpoint = atof(value); i++; }
+    else if (!strcmp(arg, "--max-devices")) { settings.maxDevices = (uint32_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--stats")) { settings.stats = atof(value); i++; }
+    else if (!strcmp(arg, "--bench")) { settings.bench = atof(value); i++; }
+    else if (!strcmp(arg, "--ports")) { settings.benchPorts = (uint32_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--rate")) { settings.benchRate = atof(value); i++; }
+    else ok = false;
+    speed_t speed;
+    if (!ok || !baudSpeed(settings.baud, speed) || settings.maxDevices < 1 || settings.stats <= 0 ||
+        settings.checkpoint <= 0 || settings.benchPorts < 1 || settings.benchRate < 0) {
+      fprintf(stderr, "collector: bad argument '%s'\n%s", arg, USAGE);
+      return 2;
+    }
+  }
+  if (settings.ports.empty() == (settings.bench <= 0)) {
+    fprintf(stderr, "%s", USAGE);
+    return 2;
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  std::vector<BenchLine> bench;
+  if (settings.bench > 0) {
+    bench = std::vector<BenchLine>(settings.benchPorts);
+    for (uint32_t i = 0; i < settings.benchPorts; i++) {
+      BenchLine& b = bench[i];
+      if (!openPty(b)) {
+        fprintf(stderr, "collector: cannot open a PTY: %s\n", strerror(errno));
+        return 1;
+      }
+      b.seed = 0x2545F491 + i * 0x9E3779B9;
+      b.level = (int16_t)(80 + b.seed % 240);
+      char port[96];
+      snprintf(port, sizeof(port), "%s=serial%02u", b.slave.c_str(), i);
+      settings.ports.push_back(port);
+    }
+    if (settings.benchPorts > settings.maxDevices) settings.maxDevices = settings.benchPorts;
+  }
+
+  SeriesStore store(settings.maxDevices);
+  if (!store.open(settings.out)) {
+    fprintf(stderr, "collector: store: %s\n", store.error().c_str());
+    return 1;
+  }
+  printf("store %s: %u devices, %llu samples recovered from the log\n", settings.out.c_str(), store.size(),
+         (unsigned long long)store.counters().replayed);
+  // Seal what an earlier run left, so the bench can tell its own samples apart
+  std::vector<Stored> before;
+  if (settings.bench > 0 && (!store.checkpoint() || !readBack(settings.out, settings.benchPorts, before))) {
+    fprintf(stderr, "collector: store: %s\n", store.error().c_str());
+    return 1;
+  }
+
+  EventLoop loop;
+  if (!loop.valid()) {
+    fprintf(stderr, "collector: cannot set up epoll\n");
+    return 1;
+  }
+  PortOptions options;
+  baudSpeed(settings.baud, options.speed);
+  options.hostClock = settings.hostClock;
+  options.offsetMs = settings.utcOffset * 1000;
+  std::vector<std::unique_ptr<SerialPort>> ports;
+  for (const std::string& spec : settings.ports) {
+    size_t eq = spec.rfind('=');
+    std::string path = eq == std::string::npos ? spec : spec.substr(0, eq);
+    std::string id = eq == std::string::npos ? path.substr(path.rfind('/') + 1) : spec.substr(eq + 1);
+    int32_t device = store.device(id.c_str(), id.size());
+    if (device < 0) {
+      fprintf(stderr, "collector: cannot add series '%s' for %s%s%s\n", id.c_str(), path.c_str(),
+              store.error().empty() ? "" : ": ", store.error().c_str());
+      return 1;
+    }
+    ports.emplace_back(new SerialPort(loop, store, options, path, (uint32_t)device));
+    if (!ports.back()->open()) printf("%s: %s, retrying\n", path.c_str(), strerror(errno));
+    else printf("%s -> %s\n", path.c_str(), id.c_str());
+  }
+  fflush(stdout);
+
+  std::atomic<bool> benchDone{false};
+  std::thread writer;
+  if (settings.bench > 0) {
+    printf("bench: %u PTYs for %.0fs, %s\n", settings.benchPorts, settings.bench,
+           settings.benchRate > 0 ? "rate-limited" : "as fast as they drain");
+    writer = std::thread(benchWriter, &bench, settings.bench, settings.benchRate, &benchDone);
+  }
+
+  Reporter reporter;
+  uint64_t cpuStart = threadCpuNs();
+  double nextStats = monotonicSeconds() + settings.stats;
+  double nextCheckpoint = monotonicSeconds() + settings.checkpoint;
+  double nextAttempt = monotonicSeconds() + 1;
+  bool failed = false;
+  int quiet = 0;
+  while (running) {
+    int ready = loop.poll(100);
+    if (ready < 0) {
+      fprintf(stderr, "collector: epoll: %s\n", strerror(errno));
+      failed = true;
+      break;
+    }
+    for (const std::unique_ptr<SerialPort>& p : ports) failed = failed || p->failed();
+    if (failed || !store.commit()) {
+      failed = true;
+      break;
+    }
+    double now = monotonicSeconds();
+    if (now >= nextAttempt) {
+      for (const std::unique_ptr<SerialPort>& p : ports) {
+        if (!p->isOpen() && p->open()) printf("%s: reopened\n", p->path().c_str());
+      }
+      nextAttempt = now + 1;
+    }
+    if (now >= nextCheckpoint) {
+      if (!store.checkpoint()) {
+        failed = true;
+        break;
+      }
+      nextCheckpoint = now + settings.checkpoint;
+    }
+    if (now >= nextStats) {
+      reporter.report(ports);
+      nextStats += settings.stats;
+    }
+    // The bench ends once the writer is done and the PTYs have been drained
+    if (benchDone && (ready == 0 ? ++quiet : (quiet = 0)) >= 2) break;
+  }
+  double cpuNs = (double)(threadCpuNs() - cpuStart);
+  running = false;
+  if (writer.joinable()) writer.join();
+  if (failed) fprintf(stderr, "collector: store: %s\n", store.error().c_str());
+
+  reporter.report(ports);
+  reporter.summary(ports, cpuNs);
+  bool same = true;
+  if (settings.bench > 0) {
+    for (size_t i = 0; i < bench.size(); i++) {
+      const PortCounters& c = ports[i]->counters();
+      same = same && c.bad == 0 && c.overlong == 0 && c.arrival == 0;
+    }
+    if (!same) printf("bench: lines were rejected or stamped on arrival\n");
+  }
+  ports.clear();
+  for (BenchLine& b : bench) close(b.master);
+
+  bool closed = !failed && store.close();
+  if (!failed && !closed) fprintf(stderr, "collector: store: %s\n", store.error().c_str());
+  const SeriesStore::Counters& c = store.counters();
+  printf("store      %llu samples, %llu blocks, %.2f bytes/sample in columns, %llu clamped, %llu checkpoints\n",
+         (unsigned long long)c.samples, (unsigned long long)c.blocks,
+         c.samples > 0 ? (double)c.columnBytes / c.samples : 0.0, (unsigned long long)c.clamped,
+         (unsigned long long)c.checkpoints);
+  if (settings.bench > 0 && closed) {
+    std::vector<Stored> after;
+    uint64_t written = 0;
+    uint64_t gained = 0;
+    same = same && readBack(settings.out, settings.benchPorts, after);
+    for (size_t i = 0; same && i < bench.size(); i++) {
+      written += bench[i].lines;
+      gained += after[i].samples - before[i].samples;
+      same = after[i].samples - before[i].samples == bench[i].lines &&
+             after[i].faults - before[i].faults == bench[i].faults && after[i].sum - before[i].sum == bench[i].sum;
+    }
+    printf("bench: %llu lines written, %llu samples read back from the store, values %s\n",
+           (unsigned long long)written, (unsigned long long)gained, same ? "identical" : "DIFFER");
+  }
+  return closed && same ? 0 : 1;
+}
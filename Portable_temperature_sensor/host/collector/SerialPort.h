@@ -0,0 +1,191 @@
+#ifndef SERIAL_PORT_H
+#define SERIAL_PORT_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <string>
+#include "CycleCounter.h"
+#include "EventLoop.h"
+#include "LogLine.h"
+#include "SampleRing.h"
+#include "SeriesStore.h"
+
+#define PORT_BUFFER 4096        // Longest line kept; the firmware's are under 40 bytes
+#define PORT_READS 8            // Reads per wakeup before the other ports get their turn
+#define PORT_SYNCED_YEAR 2020   // Earlier log-mode dates come from a clock NTP never set
+
+// How samples from a port are timestamped and how the line is set up
+struct PortOptions {
+  speed_t speed = B9600;        // softSerial.begin(9600) in main.cpp
+  bool hostClock = false;       // Arrival time instead of the device's log-mode date
+  int64_t offsetMs = 0;         // Device clock minus UTC, the firmware logs local time
+};
+
+// Per-port totals
+struct PortCounters {
+  uint64_t bytes = 0;
+  uint64_t reads = 0;
+  uint64_t lines = 0;
+  uint64_t samples = 0;
+  uint64_t arrival = 0;         // Samples stamped on arrival: normal mode, unset clock or --clock host
+  uint64_t faults = 0;
+  uint64_t bad = 0;             // Lines in neither format
+  uint64_t overlong = 0;        // Lines longer than PORT_BUFFER, dropped
+  uint64_t parseNs = 0;         // Framing, parsing and store appends
+  uint64_t opens = 0;
+  int64_t sum = 0;              // Of the sample values, faults left out
+};
+
+// One serial line (or PTY) carrying a unit's softSerial output into the store
+// Reads are non-blocking and driven by the event loop. Each read is cut into
+// lines in place; a line left incomplete at the end of a read moves to the
+// front of the buffer and is finished by the next one. Lines go through
+// parseLogLine() or, outside log mode, parseReadingLine(), and straight into
+// SeriesStore::append(): nothing is allocated per line. All lines of one read
+// share its arrival time. When the line goes away (EOF, EIO or a hangup, as a
+// USB adapter being unplugged) the port closes and the caller reopens it.
+class SerialPort : public EventHandler {
+private:
+  EventLoop& _loop;
+  SeriesStore& _store;
+  const PortOptions& _options;
+  std::string _path;
+  uint32_t _device;
+  int _fd = -1;
+  char _buffer[PORT_BUFFER];
+  size_t _used = 0;
+  bool _skipping = false;       // Inside an overlong line, dropping up to its newline
+  bool _failed = false;
+  PortCounters _counters;
+
+  void line(const char* p, size_t length, int64_t arrivalMs) {
+    if (length > 0 && p[length - 1] == '\r') length--;
+    if (length == 0) return;
+    _counters.lines++;
+    LogRecord record;
+    int64_t ms = arrivalMs;
+    if (parseLogLine(p, length, record)) {
+      if (!_options.hostClock && record.year >= PORT_SYNCED_YEAR) {
+        ms = logRecordSeconds(record) * 1000 - _options.offsetMs;
+      } else {
+        _counters.arrival++;
+      }
+    } else if (parseReadingLine(p, length, record)) {
+      _counters.arrival++;
+    } else {
+      _counters.bad++;
+      return;
+    }
+    // The same conversion the firmware applies to the reading it printed
+    int16_t value = record.fault ? SAMPLE_FAULT : sampleFromCelsius(record.centi / 100.0);
+    if (record.fault) _counters.faults++;
+    else _counters.sum += value;
+    _counters.samples++;
+    if (!_store.append(_device, ms, value)) _failed = true;
+  }
+
+  // Cut _buffer[0, _used) into lines, keeping an unfinished one
+  void lines(int64_t arrivalMs) {
+    const char* p = _buffer;
+    const char* end = _buffer + _used;
+    while (p < end) {
+      const char* eol = (const char*)memchr(p, '\n', end - p);
+      if (eol == NULL) break;
+      if (_skipping) _skipping = false;
+      else line(p, eol - p, arrivalMs);
+      p = eol + 1;
+    }
+    _used = end - p;
+    if (_used == PORT_BUFFER) {
+      if (!_skipping) _counters.overlong++;
+      _skipping = true;
+      _used = 0;
+    } else if (_used > 0 && p != _buffer) {
+      memmove(_buffer, p, _used);
+    }
+  }
+
+public:
+  SerialPort(EventLoop& loop, SeriesStore& store, const PortOptions& options, const std::string& path,
+             uint32_t device)
+      : _loop(loop), _store(store), _options(options), _path(path), _device(device) {}
+
+  ~SerialPort() { close(); }
+
+  SerialPort(const SerialPort&) = delete;
+  SerialPort& operator=(const SerialPort&) = delete;
+
+  // Open the device and put a tty into raw mode at the configured speed
+  bool open() {
+    if (_fd >= 0) return true;
+    _fd = ::open(_path.c_str(), O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (_fd < 0) return false;
+    if (isatty(_fd)) {
+      struct termios tio;
+      if (tcgetattr(_fd, &tio) != 0) {
+        close();
+        return false;
+      }
+      cfmakeraw(&tio);
+      tio.c_cflag |= CLOCAL | CREAD;
+      tio.c_cc[VMIN] = 1;
+      tio.c_cc[VTIME] = 0;
+      cfsetispeed(&tio, _options.speed);
+      cfsetospeed(&tio, _options.speed);
+      if (tcsetattr(_fd, TCSANOW, &tio) != 0) {
+        close();
+        return false;
+      }
+    }
+    if (!_loop.add(_fd, EPOLLIN, this)) {
+      close();
+      return false;
+    }
+    _used = 0;
+    _skipping = false;
+    _counters.opens++;
+    return true;
+  }
+
+  void close() {
+    if (_fd < 0) return;
+    _loop.remove(_fd);
+    ::close(_fd);
+    _fd = -1;
+  }
+
+  void onEvents(uint32_t events) override {
+    uint64_t start = monotonicNanos();
+    int64_t arrivalMs = wallMillis();
+    bool gone = false;
+    for (int i = 0; i < PORT_READS; i++) {
+      size_t space = PORT_BUFFER - _used;
+      ssize_t n = read(_fd, _buffer + _used, space);
+      if (n > 0) {
+        _counters.reads++;
+        _counters.bytes += (uint64_t)n;
+        _used += (size_t)n;
+        lines(arrivalMs);
+        if ((size_t)n < space) break;  // Drained
+        continue;
+      }
+      if (n < 0 && errno == EINTR) continue;
+      gone = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+      break;
+    }
+    _counters.parseNs += monotonicNanos() - start;
+    // A hangup with nothing left to read (a PTY master closing gives EIO on read anyway)
+    if (gone || ((events & (EPOLLHUP | EPOLLERR)) && !(events & EPOLLIN))) close();
+  }
+
+  bool isOpen() const { return _fd >= 0; }
+  bool failed() const { return _failed; }
+  const std::string& path() const { return _path; }
+  uint32_t device() const { return _device; }
+  const PortCounters& counters() const { return _counters; }
+};
+
+#endif // SERIAL_PORT_H
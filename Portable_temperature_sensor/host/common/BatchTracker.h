@@ -0,0 +1,49 @@
+#ifndef BATCH_TRACKER_H
+#define BATCH_TRACKER_H
+
+#include <stdint.h>
+#include "SampleCodec.h"
+
+// Receiver side of acknowledged batch delivery, one per device
+// Keeps the next expected sequence number per boot, with the rules of SimBackend:
+// samples before it are duplicates from a go-back-N resend; a batch starting past
+// it leaves a gap (the device's ring overflowed, or the batch before it was lost
+// while nobody was subscribed), which is counted as lost and skipped so delivery
+// can go on. next() is the cumulative ack to publish on sensor/<id>/set/ack.
+class BatchTracker {
+public:
+  struct Result {
+    uint32_t from;        // First new sequence number; new samples are [from, first + count)
+    uint32_t accepted;
+    uint32_t duplicates;
+    uint32_t lost;        // Gap before the batch
+  };
+
+private:
+  uint32_t _bootId = 0;
+  uint32_t _expected = 0;
+  bool _seen = false;
+
+public:
+  Result receive(const SampleBatchHeader& header) {
+    if (!_seen || header.bootId != _bootId) {
+      _seen = true;
+      _bootId = header.bootId;  // Rebooted: sequence numbers start over
+      _expected = header.first;
+    }
+    Result r;
+    uint32_t end = header.first + header.count;
+    r.lost = (int32_t)(header.first - _expected) > 0 ? header.first - _expected : 0;
+    r.from = r.lost > 0 ? header.first : _expected;
+    r.accepted = (int32_t)(end - r.from) > 0 ? end - r.from : 0;
+    r.duplicates = header.count - r.accepted;
+    if ((int32_t)(end - _expected) > 0) _expected = end;
+    return r;
+  }
+
+  uint32_t next() const { return _expected; }
+  uint32_t bootId() const { return _bootId; }
+  bool seen() const { return _seen; }
+};
+
+#endif // BATCH_TRACKER_H
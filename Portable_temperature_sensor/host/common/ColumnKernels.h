@@ -0,0 +1,478 @@
+#ifndef COLUMN_KERNELS_H
+#define COLUMN_KERNELS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include "SampleCodec.h"
+#include "SeriesFormat.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define KERNELS_X86 1
+#define KERNELS_SSE4 __attribute__((target("sse4.1")))
+#define KERNELS_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Decoding and aggregation kernels for the varint columns (SampleCodec.h, SeriesFormat.h)
+// Each kernel has a scalar version, which is the reference, and SSE4.1 and AVX2
+// versions compiled for those instruction sets with target attributes, so no
+// build flags are needed; columnKernels() picks the best the CPU has at run time.
+// All versions give bit-identical results, including the wrap-around of the
+// device encoder's 16-bit values and 32-bit millis() deltas.
+enum KernelLevel : uint8_t { KERNEL_SCALAR, KERNEL_SSE4, KERNEL_AVX2 };
+
+struct ColumnKernels {
+  KernelLevel level;
+  const char* name;
+  // n varints from p into out, each cut to 32 bits as getVarint() callers do; wide
+  // is set if one did not fit. False if the bytes run out or a varint is too long.
+  bool (*varints)(const uint8_t*& p, const uint8_t* end, uint32_t* out, uint32_t n, bool& wide);
+  // out[i] = base + zigzagDecode(in[0]) + ... + zigzagDecode(in[i]), in 16 bits
+  void (*zigzagPrefix16)(const uint32_t* in, uint32_t n, int16_t base, int16_t* out);
+  // out[i] = base + in[0] + ... + in[i], in 32 bits
+  void (*prefix32)(const uint32_t* in, uint32_t n, uint32_t base, uint32_t* out);
+  // out[i] = base + in[0] + ... + in[i]
+  void (*prefix64)(const uint32_t* in, uint32_t n, int64_t base, int64_t* out);
+  // in[2i] to even[i] and in[2i + 1] to odd[i], for i < pairs
+  void (*deinterleave)(const uint32_t* in, uint32_t pairs, uint32_t* even, uint32_t* odd);
+  // SeriesRollup::add() of every value
+  void (*rollup)(const int16_t* values, uint32_t n, SeriesRollup& r);
+};
+
+// Scalar reference versions
+inline bool varintsScalar(const uint8_t*& p, const uint8_t* end, uint32_t* out, uint32_t n, bool& wide) {
+  for (uint32_t i = 0; i < n; i++) {
+    uint64_t v;
+    if (!getVarint(p, end, v)) return false;
+    if (v > UINT32_MAX) wide = true;
+    out[i] = (uint32_t)v;
+  }
+  return true;
+}
+
+inline void zigzagPrefix16Scalar(const uint32_t* in, uint32_t n, int16_t base, int16_t* out) {
+  uint16_t sum = (uint16_t)base;
+  for (uint32_t i = 0; i < n; i++) {
+    sum += (uint16_t)zigzagDecode(in[i]);
+    out[i] = (int16_t)sum;
+  }
+}
+
+inline void prefix32Scalar(const uint32_t* in, uint32_t n, uint32_t base, uint32_t* out) {
+  for (uint32_t i = 0; i < n; i++) out[i] = base += in[i];
+}
+
+inline void prefix64Scalar(const uint32_t* in, uint32_t n, int64_t base, int64_t* out) {
+  for (uint32_t i = 0; i < n; i++) out[i] = base += in[i];
+}
+
+inline void deinterleaveScalar(const uint32_t* in, uint32_t pairs, uint32_t* even, uint32_t* odd) {
+  for (uint32_t i = 0; i < pairs; i++) {
+    even[i] = in[2 * i];
+    odd[i] = in[2 * i + 1];
+  }
+}
+
+inline void rollupScalar(const int16_t* values, uint32_t n, SeriesRollup& r) {
+  for (uint32_t i = 0; i < n; i++) r.add(values[i]);
+}
+
+#ifdef KERNELS_X86
+
+// Shuffles that spread the 1 and 2 byte varints starting in 12 bytes over 16-bit
+// lanes, keyed by the continuation bits of those bytes (after Masked VByte)
+// An entry decodes up to 8 varints; count is 0 when the first is longer than 2 bytes.
+struct VarintShuffles {
+  struct Entry {
+    uint8_t shuffle[16];
+    uint8_t count;
+    uint8_t bytes;
+  };
+  Entry entries[1 << 12];
+
+  VarintShuffles() {
+    for (uint32_t mask = 0; mask < (1u << 12); mask++) {
+      Entry& e = entries[mask];
+      memset(e.shuffle, 0x80, sizeof(e.shuffle));
+      uint32_t pos = 0;
+      uint32_t count = 0;
+      while (count < 8 && pos < 12) {
+        if (!(mask >> pos & 1)) {
+          e.shuffle[2 * count] = (uint8_t)pos;
+          pos += 1;
+        } else if (pos + 1 < 12 && !(mask >> (pos + 1) & 1)) {
+          e.shuffle[2 * count] = (uint8_t)pos;
+          e.shuffle[2 * count + 1] = (uint8_t)(pos + 1);
+          pos += 2;
+        } else {
+          break;
+        }
+        count++;
+      }
+      e.count = (uint8_t)count;
+      e.bytes = (uint8_t)pos;
+    }
+  }
+
+  static const VarintShuffles& get() {
+    static const VarintShuffles table;
+    return table;
+  }
+};
+
+// 16 bytes at a time while the rest of the column is that long; a run of 16
+// one-byte varints (small value deltas) widens in one go, as does a run of 8
+// two-byte ones (1 Hz time deltas), a mix of the two goes through a shuffle and
+// anything longer takes the scalar path for one varint
+KERNELS_SSE4 inline bool varintsSse4(const uint8_t*& p, const uint8_t* end, uint32_t* out, uint32_t n, bool& wide) {
+  const VarintShuffles::Entry* table = VarintShuffles::get().entries;
+  const __m128i low7 = _mm_set1_epi16(0x007F);
+  const __m128i high7 = _mm_set1_epi16(0x3F80);
+  uint32_t i = 0;
+  while (n - i >= 8 && end - p >= 16) {
+    __m128i bytes = _mm_loadu_si128((const __m128i*)p);
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(bytes);
+    if (mask == 0 && n - i >= 16) {
+      _mm_storeu_si128((__m128i*)(out + i), _mm_cvtepu8_epi32(bytes));
+      _mm_storeu_si128((__m128i*)(out + i + 4), _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 4)));
+      _mm_storeu_si128((__m128i*)(out + i + 8), _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+      _mm_storeu_si128((__m128i*)(out + i + 12), _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 12)));
+      p += 16;
+      i += 16;
+      continue;
+    }
+    if (mask == 0x5555) {
+      // 8 two-byte varints already sit in 16-bit lanes
+      __m128i v = _mm_or_si128(_mm_and_si128(bytes, low7), _mm_and_si128(_mm_srli_epi16(bytes, 1), high7));
+      _mm_storeu_si128((__m128i*)(out + i), _mm_cvtepu16_epi32(v));
+      _mm_storeu_si128((__m128i*)(out + i + 4), _mm_cvtepu16_epi32(_mm_srli_si128(v, 8)));
+      p += 16;
+      i += 8;
+      continue;
+    }
+    const VarintShuffles::Entry& e = table[mask & 0xFFF];
+    if (e.count == 0) {
+      if (!varintsScalar(p, end, out + i, 1, wide)) return false;
+      i++;
+      continue;
+    }
+    __m128i lanes = _mm_shuffle_epi8(bytes, _mm_loadu_si128((const __m128i*)e.shuffle));
+    __m128i v = _mm_or_si128(_mm_and_si128(lanes, low7), _mm_and_si128(_mm_srli_epi16(lanes, 1), high7));
+    _mm_storeu_si128((__m128i*)(out + i), _mm_cvtepu16_epi32(v));
+    _mm_storeu_si128((__m128i*)(out + i + 4), _mm_cvtepu16_epi32(_mm_srli_si128(v, 8)));
+    p += e.bytes;
+    i += e.count;
+  }
+  return varintsScalar(p, end, out + i, n - i, wide);
+}
+
+// Zigzag-decoded low halves of 8 varints as 16-bit lanes
+KERNELS_SSE4 inline __m128i zigzag16Sse4(const uint32_t* in) {
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i low16 = _mm_set1_epi32(0xFFFF);
+  __m128i a = _mm_loadu_si128((const __m128i*)in);
+  __m128i b = _mm_loadu_si128((const __m128i*)(in + 4));
+  a = _mm_xor_si128(_mm_srli_epi32(a, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(a, one)));
+  b = _mm_xor_si128(_mm_srli_epi32(b, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(b, one)));
+  // Masked to 16 bits, the unsigned saturating pack only truncates
+  return _mm_packus_epi32(_mm_and_si128(a, low16), _mm_and_si128(b, low16));
+}
+
+KERNELS_SSE4 inline void zigzagPrefix16Sse4(const uint32_t* in, uint32_t n, int16_t base, int16_t* out) {
+  __m128i carry = _mm_set1_epi16(base);
+  uint32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i x = zigzag16Sse4(in + i);
+    x = _mm_add_epi16(x, _mm_slli_si128(x, 2));
+    x = _mm_add_epi16(x, _mm_slli_si128(x, 4));
+    x = _mm_add_epi16(x, _mm_slli_si128(x, 8));
+    _mm_storeu_si128((__m128i*)(out + i), _mm_add_epi16(x, carry));
+    carry = _mm_add_epi16(carry, _mm_shuffle_epi8(x, _mm_set1_epi16(0x0F0E)));
+  }
+  zigzagPrefix16Scalar(in + i, n - i, (int16_t)_mm_extract_epi16(carry, 0), out + i);
+}
+
+KERNELS_SSE4 inline void prefix32Sse4(const uint32_t* in, uint32_t n, uint32_t base, uint32_t* out) {
+  __m128i carry = _mm_set1_epi32((int32_t)base);
+  uint32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+    x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+    x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+    _mm_storeu_si128((__m128i*)(out + i), _mm_add_epi32(x, carry));
+    carry = _mm_add_epi32(carry, _mm_shuffle_epi32(x, 0xFF));
+  }
+  prefix32Scalar(in + i, n - i, (uint32_t)_mm_cvtsi128_si32(carry), out + i);
+}
+
+KERNELS_SSE4 inline void prefix64Sse4(const uint32_t* in, uint32_t n, int64_t base, int64_t* out) {
+  __m128i carry = _mm_set1_epi64x(base);
+  uint32_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128i x = _mm_cvtepu32_epi64(_mm_loadl_epi64((const __m128i*)(in + i)));
+    x = _mm_add_epi64(x, _mm_slli_si128(x, 8));
+    _mm_storeu_si128((__m128i*)(out + i), _mm_add_epi64(x, carry));
+    carry = _mm_add_epi64(carry, _mm_unpackhi_epi64(x, x));
+  }
+  prefix64Scalar(in + i, n - i, _mm_cvtsi128_si64(carry), out + i);
+}
+
+KERNELS_SSE4 inline void deinterleaveSse4(const uint32_t* in, uint32_t pairs, uint32_t* even, uint32_t* odd) {
+  uint32_t i = 0;
+  for (; i + 4 <= pairs; i += 4) {
+    __m128 a = _mm_loadu_ps((const float*)(in + 2 * i));
+    __m128 b = _mm_loadu_ps((const float*)(in + 2 * i + 4));
+    _mm_storeu_ps((float*)(even + i), _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps((float*)(odd + i), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  deinterleaveScalar(in + 2 * i, pairs - i, even + i, odd + i);
+}
+
+// Faults are left out of the sum and count by masking them to 0, and out of the
+// minimum by turning them into INT16_MAX; as INT16_MIN they never win the maximum.
+// The 32-bit sums and 16-bit fault counts are flushed before they could overflow.
+KERNELS_SSE4 inline void rollupSse4(const int16_t* values, uint32_t n, SeriesRollup& r) {
+  const __m128i fault = _mm_set1_epi16(SAMPLE_FAULT);
+  const __m128i ones = _mm_set1_epi16(1);
+  __m128i vmin = _mm_set1_epi16(INT16_MAX);
+  __m128i vmax = _mm_set1_epi16(INT16_MIN);
+  uint32_t i = 0;
+  int64_t sum = 0;
+  uint32_t faults = 0;
+  while (n - i >= 8) {
+    __m128i vsum = _mm_setzero_si128();
+    __m128i vfaults = _mm_setzero_si128();
+    uint32_t stop = i + std::min<uint32_t>((n - i) & ~7u, 8 * 4096);
+    for (; i < stop; i += 8) {
+      __m128i v = _mm_loadu_si128((const __m128i*)(values + i));
+      __m128i isFault = _mm_cmpeq_epi16(v, fault);
+      vmax = _mm_max_epi16(vmax, v);
+      vmin = _mm_min_epi16(vmin, _mm_blendv_epi8(v, _mm_set1_epi16(INT16_MAX), isFault));
+      vsum = _mm_add_epi32(vsum, _mm_madd_epi16(_mm_andnot_si128(isFault, v), ones));
+      vfaults = _mm_sub_epi16(vfaults, isFault);
+    }
+    int32_t s[4];
+    int16_t f[8];
+    _mm_storeu_si128((__m128i*)s, vsum);
+    _mm_storeu_si128((__m128i*)f, vfaults);
+    for (int k = 0; k < 4; k++) sum += s[k];
+    for (int k = 0; k < 8; k++) faults += (uint16_t)f[k];
+  }
+  int16_t mins[8];
+  int16_t maxes[8];
+  _mm_storeu_si128((__m128i*)mins, vmin);
+  _mm_storeu_si128((__m128i*)maxes, vmax);
+  SeriesRollup simd;
+  simd.count = i;
+  simd.valid = i - faults;
+  simd.sum = sum;
+  for (int k = 0; k < 8; k++) {
+    simd.min = std::min(simd.min, mins[k]);
+    simd.max = std::max(simd.max, maxes[k]);
+  }
+  if (simd.valid > 0) r.merge(simd);
+  else r.count += simd.count;
+  rollupScalar(values + i, n - i, r);
+}
+
+// AVX2: the same kernels 16 or 8 lanes wide, with a cross-lane step for the
+// prefix sums; varint decoding stays on the 128-bit shuffles. The prefix sums
+// keep the running total off the critical path: each vector's own sum is added
+// to it separately from the vector's output.
+KERNELS_AVX2 inline void zigzagPrefix16Avx2(const uint32_t* in, uint32_t n, int16_t base, int16_t* out) {
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i low16 = _mm256_set1_epi32(0xFFFF);
+  const __m256i last = _mm256_set1_epi16(0x0F0E);
+  __m256i carry = _mm256_set1_epi16(base);
+  uint32_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(in + i));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(in + i + 8));
+    a = _mm256_xor_si256(_mm256_srli_epi32(a, 1), _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(a, one)));
+    b = _mm256_xor_si256(_mm256_srli_epi32(b, 1), _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(b, one)));
+    __m256i x = _mm256_packus_epi32(_mm256_and_si256(a, low16), _mm256_and_si256(b, low16));
+    x = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 1, 2, 0));
+    x = _mm256_add_epi16(x, _mm256_slli_si256(x, 2));
+    x = _mm256_add_epi16(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi16(x, _mm256_slli_si256(x, 8));
+    // Carry the low lane's total into the high lane
+    x = _mm256_add_epi16(x, _mm256_permute2x128_si256(_mm256_shuffle_epi8(x, last), x, 0x08));
+    _mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi16(x, carry));
+    // Element 15 is the top half of dword 7
+    carry = _mm256_add_epi16(carry, _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7)),
+                                                        _mm256_set1_epi16(0x0302)));
+  }
+  zigzagPrefix16Scalar(in + i, n - i, (int16_t)_mm256_extract_epi16(carry, 0), out + i);
+}
+
+KERNELS_AVX2 inline void prefix32Avx2(const uint32_t* in, uint32_t n, uint32_t base, uint32_t* out) {
+  __m256i carry = _mm256_set1_epi32((int32_t)base);
+  uint32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i x = _mm256_loadu_si256((const __m256i*)(in + i));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+    x = _mm256_add_epi32(x, _mm256_permute2x128_si256(_mm256_shuffle_epi32(x, 0xFF), x, 0x08));
+    _mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi32(x, carry));
+    carry = _mm256_add_epi32(carry, _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7)));
+  }
+  prefix32Scalar(in + i, n - i, (uint32_t)_mm256_extract_epi32(carry, 0), out + i);
+}
+
+KERNELS_AVX2 inline void prefix64Avx2(const uint32_t* in, uint32_t n, int64_t base, int64_t* out) {
+  __m256i carry = _mm256_set1_epi64x(base);
+  uint32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i x = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(in + i)));
+    x = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+    x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_setzero_si256(),
+                                               _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 1, 0, 0)), 0xF0));
+    _mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi64(x, carry));
+    carry = _mm256_add_epi64(carry, _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3)));
+  }
+  prefix64Scalar(in + i, n - i, _mm256_extract_epi64(carry, 0), out + i);
+}
+
+KERNELS_AVX2 inline void deinterleaveAvx2(const uint32_t* in, uint32_t pairs, uint32_t* even, uint32_t* odd) {
+  uint32_t i = 0;
+  for (; i + 8 <= pairs; i += 8) {
+    __m256 a = _mm256_loadu_ps((const float*)(in + 2 * i));
+    __m256 b = _mm256_loadu_ps((const float*)(in + 2 * i + 8));
+    __m256i e = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    __m256i o = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    _mm256_storeu_si256((__m256i*)(even + i), _mm256_permute4x64_epi64(e, _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm256_storeu_si256((__m256i*)(odd + i), _mm256_permute4x64_epi64(o, _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  deinterleaveScalar(in + 2 * i, pairs - i, even + i, odd + i);
+}
+
+KERNELS_AVX2 inline void rollupAvx2(const int16_t* values, uint32_t n, SeriesRollup& r) {
+  const __m256i fault = _mm256_set1_epi16(SAMPLE_FAULT);
+  const __m256i ones = _mm256_set1_epi16(1);
+  __m256i vmin = _mm256_set1_epi16(INT16_MAX);
+  __m256i vmax = _mm256_set1_epi16(INT16_MIN);
+  uint32_t i = 0;
+  int64_t sum = 0;
+  uint32_t faults = 0;
+  while (n - i >= 16) {
+    __m256i vsum = _mm256_setzero_si256();
+    __m256i vfaults = _mm256_setzero_si256();
+    uint32_t stop = i + std::min<uint32_t>((n - i) & ~15u, 16 * 4096);
+    for (; i < stop; i += 16) {
+      __m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+      __m256i isFault = _mm256_cmpeq_epi16(v, fault);
+      vmax = _mm256_max_epi16(vmax, v);
+      vmin = _mm256_min_epi16(vmin, _mm256_blendv_epi8(v, _mm256_set1_epi16(INT16_MAX), isFault));
+      vsum = _mm256_add_epi32(vsum, _mm256_madd_epi16(_mm256_andnot_si256(isFault, v), ones));
+      vfaults = _mm256_sub_epi16(vfaults, isFault);
+    }
+    int32_t s[8];
+    int16_t f[16];
+    _mm256_storeu_si256((__m256i*)s, vsum);
+    _mm256_storeu_si256((__m256i*)f, vfaults);
+    for (int k = 0; k < 8; k++) sum += s[k];
+    for (int k = 0; k < 16; k++) faults += (uint16_t)f[k];
+  }
+  int16_t mins[16];
+  int16_t maxes[16];
+  _mm256_storeu_si256((__m256i*)mins, vmin);
+  _mm256_storeu_si256((__m256i*)maxes, vmax);
+  SeriesRollup simd;
+  simd.count = i;
+  simd.valid = i - faults;
+  simd.sum = sum;
+  for (int k = 0; k < 16; k++) {
+    simd.min = std::min(simd.min, mins[k]);
+    simd.max = std::max(simd.max, maxes[k]);
+  }
+  if (simd.valid > 0) r.merge(simd);
+  else r.count += simd.count;
+  rollupScalar(values + i, n - i, r);
+}
+
+#endif // KERNELS_X86
+
+inline bool kernelLevelSupported(KernelLevel level) {
+#ifdef KERNELS_X86
+  if (level == KERNEL_AVX2) return __builtin_cpu_supports("avx2");
+  if (level == KERNEL_SSE4) return __builtin_cpu_supports("sse4.1");
+#endif
+  return level == KERNEL_SCALAR;
+}
+
+// The kernels of one level; it must be supported
+inline const ColumnKernels& columnKernels(KernelLevel level) {
+  static const ColumnKernels scalar = { KERNEL_SCALAR, "scalar", varintsScalar, zigzagPrefix16Scalar, prefix32Scalar,
+                                        prefix64Scalar, deinterleaveScalar, rollupScalar };
+#ifdef KERNELS_X86
+  static const ColumnKernels sse4 = { KERNEL_SSE4, "sse4.1", varintsSse4, zigzagPrefix16Sse4, prefix32Sse4,
+                                      prefix64Sse4, deinterleaveSse4, rollupSse4 };
+  static const ColumnKernels avx2 = { KERNEL_AVX2, "avx2", varintsSse4, zigzagPrefix16Avx2, prefix32Avx2,
+                                      prefix64Avx2, deinterleaveAvx2, rollupAvx2 };
+  if (level == KERNEL_AVX2) return avx2;
+  if (level == KERNEL_SSE4) return sse4;
+#endif
+  return scalar;
+}
+
+// The best kernels this CPU runs
+inline const ColumnKernels& columnKernels() {
+  static const ColumnKernels& best = columnKernels(kernelLevelSupported(KERNEL_AVX2)   ? KERNEL_AVX2
+                                                  : kernelLevelSupported(KERNEL_SSE4) ? KERNEL_SSE4
+                                                                                      : KERNEL_SCALAR);
+  return best;
+}
+
+// decodeSeriesBlock() on the kernels: the same results, block.count at most
+// SERIES_BLOCK_SAMPLES; a block with a time delta over 32 bits goes to the reference
+inline bool decodeSeriesBlockFast(const SeriesBlock& block, const uint8_t* time, const uint8_t* temp, int64_t* ms,
+                                  int16_t* values, const ColumnKernels& k = columnKernels()) {
+  uint32_t raw[SERIES_BLOCK_SAMPLES];
+  const uint8_t* t = time + block.timeOffset;
+  const uint8_t* tEnd = t + block.timeBytes;
+  const uint8_t* v = temp + block.tempOffset;
+  const uint8_t* vEnd = v + block.tempBytes;
+  uint64_t first;
+  bool wide = false;
+  if (block.count == 0 || block.count > SERIES_BLOCK_SAMPLES || !getVarint(t, tEnd, first) ||
+      !k.varints(t, tEnd, raw, block.count - 1, wide)) {
+    return false;
+  }
+  if (wide) return decodeSeriesBlock(block, time, temp, ms, values);
+  ms[0] = (int64_t)first;
+  k.prefix64(raw, block.count - 1, (int64_t)first, ms + 1);
+  if (!k.varints(v, vEnd, raw, block.count, wide)) return false;
+  k.zigzagPrefix16(raw, block.count, 0, values);
+  return t == tEnd && v == vEnd;
+}
+
+// Room decodeSampleBatchColumns() needs in its scratch for `capacity` samples
+#define SAMPLE_BATCH_SCRATCH(capacity) (4 * (capacity))
+
+// decodeSampleBatch() on the kernels, into columns: the same ms and values
+// The varints of a batch alternate between time and value deltas after the first
+// value; they are decoded in one pass, split and summed up.
+inline bool decodeSampleBatchColumns(const uint8_t* payload, size_t length, SampleBatchHeader& header, uint32_t* ms,
+                                     int16_t* values, uint32_t capacity, uint32_t* scratch,
+                                     const ColumnKernels& k = columnKernels()) {
+  const uint8_t* p = payload;
+  const uint8_t* end = payload + length;
+  if (!decodeSampleBatchHeader(p, end, header) || header.count > capacity) return false;
+  if (header.count == 0) return p == end;
+
+  uint32_t n = header.count;
+  uint32_t* raw = scratch;                   // value, then (ms delta, value delta) pairs
+  uint32_t* deltas = scratch + 2 * capacity;
+  uint32_t* gaps = scratch + 3 * capacity;
+  bool wide = false;
+  if (!k.varints(p, end, raw, 2 * n - 1, wide)) return false;
+  raw[2 * n - 1] = 0;
+  k.deinterleave(raw, n, deltas, gaps);
+  k.zigzagPrefix16(deltas, n, 0, values);
+  ms[0] = 0;
+  k.prefix32(gaps, n - 1, 0, ms + 1);
+  return p == end;
+}
+
+#endif // COLUMN_KERNELS_H
@@ -0,0 +1,50 @@
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Cheapest timestamp the host offers for timing short stretches of code
+// On x86 this is the TSC, which counts at the nominal clock rate regardless of
+// turbo or power saving ("ref cycles"); elsewhere it is the monotonic clock in ns.
+inline uint64_t cycleCount() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+inline const char* cycleUnit() {
+#if defined(__x86_64__) || defined(__i386__)
+  return "cycles";
+#else
+  return "ns";
+#endif
+}
+
+inline double monotonicSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+inline uint64_t monotonicNanos() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Wall clock in ms since the epoch, for sample timestamps
+inline int64_t wallMillis() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+#endif // CYCLE_COUNTER_H
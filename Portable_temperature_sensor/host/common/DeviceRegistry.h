@@ -0,0 +1,68 @@
+#ifndef DEVICE_REGISTRY_H
+#define DEVICE_REGISTRY_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <vector>
+#include "MqttTopics.h"
+
+// Device IDs seen by the gateway, numbered densely in order of first appearance
+// One thread (the receiver) adds and looks up names; any thread may read the name
+// of an index below size(), which is published with release order after the name
+// is written. Lookup is an open-addressing hash on the ID, so the per-message path
+// never allocates; all memory is reserved up front for `capacity` devices.
+class DeviceRegistry {
+private:
+  struct Name {
+    char id[MQTT_ID_LEN];
+  };
+
+  std::vector<Name> _names;
+  std::vector<int32_t> _table;  // Index into _names, -1 = empty
+  uint32_t _mask;
+  std::atomic<uint32_t> _size{0};
+
+  static uint32_t hash(const char* id, size_t length) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) h = (h ^ (uint8_t)id[i]) * 16777619u;
+    return h;
+  }
+
+public:
+  explicit DeviceRegistry(uint32_t capacity) : _names(capacity) {
+    uint32_t slots = 1;
+    while (slots < capacity * 2) slots <<= 1;
+    _table.assign(slots, -1);
+    _mask = slots - 1;
+  }
+
+  // Index of the device, adding it if new; -1 if the ID is too long or the registry is full
+  int32_t find(const char* id, size_t length) {
+    if (length == 0 || length >= MQTT_ID_LEN) return -1;
+    for (uint32_t slot = hash(id, length) & _mask;; slot = (slot + 1) & _mask) {
+      int32_t index = _table[slot];
+      if (index < 0) break;
+      const char* name = _names[index].id;
+      if (strncmp(name, id, length) == 0 && name[length] == '\0') return index;
+    }
+    uint32_t index = _size.load(std::memory_order_relaxed);
+    if (index >= _names.size()) return -1;
+    memcpy(_names[index].id, id, length);
+    _names[index].id[length] = '\0';
+    for (uint32_t slot = hash(id, length) & _mask;; slot = (slot + 1) & _mask) {
+      if (_table[slot] < 0) {
+        _table[slot] = (int32_t)index;
+        break;
+      }
+    }
+    _size.store(index + 1, std::memory_order_release);
+    return (int32_t)index;
+  }
+
+  const char* name(uint32_t index) const { return _names[index].id; }
+  uint32_t size() const { return _size.load(std::memory_order_acquire); }
+  uint32_t capacity() const { return (uint32_t)_names.size(); }
+};
+
+#endif // DEVICE_REGISTRY_H
@@ -0,0 +1,64 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+// Object woken up by the event loop when its file descriptor is ready
+class EventHandler {
+public:
+  virtual ~EventHandler() {}
+  virtual void onEvents(uint32_t events) = 0;  // EPOLLIN, EPOLLOUT, EPOLLERR, EPOLLHUP
+};
+
+// Thin epoll wrapper: one loop per thread, many non-blocking descriptors
+// Handlers are registered by pointer and must outlive their registration.
+class EventLoop {
+private:
+  static const int MAX_EVENTS = 256;
+  int _fd;
+  epoll_event _events[MAX_EVENTS];
+
+public:
+  EventLoop() : _fd(epoll_create1(EPOLL_CLOEXEC)) {}
+  ~EventLoop() {
+    if (_fd >= 0) close(_fd);
+  }
+
+  EventLoop(const EventLoop&) = delete;
+  EventLoop& operator=(const EventLoop&) = delete;
+
+  bool valid() const { return _fd >= 0; }
+
+  bool add(int fd, uint32_t events, EventHandler* handler) {
+    epoll_event ev = {};
+    ev.events = events;
+    ev.data.ptr = handler;
+    return epoll_ctl(_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+  }
+
+  bool modify(int fd, uint32_t events, EventHandler* handler) {
+    epoll_event ev = {};
+    ev.events = events;
+    ev.data.ptr = handler;
+    return epoll_ctl(_fd, EPOLL_CTL_MOD, fd, &ev) == 0;
+  }
+
+  void remove(int fd) {
+    epoll_ctl(_fd, EPOLL_CTL_DEL, fd, NULL);
+  }
+
+  // Wait up to timeoutMs (-1 = forever) and dispatch; returns the number of ready descriptors
+  int poll(int timeoutMs) {
+    int n = epoll_wait(_fd, _events, MAX_EVENTS, timeoutMs);
+    if (n < 0) return errno == EINTR ? 0 : -1;
+    for (int i = 0; i < n; i++) {
+      static_cast<EventHandler*>(_events[i].data.ptr)->onEvents(_events[i].events);
+    }
+    return n;
+  }
+};
+
+#endif // EVENT_LOOP_H
@@ -0,0 +1,87 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Fixed-size log-linear histogram for latencies in us
+// Values below 32 get a bucket each; above that every power of two is split into
+// 16 buckets, so a percentile is off by at most 1/16 (6%) of its value. Recording
+// is a few instructions and never allocates, so it can sit on the hot path.
+// Percentiles report the upper edge of their bucket, capped at the largest value seen.
+class LatencyHistogram {
+private:
+  static const int LINEAR = 32;
+  static const int SUB_BUCKETS = 16;
+  static const int BUCKETS = LINEAR + 59 * SUB_BUCKETS;
+
+  uint64_t _counts[BUCKETS];
+  uint64_t _count = 0;
+  uint64_t _sum = 0;
+  uint64_t _min = UINT64_MAX;
+  uint64_t _max = 0;
+
+  static int bucket(uint64_t v) {
+    if (v < LINEAR) return (int)v;
+    int shift = 63 - __builtin_clzll(v) - 4;
+    return LINEAR + (shift - 1) * SUB_BUCKETS + (int)((v >> shift) - SUB_BUCKETS);
+  }
+
+  static uint64_t upperEdge(int index) {
+    if (index < LINEAR) return (uint64_t)index;
+    int shift = (index - LINEAR) / SUB_BUCKETS + 1;
+    uint64_t top = (uint64_t)((index - LINEAR) % SUB_BUCKETS + SUB_BUCKETS);
+    return ((top + 1) << shift) - 1;
+  }
+
+public:
+  LatencyHistogram() { reset(); }
+
+  void reset() {
+    memset(_counts, 0, sizeof(_counts));
+    _count = 0;
+    _sum = 0;
+    _min = UINT64_MAX;
+    _max = 0;
+  }
+
+  void record(uint64_t us) {
+    _counts[bucket(us)]++;
+    _count++;
+    _sum += us;
+    if (us < _min) _min = us;
+    if (us > _max) _max = us;
+  }
+
+  void merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKETS; i++) _counts[i] += other._counts[i];
+    _count += other._count;
+    _sum += other._sum;
+    if (other._min < _min) _min = other._min;
+    if (other._max > _max) _max = other._max;
+  }
+
+  // Value at percentile p (0-100), 0 when empty
+  uint64_t percentile(double p) const {
+    if (_count == 0) return 0;
+    uint64_t rank = (uint64_t)(p / 100.0 * _count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > _count) rank = _count;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+      seen += _counts[i];
+      if (seen >= rank) {
+        uint64_t edge = upperEdge(i);
+        return edge < _max ? edge : _max;
+      }
+    }
+    return _max;
+  }
+
+  uint64_t count() const { return _count; }
+  uint64_t min() const { return _count > 0 ? _min : 0; }
+  uint64_t max() const { return _max; }
+  double mean() const { return _count > 0 ? (double)_sum / _count : 0; }
+};
+
+#endif // LATENCY_HISTOGRAM_H
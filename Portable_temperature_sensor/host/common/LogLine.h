@@ -0,0 +1,107 @@
+#ifndef LOG_LINE_H
+#define LOG_LINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// One line of the log-mode output that serialOutput() sends to softSerial:
+//   "%02d,%02d,%04d,%02d,%02d,%02d,%.2f" = day,month,year,hour,minute,second,°C
+// An open thermocouple prints the reading as "nan" (or "-nan"). Outside log mode
+// the reading is sent on its own, "%.2f".
+struct LogRecord {
+  uint16_t year;
+  uint8_t month;
+  uint8_t day;
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+  bool fault;         // Reading was NAN
+  int32_t centi;      // Temperature in 0.01°C, 0 on a fault
+};
+
+namespace LogLine {
+
+// Exactly `width` decimal digits at p
+inline bool digits(const char* p, int width, int& value) {
+  value = 0;
+  for (int i = 0; i < width; i++) {
+    unsigned d = (unsigned)(p[i] - '0');
+    if (d > 9) return false;
+    value = value * 10 + (int)d;
+  }
+  return true;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+inline int64_t daysFromCivil(int year, int month, int day) {
+  year -= month <= 2;
+  int64_t era = (year >= 0 ? year : year - 399) / 400;
+  int64_t yoe = year - era * 400;
+  int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+// The "%.2f" reading that ends a line: [-]digits '.' two digits, or [-]nan
+inline bool reading(const char* p, const char* end, LogRecord& record) {
+  bool negative = p < end && *p == '-';
+  if (negative) p++;
+  if (end - p == 3 && p[0] == 'n' && p[1] == 'a' && p[2] == 'n') {
+    record.fault = true;
+    record.centi = 0;
+    return true;
+  }
+
+  // Integer digits, '.', exactly two decimals
+  int32_t whole = 0;
+  const char* start = p;
+  while (p < end && (unsigned)(*p - '0') <= 9) {
+    whole = whole * 10 + (*p - '0');
+    if (whole > 1000000) return false;
+    p++;
+  }
+  int fraction;
+  if (p == start || end - p != 3 || p[0] != '.' || !digits(p + 1, 2, fraction)) return false;
+  record.fault = false;
+  record.centi = (whole * 100 + fraction) * (negative ? -1 : 1);
+  return true;
+}
+
+}  // namespace LogLine
+
+// Parse one line, without its line ending; no allocation, no locale, no strtod
+// Returns false unless the line has exactly the firmware's layout.
+inline bool parseLogLine(const char* line, size_t length, LogRecord& record) {
+  // Fixed part "dd,mm,yyyy,hh,mm,ss," is 20 characters
+  if (length < 21) return false;
+  const char* p = line;
+  int day, month, year, hour, minute, second;
+  if (!LogLine::digits(p, 2, day) || p[2] != ',') return false;
+  if (!LogLine::digits(p + 3, 2, month) || p[5] != ',') return false;
+  if (!LogLine::digits(p + 6, 4, year) || p[10] != ',') return false;
+  if (!LogLine::digits(p + 11, 2, hour) || p[13] != ',') return false;
+  if (!LogLine::digits(p + 14, 2, minute) || p[16] != ',') return false;
+  if (!LogLine::digits(p + 17, 2, second) || p[19] != ',') return false;
+  if (day < 1 || day > 31 || month < 1 || month > 12 || hour > 23 || minute > 59 || second > 60) return false;
+  record.day = (uint8_t)day;
+  record.month = (uint8_t)month;
+  record.year = (uint16_t)year;
+  record.hour = (uint8_t)hour;
+  record.minute = (uint8_t)minute;
+  record.second = (uint8_t)second;
+
+  return LogLine::reading(line + 20, line + length, record);
+}
+
+// Parse one normal-mode line, "%.2f" on its own; the date fields are left alone
+inline bool parseReadingLine(const char* line, size_t length, LogRecord& record) {
+  return LogLine::reading(line, line + length, record);
+}
+
+// Wall-clock time of a record as seconds since the epoch, taking the device clock as UTC
+inline int64_t logRecordSeconds(const LogRecord& record) {
+  return LogLine::daysFromCivil(record.year, record.month, record.day) * 86400 +
+         record.hour * 3600 + record.minute * 60 + record.second;
+}
+
+#endif // LOG_LINE_H
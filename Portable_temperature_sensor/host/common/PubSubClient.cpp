@@ -0,0 +1,436 @@
+#include "PubSubClient.h"
+#include "CycleCounter.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+
+#define MQTT_CONNECT 0x10
+#define MQTT_CONNACK 0x20
+#define MQTT_PUBLISH 0x30
+#define MQTT_PUBACK 0x40
+#define MQTT_SUBSCRIBE 0x82
+#define MQTT_SUBACK 0x90
+#define MQTT_UNSUBSCRIBE 0xA2
+#define MQTT_UNSUBACK 0xB0
+#define MQTT_PINGREQ 0xC0
+#define MQTT_PINGRESP 0xD0
+#define MQTT_DISCONNECT 0xE0
+
+#define MQTT_READ_CHUNK 4096
+
+// Own clock rather than millis(), so tools without the NativeHal clock can use the client
+static unsigned long monotonicMillis() {
+  return (unsigned long)(monotonicNanos() / 1000000);
+}
+
+PubSubClient::PubSubClient(EventLoop& loop) : _loop(loop) {}
+
+PubSubClient::~PubSubClient() {
+  if (_fd >= 0) close(MQTT_DISCONNECTED);
+}
+
+// All devices of a fleet use the same broker, so the last lookup is kept
+PubSubClient& PubSubClient::setServer(const char* domain, uint16_t port) {
+  static std::string cachedHost;
+  static uint16_t cachedPort = 0;
+  static sockaddr_storage cachedAddress;
+  static socklen_t cachedLength = 0;
+
+  if (cachedLength == 0 || cachedHost != domain || cachedPort != port) {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = NULL;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    cachedLength = 0;
+    if (getaddrinfo(domain, service, &hints, &result) == 0 && result != NULL) {
+      memcpy(&cachedAddress, result->ai_addr, result->ai_addrlen);
+      cachedLength = result->ai_addrlen;
+      cachedHost = domain;
+      cachedPort = port;
+    }
+    if (result != NULL) freeaddrinfo(result);
+  }
+  _server = cachedAddress;
+  _serverLength = cachedLength;
+  return *this;
+}
+
+PubSubClient& PubSubClient::setCallback(MQTT_CALLBACK_SIGNATURE) {
+  this->callback = callback;
+  return *this;
+}
+
+PubSubClient& PubSubClient::setKeepAlive(uint16_t seconds) {
+  _keepAlive = seconds;
+  return *this;
+}
+
+void PubSubClient::putString(const char* s) {
+  size_t length = strlen(s);
+  putWord((uint16_t)length);
+  _out.insert(_out.end(), (const uint8_t*)s, (const uint8_t*)s + length);
+}
+
+void PubSubClient::putHeader(uint8_t header, size_t remaining) {
+  putByte(header);
+  do {
+    uint8_t b = remaining % 128;
+    remaining /= 128;
+    putByte(remaining > 0 ? (b | 0x80) : b);
+  } while (remaining > 0);
+}
+
+uint16_t PubSubClient::packetId() {
+  if (_nextPacketId == 0) _nextPacketId = 1;
+  return _nextPacketId++;
+}
+
+bool PubSubClient::connect(const char* id, const char* user, const char* pass, const char* willTopic,
+                           uint8_t willQos, bool willRetain, const char* willMessage, bool cleanSession) {
+  if (_fd >= 0) close(MQTT_DISCONNECTED);
+  if (_serverLength == 0) {
+    _state = MQTT_CONNECT_FAILED;
+    return false;
+  }
+
+  _fd = socket(_server.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (_fd < 0) {
+    _state = MQTT_CONNECT_FAILED;  // Usually out of descriptors, see RLIMIT_NOFILE
+    return false;
+  }
+  int one = 1;
+  setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  if (::connect(_fd, (const sockaddr*)&_server, _serverLength) != 0 && errno != EINPROGRESS) {
+    ::close(_fd);
+    _fd = -1;
+    _state = MQTT_CONNECT_FAILED;
+    return false;
+  }
+
+  _session++;
+  _tcpUp = false;
+  _connack = false;
+  _pingOutstanding = false;
+  _subacksOwed = 0;
+  _subscribed = false;
+  _out.clear();
+  _outHead = 0;
+  _in.clear();
+  _streaming = false;
+  _connectStart = monotonicNanos() / 1000;
+  _lastIn = _lastOut = monotonicMillis();
+  _wantOut = true;  // Writable once the handshake is done
+  _loop.add(_fd, EPOLLIN | EPOLLOUT, this);
+
+  uint8_t flags = cleanSession ? 0x02 : 0;
+  size_t remaining = 10 + 2 + strlen(id);
+  if (willTopic != NULL) {
+    flags |= 0x04 | (willQos << 3) | (willRetain ? 0x20 : 0);
+    remaining += 2 + strlen(willTopic) + 2 + (willMessage ? strlen(willMessage) : 0);
+  }
+  if (user != NULL) {
+    flags |= 0x80;
+    remaining += 2 + strlen(user);
+    if (pass != NULL) {
+      flags |= 0x40;
+      remaining += 2 + strlen(pass);
+    }
+  }
+  putHeader(MQTT_CONNECT, remaining);
+  putString("MQTT");
+  putByte(4);  // 3.1.1
+  putByte(flags);
+  putWord(_keepAlive);
+  putString(id);
+  if (willTopic != NULL) {
+    putString(willTopic);
+    putString(willMessage ? willMessage : "");
+  }
+  if (user != NULL) {
+    putString(user);
+    if (pass != NULL) putString(pass);
+  }
+
+  _state = MQTT_CONNECTED;
+  return true;
+}
+
+void PubSubClient::disconnect() {
+  if (_fd >= 0 && _tcpUp) {
+    uint8_t packet[2] = { MQTT_DISCONNECT, 0 };
+    if (send(_fd, packet, sizeof(packet), MSG_NOSIGNAL | MSG_DONTWAIT) > 0) _bytesOut += sizeof(packet);
+  }
+  close(MQTT_DISCONNECTED);
+}
+
+void PubSubClient::abort() {
+  close(MQTT_CONNECTION_LOST);
+}
+
+void PubSubClient::close(int state) {
+  if (_fd >= 0) {
+    _loop.remove(_fd);
+    ::close(_fd);
+    _fd = -1;
+  }
+  _session++;
+  _tcpUp = false;
+  _connack = false;
+  _wantOut = false;
+  _streaming = false;
+  _state = state;
+}
+
+void PubSubClient::watchOutput(bool want) {
+  if (want == _wantOut || _fd < 0) return;
+  _wantOut = want;
+  _loop.modify(_fd, want ? (EPOLLIN | EPOLLOUT) : EPOLLIN, this);
+}
+
+// Send what the socket takes; the rest waits for EPOLLOUT
+void PubSubClient::flush() {
+  if (_fd < 0 || !_tcpUp) return;
+  while (pending() > 0) {
+    ssize_t n = send(_fd, _out.data() + _outHead, pending(), MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      close(MQTT_CONNECTION_LOST);
+      return;
+    }
+    _outHead += n;
+    _bytesOut += n;
+  }
+  if (pending() == 0) {
+    _out.clear();
+    _outHead = 0;
+  } else if (_outHead > _out.size() / 2) {
+    _out.erase(_out.begin(), _out.begin() + _outHead);  // Keep the queue from creeping
+    _outHead = 0;
+  }
+  watchOutput(pending() > 0);
+}
+
+void PubSubClient::onEvents(uint32_t events) {
+  if (!_tcpUp && (events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    getsockopt(_fd, SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error != 0) {
+      close(MQTT_CONNECT_FAILED);
+      return;
+    }
+    _tcpUp = true;
+  }
+  if (events & EPOLLIN) {
+    readAll();
+    if (_fd < 0) return;
+  }
+  if (events & (EPOLLERR | EPOLLHUP)) {
+    close(MQTT_CONNECTION_LOST);
+    return;
+  }
+  if (events & EPOLLOUT) flush();
+}
+
+void PubSubClient::readAll() {
+  for (;;) {
+    size_t used = _in.size();
+    _in.resize(used + MQTT_READ_CHUNK);
+    ssize_t n = recv(_fd, _in.data() + used, MQTT_READ_CHUNK, MSG_DONTWAIT);
+    if (n <= 0) {
+      _in.resize(used);
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) break;
+      close(MQTT_CONNECTION_LOST);  // Peer closed or reset
+      return;
+    }
+    _in.resize(used + n);
+    _bytesIn += n;
+    if (n < MQTT_READ_CHUNK) break;
+  }
+  _lastIn = monotonicMillis();
+
+  // Complete packets from the front of the buffer
+  uint32_t session = _session;
+  size_t at = 0;
+  while (at < _in.size()) {
+    size_t remaining = 0;
+    size_t p = at + 1;
+    int shift = 0;
+    bool complete = false;
+    while (p < _in.size() && shift <= 21) {
+      uint8_t b = _in[p++];
+      remaining |= (size_t)(b & 0x7F) << shift;
+      shift += 7;
+      if (!(b & 0x80)) {
+        complete = true;
+        break;
+      }
+    }
+    if (!complete) {
+      if (shift > 21) close(MQTT_CONNECTION_LOST);  // Malformed length
+      if (shift > 21 || _fd < 0) return;
+      break;
+    }
+    if (_in.size() - p < remaining) break;
+    uint8_t header = _in[at];
+    at = p + remaining;
+    if (!handlePacket(header, _in.data() + p, remaining) || _session != session) return;
+  }
+  _in.erase(_in.begin(), _in.begin() + at);
+  flush();  // PUBACKs and whatever the callback published
+}
+
+// Returns false if the connection was closed
+bool PubSubClient::handlePacket(uint8_t header, const uint8_t* body, size_t length) {
+  switch (header & 0xF0) {
+    case MQTT_CONNACK:
+      if (length < 2 || body[1] != 0) {
+        close(length < 2 ? MQTT_CONNECT_FAILED : body[1]);
+        return false;
+      }
+      _connack = true;
+      _connacks++;
+      _connackLatency = monotonicNanos() / 1000 - _connectStart;
+      return true;
+
+    case MQTT_PUBLISH: {
+      if (length < 2) break;
+      size_t topicLength = ((size_t)body[0] << 8) | body[1];
+      uint8_t qos = (header >> 1) & 3;
+      size_t offset = 2 + topicLength + (qos > 0 ? 2 : 0);
+      if (offset > length) break;
+      if (qos == 1) {
+        putHeader(MQTT_PUBACK, 2);
+        putByte(body[2 + topicLength]);
+        putByte(body[3 + topicLength]);
+      }
+      if (callback) {
+        _topic.assign((const char*)body + 2, topicLength);
+        callback(&_topic[0], (uint8_t*)body + offset, length - offset);
+      }
+      return true;
+    }
+
+    case MQTT_PINGRESP:
+      _pingOutstanding = false;
+      return true;
+
+    case MQTT_SUBACK:
+      // Ready once the subscriptions made with the connect are all in place
+      if (_subacksOwed > 0 && --_subacksOwed == 0 && !_subscribed) {
+        _subscribed = true;
+        _readies++;
+        _readyLatency = monotonicNanos() / 1000 - _connectStart;
+      }
+      return true;
+
+    case MQTT_UNSUBACK:
+    case MQTT_PUBACK:
+      return true;
+
+    default:
+      return true;  // Nothing else is sent to a client
+  }
+  close(MQTT_CONNECTION_LOST);  // Malformed
+  return false;
+}
+
+bool PubSubClient::loop() {
+  if (_fd < 0) return false;
+  unsigned long t = monotonicMillis();
+  if (!_connack) {
+    if (t - _lastOut >= MQTT_SOCKET_TIMEOUT * 1000UL) {
+      close(MQTT_CONNECTION_TIMEOUT);
+      return false;
+    }
+    return true;
+  }
+  unsigned long keepAlive = _keepAlive * 1000UL;
+  if (keepAlive > 0 && (t - _lastIn > keepAlive || t - _lastOut > keepAlive)) {
+    if (_pingOutstanding) {
+      close(MQTT_CONNECTION_TIMEOUT);
+      return false;
+    }
+    putHeader(MQTT_PINGREQ, 0);
+    _lastOut = t;
+    _lastIn = t;  // Give the broker a full keepalive to answer
+    _pingOutstanding = true;
+    flush();
+  }
+  return _fd >= 0;
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained) {
+  if (!beginPublish(topic, length, retained)) return false;
+  write(payload, length);
+  return endPublish() == 1;
+}
+
+bool PubSubClient::subscribe(const char* topic, uint8_t qos) {
+  if (_fd < 0 || qos > 1) return false;
+  putHeader(MQTT_SUBSCRIBE, 2 + 2 + strlen(topic) + 1);
+  putWord(packetId());
+  putString(topic);
+  putByte(qos);
+  _subacksOwed++;
+  _lastOut = monotonicMillis();
+  flush();
+  return _fd >= 0;
+}
+
+bool PubSubClient::unsubscribe(const char* topic) {
+  if (_fd < 0) return false;
+  putHeader(MQTT_UNSUBSCRIBE, 2 + 2 + strlen(topic));
+  putWord(packetId());
+  putString(topic);
+  _lastOut = monotonicMillis();
+  flush();
+  return _fd >= 0;
+}
+
+bool PubSubClient::beginPublish(const char* topic, unsigned int length, bool retained) {
+  if (_fd < 0 || _streaming) return false;
+  if (pending() >= _outputLimit) {
+    _refused++;
+    return false;
+  }
+  putHeader(MQTT_PUBLISH | (retained ? 1 : 0), 2 + strlen(topic) + length);
+  putString(topic);
+  _streamStart = _out.size();
+  _streamLength = length;
+  _streamTopic = topic;
+  _streaming = true;
+  return true;
+}
+
+size_t PubSubClient::write(uint8_t b) {
+  if (!_streaming) return 0;
+  _out.push_back(b);
+  return 1;
+}
+
+size_t PubSubClient::write(const uint8_t* buffer, size_t size) {
+  if (!_streaming) return 0;
+  _out.insert(_out.end(), buffer, buffer + size);
+  return size;
+}
+
+int PubSubClient::endPublish() {
+  if (!_streaming) return 0;
+  _streaming = false;
+  if (_out.size() - _streamStart != _streamLength) {
+    close(MQTT_CONNECTION_LOST);  // Header promised another length; the stream is unusable
+    return 0;
+  }
+  if (_observer) _observer(_observerContext, _streamTopic, _out.data() + _streamStart, _streamLength);
+  _lastOut = monotonicMillis();
+  flush();
+  return _fd >= 0 ? 1 : 0;
+}
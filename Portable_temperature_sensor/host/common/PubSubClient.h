@@ -0,0 +1,160 @@
+#ifndef FLEET_PUBSUBCLIENT_H
+#define FLEET_PUBSUBCLIENT_H
+
+#include <Arduino.h>
+#include <sys/socket.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include "EventLoop.h"
+
+#define MQTT_CONNECTION_TIMEOUT -4
+#define MQTT_CONNECTION_LOST -3
+#define MQTT_CONNECT_FAILED -2
+#define MQTT_DISCONNECTED -1
+#define MQTT_CONNECTED 0
+#define MQTT_CONNECT_BAD_PROTOCOL 1
+#define MQTT_CONNECT_BAD_CLIENT_ID 2
+#define MQTT_CONNECT_UNAVAILABLE 3
+#define MQTT_CONNECT_BAD_CREDENTIALS 4
+#define MQTT_CONNECT_UNAUTHORIZED 5
+
+#define MQTT_KEEPALIVE 15           // s, as in the device library
+#define MQTT_SOCKET_TIMEOUT 15      // s to wait for the CONNACK
+#define MQTT_OUTPUT_LIMIT 65536     // Bytes queued for a slow socket before publishes are refused
+
+#define MQTT_CALLBACK_SIGNATURE std::function<void(char*, uint8_t*, unsigned int)> callback
+
+// PubSubClient for the host tools: MQTT 3.1.1 over a non-blocking TCP socket
+// Same interface as the device library so MqttLink and SampleUplink run on it
+// unchanged (host/fleet), but nothing blocks: the socket is driven by an EventLoop shared by
+// every client in the process. connect() does not wait for the CONNACK; CONNECT
+// and the subscriptions after it are pipelined, and a refusal shows up later as
+// connected() going false with the CONNACK code in state(). Writes the kernel
+// cannot take yet are queued and flushed on EPOLLOUT; once MQTT_OUTPUT_LIMIT bytes
+// are waiting, publishes fail the way a full lwIP send buffer fails on the device.
+// Incoming QoS 1 messages are acknowledged; outgoing publishes are QoS 0.
+class PubSubClient : public Print, private EventHandler {
+public:
+  // Sees every outgoing publish as it is queued, e.g. to timestamp batches
+  typedef void (*PublishObserver)(void* context, const char* topic, const uint8_t* payload, size_t length);
+
+private:
+  EventLoop& _loop;
+  MQTT_CALLBACK_SIGNATURE;
+  sockaddr_storage _server;
+  socklen_t _serverLength = 0;
+  uint16_t _keepAlive = MQTT_KEEPALIVE;
+  size_t _outputLimit = MQTT_OUTPUT_LIMIT;
+  PublishObserver _observer = NULL;
+  void* _observerContext = NULL;
+
+  int _fd = -1;
+  int _state = MQTT_DISCONNECTED;
+  uint32_t _session = 0;        // Bumped on every open and close, guards callbacks
+  bool _tcpUp = false;          // Non-blocking connect finished
+  bool _connack = false;
+  bool _wantOut = false;        // EPOLLOUT registered
+  bool _pingOutstanding = false;
+  uint16_t _nextPacketId = 1;
+  unsigned long _lastIn = 0;    // ms of the last byte in / packet out, for the keepalive
+  unsigned long _lastOut = 0;
+  uint64_t _connectStart = 0;   // us
+  uint64_t _connackLatency = 0;
+  uint32_t _connacks = 0;
+  uint32_t _subacksOwed = 0;    // SUBSCRIBEs sent on this connection not yet acknowledged
+  bool _subscribed = false;     // The SUBSCRIBEs made right after connect() have all been acked
+  uint64_t _readyLatency = 0;
+  uint32_t _readies = 0;
+
+  std::vector<uint8_t> _out;
+  size_t _outHead = 0;          // First byte of _out not yet sent
+  std::vector<uint8_t> _in;
+  std::string _topic;           // Null-terminated topic of the message being delivered
+
+  size_t _streamStart = 0;      // beginPublish() .. endPublish(): payload offset in _out
+  size_t _streamLength = 0;
+  const char* _streamTopic = NULL;
+  bool _streaming = false;
+
+  uint64_t _bytesIn = 0;
+  uint64_t _bytesOut = 0;
+  uint32_t _refused = 0;        // Publishes refused because the socket was backed up
+
+  void onEvents(uint32_t events) override;
+  void close(int state);
+  void flush();
+  void readAll();
+  bool handlePacket(uint8_t header, const uint8_t* body, size_t length);
+  void watchOutput(bool want);
+
+  size_t pending() const { return _out.size() - _outHead; }
+  void putByte(uint8_t b) { _out.push_back(b); }
+  void putWord(uint16_t w) {
+    _out.push_back(w >> 8);
+    _out.push_back(w & 0xFF);
+  }
+  void putString(const char* s);
+  void putHeader(uint8_t header, size_t remaining);
+  uint16_t packetId();
+
+public:
+  explicit PubSubClient(EventLoop& loop);
+  ~PubSubClient();
+
+  PubSubClient(const PubSubClient&) = delete;
+  PubSubClient& operator=(const PubSubClient&) = delete;
+
+  PubSubClient& setServer(const char* domain, uint16_t port);
+  PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE);
+  PubSubClient& setKeepAlive(uint16_t seconds);
+  void setOutputLimit(size_t bytes) { _outputLimit = bytes; }
+  void setObserver(PublishObserver observer, void* context) {
+    _observer = observer;
+    _observerContext = context;
+  }
+
+  bool connect(const char* id, const char* user, const char* pass, const char* willTopic, uint8_t willQos,
+               bool willRetain, const char* willMessage, bool cleanSession);
+  bool connect(const char* id) { return connect(id, NULL, NULL, NULL, 0, false, NULL, true); }
+  bool connect(const char* id, const char* user, const char* pass) {
+    return connect(id, user, pass, NULL, 0, false, NULL, true);
+  }
+
+  void disconnect();   // Polite: DISCONNECT, then close
+  void abort();        // Drop the socket as a crashing device or a dead link would
+
+  bool connected() { return _fd >= 0; }
+  bool ready() const { return _connack; }  // CONNACK received
+  int state() { return _state; }
+  bool loop();         // Keepalive and CONNACK timeout; I/O happens in the EventLoop
+
+  bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained);
+  bool publish(const char* topic, const char* payload) {
+    return publish(topic, (const uint8_t*)payload, strlen(payload), false);
+  }
+  bool publish(const char* topic, const char* payload, bool retained) {
+    return publish(topic, (const uint8_t*)payload, strlen(payload), retained);
+  }
+
+  bool subscribe(const char* topic, uint8_t qos = 0);
+  bool unsubscribe(const char* topic);
+
+  bool beginPublish(const char* topic, unsigned int length, bool retained);
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int endPublish();
+
+  // Statistics
+  uint32_t connacks() const { return _connacks; }
+  uint64_t connackLatency() const { return _connackLatency; }  // us from connect() to the last CONNACK
+  uint32_t readies() const { return _readies; }                // Connections whose SUBSCRIBEs were all acked
+  uint64_t readyLatency() const { return _readyLatency; }      // us from connect() to the last of those SUBACKs
+  uint64_t bytesIn() const { return _bytesIn; }
+  uint64_t bytesOut() const { return _bytesOut; }
+  uint32_t refused() const { return _refused; }
+  size_t queued() const { return pending(); }
+};
+
+#endif // FLEET_PUBSUBCLIENT_H
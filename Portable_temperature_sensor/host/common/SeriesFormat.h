@@ -0,0 +1,159 @@
+#ifndef SERIES_FORMAT_H
+#define SERIES_FORMAT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "SampleCodec.h"
+
+// On-disk layout of the time-series store, under the store directory:
+//   devices                  device IDs, one per line; line n is device n
+//   log/<position>.wal       write-ahead log of samples not yet in a sealed block
+//   series/<id>/<n>.time     time column: per block, first epoch ms, then ms deltas
+//   series/<id>/<n>.temp     temperature column: per block, first value (zigzag), then
+//                            value deltas (zigzag); 0.25°C steps as on the device
+//   series/<id>/<n>.index    sparse time index, one SeriesBlock per block
+//   series/<id>/<n>.minute   1 min rollups, one SeriesMinute per minute a block touches
+// <n> counts a device's segments from 0. All integers in the columns are LEB128
+// varints, encoded as a device batch encodes them (SampleCodec.h), so a block is
+// the samples of a batch with the epoch moved from the header into the column.
+// Each block decodes on its own. Files only grow: a block is written to the four
+// segment files at once when it is sealed, index entry last, so a reader that
+// maps the index sees only complete blocks. Within a segment, time never goes
+// backwards. Little-endian hosts only, the structs are written as they are.
+#define SERIES_BLOCK_SAMPLES 1024      // Seal a block when it holds this many samples
+#define SERIES_SEGMENT_BLOCKS 4096     // Start a new segment after this many blocks
+#define SERIES_CLAMP_MS 1000           // Smaller steps back in time are clamped, larger start a segment
+#define SERIES_MINUTE_MS 60000
+#define SERIES_LOG_LIMIT (256u << 20)  // Checkpoint once the write-ahead log is this big
+#define SERIES_INDEX_MAGIC 0x58495354u // "TSIX"
+#define SERIES_INDEX_VERSION 1
+#define SERIES_LOG_MAGIC 0x5354        // "TS"
+
+struct SeriesIndexHeader {
+  uint32_t magic;
+  uint32_t version;
+};
+
+// One sealed block in a segment's .index
+struct SeriesBlock {
+  int64_t firstMs;
+  int64_t lastMs;
+  uint64_t logPosition;    // Write-ahead log position just past the block's last sample
+  uint32_t timeOffset;     // Where the block starts in .time and .temp
+  uint32_t tempOffset;
+  uint32_t minuteOffset;   // First record of the block in .minute
+  uint16_t count;
+  uint16_t timeBytes;
+  uint16_t tempBytes;
+  uint16_t minutes;        // Records in .minute
+  int16_t min;             // Over samples other than SAMPLE_FAULT; SAMPLE_FAULT if none
+  int16_t max;
+};
+static_assert(sizeof(SeriesBlock) == 48, "SeriesBlock is an on-disk record");
+
+// One minute of one block; a minute split across two blocks has two records
+struct SeriesMinute {
+  int64_t startMs;
+  int32_t sum;             // Of samples other than SAMPLE_FAULT
+  uint16_t count;
+  uint16_t valid;          // Samples other than SAMPLE_FAULT
+  int16_t min;
+  int16_t max;
+  uint32_t reserved;
+};
+static_assert(sizeof(SeriesMinute) == 24, "SeriesMinute is an on-disk record");
+
+// One sample in the write-ahead log
+struct SeriesLogRecord {
+  int64_t ms;
+  uint32_t device;
+  int16_t value;
+  uint16_t magic;          // SERIES_LOG_MAGIC; anything else is a torn tail
+};
+static_assert(sizeof(SeriesLogRecord) == 16, "SeriesLogRecord is an on-disk record");
+
+// Aggregate of a query bucket
+struct SeriesRollup {
+  int64_t sum = 0;
+  uint32_t count = 0;
+  uint32_t valid = 0;
+  int16_t min = INT16_MAX;
+  int16_t max = INT16_MIN;
+
+  void add(int16_t value) {
+    count++;
+    if (value == SAMPLE_FAULT) return;
+    valid++;
+    sum += value;
+    if (value < min) min = value;
+    if (value > max) max = value;
+  }
+
+  void add(const SeriesMinute& m) {
+    count += m.count;
+    if (m.valid == 0) return;
+    valid += m.valid;
+    sum += m.sum;
+    if (m.min < min) min = m.min;
+    if (m.max > max) max = m.max;
+  }
+
+  void merge(const SeriesRollup& r) {
+    count += r.count;
+    valid += r.valid;
+    sum += r.sum;
+    if (r.min < min) min = r.min;
+    if (r.max > max) max = r.max;
+  }
+
+  double mean() const { return valid > 0 ? sum / 4.0 / valid : 0; }  // °C
+};
+
+// Appends varint bytes to a column being built
+class ByteSink {
+private:
+  std::vector<uint8_t>& _bytes;
+
+public:
+  explicit ByteSink(std::vector<uint8_t>& bytes) : _bytes(bytes) {}
+  void put(uint8_t b) { _bytes.push_back(b); }
+};
+
+inline int64_t seriesFloor(int64_t ms, int64_t step) {
+  int64_t q = ms / step;
+  return (q - (ms % step < 0)) * step;
+}
+
+inline std::string seriesSegmentPath(const std::string& deviceDir, uint32_t segment, const char* column) {
+  char name[32];
+  snprintf(name, sizeof(name), "/%06u.%s", segment, column);
+  return deviceDir + name;
+}
+
+// Decode one block's columns into ms[] and values[] (room for block.count)
+// Scalar reference decoder; false if the bytes do not hold block.count samples.
+inline bool decodeSeriesBlock(const SeriesBlock& block, const uint8_t* time, const uint8_t* temp, int64_t* ms,
+                              int16_t* values) {
+  const uint8_t* t = time + block.timeOffset;
+  const uint8_t* tEnd = t + block.timeBytes;
+  const uint8_t* v = temp + block.tempOffset;
+  const uint8_t* vEnd = v + block.tempBytes;
+  uint64_t dt, dv;
+  if (block.count == 0 || !getVarint(t, tEnd, dt) || !getVarint(v, vEnd, dv)) return false;
+  int64_t prevMs = (int64_t)dt;
+  int32_t prevValue = zigzagDecode((uint32_t)dv);
+  ms[0] = prevMs;
+  values[0] = (int16_t)prevValue;
+  for (uint32_t i = 1; i < block.count; i++) {
+    if (!getVarint(t, tEnd, dt) || !getVarint(v, vEnd, dv)) return false;
+    prevMs += (int64_t)dt;
+    prevValue += zigzagDecode((uint32_t)dv);
+    ms[i] = prevMs;
+    values[i] = (int16_t)prevValue;
+  }
+  return t == tEnd && v == vEnd;
+}
+
+#endif // SERIES_FORMAT_H
@@ -0,0 +1,245 @@
+#ifndef SERIES_READER_H
+#define SERIES_READER_H
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "ColumnKernels.h"
+#include "SeriesFormat.h"
+
+// One segment file mapped read-only; empty if the file does not exist
+class SeriesFile {
+private:
+  const uint8_t* _data = NULL;
+  size_t _size = 0;
+
+public:
+  SeriesFile() {}
+  SeriesFile(const SeriesFile&) = delete;
+  SeriesFile& operator=(const SeriesFile&) = delete;
+  SeriesFile(SeriesFile&& o) : _data(o._data), _size(o._size) { o._data = NULL; o._size = 0; }
+  ~SeriesFile() {
+    if (_data != NULL) munmap((void*)_data, _size);
+  }
+
+  bool map(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return errno == ENOENT;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    if (ok && st.st_size > 0) {
+      void* p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      ok = p != MAP_FAILED;
+      if (ok) {
+        _data = (const uint8_t*)p;
+        _size = st.st_size;
+      }
+    }
+    ::close(fd);
+    return ok;
+  }
+
+  const uint8_t* data() const { return _data; }
+  size_t size() const { return _size; }
+};
+
+// Reading side of the time-series store (layout in SeriesFormat.h)
+// open() maps every segment of every device. Queries read the index and rollup
+// records in place and decode the columns straight out of the mappings, so
+// nothing is copied and the page cache is the only cache. What a reader sees is
+// fixed at open(): the blocks sealed by then. Sealed bytes never change, so any
+// number of threads may query one reader, and a gateway may keep writing.
+// Blocks are decoded and rolled up with the vector kernels (ColumnKernels.h).
+class SeriesReader {
+public:
+  struct Segment {
+    SeriesFile time;
+    SeriesFile temp;
+    SeriesFile index;
+    SeriesFile minute;
+    const SeriesBlock* blocks = NULL;
+    uint32_t blockCount = 0;
+    const SeriesMinute* minutes = NULL;
+    uint32_t minuteCount = 0;
+  };
+
+  struct Device {
+    std::string name;
+    std::vector<Segment> segments;
+    uint64_t samples = 0;
+    int64_t firstMs = INT64_MAX;
+    int64_t lastMs = INT64_MIN;
+  };
+
+private:
+  std::vector<Device> _devices;
+  uint64_t _mapped = 0;
+  std::string _error;
+
+  bool fail(const std::string& what) {
+    _error = what + ": " + strerror(errno);
+    return false;
+  }
+
+  // Keep the blocks whose bytes are all in the mappings
+  static void trim(Segment& g) {
+    const SeriesIndexHeader* header = (const SeriesIndexHeader*)g.index.data();
+    if (g.index.size() < sizeof(SeriesIndexHeader) || header->magic != SERIES_INDEX_MAGIC ||
+        header->version != SERIES_INDEX_VERSION) {
+      return;
+    }
+    g.blocks = (const SeriesBlock*)(g.index.data() + sizeof(SeriesIndexHeader));
+    uint32_t n = (uint32_t)((g.index.size() - sizeof(SeriesIndexHeader)) / sizeof(SeriesBlock));
+    while (n > 0) {
+      const SeriesBlock& b = g.blocks[n - 1];
+      if ((size_t)b.timeOffset + b.timeBytes <= g.time.size() && (size_t)b.tempOffset + b.tempBytes <= g.temp.size() &&
+          ((size_t)b.minuteOffset + b.minutes) * sizeof(SeriesMinute) <= g.minute.size()) {
+        break;
+      }
+      n--;
+    }
+    g.blockCount = n;
+    g.minutes = (const SeriesMinute*)g.minute.data();
+    g.minuteCount = n > 0 ? g.blocks[n - 1].minuteOffset + g.blocks[n - 1].minutes : 0;
+  }
+
+  bool mapDevice(const std::string& dir, Device& d) {
+    std::vector<unsigned> numbers;
+    if (DIR* h = opendir(dir.c_str())) {
+      while (struct dirent* e = readdir(h)) {
+        unsigned segment;
+        char tail[8];
+        if (sscanf(e->d_name, "%u.%7s", &segment, tail) == 2 && !strcmp(tail, "index")) numbers.push_back(segment);
+      }
+      closedir(h);
+    }
+    std::sort(numbers.begin(), numbers.end());
+    for (unsigned n : numbers) {
+      d.segments.emplace_back();
+      Segment& g = d.segments.back();
+      // Index first: the columns are at least as long as the entries it holds
+      if (!g.index.map(seriesSegmentPath(dir, n, "index")) || !g.time.map(seriesSegmentPath(dir, n, "time")) ||
+          !g.temp.map(seriesSegmentPath(dir, n, "temp")) || !g.minute.map(seriesSegmentPath(dir, n, "minute"))) {
+        return fail(dir);
+      }
+      trim(g);
+      _mapped += g.index.size() + g.time.size() + g.temp.size() + g.minute.size();
+      for (uint32_t i = 0; i < g.blockCount; i++) d.samples += g.blocks[i].count;
+      if (g.blockCount > 0) {
+        d.firstMs = std::min(d.firstMs, g.blocks[0].firstMs);
+        d.lastMs = std::max(d.lastMs, g.blocks[g.blockCount - 1].lastMs);
+      }
+    }
+    return true;
+  }
+
+public:
+  bool open(const std::string& dir) {
+    _devices.clear();
+    _mapped = 0;
+    FILE* f = fopen((dir + "/devices").c_str(), "r");
+    if (f == NULL) return fail(dir + "/devices");
+    char line[256];
+    while (fgets(line, sizeof(line), f) != NULL) {
+      line[strcspn(line, "\n")] = '\0';
+      if (line[0] == '\0') break;
+      _devices.emplace_back();
+      _devices.back().name = line;
+    }
+    fclose(f);
+    for (Device& d : _devices) {
+      if (!mapDevice(dir + "/series/" + d.name, d)) return false;
+    }
+    return true;
+  }
+
+  uint32_t size() const { return (uint32_t)_devices.size(); }
+  const Device& device(uint32_t i) const { return _devices[i]; }
+  uint64_t mappedBytes() const { return _mapped; }
+  const std::string& error() const { return _error; }
+
+  int32_t find(const char* name) const {
+    for (size_t i = 0; i < _devices.size(); i++) {
+      if (_devices[i].name == name) return (int32_t)i;
+    }
+    return -1;
+  }
+
+  // Call visit(ms, values, n) with the samples of a device with from <= ms < to,
+  // a block's worth at a time in time order within a segment; returns how many
+  // there were
+  template <class Visit>
+  uint64_t scanBlocks(uint32_t device, int64_t from, int64_t to, Visit&& visit) const {
+    int64_t ms[SERIES_BLOCK_SAMPLES];
+    int16_t values[SERIES_BLOCK_SAMPLES];
+    uint64_t visited = 0;
+    for (const Segment& g : _devices[device].segments) {
+      const SeriesBlock* end = g.blocks + g.blockCount;
+      const SeriesBlock* b =
+          std::partition_point(g.blocks, end, [from](const SeriesBlock& x) { return x.lastMs < from; });
+      for (; b < end && b->firstMs < to; b++) {
+        if (!decodeSeriesBlockFast(*b, g.time.data(), g.temp.data(), ms, values)) continue;
+        uint32_t i = 0;
+        uint32_t n = b->count;
+        if (b->firstMs < from) i = (uint32_t)(std::lower_bound(ms, ms + n, from) - ms);
+        if (b->lastMs >= to) n = (uint32_t)(std::lower_bound(ms, ms + n, to) - ms);
+        if (n > i) {
+          visited += n - i;
+          visit(ms + i, values + i, n - i);
+        }
+      }
+    }
+    return visited;
+  }
+
+  // Call visit(ms, value) for each sample of a device with from <= ms < to, oldest
+  // first within a segment; returns how many there were
+  template <class Visit>
+  uint64_t scan(uint32_t device, int64_t from, int64_t to, Visit&& visit) const {
+    return scanBlocks(device, from, to, [&](const int64_t* ms, const int16_t* values, uint32_t n) {
+      for (uint32_t i = 0; i < n; i++) visit(ms[i], values[i]);
+    });
+  }
+
+  // Add a device's samples with from <= ms < to into buckets[(ms - from) / bucketMs]
+  // Whole minutes come from the rollup records when buckets are whole minutes that
+  // start on a minute; the rest is decoded from the columns.
+  void rollup(uint32_t device, int64_t from, int64_t to, int64_t bucketMs, SeriesRollup* buckets,
+              bool minutes = true) const {
+    int64_t rawFrom = from;
+    if (minutes && bucketMs % SERIES_MINUTE_MS == 0 && seriesFloor(from, SERIES_MINUTE_MS) == from) {
+      rawFrom = std::max(from, seriesFloor(to, SERIES_MINUTE_MS));
+      for (const Segment& g : _devices[device].segments) {
+        const SeriesMinute* end = g.minutes + g.minuteCount;
+        const SeriesMinute* m =
+            std::partition_point(g.minutes, end, [from](const SeriesMinute& x) { return x.startMs < from; });
+        for (; m < end && m->startMs < rawFrom; m++) buckets[(m->startMs - from) / bucketMs].add(*m);
+      }
+    }
+    if (rawFrom < to) {
+      // A bucket's run of samples within a block goes through the kernel at once
+      const ColumnKernels& k = columnKernels();
+      scanBlocks(device, rawFrom, to, [&](const int64_t* ms, const int16_t* values, uint32_t n) {
+        uint32_t i = 0;
+        while (i < n) {
+          int64_t bucket = (ms[i] - from) / bucketMs;
+          int64_t bucketEnd = from + (bucket + 1) * bucketMs;
+          uint32_t j = ms[n - 1] < bucketEnd ? n : (uint32_t)(std::lower_bound(ms + i, ms + n, bucketEnd) - ms);
+          k.rollup(values + i, j - i, buckets[bucket]);
+          i = j;
+        }
+      });
+    }
+  }
+};
+
+#endif // SERIES_READER_H
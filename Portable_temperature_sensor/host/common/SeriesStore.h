@@ -0,0 +1,462 @@
+#ifndef SERIES_STORE_H
+#define SERIES_STORE_H
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "DeviceRegistry.h"
+#include "SeriesFormat.h"
+
+// Writing side of the time-series store (layout in SeriesFormat.h)
+// Each device has an open block in memory that is sealed into its segment files
+// once it holds SERIES_BLOCK_SAMPLES samples. Until then its samples live in the
+// write-ahead log, one fixed-size record each, which commit() hands to the kernel
+// with a single write. That is all a caller needs before acknowledging samples.
+// checkpoint() seals every open block, even short ones, and starts a new log;
+// readers see a device's latest samples once its block has been sealed.
+// open() puts things back together after a crash: torn segment tails are cut off
+// at the last index entry and the log is replayed, skipping samples that made it
+// into a sealed block (each index entry records the log position it covers).
+// With log = false nothing is logged, for bulk loads that can simply be rerun.
+// Single-threaded; calls return false on an I/O error, described by error().
+class SeriesStore {
+public:
+  struct Counters {
+    uint64_t samples = 0;
+    uint64_t clamped = 0;      // Stepped back by up to SERIES_CLAMP_MS; stored at the previous time
+    uint64_t rejected = 0;     // Before 1970
+    uint64_t replayed = 0;     // Recovered from the log by open()
+    uint64_t blocks = 0;
+    uint64_t segments = 0;     // Started by a step back in time or a full segment
+    uint64_t checkpoints = 0;
+    uint64_t logBytes = 0;
+    uint64_t columnBytes = 0;  // Time and temperature columns
+  };
+
+private:
+  struct Series {
+    std::string dir;
+    uint32_t segment = 0;
+    uint32_t blocks = 0;         // Sealed in this segment
+    uint32_t timeEnd = 0;        // Bytes in .time and .temp, records in .minute
+    uint32_t tempEnd = 0;
+    uint32_t minuteEnd = 0;
+    uint64_t sealedPosition = 0;
+    int64_t lastMs = INT64_MIN;  // Newest sample, sealed or not
+    bool rotate = false;         // Seal the next block into a new segment
+
+    // Open block
+    uint32_t count = 0;
+    int64_t firstMs = 0;
+    int16_t lastValue = 0;
+    int16_t min = INT16_MAX;
+    int16_t max = INT16_MIN;
+    uint64_t position = 0;       // Log position past its newest sample
+    std::vector<uint8_t> time;
+    std::vector<uint8_t> temp;
+    std::vector<SeriesMinute> minutes;
+  };
+
+  std::string _dir;
+  DeviceRegistry _registry;
+  std::vector<Series> _series;
+  int _devicesFd = -1;
+  bool _log = true;
+  int _logFd = -1;
+  uint64_t _logStart = 0;        // Position of the current log file's first byte
+  uint64_t _position = 0;        // Position of the next log record
+  std::vector<SeriesLogRecord> _pending;
+  Counters _counters;
+  std::string _error;
+
+  bool fail(const std::string& what) {
+    _error = what + ": " + strerror(errno);
+    return false;
+  }
+
+  static bool writeAt(int fd, const void* data, size_t length, off_t offset) {
+    const uint8_t* p = (const uint8_t*)data;
+    while (length > 0) {
+      ssize_t n = pwrite(fd, p, length, offset);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return false;
+      p += n;
+      length -= n;
+      offset += n;
+    }
+    return true;
+  }
+
+  bool writeFile(const std::string& path, const void* data, size_t length, off_t offset) {
+    if (length == 0) return true;
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return fail(path);
+    bool ok = writeAt(fd, data, length, offset);
+    if (!ok) fail(path);
+    ::close(fd);
+    return ok;
+  }
+
+  std::string logPath(uint64_t start) const {
+    char name[40];
+    snprintf(name, sizeof(name), "/log/%020llu.wal", (unsigned long long)start);
+    return _dir + name;
+  }
+
+  // Start positions of the log files, oldest first
+  std::vector<uint64_t> logFiles() const {
+    std::vector<uint64_t> starts;
+    DIR* d = opendir((_dir + "/log").c_str());
+    if (d == NULL) return starts;
+    while (struct dirent* e = readdir(d)) {
+      unsigned long long start;
+      char tail[8];
+      if (sscanf(e->d_name, "%llu.%7s", &start, tail) == 2 && !strcmp(tail, "wal")) starts.push_back(start);
+    }
+    closedir(d);
+    std::sort(starts.begin(), starts.end());
+    return starts;
+  }
+
+  Series& addSeries(const char* id) {
+    _series.emplace_back();
+    Series& s = _series.back();
+    s.dir = _dir + "/series/" + id;
+    return s;
+  }
+
+  // Pick up a device's newest segment where it left off, cutting torn tails
+  bool recover(Series& s) {
+    DIR* d = opendir(s.dir.c_str());
+    if (d == NULL) return errno == ENOENT || fail(s.dir);
+    bool found = false;
+    while (struct dirent* e = readdir(d)) {
+      unsigned segment;
+      char tail[8];
+      if (sscanf(e->d_name, "%u.%7s", &segment, tail) == 2 && !strcmp(tail, "index")) {
+        if (!found || segment > s.segment) s.segment = segment;
+        found = true;
+      }
+    }
+    closedir(d);
+    if (!found) return true;
+
+    std::string indexPath = seriesSegmentPath(s.dir, s.segment, "index");
+    int fd = ::open(indexPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return fail(indexPath);
+    struct stat st;
+    SeriesBlock last;
+    s.blocks = 0;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)(sizeof(SeriesIndexHeader) + sizeof(SeriesBlock))) {
+      s.blocks = (uint32_t)((st.st_size - sizeof(SeriesIndexHeader)) / sizeof(SeriesBlock));
+      off_t at = sizeof(SeriesIndexHeader) + (off_t)(s.blocks - 1) * sizeof(SeriesBlock);
+      if (pread(fd, &last, sizeof(last), at) != (ssize_t)sizeof(last)) s.blocks = 0;
+    }
+    ::close(fd);
+    if (s.blocks > 0) {
+      s.timeEnd = last.timeOffset + last.timeBytes;
+      s.tempEnd = last.tempOffset + last.tempBytes;
+      s.minuteEnd = last.minuteOffset + last.minutes;
+      s.lastMs = last.lastMs;
+      s.sealedPosition = last.logPosition;
+    }
+    struct {
+      const char* column;
+      off_t end;
+    } ends[] = {
+      { "index", s.blocks > 0 ? (off_t)(sizeof(SeriesIndexHeader) + (size_t)s.blocks * sizeof(SeriesBlock)) : 0 },
+      { "time", s.timeEnd },
+      { "temp", s.tempEnd },
+      { "minute", (off_t)s.minuteEnd * (off_t)sizeof(SeriesMinute) },
+    };
+    for (const auto& e : ends) {
+      std::string path = seriesSegmentPath(s.dir, s.segment, e.column);
+      if (truncate(path.c_str(), e.end) != 0 && errno != ENOENT) return fail(path);
+    }
+    return true;
+  }
+
+  bool writeLog() {
+    if (_pending.empty()) return true;
+    size_t length = _pending.size() * sizeof(SeriesLogRecord);
+    const uint8_t* p = (const uint8_t*)_pending.data();
+    while (length > 0) {
+      ssize_t n = write(_logFd, p, length);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return fail(logPath(_logStart));
+      p += n;
+      length -= n;
+      _counters.logBytes += n;
+    }
+    _pending.clear();
+    return true;
+  }
+
+  // Write the open block to the segment files; the log must already hold its samples
+  bool seal(Series& s) {
+    if (s.count == 0) return true;
+    if (!writeLog()) return false;
+    if ((s.rotate || s.blocks >= SERIES_SEGMENT_BLOCKS) && s.blocks > 0) {
+      s.segment++;
+      s.blocks = 0;
+      s.timeEnd = s.tempEnd = s.minuteEnd = 0;
+      _counters.segments++;
+    }
+    s.rotate = false;
+
+    SeriesBlock b;
+    b.firstMs = s.firstMs;
+    b.lastMs = s.lastMs;
+    b.logPosition = s.position;
+    b.timeOffset = s.timeEnd;
+    b.tempOffset = s.tempEnd;
+    b.minuteOffset = s.minuteEnd;
+    b.count = (uint16_t)s.count;
+    b.timeBytes = (uint16_t)s.time.size();
+    b.tempBytes = (uint16_t)s.temp.size();
+    b.minutes = (uint16_t)s.minutes.size();
+    b.min = s.min <= s.max ? s.min : SAMPLE_FAULT;
+    b.max = s.min <= s.max ? s.max : SAMPLE_FAULT;
+
+    if (s.blocks == 0 && mkdir(s.dir.c_str(), 0755) != 0 && errno != EEXIST) return fail(s.dir);
+    SeriesIndexHeader header = { SERIES_INDEX_MAGIC, SERIES_INDEX_VERSION };
+    std::string index = seriesSegmentPath(s.dir, s.segment, "index");
+    if (!writeFile(seriesSegmentPath(s.dir, s.segment, "time"), s.time.data(), s.time.size(), s.timeEnd) ||
+        !writeFile(seriesSegmentPath(s.dir, s.segment, "temp"), s.temp.data(), s.temp.size(), s.tempEnd) ||
+        !writeFile(seriesSegmentPath(s.dir, s.segment, "minute"), s.minutes.data(),
+                   s.minutes.size() * sizeof(SeriesMinute), (off_t)s.minuteEnd * sizeof(SeriesMinute)) ||
+        (s.blocks == 0 && !writeFile(index, &header, sizeof(header), 0)) ||
+        !writeFile(index, &b, sizeof(b), sizeof(header) + (off_t)s.blocks * sizeof(SeriesBlock))) {
+      return false;
+    }
+
+    s.timeEnd += b.timeBytes;
+    s.tempEnd += b.tempBytes;
+    s.minuteEnd += b.minutes;
+    s.blocks++;
+    s.sealedPosition = s.position;
+    _counters.blocks++;
+    _counters.columnBytes += b.timeBytes + b.tempBytes;
+
+    s.count = 0;
+    s.min = INT16_MAX;
+    s.max = INT16_MIN;
+    s.time.clear();
+    s.temp.clear();
+    s.minutes.clear();
+    return true;
+  }
+
+  // Add a sample to its device's open block; `position` is the log position past it
+  bool add(Series& s, int64_t ms, int16_t value, uint64_t position) {
+    if (ms < 0) {
+      _counters.rejected++;
+      return true;
+    }
+    if (ms < s.lastMs) {
+      if (s.lastMs - ms <= SERIES_CLAMP_MS) {
+        ms = s.lastMs;  // Arrival-time estimates jitter by about this much
+        _counters.clamped++;
+      } else {
+        if (!seal(s)) return false;  // A clock correction: time restarts in a new segment
+        s.rotate = true;
+      }
+    }
+
+    ByteSink time(s.time);
+    ByteSink temp(s.temp);
+    if (s.count == 0) {
+      s.firstMs = ms;
+      putVarint(time, (uint64_t)ms);
+      putVarint(temp, zigzagEncode(value));
+    } else {
+      putVarint(time, (uint64_t)(ms - s.lastMs));
+      putVarint(temp, zigzagEncode((int32_t)value - s.lastValue));
+    }
+
+    int64_t minute = seriesFloor(ms, SERIES_MINUTE_MS);
+    if (s.minutes.empty() || s.minutes.back().startMs != minute) {
+      SeriesMinute m = { minute, 0, 0, 0, INT16_MAX, INT16_MIN, 0 };
+      s.minutes.push_back(m);
+    }
+    SeriesMinute& m = s.minutes.back();
+    m.count++;
+    if (value != SAMPLE_FAULT) {
+      m.valid++;
+      m.sum += value;
+      if (value < m.min) m.min = value;
+      if (value > m.max) m.max = value;
+      if (value < s.min) s.min = value;
+      if (value > s.max) s.max = value;
+    }
+
+    s.count++;
+    s.lastMs = ms;
+    s.lastValue = value;
+    s.position = position;
+    _counters.samples++;
+    return s.count < SERIES_BLOCK_SAMPLES || seal(s);
+  }
+
+  // Re-add the samples of a log file that never reached a sealed block
+  bool replay(uint64_t start, uint64_t& validBytes) {
+    std::string path = logPath(start);
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return fail(path);
+    std::vector<SeriesLogRecord> records(4096);
+    validBytes = 0;
+    bool torn = false;
+    while (!torn) {
+      ssize_t n = read(fd, records.data(), records.size() * sizeof(SeriesLogRecord));
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) break;
+      size_t whole = n / sizeof(SeriesLogRecord);
+      for (size_t i = 0; i < whole; i++) {
+        const SeriesLogRecord& r = records[i];
+        if (r.magic != SERIES_LOG_MAGIC || r.device >= _series.size()) {
+          torn = true;
+          break;
+        }
+        validBytes += sizeof(SeriesLogRecord);
+        uint64_t end = start + validBytes;
+        Series& s = _series[r.device];
+        if (end <= s.sealedPosition) continue;
+        _counters.replayed++;
+        if (!add(s, r.ms, r.value, end)) {
+          ::close(fd);
+          return false;
+        }
+      }
+      if (whole * sizeof(SeriesLogRecord) != (size_t)n) torn = true;  // Partial record at the end
+    }
+    ::close(fd);
+    return true;
+  }
+
+  bool openLog(uint64_t start, bool create) {
+    std::string path = logPath(start);
+    _logFd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC | (create ? O_CREAT | O_EXCL : 0), 0644);
+    if (_logFd < 0) return fail(path);
+    _logStart = start;
+    return true;
+  }
+
+public:
+  explicit SeriesStore(uint32_t maxDevices = 65536) : _registry(maxDevices) {}
+  ~SeriesStore() { close(); }
+
+  bool open(const std::string& dir, bool log = true) {
+    _dir = dir;
+    _log = log;
+    const char* dirs[] = { "", "/series", "/log" };
+    for (const char* sub : dirs) {
+      if (mkdir((dir + sub).c_str(), 0755) != 0 && errno != EEXIST) return fail(dir + sub);
+    }
+
+    std::string devicesPath = dir + "/devices";
+    if (FILE* f = fopen(devicesPath.c_str(), "r")) {
+      char line[MQTT_ID_LEN + 2];
+      while (fgets(line, sizeof(line), f) != NULL) {
+        size_t length = strcspn(line, "\n");
+        line[length] = '\0';
+        if (length == 0 || _registry.find(line, length) != (int32_t)_series.size()) break;
+        if (!recover(addSeries(line))) {
+          fclose(f);
+          return false;
+        }
+      }
+      fclose(f);
+    }
+    _devicesFd = ::open(devicesPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (_devicesFd < 0) return fail(devicesPath);
+
+    for (const Series& s : _series) _position = std::max(_position, s.sealedPosition);
+    std::vector<uint64_t> logs = logFiles();
+    uint64_t validBytes = 0;
+    for (uint64_t start : logs) {
+      if (!replay(start, validBytes)) return false;
+    }
+    if (!log) return true;
+    if (logs.empty()) return openLog(_position, true);
+    // Carry on in the newest file, past its last whole record
+    _position = logs.back() + validBytes;
+    if (truncate(logPath(logs.back()).c_str(), validBytes) != 0) return fail(logPath(logs.back()));
+    return openLog(logs.back(), false);
+  }
+
+  // Store index of a device, adding it if new; -1 if the ID cannot be a directory name
+  // or the store is full
+  int32_t device(const char* id, size_t length) {
+    if (length == 0 || id[0] == '.' || memchr(id, '/', length) != NULL) return -1;
+    int32_t index = _registry.find(id, length);
+    if (index < 0 || index < (int32_t)_series.size()) return index;
+    addSeries(_registry.name(index));
+    char line[MQTT_ID_LEN + 1];
+    memcpy(line, id, length);
+    line[length] = '\n';
+    if (write(_devicesFd, line, length + 1) != (ssize_t)(length + 1)) {
+      fail(_dir + "/devices");
+      return -1;
+    }
+    return index;
+  }
+
+  bool append(uint32_t device, int64_t ms, int16_t value) {
+    if (_log) {
+      SeriesLogRecord r = { ms, device, value, SERIES_LOG_MAGIC };
+      _pending.push_back(r);
+      _position += sizeof(SeriesLogRecord);
+    }
+    return add(_series[device], ms, value, _position);
+  }
+
+  // Hand everything appended so far to the kernel
+  bool commit() {
+    if (!writeLog()) return false;
+    if (_log && _position - _logStart >= SERIES_LOG_LIMIT) return checkpoint();
+    return true;
+  }
+
+  // Seal every open block and drop the log behind them
+  bool checkpoint() {
+    if (!writeLog()) return false;
+    for (Series& s : _series) {
+      if (!seal(s)) return false;
+    }
+    if (_log && _position != _logStart) {
+      ::close(_logFd);
+      if (!openLog(_position, true)) return false;
+    }
+    for (uint64_t start : logFiles()) {
+      if (_log && start == _logStart) continue;
+      if (unlink(logPath(start).c_str()) != 0) return fail(logPath(start));
+    }
+    _counters.checkpoints++;
+    return true;
+  }
+
+  bool close() {
+    if (_devicesFd < 0) return true;
+    bool ok = checkpoint();
+    ::close(_devicesFd);
+    _devicesFd = -1;
+    if (_logFd >= 0) ::close(_logFd);
+    _logFd = -1;
+    return ok;
+  }
+
+  uint32_t size() const { return (uint32_t)_series.size(); }
+  const char* name(uint32_t device) const { return _registry.name(device); }
+  const Counters& counters() const { return _counters; }
+  const std::string& error() const { return _error; }
+};
+
+#endif // SERIES_STORE_H
@@ -0,0 +1,57 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stddef.h>
+#include <atomic>
+
+#define SPSC_CACHE_LINE 64
+
+// Bounded lock-free queue between exactly one producer and one consumer thread
+// A power-of-two ring with free-running indices: the producer owns _tail, the
+// consumer owns _head, and each keeps a cached copy of the other's index so the
+// shared cache line is only read when the cached value says the ring looks full
+// (or empty). Elements are copied in and out; push and pop never block or allocate.
+template <class T, size_t CAPACITY>
+class SpscQueue {
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+private:
+  alignas(SPSC_CACHE_LINE) std::atomic<size_t> _tail{0};  // Next slot to write, producer
+  size_t _headCache = 0;                                   // Producer's view of _head
+  alignas(SPSC_CACHE_LINE) std::atomic<size_t> _head{0};  // Next slot to read, consumer
+  size_t _tailCache = 0;                                   // Consumer's view of _tail
+  alignas(SPSC_CACHE_LINE) T _slots[CAPACITY];
+
+public:
+  // Producer: copy up to n items in; returns how many fit
+  size_t push(const T* items, size_t n) {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    if (CAPACITY - (tail - _headCache) < n) _headCache = _head.load(std::memory_order_acquire);
+    size_t room = CAPACITY - (tail - _headCache);
+    if (n > room) n = room;
+    for (size_t i = 0; i < n; i++) _slots[(tail + i) & (CAPACITY - 1)] = items[i];
+    _tail.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  bool push(const T& item) { return push(&item, 1) == 1; }
+
+  // Consumer: copy up to max items out; returns how many there were
+  size_t pop(T* out, size_t max) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    if (_tailCache - head < max) _tailCache = _tail.load(std::memory_order_acquire);
+    size_t n = _tailCache - head;
+    if (n > max) n = max;
+    for (size_t i = 0; i < n; i++) out[i] = _slots[(head + i) & (CAPACITY - 1)];
+    _head.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  // Either side, approximate while the other is running
+  size_t size() const {
+    return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+  }
+  size_t capacity() const { return CAPACITY; }
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,192 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define POOL_DEQUE 256  // Tasks a worker can hold; a full deque runs ranges without splitting
+#define POOL_SPIN 256   // Yields an idle worker waits for the next loop before it sleeps
+
+// Fixed set of threads running parallel loops by work stealing
+// parallelFor() hands the whole range to the calling thread, which takes part as
+// worker 0. A worker that picks up a range larger than the grain splits it in
+// two, keeps the left half and pushes the right half onto the back of its own
+// deque, so a range breaks up only as far as there are idle threads to take the
+// pieces. Workers pop their own deque from the back (the newest, smallest and
+// cache-warm piece) and idle ones steal from the front of another's (the oldest,
+// largest piece), which keeps the number of steals low. Each deque has its own
+// lock and is only contended by a thief. Between loops the workers spin for a
+// moment, since loops tend to come in bursts, then sleep.
+// One thread at a time may call parallelFor().
+class WorkStealingPool {
+public:
+  typedef void (*TaskFn)(void* ctx, uint32_t begin, uint32_t end);
+
+private:
+  struct Task {
+    TaskFn fn;
+    void* ctx;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t grain;
+  };
+
+  struct alignas(64) Worker {
+    std::mutex lock;
+    Task tasks[POOL_DEQUE];
+    uint32_t head = 0;  // Oldest, stolen from here
+    uint32_t size = 0;
+    uint64_t executed = 0;
+    uint64_t stolen = 0;
+  };
+
+  std::vector<Worker> _workers;
+  std::vector<std::thread> _threads;
+  std::atomic<uint32_t> _pending{0};   // Tasks pushed or running, not finished
+  std::atomic<bool> _stop{false};
+  std::mutex _sleepLock;
+  std::condition_variable _wake;
+  uint32_t _generation = 0;            // Bumped per parallelFor, under _sleepLock
+
+  bool push(Worker& w, const Task& t) {
+    std::lock_guard<std::mutex> lock(w.lock);
+    if (w.size == POOL_DEQUE) return false;
+    w.tasks[(w.head + w.size++) % POOL_DEQUE] = t;
+    return true;
+  }
+
+  bool popBack(Worker& w, Task& t) {
+    std::lock_guard<std::mutex> lock(w.lock);
+    if (w.size == 0) return false;
+    t = w.tasks[(w.head + --w.size) % POOL_DEQUE];
+    return true;
+  }
+
+  bool popFront(Worker& w, Task& t) {
+    std::lock_guard<std::mutex> lock(w.lock);
+    if (w.size == 0) return false;
+    t = w.tasks[w.head];
+    w.head = (w.head + 1) % POOL_DEQUE;
+    w.size--;
+    return true;
+  }
+
+  // Own deque first, then the others starting from a neighbour
+  bool find(uint32_t self, Task& t) {
+    if (popBack(_workers[self], t)) return true;
+    uint32_t n = (uint32_t)_workers.size();
+    for (uint32_t i = 1; i < n; i++) {
+      if (popFront(_workers[(self + i) % n], t)) {
+        _workers[self].stolen++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run(uint32_t self, Task t) {
+    Worker& w = _workers[self];
+    while (t.end - t.begin > t.grain) {
+      uint32_t mid = t.begin + (t.end - t.begin) / 2;
+      Task right = t;
+      right.begin = mid;
+      _pending.fetch_add(1, std::memory_order_relaxed);
+      if (!push(w, right)) {
+        _pending.fetch_sub(1, std::memory_order_relaxed);
+        break;
+      }
+      t.end = mid;
+    }
+    t.fn(t.ctx, t.begin, t.end);
+    w.executed++;
+    _pending.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  void workerLoop(uint32_t self) {
+    uint32_t seen = 0;
+    uint32_t spins = 0;
+    for (;;) {
+      Task t;
+      if (find(self, t)) {
+        run(self, t);
+        spins = 0;
+        continue;
+      }
+      // Work running elsewhere may still split
+      if (_pending.load(std::memory_order_acquire) > 0 || ++spins < POOL_SPIN) {
+        std::this_thread::yield();
+        continue;
+      }
+      spins = 0;
+      std::unique_lock<std::mutex> lock(_sleepLock);
+      _wake.wait(lock, [&] { return _stop.load() || _generation != seen; });
+      if (_stop.load()) return;
+      seen = _generation;
+    }
+  }
+
+public:
+  // threads counts the caller; 0 means one per hardware thread
+  explicit WorkStealingPool(unsigned threads = 0) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    _workers = std::vector<Worker>(threads);
+    for (unsigned i = 1; i < threads; i++) _threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+  }
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(_sleepLock);
+      _stop = true;
+    }
+    _wake.notify_all();
+    for (std::thread& t : _threads) t.join();
+  }
+
+  // Call fn(ctx, begin, end) over [0, n) in pieces of at most grain; returns when all have run
+  void parallelFor(uint32_t n, uint32_t grain, TaskFn fn, void* ctx) {
+    if (n == 0) return;
+    Task t = { fn, ctx, 0, n, grain > 0 ? grain : 1 };
+    if (_threads.empty() || n <= t.grain) {
+      fn(ctx, 0, n);
+      _workers[0].executed++;
+      return;
+    }
+    _pending.fetch_add(1, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(_sleepLock);
+      _generation++;
+    }
+    _wake.notify_all();
+    run(0, t);
+    while (_pending.load(std::memory_order_acquire) > 0) {
+      if (find(0, t)) run(0, t);
+      else std::this_thread::yield();
+    }
+  }
+
+  template <class F>
+  void parallelFor(uint32_t n, uint32_t grain, F& f) {
+    parallelFor(n, grain, [](void* ctx, uint32_t begin, uint32_t end) { (*(F*)ctx)(begin, end); }, &f);
+  }
+
+  unsigned threads() const { return (unsigned)_workers.size(); }
+
+  // Pieces run and pieces stolen, summed over the workers; read between loops
+  uint64_t executed() const {
+    uint64_t n = 0;
+    for (const Worker& w : _workers) n += w.executed;
+    return n;
+  }
+  uint64_t stolen() const {
+    uint64_t n = 0;
+    for (const Worker& w : _workers) n += w.stolen;
+    return n;
+  }
+};
+
+#endif // WORK_STEALING_POOL_H
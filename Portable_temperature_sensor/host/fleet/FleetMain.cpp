@@ -0,0 +1,591 @@
+// Fleet load generator: many virtual sensors against a real MQTT broker
+// Every device runs the firmware's own MQTT path: MqttLink for the session and
+// topics, SampleRing and DeliveryWindow for buffering and acknowledged delivery,
+// and SampleUplink for the text and batch publishes, on top of the non-blocking
+// PubSubClient in host/common. All sockets share one epoll loop, so thousands
+// of devices fit in one process and thread.
+//
+// A probe client stands in for the backend: it subscribes to every device's batch
+// topic, checks the batches with the firmware's decoder, acknowledges them through
+// a BatchTracker per device, and measures the end-to-end latency from the device writing a
+// batch to the probe receiving it. Broker throughput is what goes in (device
+// publishes) and what comes out (probe deliveries), reported once a second.
+//
+// Reconnects follow the firmware by default: after a drop the device waits for the
+// first 10 ms of a 10 s period of its own uptime (networkService() in main.cpp)
+// and retries about every 2 s while that fails. Devices boot at random phases
+// unless --sync-boot lines them up, as after a site-wide power cut; --storm then
+// drops every connection at once to see the broker take the reconnect wave.
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+#include "BatchTracker.h"
+#include "EventLoop.h"
+#include "LatencyHistogram.h"
+#include "MqttLink.h"
+#include "SampleUplink.h"
+
+#define FLEET_RING_CAPACITY 512  // SAMPLE_RING_CAPACITY in main.cpp
+#define FLEET_CHIP_ID_BASE 0x100000
+#define FLEET_SENT_SLOTS 16      // Batches remembered per device for latency, > DELIVERY_WINDOW_MAX
+#define FLEET_SWEEP_US 10000     // Keepalive and link state checks
+#define FLEET_RECONNECT_PERIOD 10000  // ms, the (millis() % 10000) < 10 in main.cpp
+#define FLEET_RECONNECT_SLOT 10
+#define FLEET_RETRY_MS 2000      // mqttReconnect(1) after a failed attempt
+
+typedef SampleRing<FLEET_RING_CAPACITY> FleetRing;
+
+namespace {
+
+const char* USAGE =
+  "usage: fleet [options]\n"
+  "  --host H            broker address (default 127.0.0.1)\n"
+  "  --port P            broker port (default 1883)\n"
+  "  --user U --pass P   broker credentials\n"
+  "  --devices N         virtual devices (default 100)\n"
+  "  --seconds S         run time (default 30)\n"
+  "  --interval MS       sample interval per device (default 1000, sendInterval in main.cpp)\n"
+  "  --batch K           deliver once K samples are waiting (default 1, every sample)\n"
+  "  --window N          delivery window in batches, 0 = no acks (default 4)\n"
+  "  --no-text           skip the text temperature topic\n"
+  "  --ramp S            spread the first connects over S seconds (default 0)\n"
+  "  --policy P          reconnect policy: firmware or immediate (default firmware)\n"
+  "  --sync-boot         all devices share one uptime phase\n"
+  "  --storm S           drop every device connection S seconds into the run\n"
+  "  --clean-session     connect with cleanSession=true\n"
+  "  --report S          seconds between progress lines (default 1)\n";
+
+enum Policy { POLICY_FIRMWARE, POLICY_IMMEDIATE };
+
+struct Settings {
+  const char* host = "127.0.0.1";
+  uint16_t port = 1883;
+  const char* user = NULL;
+  const char* pass = NULL;
+  uint32_t devices = 100;
+  double seconds = 30;
+  uint32_t intervalMs = 1000;
+  uint32_t batch = 1;
+  int window = 4;
+  bool text = true;
+  double ramp = 0;
+  Policy policy = POLICY_FIRMWARE;
+  bool syncBoot = false;
+  double storm = -1;
+  bool cleanSession = false;
+  double report = 1;
+};
+
+// Counters for one report interval and for the whole run
+struct Counters {
+  uint64_t published = 0;    // Device publishes written (text and batch)
+  uint64_t publishBytes = 0;
+  uint64_t received = 0;     // Messages the probe got
+  uint64_t receiveBytes = 0;
+  uint64_t samples = 0;      // New samples at the probe
+  uint64_t duplicates = 0;
+  uint64_t lost = 0;
+  uint64_t connects = 0;     // CONNACKs
+  uint64_t drops = 0;
+  uint64_t failed = 0;       // Attempts that never got a CONNACK
+  LatencyHistogram latency;  // Batch written -> probe, us
+
+  void add(const Counters& c) {
+    published += c.published;
+    publishBytes += c.publishBytes;
+    received += c.received;
+    receiveBytes += c.receiveBytes;
+    samples += c.samples;
+    duplicates += c.duplicates;
+    lost += c.lost;
+    connects += c.connects;
+    drops += c.drops;
+    failed += c.failed;
+    latency.merge(c.latency);
+  }
+};
+
+struct Device {
+  struct Sent {
+    uint32_t first;
+    uint64_t at;  // us, 0 = slot free
+  };
+
+  uint32_t index;
+  PubSubClient client;
+  MqttLink link;
+  FleetRing ring;
+  DeliveryWindow window;
+  SampleUplink<FleetRing> uplink;
+  uint32_t intervalMs;
+  uint64_t bootOffsetMs;     // Uptime at the start of the run
+  uint32_t random;
+  int16_t value = 100;       // 25°C
+  bool up = false;           // Connect attempt made and not dropped since
+  bool established = false;  // CONNACK received since the attempt
+  uint32_t connacks = 0;     // client.connacks() already accounted for
+  uint32_t readies = 0;      // client.readies() already accounted for
+  uint64_t attemptAt = 0;
+  uint32_t acks = 0;
+  Sent sent[FLEET_SENT_SLOTS] = {};
+  BatchTracker tracker;      // Probe side
+
+  Device(EventLoop& loop, uint32_t i, const char* user, const char* pass)
+    : index(i), client(loop), link(client, user, pass), uplink(client, link, ring, window) {}
+};
+
+enum EventKind { EVENT_SAMPLE, EVENT_CONNECT };
+
+struct Event {
+  uint64_t at;
+  uint32_t device;
+  EventKind kind;
+  bool operator>(const Event& other) const { return at > other.at; }
+};
+
+struct Fleet {
+  Settings settings;
+  EventLoop loop;
+  std::vector<std::unique_ptr<Device>> devices;
+  std::unique_ptr<PubSubClient> probe;
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+  Counters interval;
+  Counters total;
+  LatencyHistogram connectLatency;  // connect() -> CONNACK, us
+  LatencyHistogram readyLatency;    // connect() -> SUBACK of the last command subscription, us
+  LatencyHistogram ackRtt;          // DeliveryWindow's write -> ack, us (ms resolution)
+  uint64_t start = 0;
+  uint32_t malformed = 0;
+  uint32_t commands = 0;
+  Sample scratch[SAMPLE_BATCH_MAX];
+};
+
+Fleet* fleet = NULL;
+
+uint32_t xorshift(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+bool endsWith(const char* s, size_t length, const char* suffix) {
+  size_t n = strlen(suffix);
+  return length >= n && memcmp(s + length - n, suffix, n) == 0;
+}
+
+// Device index from "sensor/<id>/...", or -1
+int32_t deviceFromTopic(const char* topic) {
+  static const char root[] = MQTT_TOPIC_ROOT "/";
+  if (strncmp(topic, root, sizeof(root) - 1) != 0) return -1;
+  char* end;
+  unsigned long chipId = strtoul(topic + sizeof(root) - 1, &end, 16);
+  if (*end != '/' || chipId < FLEET_CHIP_ID_BASE) return -1;
+  unsigned long index = chipId - FLEET_CHIP_ID_BASE;
+  return index < fleet->devices.size() ? (int32_t)index : -1;
+}
+
+Device::Sent& sentSlot(Device& d, uint32_t first) {
+  return d.sent[(first ^ (first >> 8)) % FLEET_SENT_SLOTS];
+}
+
+// Samples waiting to be written, not counting ones in flight
+uint32_t unsent(Device& d) {
+  return d.ring.head() - d.window.nextToSend(d.ring.tail());
+}
+
+void deliver(Device& d) {
+  if (d.client.connected() && unsent(d) >= fleet->settings.batch) d.uplink.deliver();
+}
+
+// Every device publish passes here as it is queued
+void onPublish(void* context, const char* topic, const uint8_t* payload, size_t length) {
+  Device& d = *static_cast<Device*>(context);
+  fleet->interval.published++;
+  fleet->interval.publishBytes += length;
+  if (!endsWith(topic, strlen(topic), "batch")) return;
+
+  SampleBatchHeader header;
+  const uint8_t* p = payload;
+  if (!decodeSampleBatchHeader(p, payload + length, header)) return;
+  Device::Sent& slot = sentSlot(d, header.first);
+  slot.first = header.first;
+  slot.at = NativeHal::now();
+}
+
+// Commands reaching a device, handled like mqttCallback() in main.cpp where it matters for load
+void onDeviceMessage(Device& d, char* topic, uint8_t* payload, unsigned int length) {
+  char message[32];
+  size_t n = length < sizeof(message) - 1 ? length : sizeof(message) - 1;
+  memcpy(message, payload, n);
+  message[n] = '\0';
+
+  CommandScope scope;
+  const char* command = d.link.topics().matchCommand(topic, &scope);
+  if (command == NULL) return;
+  if (!strcmp(command, "ack")) {
+    if (scope != SCOPE_DEVICE) return;
+    d.uplink.ack(message);
+    if (d.window.acksReceived() != d.acks) {
+      d.acks = d.window.acksReceived();
+      fleet->ackRtt.record((uint64_t)d.window.lastAckRtt() * 1000);
+    }
+    deliver(d);  // The window has room again
+    return;
+  }
+  fleet->commands++;
+  if (!strcmp(command, "interval")) {
+    unsigned long interval = strtoul(message, NULL, 10);
+    if (interval > 0) d.intervalMs = interval;
+  } else if (!strcmp(command, "group")) {
+    d.link.setGroup(message);
+  }
+}
+
+// The backend's side of a batch: check it, count it, acknowledge it
+void onProbeMessage(char* topic, uint8_t* payload, unsigned int length) {
+  uint64_t now = NativeHal::now();
+  Counters& c = fleet->interval;
+  c.received++;
+  c.receiveBytes += length;
+  if (!endsWith(topic, strlen(topic), "/batch")) return;
+
+  int32_t index = deviceFromTopic(topic);
+  SampleBatchHeader header;
+  const uint8_t* p = payload;
+  if (index < 0 || !decodeSampleBatchHeader(p, payload + length, header) || header.count > SAMPLE_BATCH_MAX ||
+      !decodeSampleBatch(payload, length, header, fleet->scratch, SAMPLE_BATCH_MAX)) {
+    fleet->malformed++;
+    return;
+  }
+  Device& d = *fleet->devices[index];
+
+  Device::Sent& slot = sentSlot(d, header.first);
+  if (slot.at != 0 && slot.first == header.first) {
+    c.latency.record(now - slot.at);
+    slot.at = 0;
+  }
+
+  BatchTracker::Result r = d.tracker.receive(header);
+  c.samples += r.accepted;
+  c.duplicates += r.duplicates;
+  c.lost += r.lost;
+
+  if (fleet->settings.window > 0) {
+    char ackTopic[MQTT_TOPIC_LEN + 8];
+    char ack[SAMPLE_ACK_LEN];
+    snprintf(ackTopic, sizeof(ackTopic), MQTT_TOPIC_ROOT "/%s/set/ack", d.link.topics().getDeviceId());
+    formatSampleAck(ack, sizeof(ack), d.tracker.bootId(), d.tracker.next());
+    fleet->probe->publish(ackTopic, ack);
+  }
+}
+
+uint64_t uptimeMs(const Device& d, uint64_t now) {
+  return d.bootOffsetMs + (now - fleet->start) / 1000;
+}
+
+// When the device's loop would next call mqttReconnect() after a drop
+uint64_t nextReconnect(const Device& d, uint64_t now) {
+  if (fleet->settings.policy == POLICY_IMMEDIATE) return now;
+  uint64_t phase = uptimeMs(d, now) % FLEET_RECONNECT_PERIOD;
+  if (phase < FLEET_RECONNECT_SLOT) return now;
+  return now + (FLEET_RECONNECT_PERIOD - phase) * 1000;
+}
+
+void schedule(uint64_t at, uint32_t device, EventKind kind) {
+  fleet->events.push({ at, device, kind });
+}
+
+// Next attempt after one that got no CONNACK
+uint64_t nextRetry(const Device& d, uint64_t now) {
+  if (fleet->settings.policy == POLICY_IMMEDIATE) return now + 1000000;  // attemptInterval in main.cpp
+  uint64_t at = d.attemptAt + FLEET_RETRY_MS * 1000ULL;
+  return at > now ? at : now;
+}
+
+void attempt(Device& d, uint64_t now) {
+  d.attemptAt = now;
+  d.established = false;
+  if (d.link.connect()) {
+    d.uplink.reconnected();  // Resend whatever was in flight when the link dropped
+    d.up = true;
+    deliver(d);
+  } else {
+    fleet->interval.failed++;
+    schedule(nextRetry(d, now), d.index, EVENT_CONNECT);
+  }
+}
+
+void sample(Device& d, uint64_t now) {
+  // Random walk in 0.25°C steps around the start value
+  uint32_t r = xorshift(d.random);
+  d.value += (int16_t)(r % 3) - 1;
+  d.ring.push(millis(), d.value);
+  if (d.client.connected()) {
+    if (fleet->settings.text) d.uplink.publishLatest();
+    deliver(d);
+  }
+  schedule(now + d.intervalMs * 1000ULL, d.index, EVENT_SAMPLE);
+}
+
+// Keepalive, CONNACKs and drops; a drop schedules the next attempt per policy
+void sweep(uint64_t now) {
+  for (auto& device : fleet->devices) {
+    Device& d = *device;
+    d.client.loop();
+    if (!d.up) continue;
+    if (d.client.connacks() != d.connacks) {
+      d.connacks = d.client.connacks();
+      d.established = true;
+      fleet->connectLatency.record(d.client.connackLatency());
+      fleet->interval.connects++;
+    }
+    if (d.client.readies() != d.readies) {
+      d.readies = d.client.readies();
+      fleet->readyLatency.record(d.client.readyLatency());
+    }
+    if (d.client.connected()) continue;
+
+    d.up = false;
+    if (d.established) {
+      fleet->interval.drops++;
+      schedule(nextReconnect(d, now), d.index, EVENT_CONNECT);
+    } else {
+      fleet->interval.failed++;  // Refused, reset or timed out before the CONNACK
+      schedule(nextRetry(d, now), d.index, EVENT_CONNECT);
+    }
+  }
+}
+
+void storm() {
+  for (auto& d : fleet->devices) d->client.abort();
+}
+
+void printInterval(double t, double seconds) {
+  Counters& c = fleet->interval;
+  uint32_t online = 0;
+  size_t queued = 0;
+  for (auto& d : fleet->devices) {
+    online += d->client.ready();
+    queued += d->client.queued();
+  }
+  printf("%7.1fs %6u up  pub %8.0f/s %7.2f MB/s  recv %8.0f/s  samples %8.0f/s  "
+         "e2e p50 %6.2fms p99 %7.2fms max %7.2fms  conn %llu drop %llu queued %zuB\n",
+         t, online, c.published / seconds, c.publishBytes / seconds / 1e6, c.received / seconds,
+         c.samples / seconds, c.latency.percentile(50) / 1000.0, c.latency.percentile(99) / 1000.0,
+         c.latency.max() / 1000.0, (unsigned long long)c.connects, (unsigned long long)c.drops, queued);
+  fflush(stdout);
+}
+
+void printHistogram(const char* name, const LatencyHistogram& h) {
+  printf("%-16s n=%-9llu p50 %8.2fms  p90 %8.2fms  p99 %8.2fms  p99.9 %8.2fms  max %8.2fms\n", name,
+         (unsigned long long)h.count(), h.percentile(50) / 1000.0, h.percentile(90) / 1000.0,
+         h.percentile(99) / 1000.0, h.percentile(99.9) / 1000.0, h.max() / 1000.0);
+}
+
+void printSummary(double seconds) {
+  const Counters& c = fleet->total;
+  uint32_t dropped = 0;
+  uint32_t retransmits = 0;
+  uint32_t refused = fleet->probe->refused();
+  for (auto& d : fleet->devices) {
+    dropped += d->ring.dropped();
+    retransmits += d->window.retransmits();
+    refused += d->client.refused();
+  }
+  printf("\n%u devices, %.1fs, %u ms interval, batch %u, window %d, %s reconnects\n", fleet->settings.devices,
+         seconds, fleet->settings.intervalMs, fleet->settings.batch, fleet->settings.window,
+         fleet->settings.policy == POLICY_FIRMWARE ? "firmware" : "immediate");
+  printf("published        %llu msgs (%.0f/s), %.2f MB/s\n", (unsigned long long)c.published,
+         c.published / seconds, c.publishBytes / seconds / 1e6);
+  printf("received         %llu msgs (%.0f/s), %.2f MB/s\n", (unsigned long long)c.received,
+         c.received / seconds, c.receiveBytes / seconds / 1e6);
+  printf("samples          %llu delivered (%.0f/s), %llu duplicates, %llu lost, %u dropped on devices\n",
+         (unsigned long long)c.samples, c.samples / seconds, (unsigned long long)c.duplicates,
+         (unsigned long long)c.lost, dropped);
+  printf("connections      %llu connects, %llu drops, %llu failed attempts, %u go-back-N resends\n",
+         (unsigned long long)c.connects, (unsigned long long)c.drops, (unsigned long long)c.failed, retransmits);
+  if (refused > 0 || fleet->malformed > 0) {
+    printf("errors           %u publishes refused (socket backed up), %u malformed batches\n", refused,
+           fleet->malformed);
+  }
+  if (fleet->commands > 0) printf("commands         %u received by devices\n", fleet->commands);
+  printHistogram("end-to-end", c.latency);
+  printHistogram("ack rtt", fleet->ackRtt);
+  printHistogram("connect", fleet->connectLatency);
+  printHistogram("ready", fleet->readyLatency);
+}
+
+// The probe subscribes before any device connects so no batch goes unseen
+bool connectProbe() {
+  PubSubClient& probe = *fleet->probe;
+  return probe.connect("fleet-probe") && probe.subscribe(MQTT_TOPIC_ROOT "/+/batch", 0) &&
+         probe.subscribe(MQTT_TOPIC_ROOT "/+/temperature", 0);
+}
+
+bool raiseFileLimit(uint32_t needed) {
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return false;
+  if (limit.rlim_cur >= needed) return true;
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+  return limit.rlim_cur >= needed;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    bool ok = true;
+    if (!strcmp(arg, "--help")) { fputs(USAGE, stdout); return 0; }
+    else if (!strcmp(arg, "--no-text")) { settings.text = false; continue; }
+    else if (!strcmp(arg, "--sync-boot")) { settings.syncBoot = true; continue; }
+    else if (!strcmp(arg, "--clean-session")) { settings.cleanSession = true; continue; }
+    else if (value == NULL) ok = false;
+    else if (!strcmp(arg, "--host")) { settings.host = value; i++; }
+    else if (!strcmp(arg, "--port")) { settings.port = (uint16_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--user")) { settings.user = value; i++; }
+    else if (!strcmp(arg, "--pass")) { settings.pass = value; i++; }
+    else if (!strcmp(arg, "--devices")) { settings.devices = (uint32_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--seconds")) { settings.seconds = atof(value); i++; }
+    else if (!strcmp(arg, "--interval")) { settings.intervalMs = (uint32_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--batch")) { settings.batch = (uint32_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--window")) { settings.window = atoi(value); i++; }
+    else if (!strcmp(arg, "--ramp")) { settings.ramp = atof(value); i++; }
+    else if (!strcmp(arg, "--storm")) { settings.storm = atof(value); i++; }
+    else if (!strcmp(arg, "--report")) { settings.report = atof(value); i++; }
+    else if (!strcmp(arg, "--policy")) {
+      if (!strcmp(value, "firmware")) settings.policy = POLICY_FIRMWARE;
+      else if (!strcmp(value, "immediate")) settings.policy = POLICY_IMMEDIATE;
+      else ok = false;
+      i++;
+    }
+    else ok = false;
+    if (!ok || settings.devices < 1 || settings.intervalMs < 1 || settings.batch < 1 || settings.window < 0 ||
+        settings.window > DELIVERY_WINDOW_MAX || settings.report <= 0) {
+      fprintf(stderr, "fleet: bad argument '%s'\n%s", arg, USAGE);
+      return 2;
+    }
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+  if (!raiseFileLimit(settings.devices + 16)) {
+    fprintf(stderr, "fleet: open file limit is below %u, some devices will fail to connect\n", settings.devices + 16);
+  }
+  NativeHal::setClockMode(NativeHal::CLOCK_REAL);
+
+  fleet = new Fleet();
+  fleet->settings = settings;
+  if (!fleet->loop.valid()) {
+    fprintf(stderr, "fleet: epoll_create1 failed\n");
+    return 1;
+  }
+
+  fleet->probe.reset(new PubSubClient(fleet->loop));
+  fleet->probe->setServer(settings.host, settings.port);
+  fleet->probe->setCallback(onProbeMessage);
+  fleet->probe->setOutputLimit(64 * MQTT_OUTPUT_LIMIT);
+  if (!connectProbe()) {
+    fprintf(stderr, "fleet: cannot reach %s:%u\n", settings.host, settings.port);
+    return 1;
+  }
+  uint64_t deadline = NativeHal::now() + MQTT_SOCKET_TIMEOUT * 1000000ULL;
+  while (fleet->probe->connected() && !fleet->probe->ready() && NativeHal::now() < deadline) {
+    fleet->loop.poll(10);
+  }
+  if (!fleet->probe->ready()) {
+    fprintf(stderr, "fleet: no CONNACK from %s:%u (state %d)\n", settings.host, settings.port, fleet->probe->state());
+    return 1;
+  }
+
+  uint32_t seed = 0x2545F491;
+  fleet->start = NativeHal::now();
+  for (uint32_t i = 0; i < settings.devices; i++) {
+    Device* d = new Device(fleet->loop, i, settings.user, settings.pass);
+    fleet->devices.emplace_back(d);
+    d->random = xorshift(seed) | 1;
+    d->intervalMs = settings.intervalMs;
+    d->bootOffsetMs = settings.syncBoot ? 0 : xorshift(seed) % FLEET_RECONNECT_PERIOD;
+    d->client.setServer(settings.host, settings.port);
+    d->client.setCallback([d](char* topic, uint8_t* payload, unsigned int length) {
+      onDeviceMessage(*d, topic, payload, length);
+    });
+    d->client.setObserver(onPublish, d);
+    d->link.begin(FLEET_CHIP_ID_BASE + i);
+    d->link.setCleanSession(settings.cleanSession);
+    d->window.setSize((uint8_t)settings.window);
+    d->uplink.begin(xorshift(seed));
+
+    uint64_t connectAt = fleet->start + (uint64_t)(settings.ramp * 1e6 * i / settings.devices);
+    schedule(connectAt, i, EVENT_CONNECT);
+    schedule(connectAt + (uint64_t)(xorshift(seed) % settings.intervalMs) * 1000, i, EVENT_SAMPLE);
+  }
+
+  uint64_t end = fleet->start + (uint64_t)(settings.seconds * 1e6);
+  uint64_t reportUs = (uint64_t)(settings.report * 1e6);
+  uint64_t nextReport = fleet->start + reportUs;
+  uint64_t nextSweep = fleet->start + FLEET_SWEEP_US;
+  uint64_t stormAt = settings.storm >= 0 ? fleet->start + (uint64_t)(settings.storm * 1e6) : UINT64_MAX;
+  uint64_t lastReport = fleet->start;
+  uint64_t probeRetry = 0;  // Next reconnect of a lost probe, 0 = connected
+
+  for (;;) {
+    uint64_t now = NativeHal::now();
+    if (now >= end) break;
+
+    while (!fleet->events.empty() && fleet->events.top().at <= now) {
+      Event e = fleet->events.top();
+      fleet->events.pop();
+      Device& d = *fleet->devices[e.device];
+      if (e.kind == EVENT_SAMPLE) sample(d, now);
+      else if (!d.client.connected()) attempt(d, now);
+    }
+    if (now >= stormAt) {
+      printf("%7.1fs storm: dropping %u connections\n", (now - fleet->start) / 1e6, settings.devices);
+      storm();
+      stormAt = UINT64_MAX;
+    }
+    if (now >= nextSweep) {
+      sweep(now);
+      fleet->probe->loop();
+      nextSweep = now + FLEET_SWEEP_US;
+      if (fleet->probe->connected()) {
+        probeRetry = 0;
+      } else if (probeRetry == 0) {
+        printf("%7.1fs probe lost its connection (state %d)\n", (now - fleet->start) / 1e6, fleet->probe->state());
+        probeRetry = now;
+      }
+      if (probeRetry != 0 && now >= probeRetry) {
+        connectProbe();
+        probeRetry = now + 1000000;
+      }
+    }
+    if (now >= nextReport) {
+      printInterval((now - fleet->start) / 1e6, (now - lastReport) / 1e6);
+      fleet->total.add(fleet->interval);
+      fleet->interval = Counters();
+      lastReport = now;
+      nextReport += reportUs;
+    }
+
+    uint64_t wake = nextSweep;
+    if (!fleet->events.empty() && fleet->events.top().at < wake) wake = fleet->events.top().at;
+    now = NativeHal::now();
+    fleet->loop.poll(wake > now ? (int)((wake - now + 999) / 1000) : 0);
+  }
+
+  uint64_t now = NativeHal::now();
+  fleet->total.add(fleet->interval);
+  printSummary((now - fleet->start) / 1e6);
+  return 0;
+}
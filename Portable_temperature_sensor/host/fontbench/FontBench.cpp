@@ -0,0 +1,202 @@
+// Benchmarks the readout blitter (src/PageCanvas.h, src/largeDigitFont.h) against scaled text
+// Every path draws the temperature readout the way displayUpdate() did, into the
+// top two pages of a 128x32 framebuffer, for a sweep of readings. The text is
+// formatted up front; formatting is the same for every path and timed on its own:
+//   format    snprintf("%.2fC")
+//   blit      drawLargeText() and the clear after it, as ReadoutWidget::render()
+//   stretch   GyverOLED's setScale(2) write: each 5x7 glyph column is widened bit
+//             by bit into a 16-bit word, written as two bytes into two columns,
+//             after clearing the box as the old code did with clear(0, 0, 126, 15)
+//   gyver     the NativeHal GyverOLED doing textMode/clear/setScale(2)/print,
+//             which scales pixel by pixel
+// Before timing, blit and stretch are compared for every reading: the large font
+// is GyverOLED's 5x7 font doubled, so the framebuffers must be identical. The
+// NativeHal GyverOLED has a different 5x7 font and is only timed.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "CycleCounter.h"
+#include "GyverOLED.h"
+#include "PageCanvas.h"
+
+#define FONTBENCH_PAGES 4
+#define FONTBENCH_FRAME_SIZE (128 * FONTBENCH_PAGES)
+#define FONTBENCH_READOUT_END 126  // Last column the readout owned in displayUpdate()
+
+namespace {
+
+const char* USAGE =
+  "usage: fontbench [options]\n"
+  "  --readouts N        readouts drawn per timed run (default 100000)\n"
+  "  --repeat N          timed runs per path, best one is reported (default 7)\n";
+
+struct Settings {
+  uint32_t readouts = 100000;
+  int repeat = 7;
+};
+
+typedef GyverOLED<SSD1306_128x32, OLED_BUFFER> Oled;
+
+// GyverOLED's own glyphs for the readout characters, in largeDigitIndex() order
+const uint8_t gyverGlyphs[][5] PROGMEM = {
+  {0x3e, 0x51, 0x49, 0x45, 0x3e}, {0x00, 0x42, 0x7f, 0x40, 0x00}, {0x42, 0x61, 0x51, 0x49, 0x46},
+  {0x21, 0x41, 0x45, 0x4b, 0x31}, {0x18, 0x14, 0x12, 0x7f, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39},
+  {0x3c, 0x4a, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03}, {0x36, 0x49, 0x49, 0x49, 0x36},
+  {0x06, 0x49, 0x49, 0x29, 0x1e}, {0x00, 0x60, 0x60, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08},
+  {0x3e, 0x41, 0x41, 0x41, 0x22}, {0x00, 0x00, 0x00, 0x00, 0x00},
+};
+
+// A reading between -20 and 1000 °C, as the MAX6675 gives them (0.25 °C steps)
+float reading(uint32_t i) {
+  return -20.0f + (float)((i * 2654435761u) % 4081) * 0.25f;
+}
+
+int format(char* out, size_t size, float value) {
+  return snprintf(out, size, "%.2fC", value);
+}
+
+// Readings formatted as displayUpdate() formats them
+struct Readout {
+  char text[12];
+};
+
+void drawBlit(uint8_t* frame, const char* text) {
+  PageCanvas canvas = { frame, FONTBENCH_PAGES, 0, FONTBENCH_PAGES - 1 };
+  uint8_t end = drawLargeText(canvas, 0, 0, text, FONTBENCH_READOUT_END);
+  if (end <= FONTBENCH_READOUT_END) {
+    canvas.clear(end, FONTBENCH_READOUT_END, 0);
+    canvas.clear(end, FONTBENCH_READOUT_END, 1);
+  }
+}
+
+// GyverOLED's write() at scale 2 in BUF_REPLACE mode, on a column-major buffer
+void drawStretch(uint8_t* frame, const char* text) {
+  for (uint8_t x = 0; x <= FONTBENCH_READOUT_END; x++) {
+    frame[x * FONTBENCH_PAGES] = 0;
+    frame[x * FONTBENCH_PAGES + 1] = 0;
+  }
+  int x = 0;
+  for (const char* p = text; *p; p++) {
+    const uint8_t* glyph = gyverGlyphs[largeDigitIndex(*p)];
+    for (uint8_t col = 0; col < 6; col++) {
+      uint8_t bits = col < 5 ? pgm_read_byte(&glyph[col]) : 0;
+      uint32_t wide = 0;
+      for (uint8_t i = 0, count = 0; i < 8; i++) {
+        for (uint8_t j = 0; j < 2; j++, count++) bitWrite(wide, count, bitRead(bits, i));
+      }
+      for (uint8_t i = 0; i < 2; i++, x++) {
+        if (x > 127) continue;
+        for (uint8_t j = 0; j < 2; j++) frame[x * FONTBENCH_PAGES + j] = (uint8_t)(wide >> (j * 8));
+      }
+    }
+  }
+}
+
+void drawGyver(Oled& oled, const char* text) {
+  oled.textMode(BUF_REPLACE);
+  oled.rect(0, 0, FONTBENCH_READOUT_END, 15, OLED_CLEAR);
+  oled.setScale(2);
+  oled.setCursor(0, 0);
+  oled.print(text);
+}
+
+// The top two pages up to the readout's last column
+bool sameReadout(const uint8_t* a, const uint8_t* b) {
+  for (uint8_t x = 0; x <= FONTBENCH_READOUT_END; x++) {
+    if (a[x * FONTBENCH_PAGES] != b[x * FONTBENCH_PAGES]) return false;
+    if (a[x * FONTBENCH_PAGES + 1] != b[x * FONTBENCH_PAGES + 1]) return false;
+  }
+  return true;
+}
+
+template <class F>
+double best(int repeat, F&& f) {
+  double best = 1e30;
+  for (int r = 0; r < repeat; r++) {
+    double start = monotonicSeconds();
+    f();
+    best = std::min(best, monotonicSeconds() - start);
+  }
+  return best;
+}
+
+volatile uint32_t sink32;  // Keeps results alive
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    if (!strcmp(arg, "--help")) { fputs(USAGE, stdout); return 0; }
+    if (value == NULL) { fprintf(stderr, "fontbench: bad argument '%s'\n%s", arg, USAGE); return 2; }
+    if (!strcmp(arg, "--readouts")) settings.readouts = (uint32_t)atoi(value);
+    else if (!strcmp(arg, "--repeat")) settings.repeat = atoi(value);
+    else { fprintf(stderr, "fontbench: bad argument '%s'\n%s", arg, USAGE); return 2; }
+    i++;
+  }
+  if (settings.readouts < 1 || settings.repeat < 1) {
+    fprintf(stderr, "%s", USAGE);
+    return 2;
+  }
+
+  // Both start from the same garbage, so leftovers of a longer reading show up
+  static Oled oled;
+  static uint8_t blit[FONTBENCH_FRAME_SIZE];
+  static uint8_t stretch[FONTBENCH_FRAME_SIZE];
+  for (uint16_t i = 0; i < FONTBENCH_FRAME_SIZE; i++) blit[i] = (uint8_t)(i * 37 + 11);
+  memcpy(stretch, blit, sizeof(stretch));
+
+  uint32_t checks = 4081 * 2;
+  uint32_t differ = 0;
+  for (uint32_t i = 0; i < checks; i++) {
+    Readout r;
+    format(r.text, sizeof(r.text), reading(i));
+    drawBlit(blit, r.text);
+    drawStretch(stretch, r.text);
+    if (!sameReadout(blit, stretch)) {
+      if (differ++ == 0) fprintf(stderr, "fontbench: readouts differ at '%s'\n", r.text);
+    }
+  }
+  printf("fontbench: %u readings checked, %u differ between blit and stretch\n", checks, differ);
+
+  std::vector<float> values(settings.readouts);
+  std::vector<Readout> readouts(settings.readouts);
+  for (uint32_t i = 0; i < settings.readouts; i++) {
+    values[i] = reading(i);
+    format(readouts[i].text, sizeof(readouts[i].text), values[i]);
+  }
+
+  const char* names[] = { "format", "blit", "stretch", "gyver" };
+  const int rows = 4;
+  double t[rows];
+  t[0] = best(settings.repeat, [&] {
+    char text[12];
+    uint32_t total = 0;
+    for (float value : values) total += (uint32_t)format(text, sizeof(text), value) + (uint8_t)text[0];
+    sink32 = total;
+  });
+  t[1] = best(settings.repeat, [&] {
+    for (const Readout& r : readouts) drawBlit(blit, r.text);
+    sink32 = blit[0];
+  });
+  t[2] = best(settings.repeat, [&] {
+    for (const Readout& r : readouts) drawStretch(stretch, r.text);
+    sink32 = stretch[0];
+  });
+  t[3] = best(settings.repeat, [&] {
+    for (const Readout& r : readouts) drawGyver(oled, r.text);
+    sink32 = oled._oled_buffer[0];
+  });
+
+  printf("\n%-10s  %10s  %8s\n", "path", "ns/readout", "vs blit");
+  for (int r = 0; r < rows; r++) {
+    printf("%-10s  %10.1f", names[r], t[r] * 1e9 / settings.readouts);
+    if (r > 0) printf("  %7.1fx", t[r] / t[1]);
+    printf("\n");
+  }
+  return differ == 0 ? 0 : 1;
+}
@@ -0,0 +1,492 @@
+#ifndef FLEET_AGGREGATOR_H
+#define FLEET_AGGREGATOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DeviceRegistry.h"
+#include "IngestDecoder.h"
+#include "SlidingMinMax.h"
+#include "WorkStealingPool.h"
+
+#define AGG_WINDOW 60              // Samples in a device's sliding window
+#define AGG_SHARD_BITS 8           // 256 devices per shard
+#define AGG_RULES_MAX 16
+#define AGG_DEFAULT_GROUP "default"
+
+enum AggScope : uint8_t { AGG_DEVICE, AGG_GROUP, AGG_FLEET };
+enum AggMetric : uint8_t { METRIC_LATEST, METRIC_MEAN, METRIC_MIN, METRIC_MAX, METRIC_SPREAD };
+
+// "scope:metric>C" or "scope:metric<C", e.g. device:max>250 or group:mean>80
+//   device  latest, mean, min, max or spread (max - min) of each device's window
+//   group   mean of the device window means, min, max or spread across the group
+//   fleet   the same across every device
+// A rule trips past its threshold and clears once back by the hysteresis, as the
+// firmware's AlarmEngine does with thresholdTemp.
+struct AlertRule {
+  AggScope scope;
+  AggMetric metric;
+  bool above;
+  double threshold;   // °C
+  std::string text;
+
+  static bool parse(const char* text, AlertRule& rule) {
+    static const char* scopes[] = { "device", "group", "fleet" };
+    static const char* metrics[] = { "latest", "mean", "min", "max", "spread" };
+    const char* colon = strchr(text, ':');
+    const char* op = strpbrk(text, "<>");
+    if (colon == NULL || op == NULL || op < colon) return false;
+    int scope = -1;
+    int metric = -1;
+    for (int i = 0; i < 3; i++) {
+      if ((size_t)(colon - text) == strlen(scopes[i]) && !strncmp(text, scopes[i], colon - text)) scope = i;
+    }
+    for (int i = 0; i < 5; i++) {
+      if ((size_t)(op - colon - 1) == strlen(metrics[i]) && !strncmp(colon + 1, metrics[i], op - colon - 1)) metric = i;
+    }
+    char* end;
+    double threshold = strtod(op + 1, &end);
+    if (scope < 0 || metric < 0 || end == op + 1 || *end != '\0') return false;
+    if (scope != AGG_DEVICE && metric == METRIC_LATEST) return false;
+    rule.scope = (AggScope)scope;
+    rule.metric = (AggMetric)metric;
+    rule.above = *op == '>';
+    rule.threshold = threshold;
+    rule.text = text;
+    return true;
+  }
+};
+
+// A rule tripping or clearing
+struct AlertEvent {
+  uint8_t rule;
+  uint8_t raised;
+  uint32_t target;    // Device or group index; 0 for the fleet
+  float celsius;      // The metric when it happened
+};
+
+// Aggregate of a group or of the fleet, °C
+struct AggStats {
+  uint32_t devices = 0;   // With a valid reading in their window
+  double mean = 0;
+  double min = 0;
+  double max = 0;
+};
+
+// Incremental fleet views over the incoming samples, spread over a thread pool
+// Every device has a sliding window of its last AGG_WINDOW samples, kept with the
+// firmware's SlidingMinMax plus a running sum for the mean. Devices belong to one
+// group each (default AGG_DEFAULT_GROUP) and sit in shards of 256 by registry index.
+// ingest() sorts a batch by shard and updates the touched shards in parallel; a
+// shard only ever runs on one thread at a time, so its devices and its per-group
+// partials (sum of device means, min, max) need no locks. The partials are kept
+// up to date incrementally: a group's max is only recomputed over the shard when
+// the device holding it drops. The touched groups are then merged across shards
+// and the fleet across groups, and every rule is checked against what changed.
+// hottest() scans the shards in parallel for the devices with the highest latest
+// reading. One thread calls ingest() and hottest(); results are identical
+// whatever the number of threads.
+class FleetAggregator {
+public:
+  struct Hot {
+    uint32_t device;
+    int16_t value;
+  };
+
+private:
+  struct DeviceState {
+    SlidingMinMax<AGG_WINDOW> window;
+    int32_t sum = 0;                 // Of the valid values in the window
+    uint16_t valid = 0;
+    int16_t latest = SAMPLE_FAULT;   // Newest valid value
+    uint32_t group = 0;
+    uint16_t alerts = 0;             // Bit per rule, device rules only
+    bool seen = false;
+  };
+
+  // A shard's share of one group
+  struct GroupPartial {
+    int64_t meanSum = 0;             // Device window means, 1/256 °C
+    uint32_t devices = 0;
+    int16_t max = INT16_MIN;
+    int16_t min = INT16_MAX;
+    uint32_t argmax = 0;
+    uint32_t argmin = 0;
+    bool rescan = false;
+  };
+
+  struct alignas(64) Shard {
+    std::vector<GroupPartial> groups;
+    std::vector<uint32_t> touched;   // Groups changed by the current batch
+    std::vector<uint8_t> isTouched;
+    std::vector<AlertEvent> events;
+    std::vector<Hot> hottest;
+  };
+
+  struct GroupView {
+    int64_t meanSum = 0;
+    uint32_t devices = 0;
+    int16_t max = INT16_MIN;
+    int16_t min = INT16_MAX;
+  };
+
+  const DeviceRegistry& _registry;
+  WorkStealingPool& _pool;
+  std::vector<DeviceState> _devices;
+  std::vector<Shard> _shards;
+  std::vector<AlertRule> _rules;
+  double _hysteresis = 1;
+
+  std::vector<std::string> _groupNames;
+  std::unordered_map<std::string, uint32_t> _groupIndex;
+  std::unordered_map<std::string, uint32_t> _assigned;   // Device ID -> group
+  std::vector<GroupView> _groupViews;
+  std::vector<uint16_t> _groupAlerts;
+  std::vector<uint8_t> _groupTouched;
+  uint16_t _fleetAlerts = 0;
+  GroupView _fleet;
+
+  // Per batch
+  const IngestSample* _batch = NULL;
+  std::vector<uint32_t> _order;          // Batch positions sorted by shard
+  std::vector<uint32_t> _shardStart;     // Into _order, one past the end per shard
+  std::vector<uint32_t> _active;         // Shards with samples
+  std::vector<uint32_t> _touched;        // Groups with samples
+  uint32_t _hottestN = 0;
+  uint64_t _samples = 0;
+  uint64_t _batches = 0;
+
+  static int32_t meanQ(const DeviceState& d) { return d.valid > 0 ? d.sum * 64 / d.valid : 0; }
+
+  static bool tripped(bool active, bool above, double value, double threshold, double hysteresis) {
+    if (above) return active ? value >= threshold - hysteresis : value > threshold;
+    return active ? value <= threshold + hysteresis : value < threshold;
+  }
+
+  static double deviceMetric(const DeviceState& d, AggMetric metric) {
+    switch (metric) {
+      case METRIC_LATEST: return d.latest / 4.0;
+      case METRIC_MEAN: return d.sum / 4.0 / d.valid;
+      case METRIC_MIN: return d.window.min() / 4.0;
+      case METRIC_MAX: return d.window.max() / 4.0;
+      default: return (d.window.max() - d.window.min()) / 4.0;
+    }
+  }
+
+  static double viewMetric(const GroupView& g, AggMetric metric) {
+    switch (metric) {
+      case METRIC_MEAN: return g.meanSum / 256.0 / g.devices;
+      case METRIC_MIN: return g.min / 4.0;
+      case METRIC_MAX: return g.max / 4.0;
+      default: return (g.max - g.min) / 4.0;
+    }
+  }
+
+  uint32_t groupOf(uint32_t device) const {
+    auto it = _assigned.find(_registry.name(device));
+    return it == _assigned.end() ? 0 : it->second;
+  }
+
+  void touch(Shard& shard, uint32_t group) {
+    if (shard.isTouched[group]) return;
+    shard.isTouched[group] = 1;
+    shard.touched.push_back(group);
+  }
+
+  void update(Shard& shard, uint32_t device, int16_t value) {
+    DeviceState& d = _devices[device];
+    if (!d.seen) {
+      d.seen = true;
+      d.group = groupOf(device);
+    }
+    bool hadValid = d.window.valid();
+    int32_t oldMean = meanQ(d);
+
+    if (d.window.count() == AGG_WINDOW) {
+      int16_t out = d.window.recent(AGG_WINDOW - 1);
+      if (out != SAMPLE_FAULT) {
+        d.sum -= out;
+        d.valid--;
+      }
+    }
+    d.window.push(value);
+    if (value != SAMPLE_FAULT) {
+      d.sum += value;
+      d.valid++;
+      d.latest = value;
+    }
+
+    GroupPartial& p = shard.groups[d.group];
+    bool hasValid = d.window.valid();
+    p.meanSum += meanQ(d) - oldMean;
+    p.devices += (int)hasValid - (int)hadValid;
+    if (hasValid && d.window.max() >= p.max) {
+      p.max = d.window.max();
+      p.argmax = device;
+    } else if (p.argmax == device && p.max != INT16_MIN) {
+      p.rescan = true;  // The group's hottest device cooled down
+    }
+    if (hasValid && d.window.min() <= p.min) {
+      p.min = d.window.min();
+      p.argmin = device;
+    } else if (p.argmin == device && p.min != INT16_MAX) {
+      p.rescan = true;
+    }
+    touch(shard, d.group);
+
+    if (!hasValid) return;
+    for (size_t r = 0; r < _rules.size(); r++) {
+      const AlertRule& rule = _rules[r];
+      if (rule.scope != AGG_DEVICE) continue;
+      double v = deviceMetric(d, rule.metric);
+      bool active = d.alerts >> r & 1;
+      bool now = tripped(active, rule.above, v, rule.threshold, _hysteresis);
+      if (now != active) {
+        d.alerts ^= 1 << r;
+        shard.events.push_back({ (uint8_t)r, (uint8_t)now, device, (float)v });
+      }
+    }
+  }
+
+  // Recompute a group's min and max over the shard's devices
+  void rescan(uint32_t shardIndex, GroupPartial& p, uint32_t group) {
+    p.max = INT16_MIN;
+    p.min = INT16_MAX;
+    uint32_t first = shardIndex << AGG_SHARD_BITS;
+    uint32_t last = std::min(first + (1u << AGG_SHARD_BITS), _registry.size());
+    for (uint32_t i = first; i < last; i++) {
+      const DeviceState& d = _devices[i];
+      if (!d.seen || d.group != group || !d.window.valid()) continue;
+      if (d.window.max() > p.max) {
+        p.max = d.window.max();
+        p.argmax = i;
+      }
+      if (d.window.min() < p.min) {
+        p.min = d.window.min();
+        p.argmin = i;
+      }
+    }
+    p.rescan = false;
+  }
+
+  void runShard(uint32_t shardIndex) {
+    Shard& shard = _shards[shardIndex];
+    uint32_t begin = shardIndex == 0 ? 0 : _shardStart[shardIndex - 1];
+    for (uint32_t i = begin; i < _shardStart[shardIndex]; i++) {
+      const IngestSample& s = _batch[_order[i]];
+      update(shard, s.device, s.value);
+    }
+    for (uint32_t group : shard.touched) {
+      GroupPartial& p = shard.groups[group];
+      if (p.rescan) rescan(shardIndex, p, group);
+    }
+  }
+
+  void hottestShard(uint32_t shardIndex) {
+    Shard& shard = _shards[shardIndex];
+    shard.hottest.clear();
+    uint32_t first = shardIndex << AGG_SHARD_BITS;
+    uint32_t last = std::min(first + (1u << AGG_SHARD_BITS), _registry.size());
+    for (uint32_t i = first; i < last; i++) {
+      const DeviceState& d = _devices[i];
+      if (d.seen && d.latest != SAMPLE_FAULT) shard.hottest.push_back({ i, d.latest });
+    }
+    keepHottest(shard.hottest, _hottestN);
+  }
+
+  static bool hotter(const Hot& a, const Hot& b) {
+    return a.value != b.value ? a.value > b.value : a.device < b.device;
+  }
+
+  static void keepHottest(std::vector<Hot>& list, uint32_t n) {
+    if (list.size() > n) {
+      std::nth_element(list.begin(), list.begin() + n, list.end(), hotter);
+      list.resize(n);
+    }
+    std::sort(list.begin(), list.end(), hotter);
+  }
+
+  void checkRules(AggScope scope, const GroupView& view, uint16_t& alerts, uint32_t target,
+                  std::vector<AlertEvent>& events) {
+    if (view.devices == 0) return;
+    for (size_t r = 0; r < _rules.size(); r++) {
+      const AlertRule& rule = _rules[r];
+      if (rule.scope != scope) continue;
+      double v = viewMetric(view, rule.metric);
+      bool active = alerts >> r & 1;
+      bool now = tripped(active, rule.above, v, rule.threshold, _hysteresis);
+      if (now != active) {
+        alerts ^= 1 << r;
+        events.push_back({ (uint8_t)r, (uint8_t)now, target, (float)v });
+      }
+    }
+  }
+
+public:
+  FleetAggregator(const DeviceRegistry& registry, WorkStealingPool& pool)
+      : _registry(registry), _pool(pool), _devices(registry.capacity()),
+        _shards((registry.capacity() + (1u << AGG_SHARD_BITS) - 1) >> AGG_SHARD_BITS),
+        _shardStart(_shards.size()) {
+    group(AGG_DEFAULT_GROUP);
+  }
+
+  bool addRule(const char* text) {
+    AlertRule rule;
+    if (_rules.size() == AGG_RULES_MAX || !AlertRule::parse(text, rule)) return false;
+    _rules.push_back(rule);
+    return true;
+  }
+
+  void setHysteresis(double celsius) { _hysteresis = celsius; }
+
+  // Index of a group, adding it if new; set groups up before the first ingest()
+  uint32_t group(const char* name) {
+    auto it = _groupIndex.find(name);
+    if (it != _groupIndex.end()) return it->second;
+    uint32_t index = (uint32_t)_groupNames.size();
+    _groupNames.push_back(name);
+    _groupIndex[name] = index;
+    _groupViews.emplace_back();
+    _groupAlerts.push_back(0);
+    _groupTouched.push_back(0);
+    for (Shard& s : _shards) {
+      s.groups.emplace_back();
+      s.isTouched.push_back(0);
+    }
+    return index;
+  }
+
+  void assign(const char* device, const char* groupName) { _assigned[device] = group(groupName); }
+
+  // "<device ID> <group>" per line; # starts a comment
+  bool loadGroups(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) return false;
+    char line[256];
+    bool ok = true;
+    while (fgets(line, sizeof(line), f) != NULL) {
+      char device[128];
+      char name[128];
+      char* hash = strchr(line, '#');
+      if (hash != NULL) *hash = '\0';
+      int fields = sscanf(line, "%127s %127s", device, name);
+      if (fields == 2) assign(device, name);
+      else if (fields == 1) ok = false;
+    }
+    fclose(f);
+    return ok;
+  }
+
+  // Fold a batch of samples in (ack markers are skipped) and check the rules
+  // `events` gets the rules that tripped or cleared: device rules in shard order,
+  // then group rules, then fleet rules.
+  void ingest(const IngestSample* batch, size_t n, std::vector<AlertEvent>& events) {
+    events.clear();
+    _batch = batch;
+    _order.resize(n);
+    std::fill(_shardStart.begin(), _shardStart.end(), 0);
+    size_t samples = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (batch[i].source != SOURCE_ACK) {
+        _shardStart[batch[i].device >> AGG_SHARD_BITS]++;
+        samples++;
+      }
+    }
+    if (samples == 0) return;
+    _active.clear();
+    uint32_t total = 0;
+    for (uint32_t s = 0; s < _shardStart.size(); s++) {
+      if (_shardStart[s] > 0) _active.push_back(s);
+      total += _shardStart[s];
+      _shardStart[s] = total - _shardStart[s];  // Start for now, end once filled
+    }
+    for (size_t i = 0; i < n; i++) {
+      if (batch[i].source != SOURCE_ACK) _order[_shardStart[batch[i].device >> AGG_SHARD_BITS]++] = (uint32_t)i;
+    }
+
+    auto work = [this](uint32_t begin, uint32_t end) {
+      for (uint32_t i = begin; i < end; i++) runShard(_active[i]);
+    };
+    _pool.parallelFor((uint32_t)_active.size(), 1, work);
+
+    // Merge the touched groups across every shard, then the fleet across groups
+    _touched.clear();
+    for (uint32_t s : _active) {
+      Shard& shard = _shards[s];
+      events.insert(events.end(), shard.events.begin(), shard.events.end());
+      shard.events.clear();
+      for (uint32_t group : shard.touched) {
+        shard.isTouched[group] = 0;
+        if (!_groupTouched[group]) {
+          _groupTouched[group] = 1;
+          _touched.push_back(group);
+        }
+      }
+      shard.touched.clear();
+    }
+    std::sort(_touched.begin(), _touched.end());
+    uint32_t shards = (_registry.size() + (1u << AGG_SHARD_BITS) - 1) >> AGG_SHARD_BITS;
+    for (uint32_t group : _touched) {
+      _groupTouched[group] = 0;
+      GroupView v;
+      for (uint32_t s = 0; s < shards; s++) {
+        const GroupPartial& p = _shards[s].groups[group];
+        v.meanSum += p.meanSum;
+        v.devices += p.devices;
+        v.max = std::max(v.max, p.max);
+        v.min = std::min(v.min, p.min);
+      }
+      _groupViews[group] = v;
+      checkRules(AGG_GROUP, v, _groupAlerts[group], group, events);
+    }
+    _fleet = GroupView();
+    for (const GroupView& v : _groupViews) {
+      _fleet.meanSum += v.meanSum;
+      _fleet.devices += v.devices;
+      _fleet.max = std::max(_fleet.max, v.max);
+      _fleet.min = std::min(_fleet.min, v.min);
+    }
+    checkRules(AGG_FLEET, _fleet, _fleetAlerts, 0, events);
+    _samples += samples;
+    _batches++;
+  }
+
+  // The n devices with the highest latest reading, hottest first
+  void hottest(uint32_t n, std::vector<Hot>& out) {
+    _hottestN = n;
+    uint32_t shards = (_registry.size() + (1u << AGG_SHARD_BITS) - 1) >> AGG_SHARD_BITS;
+    auto scan = [this](uint32_t begin, uint32_t end) {
+      for (uint32_t s = begin; s < end; s++) hottestShard(s);
+    };
+    _pool.parallelFor(shards, 1, scan);
+    out.clear();
+    for (uint32_t s = 0; s < shards; s++) out.insert(out.end(), _shards[s].hottest.begin(), _shards[s].hottest.end());
+    keepHottest(out, n);
+  }
+
+  AggStats stats(const GroupView& v) const {
+    AggStats s;
+    s.devices = v.devices;
+    if (v.devices == 0) return s;
+    s.mean = viewMetric(v, METRIC_MEAN);
+    s.min = v.min / 4.0;
+    s.max = v.max / 4.0;
+    return s;
+  }
+
+  AggStats groupStats(uint32_t group) const { return stats(_groupViews[group]); }
+  AggStats fleetStats() const { return stats(_fleet); }
+  uint32_t groups() const { return (uint32_t)_groupNames.size(); }
+  const char* groupName(uint32_t group) const { return _groupNames[group].c_str(); }
+  const AlertRule& rule(uint32_t r) const { return _rules[r]; }
+  size_t rules() const { return _rules.size(); }
+  uint64_t samples() const { return _samples; }
+  uint64_t batches() const { return _batches; }
+};
+
+#endif // FLEET_AGGREGATOR_H
@@ -0,0 +1,770 @@
+// Ingestion gateway: MQTT in, decoded samples out to storage
+// Two threads joined by lock-free single-producer/single-consumer queues:
+//   receive  the EventLoop with the broker connection; decodes batch and text
+//            payloads (IngestDecoder.h), drops go-back-N duplicates and queues
+//            the new samples, followed by an ack marker per batch
+//   storage  appends the samples to the time-series store (SeriesStore.h), and
+//            once its write-ahead log has them hands the ack markers back; the
+//            receive thread, woken through an eventfd, publishes them to
+//            sensor/<id>/set/ack
+// Acking only what storage has written gives end-to-end flow control: if storage
+// falls behind, device delivery windows fill up and samples wait in the device
+// rings instead of in gateway memory. Samples/s and latency percentiles from the
+// MQTT read to the write are printed and published on gateway/stats.
+//
+// Once written, each batch also goes through the fleet aggregator
+// (FleetAggregator.h) on a work-stealing pool the storage thread leads: sliding
+// windows per device, per-group and fleet views and the --alert rules. Rules
+// that trip or clear go to the receive thread like the acks and are published on
+// gateway/alert; the hottest devices and the group views on gateway/fleet.
+//
+// --bench replaces the broker with pre-encoded batches from a synthetic fleet and
+// runs both threads flat out, to see how large a fleet one core keeps up with.
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CycleCounter.h"
+#include "DeviceRegistry.h"
+#include "EventLoop.h"
+#include "FleetAggregator.h"
+#include "IngestDecoder.h"
+#include "LatencyHistogram.h"
+#include "PubSubClient.h"
+#include "SampleLog.h"
+#include "SeriesStore.h"
+#include "SpscQueue.h"
+#include "WorkStealingPool.h"
+
+#define GATEWAY_QUEUE 65536        // Samples between the threads, 2 MB
+#define GATEWAY_ACK_QUEUE 16384
+#define GATEWAY_ALERT_QUEUE 4096
+#define GATEWAY_POP 1024           // Samples the storage thread takes at a time
+#define GATEWAY_STATS_TOPIC "gateway/stats"
+#define GATEWAY_ALERT_TOPIC "gateway/alert"
+#define GATEWAY_FLEET_TOPIC "gateway/fleet"
+#define GATEWAY_BENCH_GROUPS 16
+
+namespace {
+
+const char* USAGE =
+  "usage: gateway [options]\n"
+  "  --host H            broker address (default 127.0.0.1)\n"
+  "  --port P            broker port (default 1883)\n"
+  "  --user U --pass P   broker credentials\n"
+  "  --client-id ID      MQTT client ID (default gateway)\n"
+  "  --out DIR           time-series store directory (default data)\n"
+  "  --csv               also append every sample to DIR/samples.csv\n"
+  "  --checkpoint S      seconds between store checkpoints (default 300)\n"
+  "  --max-devices N     devices the registry has room for (default 65536)\n"
+  "  --stats S           seconds between stats lines and gateway/stats messages (default 1)\n"
+  "  --no-ack            do not acknowledge batches\n"
+  "  --threads N         aggregator threads, storage's included (default one per core less one)\n"
+  "  --groups FILE       device groups, \"<device ID> <group>\" per line (default: one group)\n"
+  "  --alert RULE        alert rule, repeatable: device|group|fleet:latest|mean|min|max|spread>C or <C\n"
+  "  --hysteresis C      how far back past its threshold a rule clears (default 1)\n"
+  "  --hottest N         devices in the hottest list (default 10)\n"
+  "  --bench S           no broker: feed a synthetic fleet for S seconds\n"
+  "  --devices N         bench fleet size (default 10000)\n"
+  "  --batch K           bench samples per batch (default 1)\n";
+
+struct Settings {
+  const char* host = "127.0.0.1";
+  uint16_t port = 1883;
+  const char* user = NULL;
+  const char* pass = NULL;
+  const char* clientId = "gateway";
+  std::string out = "data";
+  bool csv = false;
+  double checkpoint = 300;
+  uint32_t maxDevices = 65536;
+  double stats = 1;
+  bool ack = true;
+  unsigned threads = 0;
+  const char* groups = NULL;
+  std::vector<const char*> rules;
+  double hysteresis = 1;
+  uint32_t hottest = 10;
+  double bench = 0;
+  uint32_t benchDevices = 10000;
+  uint32_t benchBatch = 1;
+};
+
+struct Ack {
+  uint32_t device;
+  uint32_t bootId;
+  uint32_t next;
+};
+
+// Storage thread figures, handed over under a mutex once per stats period
+struct StorageStats {
+  uint64_t stored = 0;
+  uint64_t unstored = 0;      // Device ID the store cannot use as a directory name
+  uint64_t cpuNs = 0;         // Storage thread CPU time
+  uint64_t aggregateNs = 0;   // Wall time in the aggregator
+  LatencyHistogram latency;   // MQTT read -> written, us
+  LatencyHistogram age;       // Device latch -> written, us (batches with a synced clock)
+
+  void add(const StorageStats& s) {
+    stored += s.stored;
+    unstored += s.unstored;
+    cpuNs += s.cpuNs;
+    aggregateNs += s.aggregateNs;
+    latency.merge(s.latency);
+    age.merge(s.age);
+  }
+};
+
+// Aggregator views, taken by the storage thread once per stats period
+struct FleetViews {
+  std::vector<FleetAggregator::Hot> hottest;
+  std::vector<AggStats> groups;
+  AggStats fleet;
+  bool fresh = false;
+};
+
+struct Gateway {
+  Settings settings;
+  DeviceRegistry registry;
+  IngestDecoder decoder;
+  WorkStealingPool pool;
+  FleetAggregator aggregator;  // Set up before the storage thread starts, then only used there
+  SpscQueue<IngestSample, GATEWAY_QUEUE> samples;
+  SpscQueue<Ack, GATEWAY_ACK_QUEUE> acks;
+  SpscQueue<AlertEvent, GATEWAY_ALERT_QUEUE> alerts;
+  int wakeFd = -1;             // eventfd: storage -> receive, acks or alerts are waiting
+  std::atomic<bool> storing{true};
+  std::atomic<bool> storageFailed{false};
+  std::atomic<bool> drained{false};   // Storage thread has emptied the queue and stopped
+  std::mutex statsLock;
+  StorageStats pending;        // Guarded by statsLock, taken by the reporter
+  FleetViews views;            // Guarded by statsLock
+  std::atomic<uint64_t> alertsDropped{0};
+  IngestSample out[INGEST_BATCH_MAX + 1];
+  uint64_t stalls = 0;         // Times the receive thread found the sample queue full
+  uint64_t acksSent = 0;
+  uint64_t alertsRaised = 0;
+  uint64_t alertsCleared = 0;
+
+  explicit Gateway(const Settings& s)
+      : settings(s), registry(s.maxDevices), decoder(registry), pool(s.threads), aggregator(registry, pool) {}
+};
+
+Gateway* gateway = NULL;
+std::atomic<bool> running{true};
+
+void onSignal(int) {
+  running = false;
+}
+
+uint64_t threadCpuNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void wake() {
+  uint64_t one = 1;
+  ssize_t w = write(gateway->wakeFd, &one, sizeof(one));
+  (void)w;
+}
+
+// Storage thread: drain the queue into the store, release the acks behind the
+// samples, then fold them into the aggregator
+// A store error stops the gateway rather than acking samples it could not keep;
+// the devices hold on to them until it is back.
+void storageThread(SeriesStore* store, SampleLog* csv) {
+  Gateway& g = *gateway;
+  std::vector<IngestSample> batch(GATEWAY_POP);
+  std::vector<Ack> acks;
+  acks.reserve(GATEWAY_POP);
+  std::vector<AlertEvent> events;
+  FleetViews views;
+  std::vector<int32_t> storeIndex(g.registry.capacity(), -1);  // Registry index -> store index
+  StorageStats local;
+  uint64_t cpuStart = threadCpuNs();
+  double nextHandover = monotonicSeconds() + 0.1;
+  double nextCheckpoint = monotonicSeconds() + g.settings.checkpoint;
+  double nextViews = monotonicSeconds() + g.settings.stats;
+  uint32_t idle = 0;
+  bool failed = false;
+
+  for (;;) {
+    size_t n = g.samples.pop(batch.data(), batch.size());
+    if (n == 0) {
+      if (!g.storing.load(std::memory_order_acquire) && g.samples.size() == 0) break;
+      // Spin briefly for the next burst, then back off to sleeping
+      if (++idle > 64) {
+        struct timespec ts = { 0, idle > 1024 ? 200000 : 20000 };
+        nanosleep(&ts, NULL);
+      }
+    } else if (failed) {
+      continue;  // Keep the receive thread from blocking until it has stopped
+    } else {
+      idle = 0;
+      bool ok = true;
+      for (size_t i = 0; i < n && ok; i++) {
+        const IngestSample& s = batch[i];
+        if (s.source == SOURCE_ACK) {
+          acks.push_back({ s.device, s.bootId, s.sequence });
+          continue;
+        }
+        int32_t& d = storeIndex[s.device];
+        if (d < 0) {
+          const char* name = g.registry.name(s.device);
+          d = store->device(name, strlen(name));
+          ok = d >= 0 || store->error().empty();
+        }
+        if (d >= 0) ok = store->append((uint32_t)d, s.epochMs, s.value);
+        else local.unstored++;
+        if (csv != NULL) csv->append(g.registry, s);
+      }
+      ok = ok && store->commit();  // Acks promise the samples are with the kernel
+      if (csv != NULL) csv->flush();
+      if (!ok) {
+        fprintf(stderr, "gateway: store: %s\n", store->error().c_str());
+        failed = true;
+        acks.clear();
+        g.storageFailed.store(true, std::memory_order_release);
+        running = false;
+        continue;
+      }
+
+      uint64_t nowNs = monotonicNanos();
+      int64_t wallMs = wallMillis();
+      for (size_t i = 0; i < n; i++) {
+        const IngestSample& s = batch[i];
+        if (s.source == SOURCE_ACK) continue;
+        local.stored++;
+        local.latency.record((nowNs - s.receivedNs) / 1000);
+        if (s.source == SOURCE_BATCH && !s.estimated && wallMs >= s.epochMs) {
+          local.age.record((uint64_t)(wallMs - s.epochMs) * 1000);
+        }
+      }
+      if (!acks.empty()) {
+        size_t pushed = 0;
+        while (pushed < acks.size()) {
+          pushed += g.acks.push(acks.data() + pushed, acks.size() - pushed);
+          if (pushed < acks.size()) sched_yield();  // Receive thread is behind on publishing
+        }
+        acks.clear();
+        wake();
+      }
+
+      uint64_t aggregateStart = monotonicNanos();
+      g.aggregator.ingest(batch.data(), n, events);
+      local.aggregateNs += monotonicNanos() - aggregateStart;
+      if (!events.empty()) {
+        size_t pushed = g.alerts.push(events.data(), events.size());
+        if (pushed < events.size()) g.alertsDropped.fetch_add(events.size() - pushed, std::memory_order_relaxed);
+        wake();
+      }
+    }
+
+    double now = monotonicSeconds();
+    if (now >= nextCheckpoint && !failed) {
+      if (!store->checkpoint()) {
+        fprintf(stderr, "gateway: store: %s\n", store->error().c_str());
+        failed = true;
+        g.storageFailed.store(true, std::memory_order_release);
+        running = false;
+      }
+      nextCheckpoint = now + g.settings.checkpoint;
+    }
+    if (now >= nextViews) {
+      g.aggregator.hottest(g.settings.hottest, views.hottest);
+      views.groups.resize(g.aggregator.groups());
+      for (uint32_t i = 0; i < g.aggregator.groups(); i++) views.groups[i] = g.aggregator.groupStats(i);
+      views.fleet = g.aggregator.fleetStats();
+      views.fresh = true;
+      {
+        std::lock_guard<std::mutex> lock(g.statsLock);
+        std::swap(g.views, views);
+      }
+      nextViews = now + g.settings.stats;
+    }
+    if (now >= nextHandover) {
+      uint64_t cpu = threadCpuNs();
+      local.cpuNs = cpu - cpuStart;
+      cpuStart = cpu;
+      {
+        std::lock_guard<std::mutex> lock(g.statsLock);
+        g.pending.add(local);
+      }
+      local = StorageStats();
+      nextHandover = now + 0.1;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(g.statsLock);
+    local.cpuNs = threadCpuNs() - cpuStart;
+    g.pending.add(local);
+  }
+  g.drained.store(true, std::memory_order_release);
+}
+
+// Receive thread: queue a message's samples and its ack marker for storage
+void ingest(const char* topic, const uint8_t* payload, size_t length, PubSubClient* client);
+
+void publishAcks(PubSubClient* client) {
+  Gateway& g = *gateway;
+  Ack acks[256];
+  size_t n;
+  while ((n = g.acks.pop(acks, 256)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      g.acksSent++;
+      if (client == NULL) continue;
+      char topic[MQTT_TOPIC_LEN + 8];
+      char value[SAMPLE_ACK_LEN];
+      snprintf(topic, sizeof(topic), MQTT_TOPIC_ROOT "/%s/set/ack", g.registry.name(acks[i].device));
+      formatSampleAck(value, sizeof(value), acks[i].bootId, acks[i].next);
+      client->publish(topic, value);
+    }
+  }
+}
+
+// Print the rules that tripped or cleared and publish them on gateway/alert
+void publishAlerts(PubSubClient* client) {
+  Gateway& g = *gateway;
+  AlertEvent events[64];
+  size_t n;
+  while ((n = g.alerts.pop(events, 64)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      const AlertEvent& e = events[i];
+      (e.raised ? g.alertsRaised : g.alertsCleared)++;
+      const AlertRule& rule = g.aggregator.rule(e.rule);
+      const char* target = rule.scope == AGG_DEVICE ? g.registry.name(e.target)
+                           : rule.scope == AGG_GROUP ? g.aggregator.groupName(e.target)
+                                                     : "fleet";
+      if (g.settings.bench == 0) {
+        printf("alert %s %s %s at %.2f C\n", e.raised ? "raised" : "cleared", rule.text.c_str(), target, e.celsius);
+      }
+      if (client == NULL || !client->ready()) continue;
+      char json[256];
+      snprintf(json, sizeof(json), "{\"rule\":\"%s\",\"target\":\"%s\",\"raised\":%s,\"celsius\":%.2f}",
+               rule.text.c_str(), target, e.raised ? "true" : "false", e.celsius);
+      client->publish(GATEWAY_ALERT_TOPIC, json);
+    }
+  }
+}
+
+void ingest(const char* topic, const uint8_t* payload, size_t length, PubSubClient* client) {
+  Gateway& g = *gateway;
+  uint64_t receivedNs = monotonicNanos();
+  IngestDecoder::Result r = g.decoder.message(topic, payload, length, receivedNs, wallMillis(), g.out);
+  size_t n = r.samples;
+  if (r.ackDevice >= 0 && g.settings.ack) {
+    IngestSample& marker = g.out[n++];
+    marker.device = (uint32_t)r.ackDevice;
+    marker.bootId = r.ackBoot;
+    marker.sequence = r.ack;
+    marker.source = SOURCE_ACK;
+    marker.receivedNs = receivedNs;
+  }
+  size_t pushed = 0;
+  while (pushed < n) {
+    pushed += g.samples.push(g.out + pushed, n - pushed);
+    if (pushed < n) {
+      g.stalls++;
+      publishAcks(client);  // Storage may be waiting for room in the ack queue
+      sched_yield();
+    }
+  }
+}
+
+// Stop feeding storage and wait for it to finish the queue, publishing the acks
+// it releases meanwhile; storage waits for room in the ack queue
+void drainStorage(std::thread& storage, PubSubClient* client, EventLoop& loop) {
+  gateway->storing.store(false, std::memory_order_release);
+  while (!gateway->drained.load(std::memory_order_acquire)) {
+    publishAcks(client);
+    publishAlerts(client);
+    loop.poll(1);
+  }
+  storage.join();
+  publishAcks(client);
+  publishAlerts(client);
+}
+
+// Acks or alerts waiting from the storage thread
+class AckWaker : public EventHandler {
+public:
+  PubSubClient* client = NULL;
+  void onEvents(uint32_t) override {
+    uint64_t count;
+    ssize_t r = read(gateway->wakeFd, &count, sizeof(count));
+    (void)r;
+    publishAcks(client);
+    publishAlerts(client);
+  }
+};
+
+void printHistogram(FILE* out, const char* name, const LatencyHistogram& h) {
+  fprintf(out, "%-10s n=%-10llu p50 %9.3fms  p90 %9.3fms  p99 %9.3fms  p99.9 %9.3fms  max %9.3fms\n", name,
+          (unsigned long long)h.count(), h.percentile(50) / 1000.0, h.percentile(90) / 1000.0,
+          h.percentile(99) / 1000.0, h.percentile(99.9) / 1000.0, h.max() / 1000.0);
+}
+
+// Hottest few devices and the fleet on stdout
+void printViews(const FleetViews& v) {
+  Gateway& g = *gateway;
+  printf("         fleet %u devices mean %.2f min %.2f max %.2f C  hottest", v.fleet.devices, v.fleet.mean, v.fleet.min,
+         v.fleet.max);
+  for (size_t i = 0; i < v.hottest.size() && i < 3; i++) {
+    printf(" %s %.2f", g.registry.name(v.hottest[i].device), v.hottest[i].value / 4.0);
+  }
+  printf("\n");
+}
+
+std::string statsJson(const AggStats& s) {
+  char json[128];
+  snprintf(json, sizeof(json), "{\"devices\":%u,\"mean\":%.2f,\"min\":%.2f,\"max\":%.2f}", s.devices, s.mean,
+           s.min, s.max);
+  return json;
+}
+
+// gateway/fleet: the fleet, every group and the hottest devices
+std::string viewsJson(const FleetViews& v) {
+  Gateway& g = *gateway;
+  std::string json = "{\"fleet\":" + statsJson(v.fleet) + ",\"groups\":{";
+  for (size_t i = 0; i < v.groups.size(); i++) {
+    if (i > 0) json += ",";
+    json += std::string("\"") + g.aggregator.groupName((uint32_t)i) + "\":" + statsJson(v.groups[i]);
+  }
+  json += "},\"hottest\":[";
+  for (size_t i = 0; i < v.hottest.size(); i++) {
+    char entry[64];
+    snprintf(entry, sizeof(entry), "%s{\"id\":\"%s\",\"celsius\":%.2f}", i > 0 ? "," : "",
+             g.registry.name(v.hottest[i].device), v.hottest[i].value / 4.0);
+    json += entry;
+  }
+  return json + "]}";
+}
+
+// One stats period: a line on stdout and a JSON document on gateway/stats, plus
+// the aggregator views on gateway/fleet
+struct Reporter {
+  IngestDecoder::Counters last;
+  StorageStats total;
+  double lastAt;
+  double start;
+
+  Reporter() : lastAt(monotonicSeconds()), start(lastAt) {}
+
+  void report(PubSubClient* client) {
+    Gateway& g = *gateway;
+    StorageStats period;
+    {
+      std::lock_guard<std::mutex> lock(g.statsLock);
+      period = g.pending;
+      g.pending = StorageStats();
+    }
+    total.add(period);
+    const IngestDecoder::Counters& c = g.decoder.counters();
+    double now = monotonicSeconds();
+    double seconds = now - lastAt;
+    double messages = (c.messages - last.messages) / seconds;
+    double stored = period.stored / seconds;
+
+    printf("%7.1fs %6u devices  %8.0f msg/s  %9.0f samples/s  queue %5zu  "
+           "latency p50 %7.3fms p99 %7.3fms p99.9 %7.3fms max %7.3fms  dup %llu lost %llu bad %llu\n",
+           now - start, g.registry.size(), messages, stored, g.samples.size(), period.latency.percentile(50) / 1000.0,
+           period.latency.percentile(99) / 1000.0, period.latency.percentile(99.9) / 1000.0,
+           period.latency.max() / 1000.0, (unsigned long long)(c.duplicates - last.duplicates),
+           (unsigned long long)(c.lost - last.lost), (unsigned long long)(c.malformed - last.malformed));
+    FleetViews views;
+    {
+      std::lock_guard<std::mutex> lock(g.statsLock);
+      std::swap(views, g.views);
+    }
+    if (views.fresh) printViews(views);
+    fflush(stdout);
+
+    if (client != NULL && client->ready()) {
+      if (views.fresh) client->publish(GATEWAY_FLEET_TOPIC, viewsJson(views).c_str());
+      char json[512];
+      snprintf(json, sizeof(json),
+               "{\"devices\":%u,\"messages_per_s\":%.0f,\"samples_per_s\":%.0f,\"queue\":%zu,"
+               "\"latency_us\":{\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu,\"max\":%llu},"
+               "\"age_ms\":{\"p50\":%llu,\"p99\":%llu,\"max\":%llu},"
+               "\"stored\":%llu,\"duplicates\":%llu,\"lost\":%llu,\"malformed\":%llu}",
+               g.registry.size(), messages, stored, g.samples.size(),
+               (unsigned long long)period.latency.percentile(50), (unsigned long long)period.latency.percentile(90),
+               (unsigned long long)period.latency.percentile(99), (unsigned long long)period.latency.percentile(99.9),
+               (unsigned long long)period.latency.max(), (unsigned long long)period.age.percentile(50) / 1000,
+               (unsigned long long)period.age.percentile(99) / 1000, (unsigned long long)period.age.max() / 1000,
+               (unsigned long long)total.stored, (unsigned long long)c.duplicates, (unsigned long long)c.lost,
+               (unsigned long long)c.malformed);
+      client->publish(GATEWAY_STATS_TOPIC, json);
+    }
+    last = c;
+    lastAt = now;
+  }
+
+  void summary(double receiveCpuNs) {
+    Gateway& g = *gateway;
+    const IngestDecoder::Counters& c = g.decoder.counters();
+    double seconds = monotonicSeconds() - start;
+    printf("\n%u devices, %.1fs\n", g.registry.size(), seconds);
+    printf("received   %llu msgs (%llu batches, %llu text of which %llu stored), %.2f MB\n",
+           (unsigned long long)c.messages, (unsigned long long)c.batches, (unsigned long long)c.texts,
+           (unsigned long long)c.textsStored, c.bytes / 1e6);
+    printf("stored     %llu samples (%.0f/s), %llu duplicates dropped, %llu lost, %llu malformed, %llu acks\n",
+           (unsigned long long)total.stored, total.stored / seconds, (unsigned long long)c.duplicates,
+           (unsigned long long)c.lost, (unsigned long long)c.malformed, (unsigned long long)g.acksSent);
+    if (total.stored > 0) {
+      printf("cpu        receive %.0f ns/sample, storage %.0f ns/sample, %llu queue-full stalls\n",
+             receiveCpuNs / total.stored, (double)total.cpuNs / total.stored, (unsigned long long)g.stalls);
+    }
+    if (total.unstored > 0) {
+      printf("unstored   %llu samples from device IDs that cannot be directory names\n",
+             (unsigned long long)total.unstored);
+    }
+    if (g.aggregator.samples() > 0) {
+      printf("aggregate  %llu samples on %u threads, %.0f ns/sample, %llu alerts raised, %llu cleared",
+             (unsigned long long)g.aggregator.samples(), g.pool.threads(),
+             (double)total.aggregateNs / g.aggregator.samples(), (unsigned long long)g.alertsRaised,
+             (unsigned long long)g.alertsCleared);
+      uint64_t dropped = g.alertsDropped.load();
+      if (dropped > 0) printf(", %llu dropped", (unsigned long long)dropped);
+      printf("\n");
+    }
+    printHistogram(stdout, "latency", total.latency);
+    if (total.age.count() > 0) printHistogram(stdout, "age", total.age);
+  }
+};
+
+uint32_t xorshift(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// A synthetic fleet's batches, encoded up front with the device encoder
+// Two generations with different boot IDs alternate so replaying them again and
+// again keeps producing new samples rather than duplicates. The devices have no
+// synced clock, so sample times come from arrival and keep moving forward.
+struct BenchFleet {
+  struct Message {
+    std::string topic;
+    std::vector<uint8_t> payload;
+  };
+  std::vector<Message> messages;
+
+  struct VectorSink {
+    std::vector<uint8_t>& out;
+    void put(uint8_t b) { out.push_back(b); }
+  };
+
+  BenchFleet(uint32_t devices, uint32_t batch, uint32_t rounds) {
+    uint32_t seed = 0x2545F491;
+    for (uint32_t generation = 0; generation < 2; generation++) {
+      for (uint32_t round = 0; round < rounds; round++) {
+        for (uint32_t d = 0; d < devices; d++) {
+          SampleRing<256> ring;
+          for (uint32_t i = 0; i < round * batch; i++) ring.push(0, 0);
+          ring.consume(ring.head());
+          int16_t value = (int16_t)(100 + d % 400);
+          for (uint32_t i = 0; i < batch; i++) {
+            value += (int16_t)(xorshift(seed) % 3) - 1;
+            ring.push(0, value);  // Latched together, just before the batch arrives
+          }
+          Message m;
+          char topic[MQTT_TOPIC_LEN];
+          snprintf(topic, sizeof(topic), MQTT_TOPIC_ROOT "/%06x/batch", 0x100000 + d);
+          m.topic = topic;
+          VectorSink sink = { m.payload };
+          encodeSampleBatch(sink, ring, 0xB0070000 + generation * devices + d, ring.tail(), batch, 0);
+          messages.push_back(std::move(m));
+        }
+      }
+    }
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    bool ok = true;
+    if (!strcmp(arg, "--help")) { fputs(USAGE, stdout); return 0; }
+    else if (!strcmp(arg, "--no-ack")) { settings.ack = false; continue; }
+    else if (!strcmp(arg, "--csv")) { settings.csv = true; continue; }
+    else if (value == NULL) ok = false;
+    else if (!strcmp(arg, "--host")) { settings.host = value; i++; }
+    else if (!strcmp(arg, "--port")) { settings.port = (uint16_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--user")) { settings.user = value; i++; }
+    else if (!strcmp(arg, "--pass")) { settings.pass = value; i++; }
+    else if (!strcmp(arg, "--client-id")) { settings.clientId = value; i++; }
+    else if (!strcmp(arg, "--out")) { settings.out = value; i++; }
+    else if (!strcmp(arg, "--max-devices")) { settings.maxDevices = (uint32_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--stats")) { settings.stats = atof(value); i++; }
+    else if (!strcmp(arg, "--checkpoint")) { settings.checkpoint = atof(value); i++; }
+    else if (!strcmp(arg, "--threads")) { settings.threads = (unsigned)atoi(value); i++; ok = settings.threads > 0; }
+    else if (!strcmp(arg, "--groups")) { settings.groups = value; i++; }
+    else if (!strcmp(arg, "--alert")) {
+      AlertRule rule;
+      ok = AlertRule::parse(value, rule) && settings.rules.size() < AGG_RULES_MAX;
+      settings.rules.push_back(value);
+      i++;
+    }
+    else if (!strcmp(arg, "--hysteresis")) { settings.hysteresis = atof(value); i++; }
+    else if (!strcmp(arg, "--hottest")) { settings.hottest = (uint32_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--bench")) { settings.bench = atof(value); i++; }
+    else if (!strcmp(arg, "--devices")) { settings.benchDevices = (uint32_t)atoi(value); i++; }
+    else if (!strcmp(arg, "--batch")) { settings.benchBatch = (uint32_t)atoi(value); i++; }
+    else ok = false;
+    if (!ok || settings.maxDevices < 1 || settings.stats <= 0 || settings.checkpoint <= 0 || settings.benchDevices < 1 || settings.benchBatch < 1 ||
+        settings.benchBatch > INGEST_BATCH_MAX) {
+      fprintf(stderr, "gateway: bad argument '%s'\n%s", arg, USAGE);
+      return 2;
+    }
+  }
+  if (settings.bench > 0 && settings.benchDevices > settings.maxDevices) settings.maxDevices = settings.benchDevices;
+  if (settings.threads == 0) settings.threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+  signal(SIGPIPE, SIG_IGN);
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  SeriesStore store(settings.maxDevices);
+  if (!store.open(settings.out)) {
+    fprintf(stderr, "gateway: store: %s\n", store.error().c_str());
+    return 1;
+  }
+  printf("store %s: %u devices, %llu samples recovered from the log\n", settings.out.c_str(), store.size(),
+         (unsigned long long)store.counters().replayed);
+  SampleLog csv;
+  std::string csvPath = settings.out + "/samples.csv";
+  if (settings.csv && !csv.open(csvPath)) {
+    fprintf(stderr, "gateway: cannot open %s\n", csvPath.c_str());
+    return 1;
+  }
+
+  gateway = new Gateway(settings);
+  Gateway& g = *gateway;
+  for (const char* rule : settings.rules) g.aggregator.addRule(rule);
+  g.aggregator.setHysteresis(settings.hysteresis);
+  if (settings.groups != NULL && !g.aggregator.loadGroups(settings.groups)) {
+    fprintf(stderr, "gateway: cannot read groups from %s\n", settings.groups);
+    return 1;
+  }
+  if (settings.groups == NULL && settings.bench > 0) {
+    for (uint32_t d = 0; d < settings.benchDevices; d++) {
+      char id[16];
+      char group[16];
+      snprintf(id, sizeof(id), "%06x", 0x100000 + d);
+      snprintf(group, sizeof(group), "line%02u", d % GATEWAY_BENCH_GROUPS);
+      g.aggregator.assign(id, group);
+    }
+  }
+  EventLoop loop;
+  g.wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (!loop.valid() || g.wakeFd < 0) {
+    fprintf(stderr, "gateway: cannot set up epoll\n");
+    return 1;
+  }
+  AckWaker waker;
+  loop.add(g.wakeFd, EPOLLIN, &waker);
+
+  std::thread storage(storageThread, &store, settings.csv ? &csv : NULL);
+  pthread_setname_np(storage.native_handle(), "gw-storage");
+  Reporter reporter;
+  uint64_t cpuStart = threadCpuNs();
+
+  if (settings.bench > 0) {
+    uint32_t rounds = 4;
+    printf("encoding %u devices x %u rounds x 2 boots, %u samples per batch\n", settings.benchDevices, rounds,
+           settings.benchBatch);
+    BenchFleet fleet(settings.benchDevices, settings.benchBatch, rounds);
+    reporter = Reporter();
+    cpuStart = threadCpuNs();
+    double end = monotonicSeconds() + settings.bench;
+    double nextStats = monotonicSeconds() + settings.stats;
+    size_t next = 0;
+    while (running) {
+      for (int i = 0; i < 256; i++) {
+        const BenchFleet::Message& m = fleet.messages[next];
+        ingest(m.topic.c_str(), m.payload.data(), m.payload.size(), NULL);
+        next = next + 1 < fleet.messages.size() ? next + 1 : 0;
+      }
+      publishAcks(NULL);
+      publishAlerts(NULL);
+      double now = monotonicSeconds();
+      if (now >= nextStats) {
+        reporter.report(NULL);
+        nextStats += settings.stats;
+      }
+      if (now >= end) break;
+    }
+  } else {
+    PubSubClient client(loop);
+    waker.client = &client;
+    client.setServer(settings.host, settings.port);
+    client.setCallback([&client](char* topic, uint8_t* payload, unsigned int length) {
+      ingest(topic, payload, length, &client);
+    });
+    client.setOutputLimit(64 * MQTT_OUTPUT_LIMIT);  // Acks for the whole fleet go through here
+
+    double nextStats = monotonicSeconds() + settings.stats;
+    double nextAttempt = 0;
+    bool wasReady = false;
+    while (running) {
+      double now = monotonicSeconds();
+      if (!client.connected() && now >= nextAttempt) {
+        nextAttempt = now + 1;
+        if (client.connect(settings.clientId, settings.user, settings.pass, NULL, 0, false, NULL, true)) {
+          client.subscribe(MQTT_TOPIC_ROOT "/+/batch", 0);
+          client.subscribe(MQTT_TOPIC_ROOT "/+/temperature", 0);
+          client.subscribe(MQTT_TOPIC_ROOT "/temperature", 0);
+        }
+      }
+      if (client.ready() != wasReady) {
+        wasReady = client.ready();
+        if (wasReady) printf("connected to %s:%u\n", settings.host, settings.port);
+        else printf("lost %s:%u (state %d)\n", settings.host, settings.port, client.state());
+        fflush(stdout);
+      }
+      client.loop();
+      loop.poll(100);
+      if (monotonicSeconds() >= nextStats) {
+        reporter.report(&client);
+        nextStats += settings.stats;
+      }
+    }
+    drainStorage(storage, &client, loop);
+    waker.client = NULL;
+    client.disconnect();
+  }
+
+  double receiveCpuNs = (double)(threadCpuNs() - cpuStart);
+  if (storage.joinable()) drainStorage(storage, NULL, loop);
+  reporter.report(NULL);
+  reporter.summary(receiveCpuNs);
+  csv.close();
+  bool closed = !g.storageFailed && store.close();
+  if (!g.storageFailed && !closed) fprintf(stderr, "gateway: store: %s\n", store.error().c_str());
+  const SeriesStore::Counters& c = store.counters();
+  printf("store      %llu samples, %llu blocks, %.2f bytes/sample in columns, %llu clamped, %llu checkpoints\n",
+         (unsigned long long)c.samples, (unsigned long long)c.blocks,
+         c.samples > 0 ? (double)c.columnBytes / c.samples : 0.0, (unsigned long long)c.clamped,
+         (unsigned long long)c.checkpoints);
+  return closed ? 0 : 1;
+}
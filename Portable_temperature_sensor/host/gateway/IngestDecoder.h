@@ -0,0 +1,208 @@
+#ifndef INGEST_DECODER_H
+#define INGEST_DECODER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "BatchTracker.h"
+#include "ColumnKernels.h"
+#include "DeviceRegistry.h"
+#include "MqttTopics.h"
+#include "SampleCodec.h"
+
+#define INGEST_BATCH_MAX 256          // SAMPLE_BATCH_MAX in SampleUplink.h
+#define INGEST_NO_SEQUENCE UINT32_MAX // Text readings carry no sequence number
+#define INGEST_TEXT_QUIET_MS 10000    // Text is not stored within this long of a device's last batch
+#define INGEST_LEGACY_ID "legacy"     // Device name for the pre-namespace topic sensor/temperature
+
+enum IngestSource : uint8_t {
+  SOURCE_BATCH,
+  SOURCE_TEXT,
+  SOURCE_ACK,   // Not a sample: ack `sequence` of `bootId` to `device` once everything before it is stored
+};
+
+// One decoded sample on its way from the receive thread to storage
+struct IngestSample {
+  uint32_t device;       // DeviceRegistry index
+  uint32_t bootId;       // 0 for text readings
+  uint32_t sequence;     // Ring position on the device, or INGEST_NO_SEQUENCE
+  int16_t value;         // 0.25°C steps or SAMPLE_FAULT, as on the device
+  uint8_t source;        // IngestSource
+  uint8_t estimated;     // Device clock was not synced; epochMs derived from arrival
+  int64_t epochMs;       // When the device latched the sample
+  uint64_t receivedNs;   // Monotonic time the MQTT message was read
+};
+
+// Turns device MQTT messages into samples
+// Understands the three things a sensor publishes:
+//   sensor/<id>/batch         delta/varint sample batches (SampleCodec.h)
+//   sensor/<id>/temperature   the latest reading as text, "%.1f"
+//   sensor/temperature        the same from firmware before per-device topics
+// Batches are the record of truth: each device's sequence numbers go through a
+// BatchTracker, so go-back-N resends are dropped here and the ack to send back
+// is returned. Current firmware sends each sample once, as text without acks or
+// in a batch with them, but older builds also sent every batched sample as text.
+// So a text reading is stored unless its device has sent a batch within the last
+// INGEST_TEXT_QUIET_MS: devices that never sent a batch (the legacy topic, a
+// window of 0 with no backlog) are stored from their first reading.
+// Runs on the receive thread and never allocates after construction.
+class IngestDecoder {
+public:
+  struct Counters {
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    uint64_t batches = 0;
+    uint64_t texts = 0;
+    uint64_t textsStored = 0;
+    uint64_t samples = 0;      // Passed on to storage
+    uint64_t duplicates = 0;
+    uint64_t lost = 0;
+    uint64_t malformed = 0;
+    uint64_t ignored = 0;      // Other topics (battery, commands)
+  };
+
+  // What to do besides storing: a cumulative ack for a device, if any
+  struct Result {
+    uint32_t samples;          // Written to `out`
+    int32_t ackDevice;         // -1 = no ack
+    uint32_t ackBoot;
+    uint32_t ack;
+  };
+
+private:
+  struct DeviceState {
+    BatchTracker tracker;
+    int64_t lastBatchMs = INT64_MIN;  // Wall time of the last batch, INT64_MIN before the first
+  };
+
+  DeviceRegistry& _registry;
+  std::vector<DeviceState> _devices;
+  uint32_t _ms[INGEST_BATCH_MAX];       // Decoded batch, as columns
+  int16_t _values[INGEST_BATCH_MAX];
+  uint32_t _scratch[SAMPLE_BATCH_SCRATCH(INGEST_BATCH_MAX)];
+  Counters _counters;
+
+  // "sensor/<id>/<leaf>" -> id and leaf; false for anything else
+  static bool splitTopic(const char* topic, const char*& id, size_t& idLength, const char*& leaf) {
+    static const char root[] = MQTT_TOPIC_ROOT "/";
+    if (strncmp(topic, root, sizeof(root) - 1) != 0) return false;
+    id = topic + sizeof(root) - 1;
+    const char* slash = strchr(id, '/');
+    if (slash == NULL) return false;
+    idLength = slash - id;
+    leaf = slash + 1;
+    return true;
+  }
+
+  uint32_t batch(uint32_t device, const uint8_t* payload, size_t length, uint64_t receivedNs, int64_t wallMs,
+                 IngestSample* out, Result& result) {
+    SampleBatchHeader header;
+    if (!decodeSampleBatchColumns(payload, length, header, _ms, _values, INGEST_BATCH_MAX, _scratch)) {
+      _counters.malformed++;
+      return 0;
+    }
+    DeviceState& state = _devices[device];
+    BatchTracker::Result r = state.tracker.receive(header);
+    state.lastBatchMs = wallMs;
+    _counters.batches++;
+    _counters.duplicates += r.duplicates;
+    _counters.lost += r.lost;
+    result.ackDevice = (int32_t)device;
+    result.ackBoot = state.tracker.bootId();
+    result.ack = state.tracker.next();
+
+    // Without a synced clock on the device, assume the newest sample was latched on arrival
+    bool estimated = header.firstEpochMs == 0;
+    int64_t base = estimated && header.count > 0 ? wallMs - _ms[header.count - 1] : (int64_t)header.firstEpochMs;
+    uint32_t skip = r.from - header.first;
+    for (uint32_t i = 0; i < r.accepted; i++) {
+      IngestSample& o = out[i];
+      o.device = device;
+      o.bootId = header.bootId;
+      o.sequence = r.from + i;
+      o.value = _values[skip + i];
+      o.source = SOURCE_BATCH;
+      o.estimated = estimated;
+      o.epochMs = base + _ms[skip + i];
+      o.receivedNs = receivedNs;
+    }
+    return r.accepted;
+  }
+
+  uint32_t text(uint32_t device, const uint8_t* payload, size_t length, uint64_t receivedNs, int64_t wallMs,
+                IngestSample* out) {
+    _counters.texts++;
+    DeviceState& state = _devices[device];
+    if (state.lastBatchMs != INT64_MIN && wallMs - state.lastBatchMs < INGEST_TEXT_QUIET_MS) {
+      return 0;  // Batches carry this device's samples
+    }
+
+    char buf[24];
+    if (length == 0 || length >= sizeof(buf)) {
+      _counters.malformed++;
+      return 0;
+    }
+    memcpy(buf, payload, length);
+    buf[length] = '\0';
+    char* end;
+    double celsius = strtod(buf, &end);
+    if (*end != '\0') {
+      _counters.malformed++;
+      return 0;
+    }
+    _counters.textsStored++;
+    IngestSample& o = out[0];
+    o.device = device;
+    o.bootId = 0;
+    o.sequence = INGEST_NO_SEQUENCE;
+    o.value = sampleFromCelsius(celsius);
+    o.source = SOURCE_TEXT;
+    o.estimated = 1;
+    o.epochMs = wallMs;
+    o.receivedNs = receivedNs;
+    return 1;
+  }
+
+public:
+  explicit IngestDecoder(DeviceRegistry& registry) : _registry(registry), _devices(registry.capacity()) {}
+
+  // Decode one message into `out` (room for INGEST_BATCH_MAX samples)
+  Result message(const char* topic, const uint8_t* payload, size_t length, uint64_t receivedNs, int64_t wallMs,
+                 IngestSample* out) {
+    Result result = { 0, -1, 0, 0 };
+    _counters.messages++;
+    _counters.bytes += length;
+
+    const char* id;
+    size_t idLength;
+    const char* leaf;
+    if (!strcmp(topic, MQTT_TOPIC_ROOT "/temperature")) {
+      id = INGEST_LEGACY_ID;
+      idLength = sizeof(INGEST_LEGACY_ID) - 1;
+      leaf = "temperature";
+    } else if (!splitTopic(topic, id, idLength, leaf)) {
+      _counters.ignored++;
+      return result;
+    }
+    bool isBatch = !strcmp(leaf, "batch");
+    if (!isBatch && strcmp(leaf, "temperature") != 0) {
+      _counters.ignored++;
+      return result;
+    }
+
+    int32_t device = _registry.find(id, idLength);
+    if (device < 0) {
+      _counters.malformed++;  // ID too long, or more devices than --max-devices
+      return result;
+    }
+    result.samples = isBatch ? batch(device, payload, length, receivedNs, wallMs, out, result)
+                             : text(device, payload, length, receivedNs, wallMs, out);
+    _counters.samples += result.samples;
+    return result;
+  }
+
+  const Counters& counters() const { return _counters; }
+};
+
+#endif // INGEST_DECODER_H
@@ -0,0 +1,96 @@
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <stdio.h>
+#include <string>
+#include "DeviceRegistry.h"
+#include "IngestDecoder.h"
+
+#define SAMPLE_LOG_BUFFER (1 << 20)
+
+// Append-only CSV of every stored sample, one file for the whole fleet
+//   device,boot,sequence,epoch_ms,celsius,flags
+// boot and sequence are empty for text readings; flags has 't' for a text reading
+// and 'e' when the time was estimated on arrival (device clock not synced).
+// Rows are formatted by hand into a large stdio buffer; flush() pushes them to
+// the kernel, which the storage thread does about once a second.
+class SampleLog {
+private:
+  FILE* _file = NULL;
+  uint64_t _rows = 0;
+  uint64_t _bytes = 0;
+
+  static char* putUnsigned(char* p, uint64_t v) {
+    char digits[20];
+    int n = 0;
+    do {
+      digits[n++] = '0' + v % 10;
+      v /= 10;
+    } while (v > 0);
+    while (n > 0) *p++ = digits[--n];
+    return p;
+  }
+
+public:
+  ~SampleLog() { close(); }
+
+  bool open(const std::string& path) {
+    _file = fopen(path.c_str(), "a");
+    if (_file == NULL) return false;
+    setvbuf(_file, NULL, _IOFBF, SAMPLE_LOG_BUFFER);
+    if (ftell(_file) == 0) fputs("device,boot,sequence,epoch_ms,celsius,flags\n", _file);
+    return true;
+  }
+
+  void append(const DeviceRegistry& registry, const IngestSample& s) {
+    char line[96];
+    char* p = line;
+    const char* name = registry.name(s.device);
+    while (*name) *p++ = *name++;
+    *p++ = ',';
+    if (s.source == SOURCE_BATCH) p = putUnsigned(p, s.bootId);
+    *p++ = ',';
+    if (s.sequence != INGEST_NO_SEQUENCE) p = putUnsigned(p, s.sequence);
+    *p++ = ',';
+    if (s.epochMs < 0) *p++ = '-';
+    p = putUnsigned(p, s.epochMs < 0 ? -s.epochMs : s.epochMs);
+    *p++ = ',';
+    if (s.value == SAMPLE_FAULT) {
+      memcpy(p, "nan", 3);
+      p += 3;
+    } else {
+      // Quarter degrees print exactly with two decimals
+      int32_t v = s.value;
+      if (v < 0) {
+        *p++ = '-';
+        v = -v;
+      }
+      p = putUnsigned(p, v / 4);
+      *p++ = '.';
+      static const char* quarters[] = { "00", "25", "50", "75" };
+      memcpy(p, quarters[v % 4], 2);
+      p += 2;
+    }
+    *p++ = ',';
+    if (s.source == SOURCE_TEXT) *p++ = 't';
+    if (s.estimated) *p++ = 'e';
+    *p++ = '\n';
+    fwrite(line, 1, p - line, _file);
+    _rows++;
+    _bytes += p - line;
+  }
+
+  void flush() {
+    if (_file != NULL) fflush(_file);
+  }
+
+  void close() {
+    if (_file != NULL) fclose(_file);
+    _file = NULL;
+  }
+
+  uint64_t rows() const { return _rows; }
+  uint64_t bytes() const { return _bytes; }
+};
+
+#endif // SAMPLE_LOG_H
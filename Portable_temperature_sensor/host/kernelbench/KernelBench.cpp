@@ -0,0 +1,384 @@
+// Benchmarks the column kernels (host/common/ColumnKernels.h) against the scalar path
+// Columns and device batches are encoded up front the way the store and the
+// firmware encode them: 1 Hz readings with some jitter, a slow random walk and
+// now and then a fault. Each kernel then runs over them at every level the CPU
+// has, best of several runs, a block of 1024 at a time into buffers that stay in
+// cache, as the reader uses them. The two decoders built on them run as well:
+//   varints      the time column (2-byte deltas) and the temp column (1-byte)
+//   zigzag       temperature deltas summed up into values
+//   prefix64     time deltas summed up into epoch ms
+//   rollup       min/max/sum/count of a column with faults
+//   block        decodeSeriesBlockFast() against decodeSeriesBlock()
+//   batch        decodeSampleBatchColumns() against decodeSampleBatch()
+// Before timing, every level is checked against the scalar reference on random
+// input built to hit the edges: every varint length, deltas past 32 bits, 16-bit
+// wrap-around, all-fault runs and lengths that leave vector tails.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "ColumnKernels.h"
+#include "CycleCounter.h"
+#include "SampleCodec.h"
+#include "SampleRing.h"
+#include "SeriesFormat.h"
+
+#define KERNELBENCH_START_MS 1788220800000LL  // 2026-09-01 00:00 UTC
+
+namespace {
+
+const char* USAGE =
+  "usage: kernelbench [options]\n"
+  "  --samples N         samples per column (default 1048576)\n"
+  "  --batch K           samples per device batch (default 16)\n"
+  "  --repeat N          timed runs per kernel, best one is reported (default 7)\n"
+  "  --checks N          random inputs checked per level (default 20000)\n";
+
+struct Settings {
+  uint32_t samples = 1 << 20;
+  uint32_t batch = 16;
+  int repeat = 7;
+  uint32_t checks = 20000;
+};
+
+uint64_t rng = 0x9E3779B97F4A7C15ULL;
+
+uint32_t next() {
+  rng ^= rng << 13;
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  return (uint32_t)rng;
+}
+
+struct VectorSink {
+  std::vector<uint8_t>& out;
+  void put(uint8_t b) { out.push_back(b); }
+};
+
+// A column of blocks as the store writes them
+struct Column {
+  std::vector<SeriesBlock> blocks;
+  std::vector<uint8_t> time;
+  std::vector<uint8_t> temp;
+  std::vector<int64_t> ms;
+  std::vector<int16_t> values;
+};
+
+void encodeBlocks(Column& c) {
+  uint32_t n = (uint32_t)c.ms.size();
+  ByteSink time(c.time);
+  ByteSink temp(c.temp);
+  for (uint32_t first = 0; first < n; first += SERIES_BLOCK_SAMPLES) {
+    SeriesBlock b;
+    memset(&b, 0, sizeof(b));
+    b.count = std::min<uint32_t>(SERIES_BLOCK_SAMPLES, n - first);
+    b.timeOffset = (uint32_t)c.time.size();
+    b.tempOffset = (uint32_t)c.temp.size();
+    b.firstMs = c.ms[first];
+    b.lastMs = c.ms[first + b.count - 1];
+    putVarint(time, (uint64_t)c.ms[first]);
+    putVarint(temp, zigzagEncode(c.values[first]));
+    for (uint32_t i = first + 1; i < first + b.count; i++) {
+      putVarint(time, (uint64_t)(c.ms[i] - c.ms[i - 1]));
+      putVarint(temp, zigzagEncode((int32_t)c.values[i] - c.values[i - 1]));
+    }
+    b.timeBytes = (uint32_t)c.time.size() - b.timeOffset;
+    b.tempBytes = (uint32_t)c.temp.size() - b.tempOffset;
+    c.blocks.push_back(b);
+  }
+}
+
+// 1 Hz with a few ms of jitter, a random walk around 25 °C, one fault in 2000
+Column readings(uint32_t n) {
+  Column c;
+  int64_t ms = KERNELBENCH_START_MS;
+  int16_t level = 100;
+  for (uint32_t i = 0; i < n; i++) {
+    ms += 990 + next() % 21;
+    level += (int16_t)(next() % 3) - 1;
+    c.ms.push_back(ms);
+    c.values.push_back(next() % 2000 == 0 ? SAMPLE_FAULT : level);
+  }
+  encodeBlocks(c);
+  return c;
+}
+
+// Random input for the checks: any mix of varint lengths and values
+Column edges(uint32_t n) {
+  Column c;
+  int64_t ms = (int64_t)(next() % 1000) << (next() % 40);
+  uint32_t style = next() % 4;
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t shift = style == 0 ? next() % 36 : style == 1 ? next() % 15 : style == 2 ? 9 : 0;
+    ms += (int64_t)(((uint64_t)next() << 4) & ((1ULL << shift) - 1));
+    c.ms.push_back(ms);
+    int16_t v = style == 3 && next() % 3 == 0 ? SAMPLE_FAULT : (int16_t)next();
+    if (style == 2) v = (int16_t)(c.values.empty() ? 0 : c.values.back() + (int16_t)(next() % 5) - 2);
+    c.values.push_back(v);
+  }
+  encodeBlocks(c);
+  return c;
+}
+
+// Samples in a ring, for the device encoder
+SampleRing<256> ringOf(const Column& c, uint32_t first, uint32_t count) {
+  SampleRing<256> ring;
+  for (uint32_t i = 0; i < count; i++) ring.push((uint32_t)c.ms[first + i], c.values[first + i]);
+  return ring;
+}
+
+std::vector<uint8_t> batchOf(const Column& c, uint32_t first, uint32_t count) {
+  SampleRing<256> ring = ringOf(c, first, count);
+  std::vector<uint8_t> payload;
+  VectorSink sink = { payload };
+  encodeSampleBatch(sink, ring, 0xB0070000, ring.tail(), count, 0);
+  return payload;
+}
+
+bool sameRollup(const SeriesRollup& a, const SeriesRollup& b) {
+  return a.sum == b.sum && a.count == b.count && a.valid == b.valid && a.min == b.min && a.max == b.max;
+}
+
+// One level against the scalar reference on a random input; false on a mismatch
+bool check(const ColumnKernels& k, uint32_t round) {
+  uint32_t n = round % 3 == 0 ? 1 + next() % SERIES_BLOCK_SAMPLES : 1 + next() % 40;
+  Column c = edges(n);
+  const SeriesBlock& b = c.blocks[0];
+
+  // Varints, each length and truncation
+  for (int column = 0; column < 2; column++) {
+    const std::vector<uint8_t>& bytes = column == 0 ? c.time : c.temp;
+    uint32_t cut = next() % 4 == 0 ? next() % (uint32_t)bytes.size() : (uint32_t)bytes.size();
+    std::vector<uint8_t> copy(bytes.begin(), bytes.begin() + cut);
+    std::vector<uint32_t> expected(n);
+    std::vector<uint32_t> got(n);
+    const uint8_t* pe = copy.data();
+    const uint8_t* pg = copy.data();
+    bool wideE = false;
+    bool wideG = false;
+    bool okE = varintsScalar(pe, copy.data() + copy.size(), expected.data(), n, wideE);
+    bool okG = k.varints(pg, copy.data() + copy.size(), got.data(), n, wideG);
+    if (okE != okG || (okE && (pe != pg || wideE != wideG || expected != got))) return false;
+  }
+
+  // Prefix sums, zigzag and plain
+  std::vector<uint32_t> in(n);
+  for (uint32_t& x : in) x = next() >> (next() % 32);
+  int16_t base16 = (int16_t)next();
+  std::vector<int16_t> e16(n), g16(n);
+  zigzagPrefix16Scalar(in.data(), n, base16, e16.data());
+  k.zigzagPrefix16(in.data(), n, base16, g16.data());
+  if (e16 != g16) return false;
+  std::vector<uint32_t> e32(n), g32(n);
+  uint32_t base32 = next();
+  prefix32Scalar(in.data(), n, base32, e32.data());
+  k.prefix32(in.data(), n, base32, g32.data());
+  if (e32 != g32) return false;
+  std::vector<int64_t> e64(n), g64(n);
+  int64_t base64 = (int64_t)next() << 20;
+  prefix64Scalar(in.data(), n, base64, e64.data());
+  k.prefix64(in.data(), n, base64, g64.data());
+  if (e64 != g64) return false;
+  uint32_t pairs = n / 2;
+  std::vector<uint32_t> eEven(pairs), eOdd(pairs), gEven(pairs), gOdd(pairs);
+  deinterleaveScalar(in.data(), pairs, eEven.data(), eOdd.data());
+  k.deinterleave(in.data(), pairs, gEven.data(), gOdd.data());
+  if (eEven != gEven || eOdd != gOdd) return false;
+
+  // Rollup, from a part of the column so runs start anywhere
+  uint32_t from = next() % n;
+  SeriesRollup eR, gR;
+  rollupScalar(c.values.data() + from, n - from, eR);
+  k.rollup(c.values.data() + from, n - from, gR);
+  if (!sameRollup(eR, gR)) return false;
+
+  // Block decode
+  std::vector<int64_t> eMs(n), gMs(n);
+  std::vector<int16_t> eV(n), gV(n);
+  bool okE = decodeSeriesBlock(b, c.time.data(), c.temp.data(), eMs.data(), eV.data());
+  bool okG = decodeSeriesBlockFast(b, c.time.data(), c.temp.data(), gMs.data(), gV.data(), k);
+  if (okE != okG || (okE && (eMs != gMs || eV != gV))) return false;
+
+  // Batch decode, of up to 256 samples as on the device
+  uint32_t count = std::min<uint32_t>(n, 256);
+  std::vector<uint8_t> payload = batchOf(c, 0, count);
+  if (next() % 4 == 0) payload.resize(next() % payload.size());
+  Sample expected[256];
+  uint32_t ms[256];
+  int16_t values[256];
+  uint32_t scratch[SAMPLE_BATCH_SCRATCH(256)];
+  SampleBatchHeader he, hg;
+  okE = decodeSampleBatch(payload.data(), payload.size(), he, expected, 256);
+  okG = decodeSampleBatchColumns(payload.data(), payload.size(), hg, ms, values, 256, scratch, k);
+  if (okE != okG) return false;
+  for (uint32_t i = 0; okE && i < he.count; i++) {
+    if (expected[i].ms != ms[i] || expected[i].value != values[i]) return false;
+  }
+  return true;
+}
+
+template <class F>
+double best(int repeat, F&& f) {
+  double best = 1e30;
+  for (int r = 0; r < repeat; r++) {
+    double start = monotonicSeconds();
+    f();
+    best = std::min(best, monotonicSeconds() - start);
+  }
+  return best;
+}
+
+volatile int64_t sink64;  // Keeps results alive
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    if (!strcmp(arg, "--help")) { fputs(USAGE, stdout); return 0; }
+    if (value == NULL) { fprintf(stderr, "kernelbench: bad argument '%s'\n%s", arg, USAGE); return 2; }
+    if (!strcmp(arg, "--samples")) settings.samples = (uint32_t)atoi(value);
+    else if (!strcmp(arg, "--batch")) settings.batch = (uint32_t)atoi(value);
+    else if (!strcmp(arg, "--repeat")) settings.repeat = atoi(value);
+    else if (!strcmp(arg, "--checks")) settings.checks = (uint32_t)atoi(value);
+    else { fprintf(stderr, "kernelbench: bad argument '%s'\n%s", arg, USAGE); return 2; }
+    i++;
+  }
+  if (settings.samples < 1 || settings.batch < 1 || settings.batch > 256 || settings.repeat < 1) {
+    fprintf(stderr, "%s", USAGE);
+    return 2;
+  }
+
+  std::vector<const ColumnKernels*> levels;
+  for (KernelLevel level : { KERNEL_SCALAR, KERNEL_SSE4, KERNEL_AVX2 }) {
+    if (kernelLevelSupported(level)) levels.push_back(&columnKernels(level));
+  }
+  printf("kernelbench: levels");
+  for (const ColumnKernels* k : levels) printf(" %s", k->name);
+  printf(", best %s\n", columnKernels().name);
+
+  bool ok = true;
+  for (const ColumnKernels* k : levels) {
+    uint32_t failed = 0;
+    for (uint32_t r = 0; r < settings.checks; r++) failed += !check(*k, r);
+    printf("kernelbench: %-7s %u random inputs, %u differ from the scalar reference\n", k->name, settings.checks,
+           failed);
+    ok = ok && failed == 0;
+  }
+
+  uint32_t n = settings.samples;
+  Column c = readings(n);
+  std::vector<std::vector<uint8_t>> batches;
+  for (uint32_t first = 0; first + settings.batch <= n && batches.size() < 65536; first += settings.batch) {
+    batches.push_back(batchOf(c, first, settings.batch));
+  }
+  uint32_t batchSamples = (uint32_t)batches.size() * settings.batch;
+  printf("kernelbench: %u samples in %zu blocks, time %.2f bytes/sample, temp %.2f bytes/sample; "
+         "%zu batches of %u\n",
+         n, c.blocks.size(), (double)c.time.size() / n, (double)c.temp.size() / n, batches.size(), settings.batch);
+
+  uint32_t raw[SERIES_BLOCK_SAMPLES];
+  int64_t ms[SERIES_BLOCK_SAMPLES];
+  int16_t values[SERIES_BLOCK_SAMPLES];
+  std::vector<uint32_t> deltas(n);
+  for (uint32_t i = 1; i < n; i++) deltas[i] = (uint32_t)(c.ms[i] - c.ms[i - 1]);
+  std::vector<uint32_t> zigzags(n);
+  for (uint32_t i = 0; i < n; i++) zigzags[i] = zigzagEncode((int32_t)c.values[i] - (i > 0 ? c.values[i - 1] : 0));
+
+  const char* names[] = { "varints time", "varints temp", "zigzag", "prefix64", "rollup", "block", "batch" };
+  const int rows = 7;
+  double scalar[rows] = {};
+  printf("\n%-14s", "ns/sample");
+  for (const ColumnKernels* k : levels) printf("  %16s", k->name);
+  printf("\n");
+  std::vector<std::vector<double>> table(rows);
+
+  for (const ColumnKernels* k : levels) {
+    std::vector<double> t(rows);
+    t[0] = best(settings.repeat, [&] {
+      int64_t total = 0;
+      for (const SeriesBlock& b : c.blocks) {
+        const uint8_t* p = c.time.data() + b.timeOffset;
+        bool wide = false;
+        k->varints(p, p + b.timeBytes, raw, b.count, wide);
+        total += raw[b.count - 1];
+      }
+      sink64 = total;
+    });
+    t[1] = best(settings.repeat, [&] {
+      int64_t total = 0;
+      for (const SeriesBlock& b : c.blocks) {
+        const uint8_t* p = c.temp.data() + b.tempOffset;
+        bool wide = false;
+        k->varints(p, p + b.tempBytes, raw, b.count, wide);
+        total += raw[b.count - 1];
+      }
+      sink64 = total;
+    });
+    t[2] = best(settings.repeat, [&] {
+      int64_t total = 0;
+      for (uint32_t i = 0; i < n; i += SERIES_BLOCK_SAMPLES) {
+        uint32_t count = std::min<uint32_t>(SERIES_BLOCK_SAMPLES, n - i);
+        k->zigzagPrefix16(zigzags.data() + i, count, 0, values);
+        total += values[count - 1];
+      }
+      sink64 = total;
+    });
+    t[3] = best(settings.repeat, [&] {
+      int64_t total = 0;
+      for (uint32_t i = 0; i < n; i += SERIES_BLOCK_SAMPLES) {
+        uint32_t count = std::min<uint32_t>(SERIES_BLOCK_SAMPLES, n - i);
+        k->prefix64(deltas.data() + i, count, 0, ms);
+        total += ms[count - 1];
+      }
+      sink64 = total;
+    });
+    t[4] = best(settings.repeat, [&] {
+      SeriesRollup r;
+      for (uint32_t i = 0; i < n; i += SERIES_BLOCK_SAMPLES) {
+        k->rollup(c.values.data() + i, std::min<uint32_t>(SERIES_BLOCK_SAMPLES, n - i), r);
+      }
+      sink64 = r.sum;
+    });
+    t[5] = best(settings.repeat, [&] {
+      int64_t total = 0;
+      for (const SeriesBlock& b : c.blocks) {
+        if (k->level == KERNEL_SCALAR) decodeSeriesBlock(b, c.time.data(), c.temp.data(), ms, values);
+        else decodeSeriesBlockFast(b, c.time.data(), c.temp.data(), ms, values, *k);
+        total += ms[b.count - 1] + values[b.count - 1];
+      }
+      sink64 = total;
+    });
+    t[6] = best(settings.repeat, [&] {
+      Sample samples[256];
+      uint32_t bms[256];
+      int16_t bvalues[256];
+      uint32_t scratch[SAMPLE_BATCH_SCRATCH(256)];
+      SampleBatchHeader header;
+      int64_t total = 0;
+      for (const std::vector<uint8_t>& p : batches) {
+        if (k->level == KERNEL_SCALAR) {
+          decodeSampleBatch(p.data(), p.size(), header, samples, 256);
+          total += samples[header.count - 1].value;
+        } else {
+          decodeSampleBatchColumns(p.data(), p.size(), header, bms, bvalues, 256, scratch, *k);
+          total += bvalues[header.count - 1];
+        }
+      }
+      sink64 = total;
+    });
+    for (int r = 0; r < rows; r++) table[r].push_back(t[r] * 1e9 / (r == 6 ? batchSamples : n));
+  }
+  for (int r = 0; r < rows; r++) {
+    scalar[r] = table[r][0];
+    printf("%-14s", names[r]);
+    for (size_t l = 0; l < levels.size(); l++) {
+      printf("  %7.3f (%5.2fx)", table[r][l], scalar[r] / table[r][l]);
+    }
+    printf("\n");
+  }
+  printf("\nkernelbench: results %s the scalar reference\n", ok ? "identical to" : "DIFFER from");
+  return ok ? 0 : 1;
+}
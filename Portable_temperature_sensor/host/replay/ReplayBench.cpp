@@ -0,0 +1,402 @@
+// Replays recorded log-mode captures through the firmware's sample pipeline
+// Each trace is parsed once into memory, then the stages the firmware runs on a
+// fresh reading are replayed over the whole trace, one stage at a time and as
+// fast as the host goes:
+//   parse    log line -> reading (host side; what the serial collector does)
+//   acquire  sampleFromCelsius() and SampleRing::push(), as in queueSample()
+//   filter   the trend window's SlidingMinMax, as behind trendWidget.push()
+//   alarm    AlarmEngine::update(), as in acquireSample()
+//   encode   encodeSampleBatch() in SAMPLE_BATCH_MAX batches, as in deliverSamples()
+//   text     the "%.1f" payload of the temperature topic, as in publishSamples()
+// The best of several runs is reported per stage, then an untimed pass counts the
+// alarm decisions and encoded sizes and hashes both, so two builds can be
+// compared for speed and for identical behaviour on the same production data.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "AlarmEngine.h"
+#include "CycleCounter.h"
+#include "LogLine.h"
+#include "SampleCodec.h"
+#include "SampleRing.h"
+#include "SlidingMinMax.h"
+
+#define REPLAY_RING_CAPACITY 512  // SAMPLE_RING_CAPACITY in main.cpp
+#define REPLAY_BATCH_MAX 256      // SAMPLE_BATCH_MAX in main.cpp
+#define REPLAY_TREND_WIDTH 30     // trendWidget in main.cpp
+
+namespace {
+
+const char* USAGE =
+  "usage: replay [options] TRACE.csv...\n"
+  "  --repeat N          timed runs per trace, best one is reported (default 5)\n"
+  "  --setpoint C        alarm level 1 (default 80, thresholdTemp in main.cpp)\n"
+  "  --alarm L:C         alarm level 2 or 3 at C\n"
+  "  --hysteresis C      alarm hysteresis (default 1)\n"
+  "  --ror C             rate-of-rise limit in °C/s (default off)\n"
+  "  --batch N           samples per encoded batch (default 256)\n";
+
+enum StageId { STAGE_PARSE, STAGE_ACQUIRE, STAGE_FILTER, STAGE_ALARM, STAGE_ENCODE, STAGE_TEXT, STAGE_COUNT };
+const char* STAGE_NAMES[STAGE_COUNT] = { "parse", "acquire", "filter", "alarm", "encode", "text" };
+
+struct Reading {
+  uint32_t ms;     // Since the first line of the trace, wraps like millis()
+  double celsius;  // What readCelsius() returned, NAN on a fault
+};
+
+struct Trace {
+  std::string path;
+  std::string text;
+  std::vector<Reading> readings;
+  std::vector<Sample> samples;
+  int64_t firstSeconds = 0;
+  uint32_t lines = 0;
+  uint32_t skipped = 0;
+};
+
+struct Settings {
+  int16_t thresholds[ALARM_LEVELS] = { 320, ALARM_LEVEL_OFF, ALARM_LEVEL_OFF };
+  int16_t hysteresis = 4;
+  int16_t rorLimit = 0;
+  uint32_t batch = REPLAY_BATCH_MAX;
+  int repeat = 5;
+};
+
+// The whole trace seen as a ring, positions are sample indexes
+class TraceRing {
+private:
+  const std::vector<Sample>& _samples;
+
+public:
+  TraceRing(const std::vector<Sample>& samples) : _samples(samples) {}
+  const Sample& at(uint32_t seq) const { return _samples[seq]; }
+};
+
+// Encoder output into a preallocated buffer
+class BufferSink {
+private:
+  uint8_t* _data;
+  size_t _length = 0;
+
+public:
+  BufferSink(uint8_t* data) : _data(data) {}
+  void put(uint8_t b) { _data[_length++] = b; }
+  size_t length() const { return _length; }
+  const uint8_t* data() const { return _data; }
+};
+
+// FNV-1a, to fingerprint decisions and payloads
+struct Digest {
+  uint64_t value = 0xcbf29ce484222325ULL;
+  void add(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) value = (value ^ data[i]) * 0x100000001b3ULL;
+  }
+  void add(uint32_t v) { add((const uint8_t*)&v, sizeof(v)); }
+};
+
+volatile uint64_t sinkHole;  // Keeps results of the timed passes alive
+
+bool readFile(const char* path, std::string& text) {
+  FILE* f = fopen(path, "rb");
+  if (f == NULL) return false;
+  char buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+AlarmEngine makeEngine(const Settings& settings) {
+  AlarmEngine engine;
+  for (uint8_t level = 1; level <= ALARM_LEVELS; level++) engine.setThreshold(level, settings.thresholds[level - 1]);
+  engine.setHysteresis(settings.hysteresis);
+  engine.setRateOfRiseLimit(settings.rorLimit);
+  return engine;
+}
+
+size_t batchBufferSize(uint32_t batch) {
+  return 3 + 4 * 10 + (size_t)batch * 8;  // Header varints, then at most 5 + 3 bytes per sample
+}
+
+// parse: split lines and decode them into readings
+void parseStage(Trace& trace) {
+  trace.readings.clear();
+  trace.lines = 0;
+  trace.skipped = 0;
+  const char* p = trace.text.data();
+  const char* end = p + trace.text.size();
+  bool first = true;
+  while (p < end) {
+    const char* eol = (const char*)memchr(p, '\n', end - p);
+    if (eol == NULL) eol = end;
+    size_t length = eol - p;
+    if (length > 0 && p[length - 1] == '\r') length--;
+    trace.lines++;
+    LogRecord record;
+    if (parseLogLine(p, length, record)) {
+      int64_t seconds = logRecordSeconds(record);
+      if (first) trace.firstSeconds = seconds;
+      first = false;
+      uint32_t ms = (uint32_t)((seconds - trace.firstSeconds) * 1000);
+      trace.readings.push_back({ ms, record.fault ? NAN : record.centi / 100.0 });
+    } else if (length > 0) {
+      trace.skipped++;
+    }
+    p = eol + 1;
+  }
+}
+
+// acquire: fixed point conversion and the delivery ring; the samples are also
+// kept for the later stages, which the firmware's ring would long have dropped
+void acquireStage(Trace& trace, SampleRing<REPLAY_RING_CAPACITY>& ring) {
+  trace.samples.resize(trace.readings.size());
+  Sample* out = trace.samples.data();
+  for (const Reading& r : trace.readings) {
+    int16_t value = sampleFromCelsius(r.celsius);
+    ring.push(r.ms, value);
+    out->ms = r.ms;
+    out->value = value;
+    out++;
+  }
+  sinkHole = ring.head();
+}
+
+// filter: the sparkline's sliding window and the extremes it scales to
+void filterStage(const Trace& trace) {
+  SlidingMinMax<REPLAY_TREND_WIDTH> window;
+  int32_t sum = 0;
+  for (const Sample& s : trace.samples) {
+    window.push(s.value);
+    if (window.valid()) sum += window.max() - window.min();
+  }
+  sinkHole = sum;
+}
+
+void alarmStage(const Trace& trace, const Settings& settings) {
+  AlarmEngine engine = makeEngine(settings);
+  uint32_t changes = 0;
+  for (const Sample& s : trace.samples) changes += engine.update(s.ms, s.value);
+  sinkHole = changes;
+}
+
+void encodeStage(const Trace& trace, const Settings& settings, uint8_t* buffer) {
+  TraceRing ring(trace.samples);
+  uint64_t epochMs = (uint64_t)trace.firstSeconds * 1000;
+  size_t bytes = 0;
+  uint32_t n = (uint32_t)trace.samples.size();
+  for (uint32_t first = 0; first < n; first += settings.batch) {
+    uint32_t count = n - first < settings.batch ? n - first : settings.batch;
+    BufferSink sink(buffer);
+    encodeSampleBatch(sink, ring, 0, first, count, epochMs + trace.samples[first].ms);
+    bytes += sink.length();
+  }
+  sinkHole = bytes;
+}
+
+void textStage(const Trace& trace) {
+  char buf[16];
+  size_t bytes = 0;
+  for (const Sample& s : trace.samples) bytes += snprintf(buf, sizeof(buf), "%.1f", sampleToCelsius(s.value));
+  sinkHole = bytes;
+}
+
+struct Totals {
+  uint64_t lines = 0;
+  uint64_t skipped = 0;
+  uint64_t samples = 0;
+  uint64_t faults = 0;
+  double seconds = 0;             // Trace time covered
+  uint64_t best[STAGE_COUNT] = {};
+  double bestHostSeconds = 0;
+
+  // Alarm decisions
+  uint32_t transitions = 0;
+  uint32_t levelEntries[ALARM_LEVELS] = {};
+  uint32_t rorEntries = 0;
+  uint64_t samplesActive = 0;
+  Digest decisions;
+
+  // Encoded sizes
+  uint64_t batchBytes = 0;
+  uint32_t batches = 0;
+  uint32_t largestBatch = 0;
+  uint64_t textBytes = 0;
+  Digest payload;
+};
+
+// Untimed pass over the trace: what the pipeline decided and produced
+void analyse(const Trace& trace, const Settings& settings, uint8_t* buffer, Totals& totals) {
+  AlarmEngine engine = makeEngine(settings);
+  uint8_t level = 0;
+  bool rateOfRise = false;
+  for (uint32_t i = 0; i < trace.samples.size(); i++) {
+    const Sample& s = trace.samples[i];
+    totals.faults += s.value == SAMPLE_FAULT;
+    if (engine.update(s.ms, s.value)) {
+      totals.transitions++;
+      if (engine.level() > level) {
+        for (uint8_t l = level; l < engine.level(); l++) totals.levelEntries[l]++;
+      }
+      if (engine.rateOfRise() && !rateOfRise) totals.rorEntries++;
+      level = engine.level();
+      rateOfRise = engine.rateOfRise();
+      totals.decisions.add(i);
+      totals.decisions.add((uint32_t)level << 1 | rateOfRise);
+    }
+    totals.samplesActive += engine.active();
+  }
+
+  TraceRing ring(trace.samples);
+  uint64_t epochMs = (uint64_t)trace.firstSeconds * 1000;
+  uint32_t n = (uint32_t)trace.samples.size();
+  for (uint32_t first = 0; first < n; first += settings.batch) {
+    uint32_t count = n - first < settings.batch ? n - first : settings.batch;
+    BufferSink sink(buffer);
+    encodeSampleBatch(sink, ring, 0, first, count, epochMs + trace.samples[first].ms);
+    if (sink.length() != sampleBatchSize(ring, 0, first, count, epochMs + trace.samples[first].ms)) {
+      fprintf(stderr, "replay: %s: batch at %u sized differently than encoded\n", trace.path.c_str(), first);
+    }
+    totals.batchBytes += sink.length();
+    totals.batches++;
+    if (sink.length() > totals.largestBatch) totals.largestBatch = (uint32_t)sink.length();
+    totals.payload.add(sink.data(), sink.length());
+  }
+
+  char buf[16];
+  for (const Sample& s : trace.samples) totals.textBytes += snprintf(buf, sizeof(buf), "%.1f", sampleToCelsius(s.value));
+}
+
+void replay(Trace& trace, const Settings& settings, Totals& totals) {
+  std::vector<uint8_t> buffer(batchBufferSize(settings.batch));
+  SampleRing<REPLAY_RING_CAPACITY> ring;
+  uint64_t best[STAGE_COUNT];
+  for (int s = 0; s < STAGE_COUNT; s++) best[s] = UINT64_MAX;
+  double bestHost = 1e30;
+
+  for (int run = 0; run < settings.repeat; run++) {
+    uint64_t t[STAGE_COUNT + 1];
+    double hostStart = monotonicSeconds();
+    t[0] = cycleCount();
+    parseStage(trace);
+    t[1] = cycleCount();
+    acquireStage(trace, ring);
+    t[2] = cycleCount();
+    filterStage(trace);
+    t[3] = cycleCount();
+    alarmStage(trace, settings);
+    t[4] = cycleCount();
+    encodeStage(trace, settings, buffer.data());
+    t[5] = cycleCount();
+    textStage(trace);
+    t[6] = cycleCount();
+    double host = monotonicSeconds() - hostStart;
+    for (int s = 0; s < STAGE_COUNT; s++) {
+      if (t[s + 1] - t[s] < best[s]) best[s] = t[s + 1] - t[s];
+    }
+    if (host < bestHost) bestHost = host;
+  }
+
+  for (int s = 0; s < STAGE_COUNT; s++) totals.best[s] += best[s];
+  totals.bestHostSeconds += bestHost;
+  totals.lines += trace.lines;
+  totals.skipped += trace.skipped;
+  totals.samples += trace.samples.size();
+  if (!trace.samples.empty()) totals.seconds += trace.samples.back().ms / 1000.0;
+  analyse(trace, settings, buffer.data(), totals);
+}
+
+void report(const Totals& totals, const Settings& settings, size_t traces) {
+  double samples = totals.samples > 0 ? (double)totals.samples : 1.0;
+  printf("replay: %zu traces, %llu lines (%llu skipped), %llu samples (%llu faults) covering %.1f hours\n", traces,
+         (unsigned long long)totals.lines, (unsigned long long)totals.skipped, (unsigned long long)totals.samples,
+         (unsigned long long)totals.faults, totals.seconds / 3600);
+  printf("replay: best of %d runs %.3fs, %.2fM samples/s\n", settings.repeat, totals.bestHostSeconds,
+         totals.bestHostSeconds > 0 ? totals.samples / totals.bestHostSeconds / 1e6 : 0.0);
+
+  uint64_t all = 0;
+  for (int s = 0; s < STAGE_COUNT; s++) all += totals.best[s];
+  printf("replay: %-8s %10s/sample %6s\n", "stage", cycleUnit(), "share");
+  for (int s = 0; s < STAGE_COUNT; s++) {
+    printf("replay: %-8s %17.1f %5.1f%%\n", STAGE_NAMES[s], totals.best[s] / samples,
+           all > 0 ? 100.0 * totals.best[s] / all : 0.0);
+  }
+
+  printf("replay: alarm setpoint %.2fC", settings.thresholds[0] * 0.25);
+  for (int l = 1; l < ALARM_LEVELS; l++) {
+    if (settings.thresholds[l] != ALARM_LEVEL_OFF) printf(", level %d %.2fC", l + 1, settings.thresholds[l] * 0.25);
+  }
+  printf(", hysteresis %.2fC, rate-of-rise ", settings.hysteresis * 0.25);
+  if (settings.rorLimit > 0) printf("%.2fC/s\n", settings.rorLimit * 0.25);
+  else printf("off\n");
+  printf("replay: alarm %u transitions, entered level", totals.transitions);
+  for (int l = 0; l < ALARM_LEVELS; l++) printf(" %d: %ux", l + 1, totals.levelEntries[l]);
+  printf(", rate-of-rise %ux, active %.2f%% of samples, digest %016llx\n", totals.rorEntries,
+         100.0 * totals.samplesActive / samples, (unsigned long long)totals.decisions.value);
+
+  printf("replay: encode %u batches of up to %u, %llu bytes (%.3f bytes/sample, largest %u), digest %016llx\n",
+         totals.batches, settings.batch, (unsigned long long)totals.batchBytes, totals.batchBytes / samples,
+         totals.largestBatch, (unsigned long long)totals.payload.value);
+  printf("replay: text %llu bytes (%.3f bytes/sample)\n", (unsigned long long)totals.textBytes,
+         totals.textBytes / samples);
+}
+
+// False outside the MAX6675's range, as the firmware's commands reject it
+bool celsiusToSample(const char* text, int16_t& value) {
+  double celsius = atof(text);
+  if (!sampleCelsiusInRange(celsius)) return false;
+  value = sampleFromCelsius(celsius);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings;
+  std::vector<const char*> paths;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    bool ok = true;
+    if (!strcmp(arg, "--help")) { fputs(USAGE, stdout); return 0; }
+    else if (arg[0] != '-') { paths.push_back(arg); continue; }
+    else if (value == NULL) ok = false;
+    else if (!strcmp(arg, "--repeat")) { settings.repeat = atoi(value); i++; }
+    else if (!strcmp(arg, "--setpoint")) { ok = celsiusToSample(value, settings.thresholds[0]); i++; }
+    else if (!strcmp(arg, "--alarm")) {
+      int level = atoi(value);
+      const char* colon = strchr(value, ':');
+      ok = colon != NULL && level >= 2 && level <= ALARM_LEVELS;
+      if (ok) ok = celsiusToSample(colon + 1, settings.thresholds[level - 1]);
+      i++;
+    }
+    else if (!strcmp(arg, "--hysteresis")) { ok = celsiusToSample(value, settings.hysteresis); i++; }
+    else if (!strcmp(arg, "--ror")) { ok = celsiusToSample(value, settings.rorLimit); i++; }
+    else if (!strcmp(arg, "--batch")) { settings.batch = (uint32_t)atoi(value); i++; }
+    else ok = false;
+    if (!ok || settings.repeat < 1 || settings.batch < 1) {
+      fprintf(stderr, "replay: bad argument '%s'\n%s", arg, USAGE);
+      return 2;
+    }
+  }
+  if (paths.empty()) {
+    fputs(USAGE, stderr);
+    return 2;
+  }
+
+  Totals totals;
+  for (const char* path : paths) {
+    Trace trace;
+    trace.path = path;
+    if (!readFile(path, trace.text)) {
+      fprintf(stderr, "replay: cannot read %s\n", path);
+      return 1;
+    }
+    replay(trace, settings, totals);
+  }
+  report(totals, settings, paths.size());
+  return 0;
+}
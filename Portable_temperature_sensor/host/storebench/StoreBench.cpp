@@ -0,0 +1,310 @@
+// Benchmarks the gateway's time-series store (host/common/Series*.h)
+// Loads a synthetic fleet, by default a month of 1 Hz readings from 100 devices,
+// through SeriesStore the way the gateway's storage thread would: a second of
+// every device at a time. Then it maps the store with SeriesReader and times the
+// trend queries, best of several runs with a warm page cache:
+//   scan     every sample of a range, decoded from the columns
+//   rollup   min/max/mean per bucket; whole minutes come from the .minute records
+//   raw      the same rollup decoded from the columns, to show what those save
+// The minute and raw rollups are compared bucket by bucket, and the scans are
+// checked against the samples that were loaded.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "CycleCounter.h"
+#include "SeriesReader.h"
+#include "SeriesStore.h"
+
+#define STOREBENCH_START_MS 1788220800000LL  // 2026-09-01 00:00 UTC
+#define STOREBENCH_HOUR_MS 3600000LL
+#define STOREBENCH_DAY_MS 86400000LL
+
+namespace {
+
+const char* USAGE =
+  "usage: storebench [options]\n"
+  "  --dir DIR           store directory, emptied first (default storebench-data)\n"
+  "  --devices N         devices (default 100)\n"
+  "  --days D            days of readings per device (default 30)\n"
+  "  --interval MS       ms between readings (default 1000)\n"
+  "  --repeat N          timed runs per query, best one is reported (default 5)\n"
+  "  --log               load through the write-ahead log, as the gateway does\n"
+  "  --reuse             query the store already in DIR instead of loading one\n";
+
+struct Settings {
+  std::string dir = "storebench-data";
+  uint32_t devices = 100;
+  double days = 30;
+  uint32_t interval = 1000;
+  int repeat = 5;
+  bool log = false;
+  bool reuse = false;
+};
+
+// A sensor on something that warms up by day: a daily swing around its own base,
+// a random walk for noise, and now and then an open thermocouple
+struct Profile {
+  uint64_t rng;
+  double base;
+  double walk = 0;
+  int64_t ms;
+
+  Profile(uint32_t device, int64_t start) : rng(0x9E3779B97F4A7C15ULL * (device + 1)), ms(start + device % 1000) {
+    base = 18 + (next() % 4000) / 100.0;
+  }
+
+  uint32_t next() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return (uint32_t)(rng >> 32);
+  }
+
+  int16_t step(uint32_t interval) {
+    ms += interval + next() % 5;  // Loop timing jitter on the device
+    walk += ((int)(next() % 3) - 1) * 0.05;
+    walk *= 0.999;
+    if (next() % 200000 == 0) return SAMPLE_FAULT;
+    double phase = (ms % STOREBENCH_DAY_MS) * (2 * M_PI / STOREBENCH_DAY_MS);
+    return sampleFromCelsius(base + 6 * sin(phase) + walk);
+  }
+};
+
+void removeTree(const std::string& path) {
+  std::string command = "rm -rf '" + path + "'";
+  if (system(command.c_str()) != 0) fprintf(stderr, "storebench: could not empty %s\n", path.c_str());
+}
+
+uint64_t directoryBytes(const std::string& path) {
+  uint64_t total = 0;
+  if (DIR* d = opendir(path.c_str())) {
+    while (struct dirent* e = readdir(d)) {
+      if (e->d_name[0] == '.') continue;
+      std::string child = path + "/" + e->d_name;
+      struct stat st;
+      if (stat(child.c_str(), &st) != 0) continue;
+      total += S_ISDIR(st.st_mode) ? directoryBytes(child) : (uint64_t)st.st_size;
+    }
+    closedir(d);
+  }
+  return total;
+}
+
+bool load(const Settings& settings, uint64_t& loaded, int64_t& sum) {
+  removeTree(settings.dir);
+  SeriesStore store(settings.devices);
+  if (!store.open(settings.dir, settings.log)) {
+    fprintf(stderr, "storebench: %s\n", store.error().c_str());
+    return false;
+  }
+  std::vector<Profile> profiles;
+  for (uint32_t d = 0; d < settings.devices; d++) {
+    char id[16];
+    snprintf(id, sizeof(id), "%06X", 0x100000 + d);
+    if (store.device(id, strlen(id)) != (int32_t)d) {
+      fprintf(stderr, "storebench: cannot add device %s\n", id);
+      return false;
+    }
+    profiles.emplace_back(d, STOREBENCH_START_MS);
+  }
+
+  uint64_t readings = (uint64_t)(settings.days * STOREBENCH_DAY_MS / settings.interval);
+  double start = monotonicSeconds();
+  for (uint64_t r = 0; r < readings; r++) {
+    for (uint32_t d = 0; d < settings.devices; d++) {
+      Profile& p = profiles[d];
+      int16_t value = p.step(settings.interval);
+      if (!store.append(d, p.ms, value)) {
+        fprintf(stderr, "storebench: %s\n", store.error().c_str());
+        return false;
+      }
+      if (value != SAMPLE_FAULT) sum += value;
+    }
+    if (!store.commit()) {
+      fprintf(stderr, "storebench: %s\n", store.error().c_str());
+      return false;
+    }
+  }
+  if (!store.close()) {
+    fprintf(stderr, "storebench: %s\n", store.error().c_str());
+    return false;
+  }
+  double seconds = monotonicSeconds() - start;
+  loaded = readings * settings.devices;
+
+  const SeriesStore::Counters& c = store.counters();
+  uint64_t disk = directoryBytes(settings.dir);
+  printf("storebench: loaded %llu samples in %.2fs, %.2fM samples/s%s\n", (unsigned long long)loaded, seconds,
+         loaded / seconds / 1e6, settings.log ? " through the log" : "");
+  printf("storebench: %llu blocks, columns %.3f bytes/sample, on disk %.3f bytes/sample (%.1f MB), %llu clamped\n",
+         (unsigned long long)c.blocks, (double)c.columnBytes / loaded, (double)disk / loaded, disk / 1e6,
+         (unsigned long long)c.clamped);
+  return true;
+}
+
+// Time `run` and report it against the samples the query covers
+template <class Run>
+void timeQuery(const Settings& settings, const char* name, uint64_t covered, Run&& run) {
+  double best = 1e30;
+  for (int i = 0; i < settings.repeat; i++) {
+    double start = monotonicSeconds();
+    run();
+    best = std::min(best, monotonicSeconds() - start);
+  }
+  printf("storebench: %-32s %12llu samples %10.3fms %8.2fns/sample %9.1fM samples/s\n", name,
+         (unsigned long long)covered, best * 1e3, best * 1e9 / std::max<uint64_t>(covered, 1),
+         covered / best / 1e6);
+}
+
+bool sameRollups(const std::vector<SeriesRollup>& a, const std::vector<SeriesRollup>& b) {
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].count != b[i].count || a[i].valid != b[i].valid || a[i].sum != b[i].sum || a[i].min != b[i].min ||
+        a[i].max != b[i].max) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    if (!strcmp(arg, "--help")) { fputs(USAGE, stdout); return 0; }
+    else if (!strcmp(arg, "--log")) { settings.log = true; continue; }
+    else if (!strcmp(arg, "--reuse")) { settings.reuse = true; continue; }
+    if (value == NULL) { fprintf(stderr, "storebench: bad argument '%s'\n%s", arg, USAGE); return 2; }
+    if (!strcmp(arg, "--dir")) settings.dir = value;
+    else if (!strcmp(arg, "--devices")) settings.devices = (uint32_t)atoi(value);
+    else if (!strcmp(arg, "--days")) settings.days = atof(value);
+    else if (!strcmp(arg, "--interval")) settings.interval = (uint32_t)atoi(value);
+    else if (!strcmp(arg, "--repeat")) settings.repeat = atoi(value);
+    else { fprintf(stderr, "storebench: bad argument '%s'\n%s", arg, USAGE); return 2; }
+    i++;
+  }
+  if (settings.devices == 0 || settings.days <= 0 || settings.interval == 0 || settings.repeat < 1) {
+    fprintf(stderr, "%s", USAGE);
+    return 2;
+  }
+
+  uint64_t loaded = 0;
+  int64_t loadedSum = 0;
+  if (!settings.reuse && !load(settings, loaded, loadedSum)) return 1;
+
+  SeriesReader reader;
+  double start = monotonicSeconds();
+  if (!reader.open(settings.dir)) {
+    fprintf(stderr, "storebench: %s\n", reader.error().c_str());
+    return 1;
+  }
+  double openSeconds = monotonicSeconds() - start;
+  uint32_t devices = reader.size();
+  uint64_t samples = 0;
+  int64_t first = INT64_MAX;
+  int64_t last = INT64_MIN;
+  for (uint32_t d = 0; d < devices; d++) {
+    samples += reader.device(d).samples;
+    first = std::min(first, reader.device(d).firstMs);
+    last = std::max(last, reader.device(d).lastMs);
+  }
+  if (samples == 0) {
+    fprintf(stderr, "storebench: %s holds no samples\n", settings.dir.c_str());
+    return 1;
+  }
+  printf("storebench: opened %u devices, %llu samples, %.1f MB mapped in %.3fms\n", devices,
+         (unsigned long long)samples, reader.mappedBytes() / 1e6, openSeconds * 1e3);
+
+  // Whole hours from the first one all devices have reached
+  int64_t from = seriesFloor(first, STOREBENCH_HOUR_MS) + STOREBENCH_HOUR_MS;
+  int64_t to = seriesFloor(last, STOREBENCH_HOUR_MS);
+  if (to - from < STOREBENCH_DAY_MS) {
+    fprintf(stderr, "storebench: needs at least a day of readings\n");
+    return 1;
+  }
+  double perMs = (double)samples / (last - first);
+  int64_t sink = 0;
+  auto add = [&sink](int64_t, int16_t value) { sink += value; };
+
+  timeQuery(settings, "scan 1 h, 1 device", (uint64_t)(STOREBENCH_HOUR_MS * perMs / devices),
+            [&] { reader.scan(0, to - STOREBENCH_HOUR_MS, to, add); });
+  timeQuery(settings, "scan 1 day, all devices", (uint64_t)(STOREBENCH_DAY_MS * perMs), [&] {
+    for (uint32_t d = 0; d < devices; d++) reader.scan(d, to - STOREBENCH_DAY_MS, to, add);
+  });
+
+  uint64_t scanned = 0;
+  int64_t scannedSum = 0;
+  timeQuery(settings, "scan everything", samples, [&] {
+    scanned = 0;
+    scannedSum = 0;
+    for (uint32_t d = 0; d < devices; d++) {
+      scanned += reader.scan(d, INT64_MIN, INT64_MAX, [&scannedSum](int64_t, int16_t value) {
+        if (value != SAMPLE_FAULT) scannedSum += value;
+      });
+    }
+  });
+
+  uint64_t covered = (uint64_t)((to - from) * perMs);
+  std::vector<SeriesRollup> minutes((to - from) / SERIES_MINUTE_MS);
+  std::vector<SeriesRollup> hours((to - from) / STOREBENCH_HOUR_MS);
+  std::vector<SeriesRollup> raw(minutes.size());
+  std::vector<SeriesRollup> fleet(minutes.size());
+  bool agree = true;
+
+  timeQuery(settings, "rollup 1 min, 1 device", covered / devices, [&] {
+    std::fill(minutes.begin(), minutes.end(), SeriesRollup());
+    reader.rollup(0, from, to, SERIES_MINUTE_MS, minutes.data());
+  });
+  timeQuery(settings, "rollup 1 h, 1 device", covered / devices, [&] {
+    std::fill(hours.begin(), hours.end(), SeriesRollup());
+    reader.rollup(0, from, to, STOREBENCH_HOUR_MS, hours.data());
+  });
+  timeQuery(settings, "rollup 1 min, all devices", covered, [&] {
+    for (uint32_t d = 0; d < devices; d++) {
+      std::fill(minutes.begin(), minutes.end(), SeriesRollup());
+      reader.rollup(d, from, to, SERIES_MINUTE_MS, minutes.data());
+      sink += minutes[0].sum;
+    }
+  });
+  timeQuery(settings, "rollup 1 h, all devices", covered, [&] {
+    for (uint32_t d = 0; d < devices; d++) {
+      std::fill(hours.begin(), hours.end(), SeriesRollup());
+      reader.rollup(d, from, to, STOREBENCH_HOUR_MS, hours.data());
+      sink += hours[0].sum;
+    }
+  });
+  timeQuery(settings, "rollup 1 min, fleet average", covered, [&] {
+    std::fill(fleet.begin(), fleet.end(), SeriesRollup());
+    for (uint32_t d = 0; d < devices; d++) reader.rollup(d, from, to, SERIES_MINUTE_MS, fleet.data());
+  });
+  timeQuery(settings, "raw rollup 1 min, all devices", covered, [&] {
+    for (uint32_t d = 0; d < devices; d++) {
+      std::fill(raw.begin(), raw.end(), SeriesRollup());
+      reader.rollup(d, from, to, SERIES_MINUTE_MS, raw.data(), false);
+      sink += raw[0].sum;
+    }
+  });
+
+  // Untimed: both rollup paths must give the same buckets
+  for (uint32_t d = 0; d < devices && agree; d++) {
+    std::fill(minutes.begin(), minutes.end(), SeriesRollup());
+    std::fill(raw.begin(), raw.end(), SeriesRollup());
+    reader.rollup(d, from, to, SERIES_MINUTE_MS, minutes.data());
+    reader.rollup(d, from, to, SERIES_MINUTE_MS, raw.data(), false);
+    agree = sameRollups(minutes, raw);
+  }
+  printf("storebench: minute records and raw decode %s\n", agree ? "agree" : "DISAGREE");
+  if (!settings.reuse) {
+    bool match = scanned == loaded && scannedSum == loadedSum;
+    printf("storebench: scan %s the loaded samples (%llu, sum %lld)\n", match ? "matches" : "DOES NOT MATCH",
+           (unsigned long long)scanned, (long long)scannedSum);
+    if (!match) agree = false;
+  }
+  if (sink == 42) printf("\n");  // Keep the timed loops from being optimised away
+  return agree ? 0 : 1;
+}
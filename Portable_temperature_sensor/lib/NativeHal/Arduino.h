@@ -0,0 +1,69 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Host stand-in for the ESP8266 Arduino core, see NativeHal.h
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include "WString.h"
+#include "Print.h"
+#include "HardwareSerial.h"
+#include "NativeHal.h"
+
+using std::isnan;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define A0 17
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+char* dtostrf(double value, signed char width, unsigned char precision, char* out);
+
+// SNTP is not modelled; the host clock already has the wall time
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2 = NULL, const char* server3 = NULL);
+
+// ESP object: chip identity and a deterministic random sequence
+// Flash and heap figures do not exist on the host and read 0.
+class EspClass {
+public:
+  uint32_t getChipId() { return NativeHal::chipId(); }
+  uint32_t random();
+  uint32_t getFreeHeap() { return 0; }
+  uint32_t getSketchSize() { return 0; }
+  void restart() { exit(0); }
+};
+extern EspClass ESP;
+
+#endif // NATIVE_ARDUINO_H
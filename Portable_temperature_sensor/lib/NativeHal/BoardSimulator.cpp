@@ -0,0 +1,385 @@
+#include "BoardSimulator.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+namespace {
+
+// Next whitespace-separated word of a scenario line, NULL at the end
+char* nextWord(char** cursor) {
+  char* p = *cursor;
+  while (*p == ' ' || *p == '\t') p++;
+  if (*p == '\0') return NULL;
+  char* word = p;
+  while (*p && *p != ' ' && *p != '\t') p++;
+  if (*p) *p++ = '\0';
+  *cursor = p;
+  return word;
+}
+
+// Rest of the line, leading blanks skipped
+char* restOfLine(char** cursor) {
+  char* p = *cursor;
+  while (*p == ' ' || *p == '\t') p++;
+  *cursor = p + strlen(p);
+  return p;
+}
+
+uint64_t msToUs(const char* word) {
+  return (uint64_t)(atof(word) * 1000.0);
+}
+
+// "name +12.3ms", or "name -" if it never happened
+void printLatency(FILE* out, const char* separator, const char* name, int64_t us) {
+  if (us < 0) fprintf(out, "%s%s -", separator, name);
+  else fprintf(out, "%s%s +%.1fms", separator, name, us / 1000.0);
+}
+
+}  // namespace
+
+bool BoardSimulator::load(const char* path, std::string& error) {
+  FILE* f = fopen(path, "r");
+  if (f == NULL) {
+    error = std::string("cannot open ") + path;
+    return false;
+  }
+  std::string dir(path);
+  size_t slash = dir.rfind('/');
+  dir = slash == std::string::npos ? "" : dir.substr(0, slash + 1);
+  _name = slash == std::string::npos ? path : path + slash + 1;
+
+  float initial = 25.0f;
+  char line[512];
+  int lineNo = 0;
+  bool ok = true;
+  while (ok && fgets(line, sizeof(line), f)) {
+    lineNo++;
+    line[strcspn(line, "#\r\n")] = '\0';
+    char* cursor = line;
+    char* command = nextWord(&cursor);
+    if (command == NULL) continue;
+    if (!strcmp(command, "backend")) {
+      _backendEnabled = true;
+      continue;
+    }
+    char* a = nextWord(&cursor);
+    char* b = NULL;
+    char* c = NULL;
+
+    // Profile commands hold the starting temperature from time 0
+    if (_profile.empty() && (!strcmp(command, "step") || !strcmp(command, "ramp") ||
+                             !strcmp(command, "csv") || !strcmp(command, "open"))) {
+      _profile.rampTo(0, initial);
+    }
+
+    if (a == NULL) ok = false;
+    else if (!strcmp(command, "seconds")) _seconds = atof(a);
+    else if (!strcmp(command, "temperature")) initial = (float)atof(a);
+    else if (!strcmp(command, "step")) {
+      if ((b = nextWord(&cursor)) == NULL) ok = false;
+      else {
+        uint64_t at = msToUs(a);
+        Event e;
+        e.at = at;
+        e.from = _profile.at(at);
+        e.to = (float)atof(b);
+        _profile.stepTo(at, e.to);
+        _events.push_back(e);
+      }
+    }
+    else if (!strcmp(command, "ramp")) {
+      if ((b = nextWord(&cursor)) == NULL || (c = nextWord(&cursor)) == NULL) ok = false;
+      else {
+        _profile.rampTo(msToUs(a), _profile.at(msToUs(a)));
+        _profile.rampTo(msToUs(b), (float)atof(c));
+      }
+    }
+    else if (!strcmp(command, "open")) {
+      uint64_t from = msToUs(a);
+      b = nextWord(&cursor);
+      uint64_t to = b ? msToUs(b) : UINT64_MAX;
+      _profile.addOpen(from, to);
+      Event e;
+      e.at = from;
+      e.from = _profile.at(from);
+      e.to = NAN;
+      _events.push_back(e);
+      if (b) {
+        e.at = to;
+        e.from = NAN;
+        e.to = _profile.at(to);
+        _events.push_back(e);
+      }
+    }
+    else if (!strcmp(command, "csv")) {
+      b = nextWord(&cursor);
+      std::string file = a[0] == '/' ? a : dir + a;
+      ok = _profile.loadCsv(file.c_str(), b ? msToUs(b) : 0, error);
+      if (!ok) break;
+    }
+    else if (!strcmp(command, "conversion")) _thermocouple.setConversionTime(msToUs(a));
+    else if (!strcmp(command, "noise")) _thermocouple.setNoise(atoi(a));
+    else if (!strcmp(command, "lag")) _thermocouple.setLag(msToUs(a));
+    else if (!strcmp(command, "battery")) {
+      if ((b = nextWord(&cursor)) == NULL) ok = false;
+      else {
+        c = nextWord(&cursor);
+        _batteryStart = c ? (float)atof(c) / 100.0f : 1.0f;
+        _battery.reset(new SimBattery((float)atof(a), (float)atof(b), _batteryStart));
+      }
+    }
+    else if (!strcmp(command, "serial") || !strcmp(command, "soft")) {
+      InputKind kind = command[1] == 'e' ? INPUT_SERIAL : INPUT_SOFT;
+      _inputs.push_back({ msToUs(a), kind, restOfLine(&cursor) });
+    }
+    else if (!strcmp(command, "mqtt")) {
+      if ((b = nextWord(&cursor)) == NULL) ok = false;
+      else _inputs.push_back({ msToUs(a), INPUT_MQTT, std::string(b) + "=" + restOfLine(&cursor) });
+    }
+    else if (!strcmp(command, "wifi") || !strcmp(command, "broker")) {
+      if ((b = nextWord(&cursor)) == NULL || (strcmp(b, "on") && strcmp(b, "off"))) ok = false;
+      else _network.push_back({ msToUs(a), command[0] == 'w' ? NET_WIFI : NET_BROKER, !strcmp(b, "on") });
+    }
+    else if (!strcmp(command, "restart")) {
+      if ((b = nextWord(&cursor)) == NULL) ok = false;
+      else {
+        _network.push_back({ msToUs(a), NET_BROKER, 0 });
+        _network.push_back({ msToUs(a) + msToUs(b), NET_BROKER, 1 });
+      }
+    }
+    else if (!strcmp(command, "halfopen")) _network.push_back({ msToUs(a), NET_HALF_OPEN, 1 });
+    else if (!strcmp(command, "latency") || !strcmp(command, "loss")) {
+      if ((b = nextWord(&cursor)) == NULL) ok = false;
+      else _network.push_back({ msToUs(a), command[1] == 'a' ? NET_LATENCY : NET_LOSS, (uint32_t)atoi(b) });
+    }
+    else ok = false;
+
+    if (!ok) error = std::string(path) + ":" + std::to_string(lineNo) + ": bad command '" + command + "'";
+  }
+  fclose(f);
+  if (ok && _profile.empty()) _profile.rampTo(0, initial);
+  std::stable_sort(_inputs.begin(), _inputs.end(),
+                   [](const ScheduledInput& x, const ScheduledInput& y) { return x.at < y.at; });
+  std::stable_sort(_network.begin(), _network.end(),
+                   [](const NetworkChange& x, const NetworkChange& y) { return x.at < y.at; });
+  findOutages();
+  return ok;
+}
+
+// Pair each network loss with its return; a half-open connection is its own outage
+void BoardSimulator::findOutages() {
+  int64_t wifiDown = -1;
+  int64_t brokerDown = -1;
+  for (const NetworkChange& change : _network) {
+    if (change.kind == NET_HALF_OPEN) {
+      Outage o;
+      o.kind = "halfopen";
+      o.from = o.to = change.at;
+      _outages.push_back(o);
+      continue;
+    }
+    int64_t* down = change.kind == NET_WIFI ? &wifiDown : (change.kind == NET_BROKER ? &brokerDown : NULL);
+    if (down == NULL) continue;
+    if (!change.value && *down < 0) *down = change.at;
+    if (change.value && *down >= 0) {
+      Outage o;
+      o.kind = change.kind == NET_WIFI ? "wifi" : "broker";
+      o.from = *down;
+      o.to = change.at;
+      _outages.push_back(o);
+      *down = -1;
+    }
+  }
+  std::stable_sort(_outages.begin(), _outages.end(), [](const Outage& x, const Outage& y) { return x.from < y.from; });
+}
+
+void BoardSimulator::recordFrames(const std::string& dir, uint64_t intervalUs) {
+  mkdir(dir.c_str(), 0755);  // Fails harmlessly if it exists
+  _panel.reset(new PanelRecorder(dir, intervalUs));
+}
+
+// The event the board is currently reacting to; later events take over from
+// earlier ones, which then stop collecting latencies
+BoardSimulator::Event* BoardSimulator::current(uint64_t us) {
+  while (_nextEvent < _events.size() && _events[_nextEvent].at <= us) {
+    snapshotArea(_events[_nextEvent].area);
+    _nextEvent++;
+  }
+  return _nextEvent == 0 ? NULL : &_events[_nextEvent - 1];
+}
+
+bool BoardSimulator::reached(const Event& e, float value) const {
+  if (isnan(e.to)) return isnan(value);
+  if (isnan(value)) return false;
+  if (isnan(e.from)) return true;
+  float midpoint = (e.from + e.to) / 2;
+  return e.to > e.from ? value >= midpoint : value <= midpoint;
+}
+
+void BoardSimulator::snapshotArea(uint8_t* area) const {
+  const uint8_t* ram = NativeHal::panel().ram;
+  for (int x = 0; x <= VALUE_X1; x++) {
+    for (int page = 0; page < VALUE_PAGES; page++) area[x * VALUE_PAGES + page] = ram[x * NativeHal::Panel::PAGES + page];
+  }
+}
+
+void BoardSimulator::afterLoop(uint64_t now) {
+  while (_nextNetwork < _network.size() && _network[_nextNetwork].at <= now) {
+    const NetworkChange& change = _network[_nextNetwork++];
+    NativeHal::Network& net = NativeHal::network();
+    switch (change.kind) {
+      case NET_WIFI: net.accessPoint = change.value; break;
+      case NET_BROKER: net.broker = change.value; break;
+      case NET_HALF_OPEN: NativeHal::setHalfOpen(); break;
+      case NET_LATENCY: net.latencyMs = change.value; break;
+      case NET_LOSS: net.lossPercent = change.value > 100 ? 100 : change.value; break;
+    }
+  }
+  current(now);
+  if (_panel) _panel->poll(now);
+}
+
+void BoardSimulator::finish(uint64_t now) {
+  if (_panel) _panel->poll(now, true);
+}
+
+float BoardSimulator::thermocouple(uint64_t us) {
+  float value = _thermocouple.read(us);
+  Event* e = current(us);
+  if (e && e->read < 0 && reached(*e, value)) {
+    e->read = us - e->at;
+    e->displayArmed = true;
+  }
+  return value;
+}
+
+int BoardSimulator::analog(uint8_t pin, uint64_t us) {
+  if (pin != A0 || !_battery) return Devices::analog(pin, us);
+  return _battery->adc(us);
+}
+
+void BoardSimulator::pinChanged(uint8_t pin, int level, uint64_t us) {
+  if (pin != TRIGGER_PIN) return;
+  _edges.record(us, "trigger", level);
+  Event* e = current(us);
+  if (e && e->trigger < 0 && e->read >= 0) e->trigger = us - e->at;
+}
+
+void BoardSimulator::toneChanged(uint8_t pin, unsigned int frequency, uint64_t us) {
+  if (pin != BUZZER_PIN) return;
+  _edges.record(us, "buzzer", frequency);
+  Event* e = current(us);
+  if (e && e->buzzer < 0 && e->read >= 0) e->buzzer = us - e->at;
+}
+
+// Display latency: the first panel update after the reading crossed that changes
+// the temperature widget's area from what it showed when the event happened
+void BoardSimulator::panelWritten(uint64_t us) {
+  if (_panel) _panel->written();
+  Event* e = current(us);
+  if (e == NULL || !e->displayArmed || e->display >= 0) return;
+  uint8_t area[sizeof(Event::area)];
+  snapshotArea(area);
+  if (memcmp(area, e->area, sizeof(area)) != 0) e->display = us - e->at;
+}
+
+// A batch reached the backend: credit it to the latest outage that has started
+void BoardSimulator::delivered(const SimBackend::Delivery& delivery, uint64_t us) {
+  Outage* o = NULL;
+  for (Outage& outage : _outages) {
+    if (outage.from <= us) o = &outage;
+  }
+  if (o == NULL || o->drained >= 0) return;
+  o->duplicates += delivery.duplicates;
+  o->lost += delivery.lost;
+  if (o->recovered < 0) {
+    if (us < o->to || delivery.accepted == 0) return;
+    o->recovered = us - o->to;
+  }
+  o->backlog += delivery.accepted;
+  if (delivery.count <= 2) o->drained = us - o->to - o->recovered;
+}
+
+void BoardSimulator::published(const char* topic, const uint8_t* payload, size_t length, uint64_t us) {
+  SimBackend::Delivery delivery;
+  if (_backendEnabled && _backend.received(topic, payload, length, delivery)) {
+    delivered(delivery, us);
+    return;
+  }
+  static const char suffix[] = "/temperature";
+  size_t topicLength = strlen(topic);
+  if (topicLength < sizeof(suffix) - 1 || strcmp(topic + topicLength - (sizeof(suffix) - 1), suffix) != 0) return;
+  Event* e = current(us);
+  if (e == NULL || e->publish >= 0) return;
+  char text[16];
+  size_t n = length < sizeof(text) - 1 ? length : sizeof(text) - 1;
+  memcpy(text, payload, n);
+  text[n] = '\0';
+  if (reached(*e, (float)atof(text))) e->publish = us - e->at;
+}
+
+void BoardSimulator::report(FILE* out, uint64_t now) {
+  fprintf(out, "sim: scenario %s, %.1fs\n", _name.empty() ? "-" : _name.c_str(), now / 1e6);
+  for (const Event& e : _events) {
+    if (e.at > now) break;
+    fprintf(out, "sim: ");
+    if (isnan(e.to)) fprintf(out, "Open at %lums (%.2fC)", (unsigned long)(e.at / 1000), e.from);
+    else if (isnan(e.from)) fprintf(out, "Closed at %lums (%.2fC)", (unsigned long)(e.at / 1000), e.to);
+    else fprintf(out, "Step at %lums %.2f -> %.2fC", (unsigned long)(e.at / 1000), e.from, e.to);
+    printLatency(out, ": ", "read", e.read);
+    printLatency(out, ", ", "publish", e.publish);
+    printLatency(out, ", ", "buzzer", e.buzzer);
+    printLatency(out, ", ", "trigger", e.trigger);
+    printLatency(out, ", ", "display", e.display);
+    fprintf(out, "\n");
+  }
+  fprintf(out, "sim: MAX6675 %u reads, %u before a new conversion, %u faults\n",
+          _thermocouple.reads(), _thermocouple.staleReads(), _thermocouple.faultReads());
+  if (_battery) {
+    fprintf(out, "sim: battery %.0f%% -> %.0f%%, %.2fV at A0 %d\n", _batteryStart * 100,
+            _battery->charge(now) * 100, _battery->voltage(now), _battery->adc(now));
+  }
+  if (_backendEnabled) {
+    fprintf(out, "sim: backend %llu batches, %llu samples, %llu duplicates, %llu lost, %u malformed, %u acks; "
+            "%u messages lost on the wire\n", (unsigned long long)_backend.batches(),
+            (unsigned long long)_backend.accepted(), (unsigned long long)_backend.duplicates(),
+            (unsigned long long)_backend.lost(), _backend.malformed(), _backend.acks(), NativeHal::network().lostOnWire);
+  }
+  for (const Outage& o : _outages) {
+    if (o.from > now) break;
+    fprintf(out, "sim: Outage %s at %lums", o.kind, (unsigned long)(o.from / 1000));
+    if (o.to != o.from) fprintf(out, " for %lums", (unsigned long)((o.to - o.from) / 1000));
+    if (o.recovered < 0) fprintf(out, ": not recovered");
+    else fprintf(out, ": recovered +%.1fms", o.recovered / 1000.0);
+    if (o.drained >= 0) {
+      fprintf(out, ", backlog %u samples in %.1fms (%.1f/s)", o.backlog, o.drained / 1000.0,
+              o.drained > 0 ? o.backlog * 1e6 / o.drained : 0.0);
+    }
+    fprintf(out, ", %u duplicates, %u lost\n", o.duplicates, o.lost);
+  }
+  fprintf(out, "sim: %u buzzer and %u trigger edges", _edges.count("buzzer"), _edges.count("trigger"));
+  if (_panel) fprintf(out, ", %u frames in %s", _panel->frames(), _panel->dir().c_str());
+  fprintf(out, "\n");
+}
+
+// One row per outage and a total row; the header is written when the file is new
+bool BoardSimulator::writeResults(const char* path) const {
+  FILE* f = fopen(path, "a");
+  if (f == NULL) return false;
+  if (ftell(f) == 0) fprintf(f, "scenario,event,start_ms,end_ms,recovery_ms,samples,drain_ms,drain_per_s,duplicates,lost\n");
+  for (const Outage& o : _outages) {
+    fprintf(f, "%s,%s,%lu,%lu,", _name.c_str(), o.kind, (unsigned long)(o.from / 1000), (unsigned long)(o.to / 1000));
+    if (o.recovered >= 0) fprintf(f, "%.1f", o.recovered / 1000.0);
+    fprintf(f, ",%u,", o.backlog);
+    if (o.drained >= 0) fprintf(f, "%.1f,%.2f", o.drained / 1000.0, o.drained > 0 ? o.backlog * 1e6 / o.drained : 0.0);
+    else fprintf(f, ",");
+    fprintf(f, ",%u,%u\n", o.duplicates, o.lost);
+  }
+  fprintf(f, "%s,total,,,,%llu,,,%llu,%llu\n", _name.c_str(), (unsigned long long)_backend.accepted(),
+          (unsigned long long)_backend.duplicates(), (unsigned long long)_backend.lost());
+  fclose(f);
+  return true;
+}
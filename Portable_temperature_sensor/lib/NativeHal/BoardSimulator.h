@@ -0,0 +1,146 @@
+#ifndef BOARD_SIMULATOR_H
+#define BOARD_SIMULATOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "NativeHal.h"
+#include "SimBackend.h"
+#include "SimBattery.h"
+#include "SimRecorders.h"
+#include "SimThermocouple.h"
+
+// Input for the firmware at a given board time, see NativeMain.cpp
+enum InputKind { INPUT_SERIAL, INPUT_SOFT, INPUT_MQTT };
+
+struct ScheduledInput {
+  uint64_t at;  // us
+  InputKind kind;
+  std::string text;  // Serial line, or "topic=payload" for MQTT
+};
+
+// Board peripherals driven by a scenario file
+// Installs itself as NativeHal::devices(): the MAX6675 and A0 readings come from
+// the models, buzzer and trigger edges are recorded, display frames captured.
+// Each temperature step or open-circuit fault in the scenario is a physical event
+// whose end-to-end latency is measured to the first reading, MQTT publish, buzzer
+// edge, trigger edge and display update that reflect it. A change counts as seen
+// once a value is past the midpoint between the old and new temperature.
+// With `backend`, published batches are received and acknowledged by a SimBackend,
+// and each network outage gets its recovery time (from the network coming back,
+// or for a half-open connection from when it went dead, to the first new sample
+// at the backend), the backlog drained afterwards and its rate (until a batch of
+// at most two samples shows the device has caught up), duplicates and lost samples.
+//
+// Scenario files have one command per line, times in ms, # starts a comment:
+//   seconds <s>                     run time (default 30)
+//   temperature <c>                 starting temperature (default 25)
+//   step <ms> <c>                   jump to <c>
+//   ramp <ms> <ms_end> <c>          linear from the value at <ms> to <c> at <ms_end>
+//   open <ms> [<ms_end>]            open thermocouple from <ms> (to <ms_end>)
+//   csv <file> [<offset_ms>]        recorded ms,celsius profile (path relative to the scenario)
+//   conversion <ms>                 MAX6675 conversion time (default 220)
+//   noise <counts>                  +-counts of 0.25°C on each conversion (default 0)
+//   lag <ms>                        probe time constant (default 0, ideal probe)
+//   battery <mAh> <mA> [<percent>]  LiPo with a constant load (default: fixed 4V)
+//   serial <ms> <text>              line typed on the debug serial port
+//   soft <ms> <text>                line from the external device
+//   mqtt <ms> <topic> <payload>     message from the broker
+//   wifi <ms> on|off                access point in or out of range
+//   broker <ms> on|off              broker accepting connections or not
+//   restart <ms> <down_ms>          broker restart: connections and messages on the wire are lost
+//   halfopen <ms>                   connection dies silently, found by the keepalive
+//   latency <ms> <one_way_ms>       link delay from <ms> on
+//   loss <ms> <percent>             segment loss from <ms> on, resent by TCP
+//   backend                         receive and acknowledge sample batches
+class BoardSimulator : public NativeHal::Devices {
+public:
+  // Pins from the wiring in main.cpp
+  static const uint8_t BUZZER_PIN = 0;
+  static const uint8_t TRIGGER_PIN = 2;
+  // Temperature widget area: columns 0-96 of pages 0-1
+  static const uint8_t VALUE_X1 = 96;
+  static const uint8_t VALUE_PAGES = 2;
+
+private:
+  struct Event {
+    uint64_t at;
+    float from;
+    float to;             // NAN for an open-circuit fault
+    int64_t read = -1;    // us after the event, -1 = not seen
+    int64_t publish = -1;
+    int64_t buzzer = -1;
+    int64_t trigger = -1;
+    int64_t display = -1;
+    bool displayArmed = false;  // Reading seen; the next change of the value area counts
+    uint8_t area[(VALUE_X1 + 1) * VALUE_PAGES];
+  };
+
+  enum NetworkKind { NET_WIFI, NET_BROKER, NET_HALF_OPEN, NET_LATENCY, NET_LOSS };
+
+  struct NetworkChange {
+    uint64_t at;
+    NetworkKind kind;
+    uint32_t value;  // 1/0 for up/down, or ms, or percent
+  };
+
+  struct Outage {
+    const char* kind;
+    uint64_t from;
+    uint64_t to;              // Network back; for a half-open connection the time it went dead
+    int64_t recovered = -1;   // us after `to`, -1 = no new sample since
+    int64_t drained = -1;     // us after recovery until caught up
+    uint32_t backlog = 0;     // Samples delivered from recovery until caught up
+    uint32_t duplicates = 0;
+    uint32_t lost = 0;
+  };
+
+  std::string _name;
+  double _seconds = 30;
+  TemperatureProfile _profile;
+  SimMax6675 _thermocouple;
+  std::unique_ptr<SimBattery> _battery;
+  float _batteryStart = 0;
+  std::unique_ptr<PanelRecorder> _panel;
+  EdgeRecorder _edges;
+  std::vector<Event> _events;
+  size_t _nextEvent = 0;  // First event not yet reached
+  std::vector<ScheduledInput> _inputs;
+  std::vector<NetworkChange> _network;
+  size_t _nextNetwork = 0;
+  std::vector<Outage> _outages;
+  bool _backendEnabled = false;
+  SimBackend _backend;
+
+  Event* current(uint64_t us);
+  bool reached(const Event& e, float value) const;
+  void snapshotArea(uint8_t* area) const;
+  void findOutages();
+  void delivered(const SimBackend::Delivery& delivery, uint64_t us);
+
+public:
+  BoardSimulator() : _thermocouple(_profile) {}
+
+  bool load(const char* path, std::string& error);
+  void recordFrames(const std::string& dir, uint64_t intervalUs);
+  bool writeEdges(const char* path) const { return _edges.writeCsv(path); }
+  bool writeResults(const char* path) const;  // Appends the outage measurements as CSV
+
+  double seconds() const { return _seconds; }
+  const std::vector<ScheduledInput>& inputs() const { return _inputs; }
+
+  void afterLoop(uint64_t now);  // Network changes and frame capture
+  void finish(uint64_t now);
+  void report(FILE* out, uint64_t now);
+
+  float thermocouple(uint64_t us) override;
+  int analog(uint8_t pin, uint64_t us) override;
+  void pinChanged(uint8_t pin, int level, uint64_t us) override;
+  void toneChanged(uint8_t pin, unsigned int frequency, uint64_t us) override;
+  void panelWritten(uint64_t us) override;
+  void published(const char* topic, const uint8_t* payload, size_t length, uint64_t us) override;
+};
+
+#endif // BOARD_SIMULATOR_H
@@ -0,0 +1,87 @@
+#ifndef NATIVE_ESP8266_WIFI_H
+#define NATIVE_ESP8266_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3
+} WiFiMode_t;
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+class IPAddress : public Printable {
+private:
+  uint8_t _bytes[4];
+
+public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : _bytes{a, b, c, d} {}
+
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+    return String(buf);
+  }
+
+  size_t printTo(Print& p) const override { return p.print(toString()); }
+};
+
+// Station interface on NativeHal::network()
+// begin() associates once the AP has been in range for associateMs; losing the
+// AP drops the link until the next begin(), like the SDK without auto-reconnect.
+class ESP8266WiFiClass {
+private:
+  bool _joining = false;
+  uint64_t _joinStart = 0;
+  bool _connected = false;
+
+public:
+  bool mode(WiFiMode_t mode) { (void)mode; return true; }
+
+  wl_status_t begin(const char* ssid, const char* password) {
+    (void)ssid;
+    (void)password;
+    _joining = true;
+    _joinStart = NativeHal::now();
+    _connected = false;
+    return status();
+  }
+
+  bool disconnect() {
+    _joining = false;
+    _connected = false;
+    return true;
+  }
+
+  wl_status_t status() {
+    NativeHal::Network& net = NativeHal::network();
+    if (_connected && !net.accessPoint) {
+      _connected = false;
+      return WL_CONNECTION_LOST;
+    }
+    if (_joining && !net.accessPoint) _joinStart = NativeHal::now();  // Scanning; association starts once the AP is back
+    if (_joining && net.accessPoint && NativeHal::now() - _joinStart >= net.associateMs * 1000ULL) {
+      _joining = false;
+      _connected = true;
+    }
+    if (_connected) return WL_CONNECTED;
+    return _joining ? WL_IDLE_STATUS : WL_DISCONNECTED;
+  }
+
+  IPAddress localIP() { return _connected ? IPAddress(192, 168, 137, 50) : IPAddress(); }
+};
+extern ESP8266WiFiClass WiFi;
+
+// The TCP client is not modelled; PubSubClient talks to NativeHal::network() itself
+class WiFiClient {};
+
+#endif // NATIVE_ESP8266_WIFI_H
@@ -0,0 +1,203 @@
+#ifndef NATIVE_GYVER_OLED_H
+#define NATIVE_GYVER_OLED_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SSD1306_128x32 0
+#define SSD1306_128x64 1
+
+#define OLED_NO_BUFFER 0
+#define OLED_BUFFER 1
+#define OLED_I2C 0
+
+#define BUF_ADD 0
+#define BUF_SUBTRACT 1
+#define BUF_REPLACE 2
+
+#define OLED_CLEAR 0
+#define OLED_FILL 1
+#define OLED_STROKE 2
+
+// Classic 5x7 font, ASCII 0x20..0x7E, one byte per column with bit 0 at the top
+static const uint8_t nativeOledFont[][5] = {
+  {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+  {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x56,0x20,0x50}, {0x00,0x08,0x07,0x03,0x00},
+  {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08},
+  {0x00,0x80,0x70,0x30,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x00,0x60,0x60,0x00}, {0x20,0x10,0x08,0x04,0x02},
+  {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33},
+  {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07},
+  {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E}, {0x00,0x00,0x14,0x00,0x00}, {0x00,0x40,0x34,0x00,0x00},
+  {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06},
+  {0x3E,0x41,0x5D,0x59,0x4E}, {0x7C,0x12,0x11,0x12,0x7C}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+  {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x41,0x51,0x73},
+  {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+  {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+  {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x26,0x49,0x49,0x49,0x32},
+  {0x03,0x01,0x7F,0x01,0x03}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},
+  {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03}, {0x61,0x59,0x49,0x4D,0x43}, {0x00,0x7F,0x41,0x41,0x41},
+  {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x41,0x7F}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+  {0x00,0x03,0x07,0x08,0x00}, {0x20,0x54,0x54,0x78,0x40}, {0x7F,0x28,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x28},
+  {0x38,0x44,0x44,0x28,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x00,0x08,0x7E,0x09,0x02}, {0x18,0xA4,0xA4,0x9C,0x78},
+  {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x40,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},
+  {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x78,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+  {0xFC,0x18,0x24,0x24,0x18}, {0x18,0x24,0x24,0x18,0xFC}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x24},
+  {0x04,0x04,0x3F,0x44,0x24}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+  {0x44,0x28,0x10,0x28,0x44}, {0x4C,0x90,0x90,0x90,0x7C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+  {0x00,0x00,0x77,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x02,0x01,0x02,0x04,0x02}
+};
+static const uint8_t nativeOledDegree[5] = {0x00, 0x06, 0x09, 0x09, 0x06};
+
+// GyverOLED on top of the NativeHal::panel() SSD1306 model, 128x32 only
+// The drawing calls the firmware uses are implemented on the framebuffer
+// (OLED_BUFFER) or straight on the panel RAM (OLED_NO_BUFFER). setWindow(),
+// beginData(), sendByte() and endTransm() move bytes into the panel and account
+// their I2C time, so the compositor and tile renderer budgets behave as on the
+// board. Text uses a plain 5x7 font rather than GyverOLED's own glyphs.
+template <int _TYPE, int _BUFF = OLED_BUFFER, int _CONN = OLED_I2C, int8_t _CS = -1, int8_t _DC = -1, int8_t _RST = -1>
+class GyverOLED : public Print {
+private:
+  static const uint8_t WIDTH = NativeHal::Panel::WIDTH;
+  static const uint8_t HEIGHT = NativeHal::Panel::PAGES * 8;
+
+  int _x = 0, _y = 0;  // Text cursor in pixels
+  uint8_t _scale = 1;
+  bool _autoPrintln = false;
+  bool _invert = false;
+  uint8_t _mode = BUF_ADD;
+
+  uint8_t* pageByte(int x, int page) {
+    if (_BUFF) return &_oled_buffer[x * NativeHal::Panel::PAGES + page];
+    return &NativeHal::panel().ram[x * NativeHal::Panel::PAGES + page];
+  }
+
+  void plot(int x, int y, bool on) {
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+    uint8_t* b = pageByte(x, y >> 3);
+    if (on) *b |= 1 << (y & 7);
+    else *b &= ~(1 << (y & 7));
+  }
+
+  // Without a buffer every drawing call is its own transfer to the panel
+  void directTransfer(size_t bytes) {
+    if (_BUFF) return;
+    NativeHal::i2cTransfer(OLED_DIRECT_OVERHEAD + bytes);
+    NativeHal::devices().panelWritten(NativeHal::now());
+  }
+  static const uint8_t OLED_DIRECT_OVERHEAD = 9;
+
+  void newline() {
+    _x = 0;
+    _y += 8 * _scale;
+  }
+
+  void drawGlyph(const uint8_t* glyph) {
+    if (_autoPrintln && _x + 6 * _scale > WIDTH) newline();
+    for (uint8_t col = 0; col < 6; col++) {
+      uint8_t bits = col < 5 ? glyph[col] : 0;
+      if (_invert) bits = ~bits;
+      for (uint8_t row = 0; row < 8; row++) {
+        bool on = bits & (1 << row);
+        if (!on && _mode != BUF_REPLACE) continue;
+        for (uint8_t sx = 0; sx < _scale; sx++) {
+          for (uint8_t sy = 0; sy < _scale; sy++) plot(_x + col * _scale + sx, _y + row * _scale + sy, on);
+        }
+      }
+    }
+    _x += 6 * _scale;
+    directTransfer(6 * _scale * _scale);
+  }
+
+public:
+  uint8_t _oled_buffer[_BUFF ? NativeHal::Panel::WIDTH * NativeHal::Panel::PAGES : 1] = {};
+
+  GyverOLED(uint8_t address = 0x3C) { (void)address; }
+
+  void init() {
+    NativeHal::i2cTransfer(30);  // Init command sequence
+  }
+
+  void clear() {
+    if (_BUFF) {
+      memset(_oled_buffer, 0, sizeof(_oled_buffer));
+    } else {
+      setWindow(0, 0, WIDTH - 1, NativeHal::Panel::PAGES - 1);
+      beginData();
+      for (uint16_t i = 0; i < WIDTH * NativeHal::Panel::PAGES; i++) sendByte(0);
+      endTransm();
+    }
+    _x = 0;
+    _y = 0;
+  }
+
+  // Send the whole framebuffer
+  void update() {
+    if (!_BUFF) return;
+    setWindow(0, 0, WIDTH - 1, NativeHal::Panel::PAGES - 1);
+    beginData();
+    for (uint16_t i = 0; i < sizeof(_oled_buffer); i++) sendByte(_oled_buffer[i]);
+    endTransm();
+  }
+
+  void setScale(uint8_t scale) { _scale = constrain(scale, 1, 4); }
+  void autoPrintln(bool enabled) { _autoPrintln = enabled; }
+  void invertText(bool inverted) { _invert = inverted; }
+  void textMode(uint8_t mode) { _mode = mode; }
+  void setCursor(int x, int row) { _x = x; _y = row * 8; }
+  void setCursorXY(int x, int y) { _x = x; _y = y; }
+
+  size_t write(uint8_t c) override {
+    if (c == '\n') { newline(); return 1; }
+    if (c == '\r' || c == 0xC2) return 1;  // 0xC2 leads the UTF-8 degree sign
+    if (c >= 0x20 && c <= 0x7E) drawGlyph(nativeOledFont[c - 0x20]);
+    else if (c == 0xB0 || c == 247) drawGlyph(nativeOledDegree);
+    return 1;
+  }
+  using Print::write;
+
+  void dot(int x, int y, uint8_t fill = 1) {
+    plot(x, y, fill);
+    directTransfer(1);
+  }
+
+  void line(int x0, int y0, int x1, int y1, uint8_t fill = 1) {
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    size_t count = 0;
+    for (;;) {
+      plot(x0, y0, fill);
+      count++;
+      if (x0 == x1 && y0 == y1) break;
+      int e2 = 2 * err;
+      if (e2 >= dy) { err += dy; x0 += sx; }
+      if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+    directTransfer(count);
+  }
+
+  void rect(int x0, int y0, int x1, int y1, uint8_t fill = 1) {
+    for (int x = x0; x <= x1; x++) {
+      for (int y = y0; y <= y1; y++) {
+        bool edge = x == x0 || x == x1 || y == y0 || y == y1;
+        if (fill == OLED_STROKE) { if (edge) plot(x, y, true); }
+        else plot(x, y, fill == OLED_FILL);
+      }
+    }
+    directTransfer((x1 - x0 + 1) * ((y1 - y0) / 8 + 1));
+  }
+
+  // Raw transfers: window commands, then data bytes written in vertical addressing order
+  void setWindow(int x0, int y0, int x1, int y1) {
+    NativeHal::panel().setWindow(x0, y0, x1, y1);
+    NativeHal::i2cTransfer(7);  // Address + 6 window commands
+  }
+  void beginData() { NativeHal::i2cTransfer(2); }  // Address + data control byte
+  void sendByte(uint8_t data) {
+    NativeHal::panel().data(data);
+    NativeHal::i2cTransfer(1);
+  }
+  void endTransm() { NativeHal::devices().panelWritten(NativeHal::now()); }
+};
+
+#endif // NATIVE_GYVER_OLED_H
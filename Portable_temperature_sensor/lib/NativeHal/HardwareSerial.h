@@ -0,0 +1,52 @@
+#ifndef NATIVE_HARDWARE_SERIAL_H
+#define NATIVE_HARDWARE_SERIAL_H
+
+#include <stdio.h>
+#include <string>
+#include "Print.h"
+
+// Serial port on the host
+// Input is queued by the runner (see NativeMain.cpp) and read back by the firmware;
+// output goes to a FILE*, each line tagged with the port's prefix, or nowhere when
+// the output is NULL.
+class HostSerial : public Stream {
+private:
+  std::string _input;
+  size_t _readPos = 0;
+  const char* _prefix;
+  FILE* _out = stdout;
+  bool _lineStart = true;
+
+public:
+  HostSerial(const char* prefix) : _prefix(prefix) {}
+
+  void begin(unsigned long baud) { (void)baud; }
+  void setOutput(FILE* out) { _out = out; }
+
+  // Queue bytes as if they had arrived on the RX pin
+  void inject(const char* text) {
+    if (_readPos == _input.size()) {
+      _input.clear();
+      _readPos = 0;
+    }
+    _input += text;
+  }
+
+  int available() override { return (int)(_input.size() - _readPos); }
+  int read() override { return _readPos < _input.size() ? (uint8_t)_input[_readPos++] : -1; }
+  int peek() override { return _readPos < _input.size() ? (uint8_t)_input[_readPos] : -1; }
+
+  size_t write(uint8_t b) override {
+    if (_out == NULL) return 1;
+    if (_lineStart) fputs(_prefix, _out);
+    fputc(b, _out);
+    _lineStart = (b == '\n');
+    return 1;
+  }
+  using Print::write;
+};
+
+typedef HostSerial HardwareSerial;
+extern HardwareSerial Serial;
+
+#endif // NATIVE_HARDWARE_SERIAL_H
@@ -0,0 +1,375 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <Wire.h>
+#include <time.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+HardwareSerial Serial("");
+EspClass ESP;
+ESP8266WiFiClass WiFi;
+TwoWire Wire;
+
+namespace NativeHal {
+
+static ClockMode mode = CLOCK_VIRTUAL;
+static uint64_t virtualNow = 0;
+static uint64_t realStart = 0;
+static const uint64_t CLOCK_READ_COST = 1;  // us per micros()/millis() call in virtual time
+
+struct Timer {
+  const void* owner;
+  uint64_t due;
+  uint64_t period;
+  std::function<void()> callback;
+};
+static std::vector<Timer> timers;
+static bool runningTimers = false;
+
+static Devices defaultDevices;
+static Devices* activeDevices = &defaultDevices;
+
+static uint8_t pinLevels[32];
+static unsigned int pinTones[32];
+static const char toneOwners[32] = {};  // Timer owner keys for tone() durations
+
+static Panel thePanel;
+static uint32_t i2cByteTime = 23;  // 9 bits at 400kHz, rounded up
+static Network theNetwork;
+
+struct Message {
+  std::string topic;
+  std::string payload;
+  uint64_t due;  // Arrival at the client
+};
+static std::deque<Message> messages;
+static uint64_t lastUplinkArrival = 0;    // Keeps each direction in order
+static uint64_t lastDownlinkArrival = 0;
+static uint32_t uplinkOnWire = 0;         // Messages to the broker still travelling
+static const char linkTimerOwner = 0;
+
+static HostSerial* softPort = NULL;
+static uint32_t randomState = 0x2545F491;
+
+static uint64_t hostMicros() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+void setClockMode(ClockMode clockMode) {
+  mode = clockMode;
+  realStart = hostMicros() - virtualNow;
+}
+
+ClockMode clockMode() {
+  return mode;
+}
+
+uint64_t now() {
+  return mode == CLOCK_REAL ? hostMicros() - realStart : virtualNow;
+}
+
+uint64_t readClock() {
+  if (mode == CLOCK_VIRTUAL) advance(CLOCK_READ_COST);
+  return now();
+}
+
+void sleep(uint64_t us) {
+  if (mode == CLOCK_VIRTUAL) {
+    advance(us);
+    return;
+  }
+  struct timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000 };
+  nanosleep(&ts, NULL);
+  runTimers();
+}
+
+void advance(uint64_t us) {
+  if (mode == CLOCK_VIRTUAL) virtualNow += us;
+  runTimers();
+}
+
+void addTimer(const void* owner, uint64_t delayUs, uint64_t periodUs, std::function<void()> callback) {
+  timers.push_back({ owner, now() + delayUs, periodUs, callback });
+}
+
+void removeTimers(const void* owner) {
+  for (size_t i = 0; i < timers.size();) {
+    if (timers[i].owner == owner) timers.erase(timers.begin() + i);
+    else i++;
+  }
+}
+
+// Fire due timers in deadline order; callbacks may add or remove timers
+void runTimers() {
+  if (runningTimers) return;
+  runningTimers = true;
+  for (;;) {
+    size_t next = timers.size();
+    for (size_t i = 0; i < timers.size(); i++) {
+      if (timers[i].due <= now() && (next == timers.size() || timers[i].due < timers[next].due)) next = i;
+    }
+    if (next == timers.size()) break;
+    Timer timer = timers[next];
+    if (timer.period) timers[next].due += timer.period;
+    else timers.erase(timers.begin() + next);
+    timer.callback();
+  }
+  runningTimers = false;
+}
+
+float Devices::thermocouple(uint64_t us) {
+  (void)us;
+  return roundf(temperature * 4.0f) / 4.0f;  // 0.25°C steps like the MAX6675
+}
+
+int Devices::analog(uint8_t pin, uint64_t us) {
+  (void)pin;
+  (void)us;
+  return adc;
+}
+
+void setDevices(Devices* devices) {
+  activeDevices = devices ? devices : &defaultDevices;
+}
+
+Devices& devices() {
+  return *activeDevices;
+}
+
+void setPin(uint8_t pin, int level) {
+  if (pin >= 32 || pinLevels[pin] == level) return;
+  pinLevels[pin] = level;
+  activeDevices->pinChanged(pin, level, now());
+}
+
+int pinLevel(uint8_t pin) {
+  return pin < 32 ? pinLevels[pin] : LOW;
+}
+
+void setTone(uint8_t pin, unsigned int frequency) {
+  if (pin >= 32 || pinTones[pin] == frequency) return;
+  pinTones[pin] = frequency;
+  activeDevices->toneChanged(pin, frequency, now());
+}
+
+unsigned int toneFrequency(uint8_t pin) {
+  return pin < 32 ? pinTones[pin] : 0;
+}
+
+static const void* toneOwner(uint8_t pin) {
+  return &toneOwners[pin & 31];
+}
+
+void Panel::setWindow(uint8_t wx0, uint8_t wpage0, uint8_t wx1, uint8_t wpage1) {
+  x0 = wx0 < WIDTH ? wx0 : WIDTH - 1;
+  x1 = wx1 < WIDTH ? wx1 : WIDTH - 1;
+  page0 = wpage0 < PAGES ? wpage0 : PAGES - 1;
+  page1 = wpage1 < PAGES ? wpage1 : PAGES - 1;
+  x = x0;
+  page = page0;
+}
+
+void Panel::data(uint8_t b) {
+  ram[x * PAGES + page] = b;
+  if (page < page1) {
+    page++;
+    return;
+  }
+  page = page0;
+  x = (x < x1) ? x + 1 : x0;
+}
+
+Panel& panel() {
+  return thePanel;
+}
+
+void i2cTransfer(size_t bytes) {
+  thePanel.i2cBytes += bytes;
+  if (mode == CLOCK_VIRTUAL) advance((uint64_t)bytes * i2cByteTime);
+}
+
+void setI2cByteTime(uint32_t us) {
+  i2cByteTime = us;
+}
+
+Network& network() {
+  return theNetwork;
+}
+
+// Loss draws come from their own generator so the firmware's random() sequence does not change
+static uint32_t linkRandom() {
+  static uint32_t state = 0x6C8E9CF5;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// Arrival time of a message sent now, after latency and retransmissions
+static uint64_t linkArrival(uint64_t& lastArrival) {
+  uint64_t delay = theNetwork.latencyMs * 1000ULL;
+  uint64_t rto = theNetwork.retransmitMs * 1000ULL;
+  for (int retry = 0; retry < 8 && theNetwork.lossPercent > 0 && linkRandom() % 100 < theNetwork.lossPercent; retry++) {
+    delay += rto;
+    rto *= 2;
+  }
+  uint64_t at = now() + delay;
+  if (at < lastArrival) at = lastArrival;
+  lastArrival = at;
+  return at;
+}
+
+static void brokerReceive(const std::string& topic, const std::string& payload) {
+  theNetwork.published++;
+  theNetwork.publishedBytes += payload.size();
+  activeDevices->published(topic.c_str(), (const uint8_t*)payload.data(), payload.size(), now());
+}
+
+void sendToBroker(const char* topic, const uint8_t* payload, size_t length) {
+  if (theNetwork.halfOpen) {
+    theNetwork.lostOnWire++;
+    return;
+  }
+  std::string t(topic), p((const char*)payload, length);
+  if (theNetwork.latencyMs == 0 && theNetwork.lossPercent == 0 && uplinkOnWire == 0) {
+    brokerReceive(t, p);
+    return;
+  }
+  uint64_t at = linkArrival(lastUplinkArrival);
+  uplinkOnWire++;
+  addTimer(&linkTimerOwner, at - now(), 0, [t, p]() {
+    uplinkOnWire--;
+    if (!theNetwork.broker || !theNetwork.accessPoint) theNetwork.lostOnWire++;
+    else brokerReceive(t, p);
+  });
+}
+
+void dropConnection() {
+  theNetwork.lostOnWire += uplinkOnWire;
+  uplinkOnWire = 0;
+  removeTimers(&linkTimerOwner);
+  for (size_t i = 0; i < messages.size();) {
+    if (messages[i].due > now()) {
+      messages.erase(messages.begin() + i);
+      theNetwork.lostOnWire++;
+    } else {
+      i++;
+    }
+  }
+  theNetwork.halfOpen = false;
+}
+
+void setHalfOpen() {
+  theNetwork.halfOpen = true;
+  theNetwork.halfOpenSince = now();
+}
+
+void injectMessage(const char* topic, const char* payload) {
+  if (theNetwork.halfOpen) {
+    theNetwork.lostOnWire++;  // Sent to a connection that no longer exists
+    return;
+  }
+  messages.push_back({ topic, payload, linkArrival(lastDownlinkArrival) });
+}
+
+bool takeMessage(const char** topic, const char** payload) {
+  if (messages.empty() || messages.front().due > now()) return false;
+  *topic = messages.front().topic.c_str();
+  *payload = messages.front().payload.c_str();
+  return true;
+}
+
+void popMessage() {
+  if (!messages.empty()) messages.pop_front();
+}
+
+uint32_t chipId() {
+  return 0x00A1B2C3;
+}
+
+void registerSoftSerial(HostSerial* port) {
+  softPort = port;
+}
+
+HostSerial* softSerial() {
+  return softPort;
+}
+
+static uint32_t nextRandom() {
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
+
+}  // namespace NativeHal
+
+// Arduino core on top of NativeHal
+
+unsigned long millis() {
+  return (unsigned long)(NativeHal::readClock() / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)NativeHal::readClock();
+}
+
+void delay(unsigned long ms) {
+  NativeHal::sleep(ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+  NativeHal::sleep(us);
+}
+
+void yield() {
+  NativeHal::runTimers();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  NativeHal::setPin(pin, level ? HIGH : LOW);
+}
+
+int digitalRead(uint8_t pin) {
+  return NativeHal::pinLevel(pin);
+}
+
+int analogRead(uint8_t pin) {
+  int value = NativeHal::devices().analog(pin, NativeHal::now());
+  return constrain(value, 0, 1023);
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  NativeHal::removeTimers(NativeHal::toneOwner(pin));
+  NativeHal::setTone(pin, frequency);
+  if (duration > 0) {
+    NativeHal::addTimer(NativeHal::toneOwner(pin), duration * 1000ULL, 0, [pin]() { NativeHal::setTone(pin, 0); });
+  }
+}
+
+void noTone(uint8_t pin) {
+  NativeHal::removeTimers(NativeHal::toneOwner(pin));
+  NativeHal::setTone(pin, 0);
+}
+
+char* dtostrf(double value, signed char width, unsigned char precision, char* out) {
+  sprintf(out, "%*.*f", width, precision, value);
+  return out;
+}
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1, const char* server2,
+                const char* server3) {
+  (void)gmtOffsetSec; (void)daylightOffsetSec; (void)server1; (void)server2; (void)server3;
+}
+
+uint32_t EspClass::random() {
+  return NativeHal::nextRandom();
+}
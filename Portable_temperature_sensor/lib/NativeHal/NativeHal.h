@@ -0,0 +1,121 @@
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+
+class HostSerial;
+
+// Host side of the hardware abstraction layer for [env:native]
+// The fakes in this library (Arduino core, MAX6675, GyverOLED, SoftwareSerial,
+// WiFi, PubSubClient, Ticker) call into here for time, pins and peripherals.
+//
+// Time is virtual by default. It only moves when the runner advances it between
+// loop() calls, when the firmware calls delay(), while bytes go out on I2C, and by
+// one microsecond per clock read so that busy-waits still terminate. Runs are then
+// deterministic and go as fast as the host allows. CLOCK_REAL uses the host's
+// monotonic clock instead, so the firmware's own timing stats show host cost.
+namespace NativeHal {
+
+enum ClockMode { CLOCK_VIRTUAL, CLOCK_REAL };
+
+void setClockMode(ClockMode mode);
+ClockMode clockMode();
+uint64_t now();             // Current time in us, without charging a clock read
+uint64_t readClock();       // What micros() sees; charges one read in virtual mode
+void sleep(uint64_t us);    // delay(): advance virtual time, or really sleep
+void advance(uint64_t us);  // Move virtual time forward, firing due timers
+
+// One-shot or periodic callbacks on the board clock, e.g. for Ticker and tone()
+void addTimer(const void* owner, uint64_t delayUs, uint64_t periodUs, std::function<void()> callback);
+void removeTimers(const void* owner);
+void runTimers();  // Fire what is due; called whenever time moves
+
+// Board peripherals as seen by the firmware
+// The defaults model an idle bench: a steady 25°C thermocouple and a 4V battery.
+// A simulator subclasses this and installs itself with setDevices().
+struct Devices {
+  float temperature = 25.0f;  // °C returned by the default thermocouple
+  int adc = 969;              // Raw A0 reading, about 4V through the battery shield divider
+
+  virtual ~Devices() {}
+  virtual float thermocouple(uint64_t us);       // MAX6675 readCelsius(), NAN on a fault
+  virtual int analog(uint8_t pin, uint64_t us);  // analogRead(), 0..1023
+  virtual void pinChanged(uint8_t /*pin*/, int /*level*/, uint64_t /*us*/) {}
+  virtual void toneChanged(uint8_t /*pin*/, unsigned int /*frequency*/, uint64_t /*us*/) {}  // 0 = silent
+  virtual void panelWritten(uint64_t /*us*/) {}  // End of an I2C transfer to the OLED
+  virtual void published(const char* /*topic*/, const uint8_t* /*payload*/, size_t /*length*/, uint64_t /*us*/) {}
+};
+
+void setDevices(Devices* devices);
+Devices& devices();
+
+// GPIO state, readable by the runner and simulators
+void setPin(uint8_t pin, int level);
+int pinLevel(uint8_t pin);
+void setTone(uint8_t pin, unsigned int frequency);
+unsigned int toneFrequency(uint8_t pin);
+
+// SSD1306 display RAM with its addressing window, in vertical addressing mode
+// RAM is column-major like GyverOLED's buffer, one byte per page: x * 4 + page.
+struct Panel {
+  static const uint8_t WIDTH = 128;
+  static const uint8_t PAGES = 4;
+  uint8_t ram[WIDTH * PAGES] = {};
+  uint8_t x0 = 0, x1 = WIDTH - 1, page0 = 0, page1 = PAGES - 1;
+  uint8_t x = 0, page = 0;      // Write pointer
+  uint32_t i2cBytes = 0;        // Bytes on the bus so far, addresses and commands included
+
+  void setWindow(uint8_t wx0, uint8_t wpage0, uint8_t wx1, uint8_t wpage1);
+  void data(uint8_t b);         // Write at the pointer and advance: page first, then column
+};
+Panel& panel();
+void i2cTransfer(size_t bytes);        // Account bus bytes and their time at 400kHz
+void setI2cByteTime(uint32_t us);      // us per byte including ack, 0 for a free bus
+
+// Network the WiFi and PubSubClient fakes see
+// Between the client and the broker sits a faulty link: messages take latencyMs
+// each way, and lost segments are resent by TCP after retransmitMs, doubling per
+// retry, so loss shows as delay and the stream stays in order. A half-open
+// connection (peer gone without FIN or RST) swallows everything while the client
+// still believes it is connected, until its keepalive ping times out. Whatever is
+// on the wire when a connection dies is lost.
+struct Network {
+  bool accessPoint = true;    // AP in range: WiFi.begin() associates after associateMs
+  uint32_t associateMs = 1500;
+  bool broker = true;         // Broker accepting connections
+  uint32_t connectMs = 5;     // CONNECT to CONNACK; blocks the firmware like the real client
+  uint32_t published = 0;     // Messages and payload bytes the broker has received
+  uint32_t publishedBytes = 0;
+
+  uint32_t latencyMs = 0;
+  uint8_t lossPercent = 0;
+  uint32_t retransmitMs = 200;
+  bool halfOpen = false;
+  uint64_t halfOpenSince = 0;   // us
+  uint32_t keepAliveMs = 15000; // PubSubClient's MQTT_KEEPALIVE
+  uint32_t lostOnWire = 0;      // Messages that died with their connection, both directions
+};
+Network& network();
+
+// Client side: a message written to the socket, handed to devices().published()
+// once it reaches the broker
+void sendToBroker(const char* topic, const uint8_t* payload, size_t length);
+void dropConnection();  // The client's connection closed or timed out
+void setHalfOpen();     // The current connection goes half-open from now on
+
+// Broker side: queue a message for the client's subscriptions, delivered from its loop()
+// once it has crossed the link
+void injectMessage(const char* topic, const char* payload);
+bool takeMessage(const char** topic, const char** payload);  // Oldest arrived message, if any
+void popMessage();
+
+// Device identity and the external serial port, once the firmware has created it
+uint32_t chipId();
+void registerSoftSerial(HostSerial* port);
+HostSerial* softSerial();
+
+}  // namespace NativeHal
+
+#endif // NATIVE_HAL_H
@@ -0,0 +1,157 @@
+// Host runner for [env:native]: setup() once, then loop() until the run time is up
+// The firmware's serial output goes to stdout; a summary of loops, board time and
+// host time goes to stderr. With --scenario, --frames or --edges the board's
+// peripherals are a BoardSimulator and its latency report follows the summary.
+// Unit tests (pio test -e native) bring their own main(), so it is left out there.
+#ifndef PIO_UNIT_TESTING
+#include <Arduino.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "BoardSimulator.h"
+
+void setup();
+void loop();
+
+namespace {
+
+const char* USAGE =
+  "usage: program [options]\n"
+  "  --seconds N               run time in board seconds (default 10, or the scenario's)\n"
+  "  --tick US                 virtual time between loop() calls (default 100)\n"
+  "  --real-time               use the host clock instead of virtual time\n"
+  "  --temperature C           steady thermocouple reading (default 25)\n"
+  "  --serial MS:TEXT          type TEXT on the debug serial port at MS\n"
+  "  --soft MS:TEXT            send TEXT on the external serial port at MS\n"
+  "  --mqtt MS:TOPIC=PAYLOAD   broker delivers a message at MS\n"
+  "  --scenario FILE           simulate the board from a scenario (see BoardSimulator.h)\n"
+  "  --frames DIR[:MS]         save changed OLED frames as PBM, at most one per MS (default 100)\n"
+  "  --edges FILE              save buzzer and trigger edges as CSV\n"
+  "  --results FILE            append the scenario's outage measurements as CSV\n"
+  "  --quiet                   drop the firmware's debug serial output\n";
+
+double hostSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+bool parseInput(const char* arg, InputKind kind, std::vector<ScheduledInput>& inputs) {
+  const char* colon = strchr(arg, ':');
+  if (colon == NULL) return false;
+  inputs.push_back({ strtoull(arg, NULL, 10) * 1000ULL, kind, colon + 1 });
+  return true;
+}
+
+void deliver(const ScheduledInput& input) {
+  if (input.kind == INPUT_MQTT) {
+    size_t eq = input.text.find('=');
+    std::string topic = input.text.substr(0, eq);
+    std::string payload = eq == std::string::npos ? "" : input.text.substr(eq + 1);
+    NativeHal::injectMessage(topic.c_str(), payload.c_str());
+    return;
+  }
+  HostSerial* port = input.kind == INPUT_SOFT ? NativeHal::softSerial() : &Serial;
+  if (port == NULL) {
+    fprintf(stderr, "native: no external serial port in this build, dropped '%s'\n", input.text.c_str());
+    return;
+  }
+  port->inject((input.text + "\n").c_str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  double seconds = 0;
+  uint64_t tick = 100;
+  std::vector<ScheduledInput> inputs;
+  const char* scenario = NULL;
+  const char* frames = NULL;
+  const char* edges = NULL;
+  const char* results = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    bool ok = true;
+    if (!strcmp(arg, "--help")) { fputs(USAGE, stdout); return 0; }
+    else if (!strcmp(arg, "--real-time")) NativeHal::setClockMode(NativeHal::CLOCK_REAL);
+    else if (!strcmp(arg, "--quiet")) Serial.setOutput(NULL);
+    else if (value == NULL) ok = false;
+    else if (!strcmp(arg, "--seconds")) { seconds = atof(value); i++; }
+    else if (!strcmp(arg, "--tick")) { tick = strtoull(value, NULL, 10); i++; }
+    else if (!strcmp(arg, "--temperature")) { NativeHal::devices().temperature = atof(value); i++; }
+    else if (!strcmp(arg, "--serial")) { ok = parseInput(value, INPUT_SERIAL, inputs); i++; }
+    else if (!strcmp(arg, "--soft")) { ok = parseInput(value, INPUT_SOFT, inputs); i++; }
+    else if (!strcmp(arg, "--mqtt")) { ok = parseInput(value, INPUT_MQTT, inputs); i++; }
+    else if (!strcmp(arg, "--scenario")) { scenario = value; i++; }
+    else if (!strcmp(arg, "--frames")) { frames = value; i++; }
+    else if (!strcmp(arg, "--edges")) { edges = value; i++; }
+    else if (!strcmp(arg, "--results")) { results = value; i++; }
+    else ok = false;
+    if (!ok) {
+      fprintf(stderr, "native: bad argument '%s'\n%s", arg, USAGE);
+      return 2;
+    }
+  }
+
+  BoardSimulator simulator;
+  bool simulate = scenario || frames || edges || results;
+  if (scenario) {
+    std::string error;
+    if (!simulator.load(scenario, error)) {
+      fprintf(stderr, "native: %s\n", error.c_str());
+      return 2;
+    }
+    inputs.insert(inputs.end(), simulator.inputs().begin(), simulator.inputs().end());
+    if (seconds <= 0) seconds = simulator.seconds();
+  }
+  if (frames) {
+    std::string dir(frames);
+    size_t colon = dir.rfind(':');
+    uint64_t interval = 100000;
+    if (colon != std::string::npos) {
+      interval = strtoull(dir.c_str() + colon + 1, NULL, 10) * 1000ULL;
+      dir.resize(colon);
+    }
+    simulator.recordFrames(dir, interval);
+  }
+  if (simulate) NativeHal::setDevices(&simulator);
+  if (seconds <= 0) seconds = 10;
+
+  uint64_t end = (uint64_t)(seconds * 1e6);
+  double hostStart = hostSeconds();
+  unsigned long loops = 0;
+
+  setup();
+  while (NativeHal::now() < end) {
+    for (size_t i = 0; i < inputs.size();) {
+      if (inputs[i].at <= NativeHal::now()) {
+        deliver(inputs[i]);
+        inputs.erase(inputs.begin() + i);
+      } else {
+        i++;
+      }
+    }
+    loop();
+    loops++;
+    if (simulate) simulator.afterLoop(NativeHal::now());
+    NativeHal::advance(tick);
+  }
+
+  double hostTime = hostSeconds() - hostStart;
+  fprintf(stderr, "native: %lu loops in %.3fs board time, %.3fs host time (%.0f loops/s, %.1fx real time)\n",
+          loops, NativeHal::now() / 1e6, hostTime, loops / hostTime, NativeHal::now() / 1e6 / hostTime);
+  fprintf(stderr, "native: %u MQTT messages (%u bytes) published, %u I2C bytes to the OLED\n",
+          NativeHal::network().published, NativeHal::network().publishedBytes, NativeHal::panel().i2cBytes);
+  if (simulate) {
+    simulator.finish(NativeHal::now());
+    simulator.report(stderr, NativeHal::now());
+    if (edges && !simulator.writeEdges(edges)) fprintf(stderr, "native: cannot write %s\n", edges);
+    if (results && !simulator.writeResults(results)) fprintf(stderr, "native: cannot write %s\n", results);
+  }
+  NativeHal::setDevices(NULL);
+  return 0;
+}
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,102 @@
+#ifndef NATIVE_PRINT_H
+#define NATIVE_PRINT_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "WString.h"
+
+class Print;
+
+// Objects that know how to print themselves, e.g. IPAddress
+class Printable {
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print& p) const = 0;
+};
+
+// Arduino Print: everything funnels into write(uint8_t)
+// println() ends lines with "\n" instead of the device's "\r\n" so host logs diff cleanly.
+class Print {
+private:
+  size_t printNumber(unsigned long v, int base) {
+    char buf[8 * sizeof(long) + 1];
+    char* p = &buf[sizeof(buf) - 1];
+    *p = '\0';
+    if (base < 2) base = 10;
+    do {
+      unsigned long digit = v % base;
+      *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+      v /= base;
+    } while (v);
+    return write(p);
+  }
+
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = 10) { return printNumber(v, base); }
+  size_t print(int v, int base = 10) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = 10) { return printNumber(v, base); }
+  size_t print(long v, int base = 10) {
+    if (v < 0 && base == 10) return print('-') + printNumber(-(unsigned long)v, 10);
+    return printNumber((unsigned long)v, base);
+  }
+  size_t print(unsigned long v, int base = 10) { return printNumber(v, base); }
+  size_t print(double v, int digits = 2) {
+    char buf[40];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return write(buf);
+  }
+  size_t print(const Printable& p) { return p.printTo(*this); }
+
+  size_t println() { return write((uint8_t)'\n'); }
+  template <typename T>
+  size_t println(const T& v) { size_t n = print(v); return n + println(); }
+  size_t println(double v, int digits) { size_t n = print(v, digits); return n + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char small[128];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(small, sizeof(small), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    if ((size_t)length < sizeof(small)) return write((const uint8_t*)small, length);
+
+    std::string big(length + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&big[0], big.size(), format, args);
+    va_end(args);
+    return write((const uint8_t*)big.data(), length);
+  }
+};
+
+// Arduino Stream: a Print that can also be read from
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  // Reads what has arrived; on the host there is nothing more to wait for
+  String readStringUntil(char terminator) {
+    String s;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) s += (char)c;
+    return s;
+  }
+};
+
+#endif // NATIVE_PRINT_H
@@ -0,0 +1,192 @@
+#ifndef NATIVE_PUBSUBCLIENT_H
+#define NATIVE_PUBSUBCLIENT_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define MQTT_CONNECTION_TIMEOUT -4
+#define MQTT_CONNECTION_LOST -3
+#define MQTT_CONNECT_FAILED -2
+#define MQTT_DISCONNECTED -1
+#define MQTT_CONNECTED 0
+
+#define MQTT_CALLBACK_SIGNATURE std::function<void(char*, uint8_t*, unsigned int)> callback
+
+// PubSubClient against the in-process broker of NativeHal::network()
+// Publishes cross the link to NativeHal::devices().published(); messages queued
+// with NativeHal::injectMessage() reach the callback from loop() when they have
+// arrived and match a subscription. The session is dropped when WiFi or the
+// broker goes away, or by keepalive timeout on a half-open connection.
+class PubSubClient : public Print {
+private:
+  MQTT_CALLBACK_SIGNATURE;
+  std::vector<std::string> _subscriptions;
+  bool _connected = false;
+  int _state = MQTT_DISCONNECTED;
+  std::string _streamTopic;    // beginPublish() .. endPublish()
+  std::string _streamPayload;
+  size_t _streamLength = 0;
+  bool _streaming = false;
+
+  // MQTT topic filter match with + and # wildcards
+  static bool matches(const char* filter, const char* topic) {
+    for (;;) {
+      if (*filter == '#') return true;
+      if (*filter == '+') {
+        filter++;
+        while (*topic && *topic != '/') topic++;
+      } else {
+        while (*filter && *filter != '/' && *filter == *topic) {
+          filter++;
+          topic++;
+        }
+        if ((*filter && *filter != '/') || (*topic && *topic != '/')) return false;
+      }
+      if (!*filter && !*topic) return true;
+      if (*filter == '/' && filter[1] == '#' && !*topic) return true;  // "a/#" also matches "a"
+      if (*filter != '/' || *topic != '/') return false;
+      filter++;
+      topic++;
+    }
+  }
+
+  bool linkUp() {
+    if (!_connected) return false;
+    NativeHal::Network& net = NativeHal::network();
+    if (WiFi.status() != WL_CONNECTED || !net.broker) {
+      _state = MQTT_CONNECTION_LOST;
+    } else if (net.halfOpen && NativeHal::now() - net.halfOpenSince >= 2000ULL * net.keepAliveMs) {
+      // Nothing came back: a PINGREQ goes out after one keepalive, the client gives up after another
+      _state = MQTT_CONNECTION_TIMEOUT;
+    } else {
+      return true;
+    }
+    _connected = false;
+    NativeHal::dropConnection();
+    return false;
+  }
+
+  bool deliver(const char* topic, const uint8_t* payload, size_t length) {
+    NativeHal::sendToBroker(topic, payload, length);
+    return true;
+  }
+
+public:
+  PubSubClient(WiFiClient& client) { (void)client; }
+
+  PubSubClient& setServer(const char* domain, uint16_t port) {
+    (void)domain;
+    (void)port;
+    return *this;
+  }
+
+  PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE) {
+    this->callback = callback;
+    return *this;
+  }
+
+  bool connect(const char* id, const char* user, const char* pass, const char* willTopic, uint8_t willQos,
+               bool willRetain, const char* willMessage, bool cleanSession) {
+    (void)id; (void)user; (void)pass; (void)willTopic; (void)willQos; (void)willRetain; (void)willMessage;
+    if (WiFi.status() != WL_CONNECTED || !NativeHal::network().broker) {
+      _state = MQTT_CONNECT_FAILED;
+      return false;
+    }
+    NativeHal::sleep(NativeHal::network().connectMs * 1000ULL);  // Blocking handshake
+    if (cleanSession) _subscriptions.clear();
+    _connected = true;
+    _state = MQTT_CONNECTED;
+    return true;
+  }
+
+  bool connect(const char* id) { return connect(id, NULL, NULL, NULL, 0, false, NULL, true); }
+  bool connect(const char* id, const char* user, const char* pass) {
+    return connect(id, user, pass, NULL, 0, false, NULL, true);
+  }
+
+  void disconnect() {
+    if (_connected) NativeHal::dropConnection();
+    _connected = false;
+    _state = MQTT_DISCONNECTED;
+  }
+
+  bool connected() { return linkUp(); }
+  int state() { return _state; }
+
+  bool loop() {
+    if (!linkUp()) return false;
+    const char* topic;
+    const char* payload;
+    while (NativeHal::takeMessage(&topic, &payload)) {
+      bool subscribed = false;
+      for (const std::string& filter : _subscriptions) subscribed |= matches(filter.c_str(), topic);
+      std::string t(topic), p(payload);
+      NativeHal::popMessage();
+      if (subscribed && callback) callback(&t[0], (uint8_t*)&p[0], p.size());
+    }
+    return true;
+  }
+
+  bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained) {
+    (void)retained;
+    if (!linkUp()) return false;
+    return deliver(topic, payload, length);
+  }
+  bool publish(const char* topic, const char* payload) {
+    return publish(topic, (const uint8_t*)payload, strlen(payload), false);
+  }
+  bool publish(const char* topic, const char* payload, bool retained) {
+    return publish(topic, (const uint8_t*)payload, strlen(payload), retained);
+  }
+
+  bool subscribe(const char* topic, uint8_t qos = 0) {
+    (void)qos;
+    if (!linkUp()) return false;
+    for (const std::string& filter : _subscriptions) {
+      if (filter == topic) return true;
+    }
+    _subscriptions.push_back(topic);
+    return true;
+  }
+
+  bool unsubscribe(const char* topic) {
+    if (!linkUp()) return false;
+    for (size_t i = 0; i < _subscriptions.size(); i++) {
+      if (_subscriptions[i] == topic) {
+        _subscriptions.erase(_subscriptions.begin() + i);
+        break;
+      }
+    }
+    return true;
+  }
+
+  // Streamed publish: the payload is collected and handed over on endPublish()
+  bool beginPublish(const char* topic, unsigned int length, bool retained) {
+    (void)retained;
+    if (!linkUp()) return false;
+    _streamTopic = topic;
+    _streamPayload.clear();
+    _streamLength = length;
+    _streaming = true;
+    return true;
+  }
+
+  size_t write(uint8_t b) override {
+    if (!_streaming) return 0;
+    _streamPayload += (char)b;
+    return 1;
+  }
+  using Print::write;
+
+  int endPublish() {
+    if (!_streaming) return 0;
+    _streaming = false;
+    if (!linkUp() || _streamPayload.size() != _streamLength) return 0;
+    return deliver(_streamTopic.c_str(), (const uint8_t*)_streamPayload.data(), _streamPayload.size()) ? 1 : 0;
+  }
+};
+
+#endif // NATIVE_PUBSUBCLIENT_H
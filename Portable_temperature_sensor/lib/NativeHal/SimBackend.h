@@ -0,0 +1,107 @@
+#ifndef SIM_BACKEND_H
+#define SIM_BACKEND_H
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "NativeHal.h"
+#include "SampleCodec.h"
+
+// Stand-in for the backend that receives sample batches and acknowledges them
+// Keeps the next expected sequence number per device and boot. Samples before it
+// are duplicates from a go-back-N resend; a batch starting past it means samples
+// the device never sent (its ring overflowed), which are counted as lost and
+// skipped so delivery can go on. Every batch is answered with a cumulative ack on
+// sensor/<id>/set/ack ("<boot ID>:<next>"), which crosses the faulty link like any
+// other message.
+class SimBackend {
+public:
+  struct Delivery {
+    uint32_t count;       // Samples in the batch
+    uint32_t accepted;    // New samples
+    uint32_t duplicates;
+    uint32_t lost;        // Gap before the batch
+  };
+
+private:
+  struct Device {
+    std::string prefix;   // "sensor/<id>/"
+    uint32_t bootId;
+    uint32_t expected;
+  };
+
+  std::vector<Device> _devices;
+  std::vector<Sample> _scratch;
+  uint64_t _batches = 0;
+  uint64_t _accepted = 0;
+  uint64_t _duplicates = 0;
+  uint64_t _lost = 0;
+  uint32_t _malformed = 0;
+  uint32_t _acks = 0;
+
+  Device& device(const std::string& prefix, uint32_t bootId, uint32_t first) {
+    for (Device& d : _devices) {
+      if (d.prefix != prefix) continue;
+      if (d.bootId != bootId) {
+        d.bootId = bootId;  // Rebooted: sequence numbers start over
+        d.expected = first;
+      }
+      return d;
+    }
+    _devices.push_back({ prefix, bootId, first });
+    return _devices.back();
+  }
+
+public:
+  // A message reached the broker; returns true and fills `delivery` for a valid batch
+  bool received(const char* topic, const uint8_t* payload, size_t length, Delivery& delivery) {
+    static const char suffix[] = "batch";
+    size_t topicLength = strlen(topic);
+    if (topicLength < sizeof(suffix) - 1 || strcmp(topic + topicLength - (sizeof(suffix) - 1), suffix) != 0) {
+      return false;
+    }
+
+    SampleBatchHeader header;
+    const uint8_t* p = payload;
+    if (!decodeSampleBatchHeader(p, payload + length, header)) {
+      _malformed++;
+      return false;
+    }
+    _scratch.resize(header.count > 0 ? header.count : 1);
+    if (!decodeSampleBatch(payload, length, header, _scratch.data(), header.count)) {
+      _malformed++;
+      return false;
+    }
+
+    std::string prefix(topic, topicLength - (sizeof(suffix) - 1));
+    Device& d = device(prefix, header.bootId, header.first);
+    uint32_t end = header.first + header.count;
+    delivery.count = header.count;
+    delivery.lost = (int32_t)(header.first - d.expected) > 0 ? header.first - d.expected : 0;
+    uint32_t from = delivery.lost > 0 ? header.first : d.expected;
+    delivery.accepted = (int32_t)(end - from) > 0 ? end - from : 0;
+    delivery.duplicates = header.count - delivery.accepted;
+    if ((int32_t)(end - d.expected) > 0) d.expected = end;
+
+    _batches++;
+    _accepted += delivery.accepted;
+    _duplicates += delivery.duplicates;
+    _lost += delivery.lost;
+
+    char ack[SAMPLE_ACK_LEN];
+    formatSampleAck(ack, sizeof(ack), d.bootId, d.expected);
+    NativeHal::injectMessage((prefix + "set/ack").c_str(), ack);
+    _acks++;
+    return true;
+  }
+
+  uint64_t batches() const { return _batches; }
+  uint64_t accepted() const { return _accepted; }
+  uint64_t duplicates() const { return _duplicates; }
+  uint64_t lost() const { return _lost; }
+  uint32_t malformed() const { return _malformed; }
+  uint32_t acks() const { return _acks; }
+};
+
+#endif // SIM_BACKEND_H
@@ -0,0 +1,58 @@
+#ifndef SIM_BATTERY_H
+#define SIM_BATTERY_H
+
+#include <math.h>
+#include <stdint.h>
+
+// Single-cell LiPo on the battery shield, as seen on A0
+// State of charge drops with a constant load current; the terminal voltage is the
+// open-circuit voltage for that charge less the drop across the cell's internal
+// resistance. The A0 reading inverts the firmware's conversion in batteryMonitor()
+// (divider ratio 4.4, 0.17V offset), i.e. it models a calibrated board.
+class SimBattery {
+private:
+  float _capacityMah;
+  float _loadMa;
+  float _charge;               // State of charge, 0..1
+  float _resistance = 0.15f;   // Ohm
+  uint64_t _time = 0;
+
+  // Open-circuit voltage at 0%, 10%, ... 100% charge
+  static float openCircuitVoltage(float charge) {
+    static const float curve[11] = { 3.00f, 3.68f, 3.74f, 3.77f, 3.79f, 3.82f, 3.87f, 3.92f, 3.98f, 4.06f, 4.20f };
+    float position = charge * 10.0f;
+    if (position <= 0) return curve[0];
+    if (position >= 10) return curve[10];
+    int i = (int)position;
+    return curve[i] + (curve[i + 1] - curve[i]) * (position - i);
+  }
+
+  void drain(uint64_t now) {
+    if (now <= _time) return;
+    float hours = (now - _time) / 3.6e9f;
+    _time = now;
+    _charge -= _loadMa * hours / _capacityMah;
+    if (_charge < 0) _charge = 0;
+  }
+
+public:
+  SimBattery(float capacityMah, float loadMa, float startCharge)
+    : _capacityMah(capacityMah), _loadMa(loadMa), _charge(startCharge) {}
+
+  float charge(uint64_t now) {
+    drain(now);
+    return _charge;
+  }
+
+  float voltage(uint64_t now) {
+    drain(now);
+    return openCircuitVoltage(_charge) - _loadMa / 1000.0f * _resistance;
+  }
+
+  int adc(uint64_t now) {
+    int raw = (int)lroundf((voltage(now) + 0.17f) / 4.4f * 1023.0f);
+    return raw < 0 ? 0 : (raw > 1023 ? 1023 : raw);
+  }
+};
+
+#endif // SIM_BATTERY_H
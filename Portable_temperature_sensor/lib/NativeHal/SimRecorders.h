@@ -0,0 +1,96 @@
+#ifndef SIM_RECORDERS_H
+#define SIM_RECORDERS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "NativeHal.h"
+
+// Writes the OLED's display RAM to numbered PBM images whenever it has changed
+// At most one frame per interval, so a frame sent in slices over several loops is
+// usually caught complete; what is captured is what the panel shows at that moment.
+class PanelRecorder {
+private:
+  std::string _dir;
+  uint64_t _intervalUs;
+  uint64_t _lastCapture = 0;
+  uint8_t _last[NativeHal::Panel::WIDTH * NativeHal::Panel::PAGES] = {};
+  bool _dirty = false;
+  uint32_t _frames = 0;
+
+  bool write(const uint8_t* ram, uint64_t now) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%05u.pbm", _dir.c_str(), (unsigned)_frames);
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) return false;
+    const int width = NativeHal::Panel::WIDTH;
+    const int height = NativeHal::Panel::PAGES * 8;
+    fprintf(f, "P4\n# t=%lums\n%d %d\n", (unsigned long)(now / 1000), width, height);
+    for (int y = 0; y < height; y++) {
+      uint8_t row[NativeHal::Panel::WIDTH / 8] = {};
+      for (int x = 0; x < width; x++) {
+        if (ram[x * NativeHal::Panel::PAGES + y / 8] & (1 << (y & 7))) row[x / 8] |= 0x80 >> (x & 7);
+      }
+      fwrite(row, 1, sizeof(row), f);
+    }
+    fclose(f);
+    return true;
+  }
+
+public:
+  PanelRecorder(const std::string& dir, uint64_t intervalUs) : _dir(dir), _intervalUs(intervalUs) {}
+
+  void written() { _dirty = true; }
+
+  // Called after each loop(); force captures a pending change regardless of the interval
+  void poll(uint64_t now, bool force = false) {
+    if (!_dirty || (!force && _frames > 0 && now - _lastCapture < _intervalUs)) return;
+    const uint8_t* ram = NativeHal::panel().ram;
+    _dirty = false;
+    if (_frames > 0 && memcmp(ram, _last, sizeof(_last)) == 0) return;
+    if (!write(ram, now)) return;
+    memcpy(_last, ram, sizeof(_last));
+    _lastCapture = now;
+    _frames++;
+  }
+
+  uint32_t frames() const { return _frames; }
+  const std::string& dir() const { return _dir; }
+};
+
+// Timestamped edges of the buzzer and the trigger output
+class EdgeRecorder {
+public:
+  struct Edge {
+    uint64_t us;
+    const char* signal;  // "buzzer" (value = tone Hz, 0 = off) or "trigger" (value = level)
+    unsigned int value;
+  };
+
+private:
+  std::vector<Edge> _edges;
+
+public:
+  void record(uint64_t us, const char* signal, unsigned int value) {
+    _edges.push_back({ us, signal, value });
+  }
+
+  uint32_t count(const char* signal) const {
+    uint32_t n = 0;
+    for (const Edge& e : _edges) n += strcmp(e.signal, signal) == 0;
+    return n;
+  }
+
+  bool writeCsv(const char* path) const {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) return false;
+    fprintf(f, "us,signal,value\n");
+    for (const Edge& e : _edges) fprintf(f, "%llu,%s,%u\n", (unsigned long long)e.us, e.signal, e.value);
+    fclose(f);
+    return true;
+  }
+};
+
+#endif // SIM_RECORDERS_H
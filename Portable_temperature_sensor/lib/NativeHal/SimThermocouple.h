@@ -0,0 +1,202 @@
+#ifndef SIM_THERMOCOUPLE_H
+#define SIM_THERMOCOUPLE_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Temperature at the probe over time
+// Piecewise linear between points; two points at the same time make a step.
+// Open-circuit intervals (broken or unplugged thermocouple) are kept separately.
+class TemperatureProfile {
+private:
+  struct Point {
+    uint64_t us;
+    float celsius;
+  };
+  struct Interval {
+    uint64_t from;
+    uint64_t to;
+  };
+  std::vector<Point> _points;
+  std::vector<Interval> _open;
+
+public:
+  bool empty() const { return _points.empty(); }
+  uint64_t end() const { return _points.empty() ? 0 : _points.back().us; }
+
+  // Linear from the previous point to this one; points must come in time order
+  void rampTo(uint64_t us, float celsius) {
+    if (!_points.empty() && us < _points.back().us) us = _points.back().us;
+    _points.push_back({ us, celsius });
+  }
+
+  // Jump to a new value at `us`, holding the previous value until then
+  void stepTo(uint64_t us, float celsius) {
+    if (!_points.empty()) rampTo(us, at(us));
+    rampTo(us, celsius);
+  }
+
+  void addOpen(uint64_t from, uint64_t to) {
+    _open.push_back({ from, to });
+  }
+
+  float at(uint64_t us) const {
+    if (_points.empty()) return 25.0f;
+    // Last point at or before `us`; of points at the same time, the later one
+    auto next = std::upper_bound(_points.begin(), _points.end(), us,
+                                 [](uint64_t t, const Point& p) { return t < p.us; });
+    if (next == _points.begin()) return _points.front().celsius;
+    if (next == _points.end()) return _points.back().celsius;
+    const Point& a = *(next - 1);
+    const Point& b = *next;
+    return a.celsius + (b.celsius - a.celsius) * (float)(us - a.us) / (float)(b.us - a.us);
+  }
+
+  bool open(uint64_t us) const {
+    for (const Interval& i : _open) {
+      if (us >= i.from && us < i.to) return true;
+    }
+    return false;
+  }
+
+  // Recorded profile, one "ms,celsius" row per line; "open" instead of a value
+  // marks an open circuit until the next numeric row. Lines starting with # and a
+  // non-numeric header line are skipped. Rows are shifted by offsetUs.
+  bool loadCsv(const char* path, uint64_t offsetUs, std::string& error) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+      error = std::string("cannot open ") + path;
+      return false;
+    }
+    char line[128];
+    int lineNo = 0;
+    bool inOpen = false;
+    uint64_t openFrom = 0;
+    uint64_t last = offsetUs;
+    while (fgets(line, sizeof(line), f)) {
+      lineNo++;
+      if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+      char* comma = strchr(line, ',');
+      if (comma == NULL || !(line[0] >= '0' && line[0] <= '9')) {
+        if (lineNo == 1) continue;  // Header
+        error = std::string(path) + ":" + std::to_string(lineNo) + ": expected ms,celsius";
+        fclose(f);
+        return false;
+      }
+      uint64_t us = offsetUs + strtoull(line, NULL, 10) * 1000ULL;
+      const char* value = comma + 1;
+      while (*value == ' ') value++;
+      last = us;
+      if (strncmp(value, "open", 4) == 0) {
+        if (!inOpen) openFrom = us;
+        inOpen = true;
+        continue;
+      }
+      if (inOpen) addOpen(openFrom, us);
+      inOpen = false;
+      rampTo(us, (float)atof(value));
+    }
+    if (inOpen) addOpen(openFrom, last + 1);
+    fclose(f);
+    return true;
+  }
+};
+
+// MAX6675 model
+// The chip converts continuously while CS is high, one conversion every
+// conversionUs (220ms worst case). A read returns the result of the last completed
+// conversion and aborts the one in progress; converting starts again when CS goes
+// back high. Results are 12 bits in 0.25°C steps, clamped to 0..1023.75°C; an open
+// input sets the fault bit, which the library returns as NAN. The probe itself can
+// lag the profile with a first-order time constant.
+class SimMax6675 {
+private:
+  const TemperatureProfile& _profile;
+  uint64_t _conversionUs = 220000;
+  uint64_t _lagUs = 0;       // Probe time constant, 0 = ideal probe
+  int _noiseLsb = 0;         // Uniform noise of +-n counts per conversion
+  uint32_t _random = 0x9E3779B9;
+
+  uint64_t _convStart = 0;   // When the current run of conversions started (CS high)
+  uint64_t _resultTime = 0;  // Completion time of the conversion in _raw
+  int _raw = -1;             // 0.25°C counts, -1 = open circuit; 0 before the first conversion
+  bool _haveResult = false;
+
+  float _probe = 0;          // Lagged probe temperature
+  uint64_t _probeTime = 0;
+  bool _probeStarted = false;
+
+  uint32_t _reads = 0;
+  uint32_t _staleReads = 0;  // Reads that found no new conversion since the last one
+  uint32_t _faultReads = 0;
+
+  uint32_t nextRandom() {
+    _random ^= _random << 13;
+    _random ^= _random >> 17;
+    _random ^= _random << 5;
+    return _random;
+  }
+
+  float probeAt(uint64_t us) {
+    if (_lagUs == 0) return _profile.at(us);
+    if (!_probeStarted) {
+      _probe = _profile.at(0);
+      _probeStarted = true;
+    }
+    const uint64_t stepUs = 1000;
+    const float alpha = 1.0f - expf(-(float)stepUs / (float)_lagUs);
+    while (_probeTime + stepUs <= us) {
+      _probeTime += stepUs;
+      _probe += (_profile.at(_probeTime) - _probe) * alpha;
+    }
+    return _probe;
+  }
+
+  int convert(uint64_t us) {
+    if (_profile.open(us)) return -1;
+    int counts = (int)lroundf(probeAt(us) * 4.0f);
+    if (_noiseLsb > 0) counts += (int)(nextRandom() % (2 * _noiseLsb + 1)) - _noiseLsb;
+    return std::max(0, std::min(4095, counts));
+  }
+
+public:
+  SimMax6675(const TemperatureProfile& profile) : _profile(profile) {}
+
+  void setConversionTime(uint64_t us) { _conversionUs = us; }
+  void setLag(uint64_t us) { _lagUs = us; }
+  void setNoise(int lsb) { _noiseLsb = lsb; }
+
+  // readCelsius() at time `now`
+  float read(uint64_t now) {
+    _reads++;
+    uint64_t completed = (now - _convStart) / _conversionUs;
+    if (completed > 0) {
+      _resultTime = _convStart + completed * _conversionUs;
+      _raw = convert(_resultTime);
+      _haveResult = true;
+    } else {
+      _staleReads++;
+    }
+    _convStart = now;  // Aborted by the read, restarts when CS goes high
+
+    if (!_haveResult) return 0.0f;  // Power-up: the result register is still clear
+    if (_raw < 0) {
+      _faultReads++;
+      return NAN;
+    }
+    return _raw * 0.25f;
+  }
+
+  uint64_t resultTime() const { return _resultTime; }
+  uint32_t reads() const { return _reads; }
+  uint32_t staleReads() const { return _staleReads; }
+  uint32_t faultReads() const { return _faultReads; }
+};
+
+#endif // SIM_THERMOCOUPLE_H
@@ -0,0 +1,16 @@
+#ifndef NATIVE_SOFTWARE_SERIAL_H
+#define NATIVE_SOFTWARE_SERIAL_H
+
+#include <Arduino.h>
+
+// The external device port; its traffic is tagged "soft> " in the host output
+class SoftwareSerial : public HostSerial {
+public:
+  SoftwareSerial(int8_t rxPin, int8_t txPin) : HostSerial("soft> ") {
+    (void)rxPin;
+    (void)txPin;
+    NativeHal::registerSoftSerial(this);
+  }
+};
+
+#endif // NATIVE_SOFTWARE_SERIAL_H
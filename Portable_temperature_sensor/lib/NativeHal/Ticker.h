@@ -0,0 +1,36 @@
+#ifndef NATIVE_TICKER_H
+#define NATIVE_TICKER_H
+
+#include <Arduino.h>
+
+// Ticker on the board clock; callbacks fire whenever time moves past their deadline
+class Ticker {
+public:
+  ~Ticker() { detach(); }
+
+  void once_ms(uint32_t ms, void (*callback)()) {
+    detach();
+    NativeHal::addTimer(this, ms * 1000ULL, 0, callback);
+  }
+
+  template <typename T>
+  void once_ms(uint32_t ms, void (*callback)(T), T arg) {
+    detach();
+    NativeHal::addTimer(this, ms * 1000ULL, 0, [callback, arg]() { callback(arg); });
+  }
+
+  void attach_ms(uint32_t ms, void (*callback)()) {
+    detach();
+    NativeHal::addTimer(this, ms * 1000ULL, ms * 1000ULL, callback);
+  }
+
+  template <typename T>
+  void attach_ms(uint32_t ms, void (*callback)(T), T arg) {
+    detach();
+    NativeHal::addTimer(this, ms * 1000ULL, ms * 1000ULL, [callback, arg]() { callback(arg); });
+  }
+
+  void detach() { NativeHal::removeTimers(this); }
+};
+
+#endif // NATIVE_TICKER_H
@@ -0,0 +1,83 @@
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+// Arduino String on top of std::string, covering what the firmware uses
+class String {
+private:
+  std::string _s;
+
+public:
+  String() {}
+  String(const char* s) : _s(s ? s : "") {}
+  String(const std::string& s) : _s(s) {}
+  explicit String(char c) : _s(1, c) {}
+  explicit String(int v) : _s(std::to_string(v)) {}
+  explicit String(unsigned int v) : _s(std::to_string(v)) {}
+  explicit String(long v) : _s(std::to_string(v)) {}
+  explicit String(unsigned long v) : _s(std::to_string(v)) {}
+  explicit String(double v, unsigned char decimals = 2) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    _s = buf;
+  }
+
+  const char* c_str() const { return _s.c_str(); }
+  unsigned int length() const { return _s.length(); }
+  char charAt(unsigned int i) const { return i < _s.length() ? _s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+
+  bool equals(const String& other) const { return _s == other._s; }
+  bool equals(const char* other) const { return _s == (other ? other : ""); }
+  bool operator==(const String& other) const { return equals(other); }
+  bool operator==(const char* other) const { return equals(other); }
+  bool operator!=(const String& other) const { return !equals(other); }
+  bool operator!=(const char* other) const { return !equals(other); }
+
+  bool startsWith(const String& prefix) const { return _s.compare(0, prefix._s.length(), prefix._s) == 0; }
+  bool endsWith(const String& suffix) const {
+    return _s.length() >= suffix._s.length() &&
+           _s.compare(_s.length() - suffix._s.length(), suffix._s.length(), suffix._s) == 0;
+  }
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t i = _s.find(c, from);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+
+  // Out-of-range bounds are clamped as on the device
+  String substring(unsigned int from) const { return substring(from, _s.length()); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) { unsigned int t = from; from = to; to = t; }
+    if (from >= _s.length()) return String();
+    if (to > _s.length()) to = _s.length();
+    return String(_s.substr(from, to - from));
+  }
+
+  long toInt() const { return atol(_s.c_str()); }
+  float toFloat() const { return (float)atof(_s.c_str()); }
+
+  void trim() {
+    size_t first = _s.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) { _s.clear(); return; }
+    size_t last = _s.find_last_not_of(" \t\r\n");
+    _s = _s.substr(first, last - first + 1);
+  }
+
+  bool concat(const String& s) { _s += s._s; return true; }
+  bool concat(const char* s) { if (s) _s += s; return true; }
+  bool concat(char c) { _s += c; return true; }
+  String& operator+=(const String& s) { concat(s); return *this; }
+  String& operator+=(const char* s) { concat(s); return *this; }
+  String& operator+=(char c) { concat(c); return *this; }
+
+  friend String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+  friend String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, char b) { String r(a); r += b; return r; }
+};
+
+#endif // NATIVE_WSTRING_H
@@ -0,0 +1,15 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+// I2C bus; the only device on it is the OLED, which GyverOLED.h talks to directly
+class TwoWire {
+public:
+  void begin() {}
+  void begin(int sda, int scl) { (void)sda; (void)scl; }
+  void setClock(uint32_t frequency) { (void)frequency; }
+};
+extern TwoWire Wire;
+
+#endif // NATIVE_WIRE_H
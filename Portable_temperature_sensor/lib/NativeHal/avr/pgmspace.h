@@ -0,0 +1,7 @@
+#ifndef NATIVE_AVR_PGMSPACE_H
+#define NATIVE_AVR_PGMSPACE_H
+
+// The ESP8266 core's <avr/pgmspace.h>, included by the asset headers; flash is plain memory here
+#include <Arduino.h>
+
+#endif // NATIVE_AVR_PGMSPACE_H
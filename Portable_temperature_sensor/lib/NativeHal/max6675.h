@@ -0,0 +1,19 @@
+#ifndef NATIVE_MAX6675_H
+#define NATIVE_MAX6675_H
+
+#include <Arduino.h>
+
+// MAX6675 whose readings come from NativeHal::devices()
+class MAX6675 {
+public:
+  MAX6675(int8_t sclk, int8_t cs, int8_t miso) {
+    (void)sclk;
+    (void)cs;
+    (void)miso;
+  }
+
+  float readCelsius() { return NativeHal::devices().thermocouple(NativeHal::now()); }
+  float readFahrenheit() { return readCelsius() * 9.0f / 5.0f + 32.0f; }
+};
+
+#endif // NATIVE_MAX6675_H
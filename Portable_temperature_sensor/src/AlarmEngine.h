@@ -0,0 +1,118 @@
+#ifndef ALARM_ENGINE_H
+#define ALARM_ENGINE_H
+
+#include <stdint.h>
+#include "SampleRing.h"
+
+#define ALARM_LEVELS 3          // Threshold levels; level 1 is the setpoint
+#define ALARM_LEVEL_OFF INT16_MAX
+#define ALARM_ROR_HISTORY 4     // Samples spanned by the rate-of-rise estimate
+
+// Threshold, hysteresis and rate-of-rise alarm evaluation
+// Runs on every fresh sample, in the same 0.25°C fixed point as the sample ring.
+// A level trips when the temperature rises above its threshold and clears once it
+// falls below threshold - hysteresis; each level keeps its own state, and the
+// highest tripped one is reported by level(). The rate-of-rise trigger compares the slope
+// over the last few samples against a limit in 0.25°C per second and clears when
+// the slope drops under half the limit. A fault empties the slope history, and the
+// trigger keeps its state until the history is full again. update() reports
+// whether the alarm output changed, so the caller only touches the buzzer on
+// transitions.
+class AlarmEngine {
+private:
+  int16_t _thresholds[ALARM_LEVELS] = { 320, ALARM_LEVEL_OFF, ALARM_LEVEL_OFF };
+  int16_t _hysteresis = 4;   // 1°C
+  int16_t _rorLimit = 0;     // 0.25°C/s; 0 disables the rate-of-rise trigger
+
+  uint8_t _level = 0;        // Highest tripped level, 0 when none
+  uint8_t _tripped = 0;      // Bit n set while level n + 1 is tripped
+  bool _rateOfRise = false;
+
+  Sample _history[ALARM_ROR_HISTORY];
+  uint8_t _historyCount = 0;
+  uint8_t _historyNext = 0;
+
+  int32_t _slope = 0;        // Last rate-of-rise estimate, 0.25°C/s
+
+  void updateLevel(int16_t value) {
+    uint8_t level = 0;
+    uint8_t trippedLevels = 0;
+    for (uint8_t i = 0; i < ALARM_LEVELS; i++) {
+      if (_thresholds[i] == ALARM_LEVEL_OFF) continue;
+      bool held = _tripped & (1 << i);
+      bool tripped = held ? (value >= _thresholds[i] - _hysteresis) : (value > _thresholds[i]);
+      if (tripped) {
+        trippedLevels |= 1 << i;
+        level = i + 1;
+      }
+    }
+    _level = level;
+    _tripped = trippedLevels;
+  }
+
+  void updateRateOfRise(uint32_t ms, int16_t value) {
+    bool fresh = _historyCount == ALARM_ROR_HISTORY;  // A slope over a full history
+    if (fresh) {
+      const Sample& oldest = _history[_historyNext];
+      uint32_t dt = ms - oldest.ms;
+      _slope = (dt > 0) ? ((int32_t)(value - oldest.value) * 1000) / (int32_t)dt : 0;
+    } else {
+      _historyCount++;
+    }
+    _history[_historyNext].ms = ms;
+    _history[_historyNext].value = value;
+    _historyNext = (_historyNext + 1) % ALARM_ROR_HISTORY;
+
+    if (_rorLimit <= 0) {
+      _rateOfRise = false;
+    } else if (!fresh) {
+      return;  // Still filling the history after power-up or a fault; _slope is from before
+    } else if (_rateOfRise) {
+      _rateOfRise = _slope * 2 >= _rorLimit;
+    } else {
+      _rateOfRise = _slope >= _rorLimit;
+    }
+  }
+
+public:
+  // Evaluate a fresh sample; returns true when the alarm state changed
+  bool update(uint32_t ms, int16_t value) {
+    uint8_t trippedLevels = _tripped;
+    bool rateOfRise = _rateOfRise;
+
+    if (value == SAMPLE_FAULT) {
+      _historyCount = 0;  // A gap in the data invalidates the slope
+      _historyNext = 0;
+      return false;       // Keep the last decision until valid data returns
+    }
+
+    updateLevel(value);
+    updateRateOfRise(ms, value);
+    return trippedLevels != _tripped || rateOfRise != _rateOfRise;
+  }
+
+  void setThreshold(uint8_t level, int16_t value) {
+    if (level >= 1 && level <= ALARM_LEVELS) _thresholds[level - 1] = value;
+  }
+
+  int16_t getThreshold(uint8_t level) const {
+    return (level >= 1 && level <= ALARM_LEVELS) ? _thresholds[level - 1] : ALARM_LEVEL_OFF;
+  }
+
+  void setHysteresis(int16_t hysteresis) { _hysteresis = (hysteresis < 0) ? 0 : hysteresis; }
+  int16_t getHysteresis() const { return _hysteresis; }
+
+  void setRateOfRiseLimit(int16_t limit) { _rorLimit = limit; }
+  int16_t getRateOfRiseLimit() const { return _rorLimit; }
+
+  uint8_t level() const { return _level; }
+  // One level on its own, e.g. level 1 for the setpoint, whatever the other levels do
+  bool tripped(uint8_t level) const {
+    return level >= 1 && level <= ALARM_LEVELS && (_tripped & (1 << (level - 1)));
+  }
+  bool rateOfRise() const { return _rateOfRise; }
+  bool active() const { return _level > 0 || _rateOfRise; }
+  int32_t slope() const { return _slope; }
+};
+
+#endif // ALARM_ENGINE_H
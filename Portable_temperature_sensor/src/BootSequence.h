@@ -0,0 +1,86 @@
+#ifndef BOOT_SEQUENCE_H
+#define BOOT_SEQUENCE_H
+
+#include <Arduino.h>
+
+// Screens shown after power-on, in order
+enum BootStage {
+  BOOT_SPLASH,  // Splash animation
+  BOOT_HOLD,    // Last splash frame held
+  BOOT_INFO,    // Version and device ID
+  BOOT_DONE     // Measurement screen
+};
+
+// Points on the boot timeline worth reporting
+enum BootMilestone {
+  BOOT_WIFI,            // WiFi associated
+  BOOT_MQTT,            // Broker session ready
+  BOOT_FIRST_SAMPLE,    // First valid thermocouple reading
+  BOOT_FIRST_PUBLISH,   // First sample handed to the broker
+  BOOT_UI_READY,        // Measurement screen shown
+  BOOT_MILESTONE_COUNT
+};
+
+// Non-blocking boot orchestration
+// setup() only starts things (WiFi association, MQTT config, display init) and
+// returns; the boot screens are then stepped from loop() like any other task, so
+// the sensor is sampled and the network comes up while the splash is playing.
+// The stage clock tells the caller how long the current screen has been up.
+// Milestones are millis() at the moment they were first reached, which is the
+// time since power-on; 0 means not reached yet.
+class BootSequence {
+private:
+  BootStage _stage = BOOT_SPLASH;
+  unsigned long _stageStart = 0;
+  unsigned long _milestones[BOOT_MILESTONE_COUNT] = {};
+
+public:
+  void begin(unsigned long now) {
+    _stage = BOOT_SPLASH;
+    _stageStart = now;
+  }
+
+  BootStage stage() const { return _stage; }
+  bool done() const { return _stage == BOOT_DONE; }
+
+  // ms the current stage has been running
+  unsigned long elapsed(unsigned long now) const {
+    return now - _stageStart;
+  }
+
+  void advance(unsigned long now) {
+    if (_stage == BOOT_DONE) return;
+    _stage = (BootStage)(_stage + 1);
+    _stageStart = now;
+  }
+
+  // Skip the remaining boot screens, e.g. in builds without a display
+  void finish(unsigned long now) {
+    _stage = BOOT_DONE;
+    _stageStart = now;
+  }
+
+  // Record a milestone the first time it is reached; returns true if this was the first time
+  bool mark(BootMilestone milestone, unsigned long now) {
+    if (_milestones[milestone] != 0) return false;
+    _milestones[milestone] = (now != 0) ? now : 1;
+    return true;
+  }
+
+  unsigned long milestone(BootMilestone milestone) const {
+    return _milestones[milestone];
+  }
+
+  static const char* milestoneName(BootMilestone milestone) {
+    switch (milestone) {
+      case BOOT_WIFI:          return "WiFi";
+      case BOOT_MQTT:          return "MQTT";
+      case BOOT_FIRST_SAMPLE:  return "first sample";
+      case BOOT_FIRST_PUBLISH: return "first publish";
+      case BOOT_UI_READY:      return "display";
+      default:                 return "?";
+    }
+  }
+};
+
+#endif // BOOT_SEQUENCE_H
@@ -0,0 +1,113 @@
+#ifndef DELIVERY_WINDOW_H
+#define DELIVERY_WINDOW_H
+
+#include <stdint.h>
+
+#define DELIVERY_WINDOW_MAX 8         // Upper bound on batches in flight; a 2s ack round trip at 250ms sends (see README)
+#define DELIVERY_ACK_TIMEOUT 5000     // ms without an ack before in-flight batches are resent
+
+// Acknowledged delivery of ring samples with a bounded in-flight window
+// PubSubClient can only publish at QoS 0, so delivery is confirmed end to end:
+// the receiver publishes a cumulative ack (the next sequence number it expects)
+// and only then are samples released from the ring. Up to `size` batches may be
+// unacknowledged at once. After a reconnect or an ack timeout the window goes
+// back to the oldest unacknowledged sample and resends from there (go-back-N),
+// so the receiver must drop duplicates by sequence number.
+// A window size of 0 disables acks: samples are released as soon as they are written.
+// That is the default, since a device that expects acks from a backend that never
+// sends them resends its backlog forever and drops samples once the ring is full;
+// acks are turned on with the `window` command once a receiver (host/gateway) is
+// in place.
+class DeliveryWindow {
+private:
+  struct InFlight {
+    uint32_t end;     // Sequence number one past the last sample of the batch
+    uint32_t sentAt;  // millis() when the batch was written
+  };
+
+  InFlight _inFlight[DELIVERY_WINDOW_MAX];
+  uint8_t _size = 0;           // Configured window, in batches; 0 = no acks
+  uint8_t _count = 0;          // Batches currently in flight
+  uint32_t _sendCursor = 0;    // Next sequence number to send
+  uint32_t _acked = 0;         // Next sequence number the receiver expects
+
+  // Statistics
+  uint32_t _batchesSent = 0;
+  uint32_t _acksReceived = 0;
+  uint32_t _retransmits = 0;   // Go-back-N rewinds that resent samples
+  uint32_t _lastAckRtt = 0;    // ms from write to ack of the oldest acked batch
+  uint32_t _maxAckRtt = 0;
+
+public:
+  void setSize(uint8_t size) {
+    _size = (size > DELIVERY_WINDOW_MAX) ? DELIVERY_WINDOW_MAX : size;
+  }
+
+  uint8_t getSize() const { return _size; }
+  bool enabled() const { return _size > 0; }
+
+  // Sequence number to start the next batch at, given the ring's oldest sample
+  uint32_t nextToSend(uint32_t tail) {
+    if ((int32_t)(_sendCursor - tail) < 0) _sendCursor = tail;  // Ring dropped samples past us
+    return _sendCursor;
+  }
+
+  bool canSend() const {
+    return _count < (_size > 0 ? _size : 1);
+  }
+
+  // Record a batch [first, end) as written to the socket
+  void sent(uint32_t end, uint32_t now) {
+    _sendCursor = end;
+    _batchesSent++;
+    if (_size == 0) {
+      _acked = end;  // No acks expected
+      return;
+    }
+    _inFlight[_count].end = end;
+    _inFlight[_count].sentAt = now;
+    _count++;
+  }
+
+  // Cumulative ack; returns the sequence number the ring may be consumed up to
+  uint32_t ack(uint32_t next, uint32_t now) {
+    if ((int32_t)(next - _acked) <= 0 || (int32_t)(next - _sendCursor) > 0) {
+      return _acked;  // Stale or bogus ack
+    }
+    _acked = next;
+    _acksReceived++;
+
+    uint8_t done = 0;
+    while (done < _count && (int32_t)(_inFlight[done].end - next) <= 0) done++;
+    if (done > 0) {
+      _lastAckRtt = now - _inFlight[done - 1].sentAt;
+      if (_lastAckRtt > _maxAckRtt) _maxAckRtt = _lastAckRtt;
+    }
+    for (uint8_t i = done; i < _count; i++) _inFlight[i - done] = _inFlight[i];
+    _count -= done;
+    return _acked;
+  }
+
+  uint32_t acked() const { return _acked; }
+
+  // Resend everything not yet acknowledged, e.g. after the connection was re-established
+  void rewind() {
+    if (_sendCursor != _acked) _retransmits++;
+    _sendCursor = _acked;
+    _count = 0;
+  }
+
+  // Rewind when the oldest batch has waited too long for its ack
+  void checkTimeout(uint32_t now) {
+    if (_count > 0 && now - _inFlight[0].sentAt > DELIVERY_ACK_TIMEOUT) rewind();
+  }
+
+  uint8_t inFlight() const { return _count; }
+  uint32_t batchesSent() const { return _batchesSent; }
+  uint32_t acksReceived() const { return _acksReceived; }
+  uint32_t retransmits() const { return _retransmits; }
+  uint32_t lastAckRtt() const { return _lastAckRtt; }
+  uint32_t maxAckRtt() const { return _maxAckRtt; }
+};
+
+#endif // DELIVERY_WINDOW_H
@@ -0,0 +1,28 @@
+#ifndef FEATURES_H
+#define FEATURES_H
+
+// Compile-time feature selection
+// Every subsystem is on unless a build flag turns it off, e.g. -D FEATURE_DISPLAY=0;
+// the PlatformIO environments combine them into the supported variants. The macros
+// gate includes, globals and function bodies, so a disabled subsystem is not linked
+// at all; its hooks in setup()/loop() become empty functions the compiler drops.
+// The constexpr copies are for ordinary `if` tests in code shared by all variants.
+#ifndef FEATURE_DISPLAY
+#define FEATURE_DISPLAY 1     // OLED, widgets and splash animation
+#endif
+#ifndef FEATURE_EXT_SERIAL
+#define FEATURE_EXT_SERIAL 1  // SoftwareSerial output and commands on GPIO13/15
+#endif
+#ifndef FEATURE_MQTT
+#define FEATURE_MQTT 1        // WiFi, NTP and MQTT
+#endif
+#ifndef FEATURE_BATTERY
+#define FEATURE_BATTERY 1     // Battery gauge on A0
+#endif
+
+constexpr bool featureDisplay = FEATURE_DISPLAY;
+constexpr bool featureExtSerial = FEATURE_EXT_SERIAL;
+constexpr bool featureMqtt = FEATURE_MQTT;
+constexpr bool featureBattery = FEATURE_BATTERY;
+
+#endif // FEATURES_H
@@ -0,0 +1,151 @@
+#ifndef MQTT_LINK_H
+#define MQTT_LINK_H
+
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include "MqttTopics.h"
+#include "SampleCodec.h"
+
+#define MQTT_CLIENT_ID_LEN 24
+#define MQTT_STREAM_CHUNK 64  // Bytes staged on the stack per socket write while streaming
+
+// Sink for the sample encoder that writes straight to the MQTT socket
+// Bytes are staged in a small stack buffer so the TCP stack sees a few
+// larger writes instead of one call per byte; nothing is held on the heap.
+class MqttStreamSink {
+private:
+  PubSubClient& _client;
+  uint8_t _chunk[MQTT_STREAM_CHUNK];
+  size_t _length = 0;
+  bool _ok = true;
+
+public:
+  MqttStreamSink(PubSubClient& client) : _client(client) {}
+
+  void put(uint8_t b) {
+    _chunk[_length++] = b;
+    if (_length == MQTT_STREAM_CHUNK) flush();
+  }
+
+  void flush() {
+    if (_length > 0 && _client.write(_chunk, _length) != _length) _ok = false;
+    _length = 0;
+  }
+
+  bool ok() const { return _ok; }
+};
+
+// MQTT session management with a stable client identity
+// The client ID is derived from the chip ID so the broker sees the same client
+// across reconnects and can keep a persistent session (cleanSession=false).
+// Commands published with QoS 1 while the device is offline are then queued by
+// the broker and delivered on reconnect; retained config is delivered on subscribe.
+class MqttLink {
+private:
+  PubSubClient& _client;
+  const char* _user;
+  const char* _pass;
+  char _clientId[MQTT_CLIENT_ID_LEN];
+  MqttTopics _topics;
+  bool _cleanSession = false;          // Keep broker-side session between connects
+  unsigned long _lastConnectTime = 0;  // ms from CONNECT to CONNACK plus sending the SUBSCRIBEs
+  unsigned long _maxConnectTime = 0;   // Worst connect time seen
+  unsigned int _connectCount = 0;      // Successful connects since boot
+
+public:
+  MqttLink(PubSubClient& client, const char* user, const char* pass)
+    : _client(client), _user(user), _pass(pass) {
+    _clientId[0] = '\0';
+  }
+
+  void begin(uint32_t chipId) {
+    char deviceId[MQTT_ID_LEN];
+    snprintf(deviceId, MQTT_ID_LEN, "%06lx", (unsigned long)chipId);
+    snprintf(_clientId, MQTT_CLIENT_ID_LEN, "NodeMCU-%s", deviceId);
+    _topics.begin(deviceId);
+  }
+
+  // Move the device to another command group, resubscribing if connected
+  // Returns false, leaving the subscriptions alone, if the name is rejected.
+  bool setGroup(const char* group) {
+    if (!MqttTopics::validGroup(group)) return false;
+    if (_client.connected() && _topics.hasScope(SCOPE_GROUP)) {
+      _client.unsubscribe(_topics.commandFilter(SCOPE_GROUP));
+    }
+    _topics.setGroup(group);
+    if (_client.connected() && _topics.hasScope(SCOPE_GROUP)) {
+      _client.subscribe(_topics.commandFilter(SCOPE_GROUP), 1);
+    }
+    return true;
+  }
+
+  void setCleanSession(bool cleanSession) {
+    _cleanSession = cleanSession;
+  }
+
+  // Single blocking connect attempt; returns true once the subscriptions are sent
+  // PubSubClient drops SUBACKs without telling us, so the time kept here ends
+  // with the last SUBSCRIBE written, not acknowledged. The fleet tool measures
+  // through to the last SUBACK (its "ready" histogram).
+  bool connect() {
+    unsigned long start = millis();
+    if (!_client.connect(_clientId, _user, _pass, 0, 0, false, 0, _cleanSession)) {
+      return false;
+    }
+
+    // PubSubClient does not expose the CONNACK session-present flag, so the
+    // subscriptions are always renewed; with a persistent session this is a
+    // no-op on the broker and does not drop queued messages.
+    _topics.build();
+    for (int scope = 0; scope < SCOPE_COUNT; scope++) {
+      if (!_topics.hasScope((CommandScope)scope)) continue;
+      // QoS 1 so the broker queues commands while offline
+      _client.subscribe(_topics.commandFilter((CommandScope)scope), 1);
+    }
+
+    _lastConnectTime = millis() - start;
+    if (_lastConnectTime > _maxConnectTime) _maxConnectTime = _lastConnectTime;
+    _connectCount++;
+    return true;
+  }
+
+  // Stream a batch of ring samples to the batch topic without building the payload in RAM
+  // The encoder runs twice: once to size the MQTT packet, once to write it out.
+  template <class Ring>
+  bool publishBatch(const Ring& ring, uint32_t bootId, uint32_t first, uint32_t count, uint64_t firstEpochMs) {
+    size_t length = sampleBatchSize(ring, bootId, first, count, firstEpochMs);
+    if (!_client.beginPublish(_topics.telemetry(TOPIC_BATCH), length, false)) {
+      return false;
+    }
+    MqttStreamSink sink(_client);
+    encodeSampleBatch(sink, ring, bootId, first, count, firstEpochMs);
+    sink.flush();
+    return _client.endPublish() && sink.ok();
+  }
+
+  MqttTopics& topics() {
+    return _topics;
+  }
+
+  const char* getClientId() {
+    return _clientId;
+  }
+
+  bool getCleanSession() {
+    return _cleanSession;
+  }
+
+  unsigned long getLastConnectTime() {
+    return _lastConnectTime;
+  }
+
+  unsigned long getMaxConnectTime() {
+    return _maxConnectTime;
+  }
+
+  unsigned int getConnectCount() {
+    return _connectCount;
+  }
+};
+
+#endif // MQTT_LINK_H
@@ -0,0 +1,114 @@
+#ifndef MQTT_TOPICS_H
+#define MQTT_TOPICS_H
+
+#include <Arduino.h>
+
+#define MQTT_TOPIC_ROOT "sensor"
+#define MQTT_TOPIC_LEN 48
+#define MQTT_ID_LEN 16
+
+// Telemetry topics published by this device
+enum TelemetryTopic {
+  TOPIC_TEMPERATURE,
+  TOPIC_BATTERY_VOLTAGE,
+  TOPIC_BATTERY_PERCENTAGE,
+  TOPIC_BATCH,  // Binary sample batches (see SampleCodec.h)
+  TOPIC_TELEMETRY_COUNT
+};
+
+// Command scopes the device subscribes to
+enum CommandScope {
+  SCOPE_DEVICE,     // sensor/<id>/set/<command>
+  SCOPE_GROUP,      // sensor/group/<group>/set/<command>
+  SCOPE_BROADCAST,  // sensor/all/set/<command>
+  SCOPE_COUNT
+};
+
+// Per-device topic namespace
+// Every topic carries the device ID so units sharing a broker do not overwrite
+// each other, and commands can address one device, a group, or the whole fleet.
+// Topic strings are built once per connect so the publish path never formats them.
+class MqttTopics {
+private:
+  char _deviceId[MQTT_ID_LEN];
+  char _group[MQTT_ID_LEN];
+  char _telemetry[TOPIC_TELEMETRY_COUNT][MQTT_TOPIC_LEN];
+  char _commandFilter[SCOPE_COUNT][MQTT_TOPIC_LEN];  // Wildcard subscription per scope, e.g. "sensor/<id>/set/+"
+
+public:
+  MqttTopics() {
+    _deviceId[0] = '\0';
+    _group[0] = '\0';
+  }
+
+  void begin(const char* deviceId) {
+    snprintf(_deviceId, MQTT_ID_LEN, "%s", deviceId);
+    build();
+  }
+
+  // A group name must fit in MQTT_ID_LEN and be a single topic level without wildcards
+  static bool validGroup(const char* group) {
+    size_t len = strlen(group);
+    return len < MQTT_ID_LEN && strpbrk(group, "/+#") == NULL;
+  }
+
+  // Group membership is optional; an empty name disables the group scope
+  // Returns false and keeps the current group if the name is not valid.
+  bool setGroup(const char* group) {
+    if (!validGroup(group)) return false;
+    snprintf(_group, MQTT_ID_LEN, "%s", group);
+    build();
+    return true;
+  }
+
+  void build() {
+    snprintf(_telemetry[TOPIC_TEMPERATURE], MQTT_TOPIC_LEN, MQTT_TOPIC_ROOT "/%s/temperature", _deviceId);
+    snprintf(_telemetry[TOPIC_BATTERY_VOLTAGE], MQTT_TOPIC_LEN, MQTT_TOPIC_ROOT "/%s/battery/voltage", _deviceId);
+    snprintf(_telemetry[TOPIC_BATTERY_PERCENTAGE], MQTT_TOPIC_LEN, MQTT_TOPIC_ROOT "/%s/battery/percentage", _deviceId);
+    snprintf(_telemetry[TOPIC_BATCH], MQTT_TOPIC_LEN, MQTT_TOPIC_ROOT "/%s/batch", _deviceId);
+
+    snprintf(_commandFilter[SCOPE_DEVICE], MQTT_TOPIC_LEN, MQTT_TOPIC_ROOT "/%s/set/+", _deviceId);
+    if (_group[0] != '\0') {
+      snprintf(_commandFilter[SCOPE_GROUP], MQTT_TOPIC_LEN, MQTT_TOPIC_ROOT "/group/%s/set/+", _group);
+    } else {
+      _commandFilter[SCOPE_GROUP][0] = '\0';
+    }
+    snprintf(_commandFilter[SCOPE_BROADCAST], MQTT_TOPIC_LEN, MQTT_TOPIC_ROOT "/all/set/+");
+  }
+
+  const char* telemetry(TelemetryTopic topic) {
+    return _telemetry[topic];
+  }
+
+  bool hasScope(CommandScope scope) {
+    return _commandFilter[scope][0] != '\0';
+  }
+
+  const char* commandFilter(CommandScope scope) {
+    return _commandFilter[scope];
+  }
+
+  // Returns the command name if the topic belongs to one of our command scopes, NULL otherwise
+  // The matching scope is stored in `scope` when given.
+  const char* matchCommand(const char* topic, CommandScope* scope = NULL) {
+    for (int i = 0; i < SCOPE_COUNT; i++) {
+      if (!hasScope((CommandScope)i)) continue;
+      size_t len = strlen(_commandFilter[i]) - 1;  // Prefix without the trailing '+'
+      if (strncmp(topic, _commandFilter[i], len) == 0 && strchr(topic + len, '/') == NULL) {
+        if (scope != NULL) *scope = (CommandScope)i;
+        return topic + len;
+      }
+    }
+    return NULL;
+  }
+
+  const char* getDeviceId() {
+    return _deviceId;
+  }
+
+  const char* getGroup() {
+    return _group;
+  }
+};
+
+#endif // MQTT_TOPICS_H
@@ -0,0 +1,301 @@
+#ifndef OLED_COMPOSITOR_H
+#define OLED_COMPOSITOR_H
+
+#include <Arduino.h>
+
+#define OLED_COLUMNS 128
+#define OLED_PAGES 4                               // 8-pixel rows on the 128x32 panel
+#define OLED_FRAME_SIZE (OLED_COLUMNS * OLED_PAGES)
+#define OLED_WINDOW_OVERHEAD 9  // I2C bytes to open a window: address + 6 commands, address + data control
+#define OLED_MAX_SPANS 16       // Dirty windows tracked per frame
+#define OLED_MAX_REGIONS 12     // Boxes whose changes are sent in one loop
+#define OLED_CHUNK_BYTES 16     // Data bytes per I2C transaction while flushing
+#define OLED_FLUSH_BUDGET 5500  // Default I2C time per loop() in us: a whole readout update at 400kHz
+
+// Dirty-region compositor for the SSD1306 with an incremental flush
+// The shadow copy holds the last committed frame. commit() diffs the draw buffer
+// against it page by page, records the changed column ranges as spans and copies
+// the new bytes into the shadow. Spans touching the same registered region (a
+// widget box) are chained, so the parts of a value drawn across pages or with
+// gaps, like the two-page temperature readout, go out together.
+// service() then sends the spans from the shadow in small chunks and stops once
+// the next region would not fit in the per-loop time budget, but never inside a
+// span or between the spans of one region: those are finished in the same call,
+// overrunning the budget if they must. The panel therefore never shows a region
+// half old and half new. Spans are split at region edges, so the largest chain
+// is the two-page readout box (224 bytes, about 5.4ms), which the default budget
+// covers; getOverruns() counts the calls that went over. A new frame is
+// only committed once the previous one is fully on the panel and every byte
+// sent comes from the committed snapshot, so drawing that happens mid-flush
+// never reaches the panel.
+// The draw buffer is GyverOLED's, column-major with one byte per page:
+// byte (x * OLED_PAGES + page) holds pixels x, page*8 .. page*8+7.
+template <class Display>
+class OledCompositor {
+private:
+  struct Span {
+    uint8_t page0;  // Windows normally cover one page; only the overflow span grows taller
+    uint8_t page1;
+    uint8_t x0;
+    uint8_t x1;
+    bool chained;   // Sent in the same service() call as the next span
+  };
+
+  Display& _display;
+  uint8_t _shadow[OLED_FRAME_SIZE];
+  bool _shadowValid = false;  // False until the panel content is known
+
+  Span _spans[OLED_MAX_SPANS];
+  uint8_t _spanCount = 0;
+  Span _regions[OLED_MAX_REGIONS];
+  uint8_t _regionCount = 0;
+  uint8_t _spanIndex = 0;     // Span being sent
+  int16_t _offset = -1;       // Next byte of the current span, -1 before its window is opened
+  unsigned long _budget = OLED_FLUSH_BUDGET;
+
+  // Statistics
+  uint16_t _frameBytes = 0;          // I2C bytes of the frame in flight, including window setup
+  uint16_t _lastFrameBytes = 0;
+  uint8_t _lastFrameWindows = 0;
+  unsigned long _commitTime = 0;     // micros() at commit of the frame in flight
+  unsigned long _lastFrameLatency = 0;  // us from commit to the last byte on the panel
+  unsigned long _maxFrameLatency = 0;
+  unsigned long _maxServiceMicros = 0;  // Longest I2C time spent in one service() call
+  uint32_t _overruns = 0;               // service() calls that went past the budget
+  uint32_t _totalBytes = 0;
+  uint32_t _frames = 0;
+
+  uint8_t* frame() {
+    return _display._oled_buffer;
+  }
+
+  void addSpan(uint8_t page, uint8_t x0, uint8_t x1) {
+    if (_spanCount < OLED_MAX_SPANS) {
+      _spans[_spanCount++] = { page, page, x0, x1, false };
+    } else {
+      // Out of spans: the last one grows to full width down to this page
+      Span& last = _spans[OLED_MAX_SPANS - 1];
+      last.page1 = page;
+      last.x0 = 0;
+      last.x1 = OLED_COLUMNS - 1;
+    }
+  }
+
+  static bool touches(const Span& a, const Span& b) {
+    return a.page0 <= b.page1 && a.page1 >= b.page0 && a.x0 <= b.x1 && a.x1 >= b.x0;
+  }
+
+  bool shareRegion(const Span& a, const Span& b) {
+    for (uint8_t r = 0; r < _regionCount; r++) {
+      if (touches(a, _regions[r]) && touches(b, _regions[r])) return true;
+    }
+    return false;
+  }
+
+  // A region of the page starts or ends between these two columns
+  bool regionEdge(uint8_t page, uint8_t from, uint8_t to) {
+    for (uint8_t r = 0; r < _regionCount; r++) {
+      const Span& region = _regions[r];
+      if (page < region.page0 || page > region.page1) continue;
+      if ((region.x0 > from && region.x0 <= to) || (region.x1 >= from && region.x1 < to)) return true;
+    }
+    return false;
+  }
+
+  // Move the spans that share a region next to each other and chain them
+  void chainRegions() {
+    uint8_t group = 0;  // First span of the chain being built
+    for (uint8_t i = 0; i < _spanCount; i++) {
+      if (i > 0 && !_spans[i - 1].chained) group = i;
+      for (uint8_t j = i + 1; j < _spanCount; j++) {
+        bool partner = false;
+        for (uint8_t k = group; k <= i && !partner; k++) partner = shareRegion(_spans[k], _spans[j]);
+        if (!partner) continue;
+        Span moved = _spans[j];
+        memmove(&_spans[i + 2], &_spans[i + 1], (j - i - 1) * sizeof(Span));
+        _spans[i + 1] = moved;
+        _spans[i].chained = true;
+        break;
+      }
+    }
+  }
+
+  // The span being sent, or the one just finished, is chained to the next
+  bool midChain() {
+    return _offset >= 0 || (_spanIndex > 0 && _spans[_spanIndex - 1].chained);
+  }
+
+  // I2C bytes of the chain starting at the current span, window setup and resumes included
+  uint16_t chainBytes() {
+    uint16_t bytes = 0;
+    for (uint8_t i = _spanIndex; i < _spanCount; i++) {
+      const Span& span = _spans[i];
+      uint16_t data = (span.x1 - span.x0 + 1) * (span.page1 - span.page0 + 1);
+      bytes += OLED_WINDOW_OVERHEAD + data + (data - 1) / OLED_CHUNK_BYTES;
+      if (!span.chained) break;
+    }
+    return bytes;
+  }
+
+  // Send one chunk of the current span; returns false when all spans are done
+  // The panel uses vertical addressing, so a window is filled column by column.
+  bool sendChunk() {
+    if (_spanIndex >= _spanCount) return false;
+    Span& span = _spans[_spanIndex];
+    uint8_t pages = span.page1 - span.page0 + 1;
+    uint16_t total = (span.x1 - span.x0 + 1) * pages;
+    if (_offset < 0) {
+      _display.setWindow(span.x0, span.page0, span.x1, span.page1);
+      _offset = 0;
+      _frameBytes += OLED_WINDOW_OVERHEAD;
+    } else {
+      _frameBytes += 1;  // Data control byte to resume
+    }
+
+    uint16_t count = total - _offset;
+    if (count > OLED_CHUNK_BYTES) count = OLED_CHUNK_BYTES;
+    uint16_t x = span.x0 + _offset / pages;
+    uint8_t page = span.page0 + _offset % pages;
+    _display.beginData();
+    for (uint16_t n = 0; n < count; n++) {
+      _display.sendByte(_shadow[x * OLED_PAGES + page]);
+      if (++page > span.page1) {
+        page = span.page0;
+        x++;
+      }
+    }
+    _display.endTransm();
+    _frameBytes += count;
+
+    _offset += count;
+    if (_offset == total) {
+      _spanIndex++;
+      _offset = -1;
+    }
+    return true;
+  }
+
+  void finishFrame() {
+    _lastFrameBytes = _frameBytes;
+    _lastFrameWindows = _spanCount;
+    _lastFrameLatency = micros() - _commitTime;
+    if (_lastFrameLatency > _maxFrameLatency) _maxFrameLatency = _lastFrameLatency;
+    _totalBytes += _frameBytes;
+    _frames++;
+    _spanCount = 0;
+    _spanIndex = 0;
+  }
+
+public:
+  OledCompositor(Display& display) : _display(display) {}
+
+  bool busy() {
+    return _spanIndex < _spanCount;
+  }
+
+  // Snapshot the changes in the draw buffer as the next frame
+  // Returns false if the previous frame is still being sent or nothing changed.
+  bool commit() {
+    if (busy()) return false;
+
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+      int16_t runStart = -1;  // First column of the pending window
+      int16_t runEnd = -1;    // Last changed column of the pending window
+      for (uint8_t x = 0; x < OLED_COLUMNS; x++) {
+        uint16_t i = x * OLED_PAGES + page;
+        if (_shadowValid && frame()[i] == _shadow[i]) continue;
+        _shadow[i] = frame()[i];
+        if (runStart >= 0 && (x - runEnd > OLED_WINDOW_OVERHEAD || regionEdge(page, runEnd, x))) {
+          addSpan(page, runStart, runEnd);  // Gap too wide to bridge, or into another region
+          runStart = -1;
+        }
+        if (runStart < 0) runStart = x;
+        runEnd = x;
+      }
+      if (runStart >= 0) addSpan(page, runStart, runEnd);
+    }
+    _shadowValid = true;
+
+    if (_spanCount == 0) return false;
+    chainRegions();
+    _spanIndex = 0;
+    _offset = -1;
+    _frameBytes = 0;
+    _commitTime = micros();
+    return true;
+  }
+
+  // Send whole chains of the committed frame while the next one fits in the time budget
+  // Its time is projected from the time per byte of this call so far. At
+  // least one chain goes out per call so a frame always makes progress; only a
+  // chain longer than the budget on its own overruns it.
+  // Returns true once the frame is complete and the panel is idle.
+  bool service(unsigned long budget) {
+    if (!busy()) return true;
+    unsigned long start = micros();
+    unsigned long elapsed = 0;
+    uint16_t startBytes = _frameBytes;
+    while (true) {
+      sendChunk();
+      elapsed = micros() - start;
+      if (!busy()) break;
+      if (midChain()) continue;  // Never stop inside a chain
+      if (elapsed >= budget) break;
+      unsigned long projected = (unsigned long)chainBytes() * elapsed / (_frameBytes - startBytes);
+      if (projected > budget - elapsed) break;  // The next chain would not fit
+    }
+
+    if (elapsed > _maxServiceMicros) _maxServiceMicros = elapsed;
+    if (elapsed > budget) _overruns++;
+    if (busy()) return false;
+    finishFrame();
+    return true;
+  }
+
+  // Once per loop(): commit the drawing done so far if idle, then send within the budget
+  void update() {
+    commit();
+    service(_budget);
+  }
+
+  // Blocking flush for boot screens: finish the frame in flight and send all changes
+  void flush() {
+    while (!service((unsigned long)-1)) {}
+    if (commit()) service((unsigned long)-1);
+  }
+
+  // Send the changes inside this box together, so they reach the panel in the same loop
+  // Returns false once OLED_MAX_REGIONS are registered.
+  bool addRegion(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+    if (_regionCount == OLED_MAX_REGIONS) return false;
+    _regions[_regionCount++] = { page0, page1, x0, x1, false };
+    return true;
+  }
+
+  // The panel was written outside the compositor with a full display.update()
+  void sync() {
+    memcpy(_shadow, frame(), OLED_FRAME_SIZE);
+    _shadowValid = true;
+    _spanCount = 0;
+    _spanIndex = 0;
+  }
+
+  // Panel content unknown (e.g. after init); the next commit sends the whole frame
+  void invalidate() {
+    _shadowValid = false;
+  }
+
+  void setBudget(unsigned long budget) { _budget = budget; }
+  unsigned long getBudget() { return _budget; }
+
+  uint16_t getLastFrameBytes() { return _lastFrameBytes; }
+  uint8_t getLastFrameWindows() { return _lastFrameWindows; }
+  unsigned long getLastFrameLatency() { return _lastFrameLatency; }
+  unsigned long getMaxFrameLatency() { return _maxFrameLatency; }
+  unsigned long getMaxServiceMicros() { return _maxServiceMicros; }
+  uint32_t getOverruns() { return _overruns; }
+  uint32_t getTotalBytes() { return _totalBytes; }
+  uint32_t getFrames() { return _frames; }
+};
+
+#endif // OLED_COMPOSITOR_H
@@ -0,0 +1,206 @@
+#ifndef OLED_TILE_RENDERER_H
+#define OLED_TILE_RENDERER_H
+
+#include <Arduino.h>
+#include "OledCompositor.h"  // Panel geometry and flush tuning
+#include "OledWidgets.h"
+
+// Bufferless renderer for a widget screen, one widget page at a time
+// Replaces GyverOLED's 512-byte framebuffer and the compositor's 512-byte shadow
+// with a single page buffer. commit() takes the dirty widgets as the next frame
+// and marks them clean. service() then sends them one by one: for each page of
+// a widget it draws the widget into the tile from its retained state and sends
+// the widget's columns in small chunks. The per-loop time budget is only checked
+// between widgets, so a widget, the two-page readout included, reaches the
+// panel in one loop and is never shown half updated. A widget that would not
+// fit in what is left of the budget waits for the next loop. A widget that changes
+// while a frame is in flight is dirty again and goes out with the next frame.
+template <class Display>
+class OledTileRenderer {
+private:
+  Display& _display;
+  uint8_t _tile[OLED_COLUMNS];
+  WidgetScreen* _screen = NULL;  // Screen of the frame in flight
+
+  uint32_t _widgets = 0;         // Widgets of the frame still to send, bit per widget
+  uint8_t _widget = 0;           // Widget being sent
+  uint8_t _page = 0;             // Its page being sent
+  int16_t _offset = -1;          // Next column of the page, -1 before it is composed
+  unsigned long _budget = OLED_FLUSH_BUDGET;
+
+  // Statistics, as in OledCompositor
+  uint16_t _frameBytes = 0;
+  uint8_t _frameWindows = 0;
+  uint16_t _lastFrameBytes = 0;
+  uint8_t _lastFrameWindows = 0;
+  unsigned long _commitTime = 0;
+  unsigned long _lastFrameLatency = 0;
+  unsigned long _maxFrameLatency = 0;
+  unsigned long _maxServiceMicros = 0;
+  uint32_t _overruns = 0;
+  unsigned long _lastComposeMicros = 0;  // Time to draw the last widget page
+  unsigned long _maxComposeMicros = 0;
+  uint32_t _totalBytes = 0;
+  uint32_t _frames = 0;
+
+  // A widget writes every byte of its box, so the tile needs no clearing
+  void compose(Widget& widget, uint8_t page) {
+    unsigned long start = micros();
+    PageCanvas canvas = { _tile, 1, page, page };
+    widget.render(canvas);
+    _lastComposeMicros = micros() - start;
+    if (_lastComposeMicros > _maxComposeMicros) _maxComposeMicros = _lastComposeMicros;
+  }
+
+  // Move to the next widget of the frame, starting at its first page
+  void nextWidget() {
+    while (_widgets != 0 && !(_widgets & (1UL << _widget))) _widget++;
+    if (_widgets != 0) _page = _screen->widget(_widget).page0();
+  }
+
+  // Send one chunk of the current widget page; returns false when the frame is done
+  bool sendChunk() {
+    if (_widgets == 0) return false;
+    Widget& widget = _screen->widget(_widget);
+
+    if (_offset < 0) {
+      compose(widget, _page);
+      _display.setWindow(widget.x0(), _page, widget.x1(), _page);
+      _offset = widget.x0();
+      _frameBytes += OLED_WINDOW_OVERHEAD;
+      _frameWindows++;
+    } else {
+      _frameBytes += 1;  // Data control byte to resume
+    }
+
+    uint16_t count = widget.x1() - _offset + 1;
+    if (count > OLED_CHUNK_BYTES) count = OLED_CHUNK_BYTES;
+    _display.beginData();
+    for (uint16_t n = 0; n < count; n++) _display.sendByte(_tile[_offset + n]);
+    _display.endTransm();
+    _frameBytes += count;
+
+    _offset += count;
+    if (_offset > widget.x1()) {
+      _offset = -1;
+      if (_page < widget.page1()) {
+        _page++;
+      } else {
+        _widgets &= ~(1UL << _widget);
+        nextWidget();
+      }
+    }
+    return true;
+  }
+
+  // Inside a widget: the budget is not checked until it is all sent
+  bool midWidget() {
+    return _offset >= 0 || (_widgets != 0 && _page > _screen->widget(_widget).page0());
+  }
+
+  // I2C bytes of the current widget, one window per page, resumes included
+  uint16_t widgetBytes() {
+    Widget& widget = _screen->widget(_widget);
+    uint16_t width = widget.x1() - widget.x0() + 1;
+    return (widget.page1() - widget.page0() + 1) * (OLED_WINDOW_OVERHEAD + width + (width - 1) / OLED_CHUNK_BYTES);
+  }
+
+  void finishFrame() {
+    _lastFrameBytes = _frameBytes;
+    _lastFrameWindows = _frameWindows;
+    _lastFrameLatency = micros() - _commitTime;
+    if (_lastFrameLatency > _maxFrameLatency) _maxFrameLatency = _lastFrameLatency;
+    _totalBytes += _frameBytes;
+    _frames++;
+  }
+
+public:
+  OledTileRenderer(Display& display) : _display(display) {}
+
+  bool busy() {
+    return _widgets != 0;
+  }
+
+  // Take the screen's dirty widgets as the next frame
+  // Returns false if the previous frame is still being sent or nothing is dirty.
+  bool commit(WidgetScreen& screen) {
+    if (busy()) return false;
+    uint32_t widgets = 0;
+    for (uint8_t i = 0; i < screen.count() && i < 32; i++) {
+      if (screen.widget(i).dirty()) widgets |= 1UL << i;
+    }
+    if (widgets == 0) return false;
+    screen.clean();
+
+    _screen = &screen;
+    _widgets = widgets;
+    _widget = 0;
+    _offset = -1;
+    nextWidget();
+    _frameBytes = 0;
+    _frameWindows = 0;
+    _commitTime = micros();
+    return true;
+  }
+
+  // Send whole widgets of the frame while the next one fits in the time budget
+  // As in OledCompositor, its time is projected from this call's time per byte,
+  // and at least one widget goes out per call so a frame always makes progress.
+  // Returns true once the frame is complete and the panel is idle.
+  bool service(unsigned long budget) {
+    if (!busy()) return true;
+    unsigned long start = micros();
+    unsigned long elapsed = 0;
+    uint16_t startBytes = _frameBytes;
+    while (true) {
+      sendChunk();
+      elapsed = micros() - start;
+      if (!busy()) break;
+      if (midWidget()) continue;
+      if (elapsed >= budget) break;
+      unsigned long projected = (unsigned long)widgetBytes() * elapsed / (_frameBytes - startBytes);
+      if (projected > budget - elapsed) break;
+    }
+
+    if (elapsed > _maxServiceMicros) _maxServiceMicros = elapsed;
+    if (elapsed > budget) _overruns++;
+    if (busy()) return false;
+    finishFrame();
+    return true;
+  }
+
+  // Once per loop(): take the dirty widgets if idle, then send within the budget
+  void update(WidgetScreen& screen) {
+    commit(screen);
+    service(_budget);
+  }
+
+  // Blocking send of a whole column-major frame (e.g. a boot screen held elsewhere)
+  // Cancels the frame in flight; the caller invalidates the screen afterwards.
+  void sendFrame(const uint8_t* frame) {
+    _widgets = 0;
+    _offset = -1;
+    _display.setWindow(0, 0, OLED_COLUMNS - 1, OLED_PAGES - 1);
+    for (uint16_t i = 0; i < OLED_FRAME_SIZE; i += OLED_CHUNK_BYTES) {
+      _display.beginData();
+      for (uint8_t n = 0; n < OLED_CHUNK_BYTES; n++) _display.sendByte(frame[i + n]);
+      _display.endTransm();
+    }
+  }
+
+  void setBudget(unsigned long budget) { _budget = budget; }
+  unsigned long getBudget() { return _budget; }
+
+  uint16_t getLastFrameBytes() { return _lastFrameBytes; }
+  uint8_t getLastFrameWindows() { return _lastFrameWindows; }
+  unsigned long getLastFrameLatency() { return _lastFrameLatency; }
+  unsigned long getMaxFrameLatency() { return _maxFrameLatency; }
+  unsigned long getMaxServiceMicros() { return _maxServiceMicros; }
+  uint32_t getOverruns() { return _overruns; }
+  unsigned long getLastComposeMicros() { return _lastComposeMicros; }
+  unsigned long getMaxComposeMicros() { return _maxComposeMicros; }
+  uint32_t getTotalBytes() { return _totalBytes; }
+  uint32_t getFrames() { return _frames; }
+};
+
+#endif // OLED_TILE_RENDERER_H
@@ -0,0 +1,323 @@
+#ifndef OLED_WIDGETS_H
+#define OLED_WIDGETS_H
+
+#include <Arduino.h>
+#include "PageCanvas.h"
+#include "SlidingMinMax.h"
+
+// Retained-mode widgets for the measurement screen
+// Each widget owns a box of whole bytes (columns x0..x1, pages page0..page1) and
+// keeps the value it shows. Setters only store the new value and mark the widget
+// dirty when the visible result changes; nothing is drawn until the screen's
+// render pass, which repaints just the dirty widgets. Widgets draw through a
+// PageCanvas, so the same code renders into the full framebuffer or into a
+// single page tile. A widget must write every byte of its box.
+class Widget {
+protected:
+  uint8_t _x0;
+  uint8_t _x1;
+  uint8_t _page0;
+  uint8_t _page1;
+  bool _dirty = true;
+
+public:
+  Widget(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1)
+    : _x0(x0), _x1(x1), _page0(page0), _page1(page1) {}
+
+  // Draw the whole box; only pages the canvas holds are touched
+  virtual void render(const PageCanvas& canvas) = 0;
+
+  // Repaint onto a canvas that still holds this widget's last drawing
+  // Widgets that can patch their previous output cheaply override this.
+  virtual void update(const PageCanvas& canvas) { render(canvas); }
+
+  virtual void invalidate() { _dirty = true; }
+  void clean() { _dirty = false; }
+  bool dirty() const { return _dirty; }
+
+  bool coversPage(uint8_t page) const {
+    return page >= _page0 && page <= _page1;
+  }
+
+  uint8_t x0() const { return _x0; }
+  uint8_t x1() const { return _x1; }
+  uint8_t page0() const { return _page0; }
+  uint8_t page1() const { return _page1; }
+};
+
+// Root of the widget tree: a fixed list of non-overlapping widgets
+class WidgetScreen {
+private:
+  Widget* const* _widgets;
+  uint8_t _count;
+
+public:
+  WidgetScreen(Widget* const* widgets, uint8_t count) : _widgets(widgets), _count(count) {}
+
+  // Repaint the dirty widgets onto the canvas; returns how many were drawn
+  uint8_t render(const PageCanvas& canvas) {
+    uint8_t drawn = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+      Widget* widget = _widgets[i];
+      if (!widget->dirty()) continue;
+      widget->update(canvas);
+      widget->clean();
+      drawn++;
+    }
+    return drawn;
+  }
+
+  void clean() {
+    for (uint8_t i = 0; i < _count; i++) _widgets[i]->clean();
+  }
+
+  uint8_t count() const { return _count; }
+  Widget& widget(uint8_t i) const { return *_widgets[i]; }
+
+  // Panel content unknown (e.g. after a boot screen); repaint everything
+  void invalidate() {
+    for (uint8_t i = 0; i < _count; i++) _widgets[i]->invalidate();
+  }
+};
+
+// Line of 5x7 text on one page, blank to the right of the text
+class TextWidget : public Widget {
+protected:
+  char _text[22];
+
+public:
+  TextWidget(uint8_t x0, uint8_t x1, uint8_t page) : Widget(x0, x1, page, page) {
+    _text[0] = '\0';
+  }
+
+  void setText(const char* text) {
+    if (strncmp(_text, text, sizeof(_text) - 1) == 0) return;
+    strncpy(_text, text, sizeof(_text) - 1);
+    _text[sizeof(_text) - 1] = '\0';
+    _dirty = true;
+  }
+
+  void render(const PageCanvas& canvas) override {
+    uint8_t end = drawSmallText(canvas, _x0, _page0, _text, _x1);
+    if (end <= _x1) canvas.clear(end, _x1, _page0);
+  }
+};
+
+// Temperature readout in the two-page large font
+class TemperatureWidget : public Widget {
+private:
+  char _text[12];
+
+public:
+  TemperatureWidget(uint8_t x0, uint8_t x1, uint8_t page) : Widget(x0, x1, page, page + 1) {
+    _text[0] = '\0';
+  }
+
+  void setTemperature(double celsius) {
+    char text[sizeof(_text)];
+    if (isnan(celsius)) strcpy(text, "----C");  // Open thermocouple
+    else snprintf(text, sizeof(text), "%.2fC", celsius);
+    if (strcmp(text, _text) == 0) return;
+    strcpy(_text, text);
+    _dirty = true;
+  }
+
+  void render(const PageCanvas& canvas) override {
+    uint8_t end = drawLargeText(canvas, _x0, _page0, _text, _x1);
+    if (end <= _x1) {
+      canvas.clear(end, _x1, _page0);
+      canvas.clear(end, _x1, _page1);
+    }
+  }
+};
+
+class SetpointWidget : public TextWidget {
+public:
+  SetpointWidget(uint8_t x0, uint8_t x1, uint8_t page) : TextWidget(x0, x1, page) {}
+
+  void setSetpoint(double celsius) {
+    char text[sizeof(_text)];
+    snprintf(text, sizeof(text), "SET:%0.2fC", celsius);
+    setText(text);
+  }
+};
+
+class ModeWidget : public TextWidget {
+public:
+  ModeWidget(uint8_t x0, uint8_t x1, uint8_t page) : TextWidget(x0, x1, page) {}
+
+  void setLogMode(bool log) { setText(log ? "|LOG" : "|NRM"); }
+};
+
+class BuzzerWidget : public TextWidget {
+public:
+  BuzzerWidget(uint8_t x0, uint8_t x1, uint8_t page) : TextWidget(x0, x1, page) {}
+
+  void setEnabled(bool enabled) { setText(enabled ? "|ON" : "|OFF"); }
+};
+
+// Horizontal rule one pixel high
+class DividerWidget : public Widget {
+private:
+  uint8_t _bits;
+
+public:
+  DividerWidget(uint8_t x0, uint8_t x1, uint8_t page, uint8_t row) : Widget(x0, x1, page, page), _bits(1 << row) {}
+
+  void render(const PageCanvas& canvas) override {
+    if (!canvas.hasPage(_page0)) return;
+    for (uint16_t x = _x0; x <= _x1; x++) *canvas.at(x, _page0) = _bits;
+  }
+};
+
+// Single-pixel indicators in one column over the first two pages:
+// upload activity (row 0), MQTT (row 4) and WiFi (row 8)
+// The caller decides blinking; the widget only shows on or off.
+class LinkStatusWidget : public Widget {
+private:
+  bool _upload = false;
+  bool _mqtt = false;
+  bool _wifi = false;
+
+  void set(bool& field, bool value) {
+    if (field == value) return;
+    field = value;
+    _dirty = true;
+  }
+
+public:
+  LinkStatusWidget(uint8_t x, uint8_t page) : Widget(x, x, page, page + 1) {}
+
+  void setUpload(bool on) { set(_upload, on); }
+  void setMqtt(bool on) { set(_mqtt, on); }
+  void setWifi(bool on) { set(_wifi, on); }
+
+  void render(const PageCanvas& canvas) override {
+    canvas.put(_x0, _page0, (_upload ? 0x01 : 0) | (_mqtt ? 0x10 : 0));
+    canvas.put(_x0, _page1, _wifi ? 0x01 : 0);
+  }
+};
+
+// Four-dot battery gauge in one column over two pages, filling from the bottom
+// Below 10% only the bottom dot is shown, blinking on every update.
+class BatteryWidget : public Widget {
+private:
+  uint8_t _dots = 0;  // Bit n set: dot n lit, dot 0 at the bottom
+
+public:
+  BatteryWidget(uint8_t x, uint8_t page) : Widget(x, x, page, page + 1) {}
+
+  void setPercentage(int percentage) {
+    uint8_t dots;
+    if (percentage > 75) dots = 0x0F;
+    else if (percentage > 50) dots = 0x07;
+    else if (percentage > 25) dots = 0x03;
+    else if (percentage >= 10) dots = 0x01;
+    else dots = _dots == 0x01 ? 0x00 : 0x01;  // Blink the last dot
+    if (dots == _dots) return;
+    _dots = dots;
+    _dirty = true;
+  }
+
+  // Dots sit on rows 3 and 7 of each page, the bottom dot on the last row
+  void render(const PageCanvas& canvas) override {
+    canvas.put(_x0, _page0, ((_dots & 0x08) ? 0x08 : 0) | ((_dots & 0x04) ? 0x80 : 0));
+    canvas.put(_x0, _page1, ((_dots & 0x02) ? 0x08 : 0) | ((_dots & 0x01) ? 0x80 : 0));
+  }
+};
+
+// Scrolling trend of the last WIDTH samples, 16 pixels tall over two pages
+// Each push() scrolls the plot by one column. update() moves the existing column
+// bytes left on the canvas and draws only the new column, so the cost per sample
+// does not depend on the width. The vertical scale follows the window's min and
+// max, which SlidingMinMax keeps without rescanning the history; it gets a margin
+// and only changes when a value leaves it or the data shrinks to under half of it,
+// so the full redraw a new scale needs stays rare.
+template <uint8_t WIDTH>
+class SparklineWidget : public Widget {
+private:
+  static const int16_t MIN_SPAN = 8;  // 2°C, so a steady reading is not blown up into noise
+
+  SlidingMinMax<WIDTH> _history;
+  int16_t _lo = 0;          // Sample value on the bottom row
+  int16_t _span = 0;        // Sample values from the bottom to the top row, 0 until scaled
+  uint8_t _scrolled = 0;    // Columns pushed since the last drawing
+  bool _redraw = true;      // Scale changed or canvas content unknown
+
+  // Scale span for the current window: the data plus a quarter on each side
+  int16_t neededSpan() const {
+    int16_t range = _history.max() - _history.min();
+    int16_t span = range + range / 2;
+    return span < MIN_SPAN ? MIN_SPAN : span;
+  }
+
+  uint8_t rowOf(int16_t value) const {
+    return 15 - (uint8_t)((int32_t)(value - _lo) * 15 / _span);  // Row 0 is the top
+  }
+
+  // Pixels of the column showing the sample `age` steps back, low byte on the upper page
+  // A vertical segment joins it to the previous sample so the trace stays connected.
+  uint16_t columnBits(uint8_t age) const {
+    if (_span == 0 || age >= _history.count()) return 0;
+    int16_t value = _history.recent(age);
+    if (value == SAMPLE_FAULT) return 0;
+    uint8_t top = rowOf(value);
+    uint8_t bottom = top;
+    if (age + 1 < _history.count() && _history.recent(age + 1) != SAMPLE_FAULT) {
+      uint8_t previous = rowOf(_history.recent(age + 1));
+      if (previous < top) top = previous + 1;
+      else if (previous > bottom) bottom = previous - 1;
+    }
+    return (uint16_t)((2u << bottom) - (1u << top));
+  }
+
+  void drawColumn(const PageCanvas& canvas, uint8_t x, uint8_t age) const {
+    uint16_t bits = columnBits(age);
+    canvas.put(x, _page0, bits & 0xFF);
+    canvas.put(x, _page1, bits >> 8);
+  }
+
+public:
+  SparklineWidget(uint8_t x0, uint8_t page) : Widget(x0, x0 + WIDTH - 1, page, page + 1) {}
+
+  void push(int16_t value) {
+    _history.push(value);
+    if (_scrolled < WIDTH) _scrolled++;
+    _dirty = true;
+    if (!_history.valid()) return;
+
+    int16_t span = neededSpan();
+    if (_span == 0 || _history.min() < _lo || _history.max() > _lo + _span || span * 2 <= _span) {
+      _lo = (_history.min() + _history.max() - span) / 2;
+      _span = span;
+      _redraw = true;
+    }
+  }
+
+  void render(const PageCanvas& canvas) override {
+    for (uint8_t c = 0; c < WIDTH; c++) drawColumn(canvas, _x0 + c, WIDTH - 1 - c);
+    _scrolled = 0;
+    _redraw = false;
+  }
+
+  void update(const PageCanvas& canvas) override {
+    if (_redraw || _scrolled >= WIDTH) {
+      render(canvas);
+      return;
+    }
+    // Scroll the existing columns left, then draw the new ones on the right
+    for (uint8_t page = _page0; page <= _page1; page++) {
+      if (!canvas.hasPage(page)) continue;
+      for (uint8_t x = _x0; x + _scrolled <= _x1; x++) *canvas.at(x, page) = *canvas.at(x + _scrolled, page);
+    }
+    for (uint8_t age = _scrolled; age > 0; age--) drawColumn(canvas, _x1 + 1 - age, age - 1);
+    _scrolled = 0;
+  }
+
+  void invalidate() override {
+    _dirty = true;
+    _redraw = true;
+  }
+};
+
+#endif // OLED_WIDGETS_H
@@ -0,0 +1,93 @@
+#ifndef PAGE_CANVAS_H
+#define PAGE_CANVAS_H
+
+#include <Arduino.h>
+#include "largeDigitFont.h"
+#include "smallFont.h"
+
+// Byte-level view onto SSD1306 page memory
+// One byte is 8 vertical pixels of one column within a page. `stride` is the
+// distance between neighbouring columns, so the same drawing code works on
+// GyverOLED's column-major framebuffer (stride = number of pages). Writes to
+// pages outside [firstPage, lastPage] are ignored.
+struct PageCanvas {
+  uint8_t* base;      // Byte of column 0 in firstPage
+  uint8_t stride;     // Bytes between columns
+  uint8_t firstPage;
+  uint8_t lastPage;
+
+  bool hasPage(uint8_t page) const {
+    return page >= firstPage && page <= lastPage;
+  }
+
+  uint8_t* at(uint8_t x, uint8_t page) const {
+    return base + x * stride + (page - firstPage);
+  }
+
+  void put(uint8_t x, uint8_t page, uint8_t bits) const {
+    if (hasPage(page)) *at(x, page) = bits;
+  }
+
+  void clear(uint8_t x0, uint8_t x1, uint8_t page) const {
+    if (!hasPage(page)) return;
+    for (uint16_t x = x0; x <= x1; x++) *at(x, page) = 0;
+  }
+};
+
+inline uint8_t largeDigitIndex(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  switch (c) {
+    case '.': return 10;
+    case '-': return 11;
+    case 'C': return 12;
+    default:  return 13;  // Blank
+  }
+}
+
+inline uint8_t smallFontIndex(char c) {
+  if (c >= '0' && c <= '9') return 5 + (c - '0');
+  if (c >= 'A' && c <= 'Z') return 15 + (c - 'A');
+  switch (c) {
+    case '-': return 1;
+    case '.': return 2;
+    case ':': return 3;
+    case '|': return 4;
+    default:  return 0;  // Blank
+  }
+}
+
+// Copy pre-rendered glyphs straight into page memory, two pages tall from `page`
+// Glyph bytes are already in column/page order, so each column is two byte copies;
+// the gap columns between glyphs are cleared. Glyphs that would run past xMax are
+// dropped. Returns the x after the last glyph.
+inline uint8_t drawLargeText(const PageCanvas& canvas, uint8_t x, uint8_t page, const char* text, uint8_t xMax = 127) {
+  bool upper = canvas.hasPage(page);
+  bool lower = canvas.hasPage(page + 1);
+  for (; *text && x + LARGE_DIGIT_PITCH <= xMax + 1; text++) {
+    const uint8_t* glyph = largeDigitFont[largeDigitIndex(*text)];
+    for (uint8_t c = 0; c < LARGE_DIGIT_PITCH; c++, x++) {
+      uint8_t top = 0, bottom = 0;
+      if (c < LARGE_DIGIT_WIDTH) {
+        top = pgm_read_byte(&glyph[c * LARGE_DIGIT_PAGES]);
+        bottom = pgm_read_byte(&glyph[c * LARGE_DIGIT_PAGES + 1]);
+      }
+      if (upper) *canvas.at(x, page) = top;
+      if (lower) *canvas.at(x, page + 1) = bottom;
+    }
+  }
+  return x;
+}
+
+// One page tall version of drawLargeText() with the 5x7 font
+inline uint8_t drawSmallText(const PageCanvas& canvas, uint8_t x, uint8_t page, const char* text, uint8_t xMax = 127) {
+  if (!canvas.hasPage(page)) return x;
+  for (; *text && x + SMALL_FONT_PITCH <= xMax + 1; text++) {
+    const uint8_t* glyph = smallFont[smallFontIndex(*text)];
+    for (uint8_t c = 0; c < SMALL_FONT_PITCH; c++, x++) {
+      *canvas.at(x, page) = (c < SMALL_FONT_WIDTH) ? pgm_read_byte(&glyph[c]) : 0;
+    }
+  }
+  return x;
+}
+
+#endif // PAGE_CANVAS_H
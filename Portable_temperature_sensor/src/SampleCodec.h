@@ -0,0 +1,167 @@
+#ifndef SAMPLE_CODEC_H
+#define SAMPLE_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "SampleRing.h"
+
+// Batch payload format (version 2), all integers LEB128 varints:
+//   'T' 'B' version
+//   boot ID (random per power-up, scopes sequence numbers to one uptime)
+//   first sequence number
+//   sample count
+//   epoch ms of the first sample (0 when the clock was not synced)
+//   first value (zigzag)
+//   per following sample: ms delta since previous sample, value delta (zigzag)
+// Samples in a batch are consecutive ring positions, so sequence numbers are implicit.
+#define SAMPLE_BATCH_MAGIC0 'T'
+#define SAMPLE_BATCH_MAGIC1 'B'
+#define SAMPLE_BATCH_VERSION 2
+
+inline uint32_t zigzagEncode(int32_t v) {
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+inline int32_t zigzagDecode(uint32_t v) {
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// Counts bytes instead of writing them; used to size a payload before streaming it
+class CountingSink {
+private:
+  size_t _count = 0;
+
+public:
+  void put(uint8_t) { _count++; }
+  size_t count() const { return _count; }
+};
+
+template <class Sink>
+inline void putVarint(Sink& sink, uint64_t v) {
+  while (v >= 0x80) {
+    sink.put((uint8_t)(v | 0x80));
+    v >>= 7;
+  }
+  sink.put((uint8_t)v);
+}
+
+// Encode count samples starting at ring position first into sink, one byte at a time
+template <class Sink, class Ring>
+inline void encodeSampleBatch(Sink& sink, const Ring& ring, uint32_t bootId, uint32_t first, uint32_t count,
+                              uint64_t firstEpochMs) {
+  sink.put(SAMPLE_BATCH_MAGIC0);
+  sink.put(SAMPLE_BATCH_MAGIC1);
+  sink.put(SAMPLE_BATCH_VERSION);
+  putVarint(sink, bootId);
+  putVarint(sink, first);
+  putVarint(sink, count);
+  putVarint(sink, firstEpochMs);
+  if (count == 0) return;
+
+  const Sample* prev = &ring.at(first);
+  putVarint(sink, zigzagEncode(prev->value));
+  for (uint32_t i = 1; i < count; i++) {
+    const Sample* s = &ring.at(first + i);
+    putVarint(sink, s->ms - prev->ms);
+    putVarint(sink, zigzagEncode((int32_t)s->value - prev->value));
+    prev = s;
+  }
+}
+
+template <class Ring>
+inline size_t sampleBatchSize(const Ring& ring, uint32_t bootId, uint32_t first, uint32_t count,
+                              uint64_t firstEpochMs) {
+  CountingSink counter;
+  encodeSampleBatch(counter, ring, bootId, first, count, firstEpochMs);
+  return counter.count();
+}
+
+// Reading batches back, for receivers and host tools; the firmware itself only encodes
+struct SampleBatchHeader {
+  uint32_t bootId;
+  uint32_t first;        // Sequence number of the first sample
+  uint32_t count;
+  uint64_t firstEpochMs;
+};
+
+// Varint of at most 10 bytes at p, advancing p; false if truncated or too long
+inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+  v = 0;
+  for (int shift = 0; shift < 70 && p < end; shift += 7) {
+    uint8_t b = *p++;
+    v |= (uint64_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+// Check the magic and version and read the header; p is left at the first sample
+inline bool decodeSampleBatchHeader(const uint8_t*& p, const uint8_t* end, SampleBatchHeader& header) {
+  if (end - p < 3 || p[0] != SAMPLE_BATCH_MAGIC0 || p[1] != SAMPLE_BATCH_MAGIC1 || p[2] != SAMPLE_BATCH_VERSION) {
+    return false;
+  }
+  p += 3;
+  uint64_t bootId, first, count;
+  if (!getVarint(p, end, bootId) || !getVarint(p, end, first) || !getVarint(p, end, count) ||
+      !getVarint(p, end, header.firstEpochMs)) {
+    return false;
+  }
+  if (bootId > UINT32_MAX || first > UINT32_MAX || count > UINT32_MAX) return false;
+  header.bootId = (uint32_t)bootId;
+  header.first = (uint32_t)first;
+  header.count = (uint32_t)count;
+  return true;
+}
+
+// Decode a whole batch into out, which must have room for `capacity` samples
+// Sample times come back relative to the first sample of the batch (ms = 0).
+inline bool decodeSampleBatch(const uint8_t* payload, size_t length, SampleBatchHeader& header, Sample* out,
+                              uint32_t capacity) {
+  const uint8_t* p = payload;
+  const uint8_t* end = payload + length;
+  if (!decodeSampleBatchHeader(p, end, header) || header.count > capacity) return false;
+  if (header.count == 0) return p == end;
+
+  uint64_t v;
+  if (!getVarint(p, end, v)) return false;
+  out[0].ms = 0;
+  out[0].value = (int16_t)zigzagDecode((uint32_t)v);
+  for (uint32_t i = 1; i < header.count; i++) {
+    uint64_t dt, dv;
+    if (!getVarint(p, end, dt) || !getVarint(p, end, dv)) return false;
+    out[i].ms = out[i - 1].ms + (uint32_t)dt;
+    out[i].value = (int16_t)(out[i - 1].value + zigzagDecode((uint32_t)dv));
+  }
+  return p == end;
+}
+
+// Ack payload on sensor/<id>/set/ack: "<boot ID>:<next sequence number>", in decimal
+// The boot ID scopes the ack like the batch it answers: an ack the broker kept
+// for the persistent session across a reboot must not release the new boot's samples.
+#define SAMPLE_ACK_LEN 22  // Longest payload plus its terminator
+
+inline int formatSampleAck(char* buf, size_t size, uint32_t bootId, uint32_t next) {
+  return snprintf(buf, size, "%lu:%lu", (unsigned long)bootId, (unsigned long)next);
+}
+
+// Decimal uint32_t at p up to `stop`; false if empty, too large or followed by anything else
+inline bool getDecimal32(const char*& p, char stop, uint32_t& v) {
+  uint64_t n = 0;
+  const char* start = p;
+  while ((unsigned)(*p - '0') <= 9) {
+    n = n * 10 + (uint32_t)(*p++ - '0');
+    if (n > UINT32_MAX) return false;
+  }
+  v = (uint32_t)n;
+  return p != start && *p == stop;
+}
+
+inline bool parseSampleAck(const char* payload, uint32_t& bootId, uint32_t& next) {
+  const char* p = payload;
+  if (!getDecimal32(p, ':', bootId)) return false;
+  p++;
+  return getDecimal32(p, '\0', next);
+}
+
+#endif // SAMPLE_CODEC_H
@@ -0,0 +1,75 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <stdint.h>
+#include <math.h>
+
+// Temperatures are stored as fixed-point quarter degrees, the MAX6675's native resolution
+#define SAMPLE_FAULT INT16_MIN  // Open thermocouple / invalid reading
+
+struct Sample {
+  uint32_t ms;    // millis() when the sample was latched
+  int16_t value;  // Temperature in 0.25°C steps, or SAMPLE_FAULT
+};
+
+inline int16_t sampleFromCelsius(double celsius) {
+  if (isnan(celsius)) return SAMPLE_FAULT;
+  return (int16_t)lround(celsius * 4.0);
+}
+
+// Limits set in °C (thresholds, hysteresis, rate of rise) must lie within the
+// MAX6675's range; anything larger would wrap in the 16-bit sample format, or hit
+// ALARM_LEVEL_OFF, instead of comparing as a large value
+#define SAMPLE_CELSIUS_MAX 1023.75
+
+inline bool sampleCelsiusInRange(double celsius) {
+  return celsius >= 0 && celsius <= SAMPLE_CELSIUS_MAX;  // False for NaN
+}
+
+inline double sampleToCelsius(int16_t value) {
+  return (value == SAMPLE_FAULT) ? NAN : value * 0.25;
+}
+
+// Fixed-capacity ring of samples waiting to be delivered
+// Positions are absolute sequence numbers that keep increasing across wraps,
+// so a position identifies one sample for the whole uptime. When the ring is
+// full the oldest sample is overwritten and counted as dropped.
+template <uint16_t CAPACITY>
+class SampleRing {
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "SampleRing capacity must be a power of two");
+
+private:
+  Sample _samples[CAPACITY];
+  uint32_t _head = 0;     // Sequence number of the next sample to be written
+  uint32_t _tail = 0;     // Sequence number of the oldest undelivered sample
+  uint32_t _dropped = 0;  // Samples overwritten before delivery
+
+public:
+  void push(uint32_t ms, int16_t value) {
+    if (_head - _tail == CAPACITY) {
+      _tail++;
+      _dropped++;
+    }
+    Sample& s = _samples[_head & (CAPACITY - 1)];
+    s.ms = ms;
+    s.value = value;
+    _head++;
+  }
+
+  const Sample& at(uint32_t seq) const {
+    return _samples[seq & (CAPACITY - 1)];
+  }
+
+  // Mark every sample before seq as delivered
+  void consume(uint32_t seq) {
+    if (seq - _tail <= _head - _tail) _tail = seq;
+  }
+
+  uint32_t head() const { return _head; }
+  uint32_t tail() const { return _tail; }
+  uint32_t size() const { return _head - _tail; }
+  uint32_t dropped() const { return _dropped; }
+  uint16_t capacity() const { return CAPACITY; }
+};
+
+#endif // SAMPLE_RING_H
@@ -0,0 +1,104 @@
+#ifndef SAMPLE_UPLINK_H
+#define SAMPLE_UPLINK_H
+
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include <sys/time.h>
+#include "DeliveryWindow.h"
+#include "MqttLink.h"
+#include "SampleCodec.h"
+#include "SampleRing.h"
+
+#define SAMPLE_BATCH_MAX 256  // Samples per streamed batch message
+
+// MQTT delivery of the buffered samples: the live text value and acknowledged batches
+// Holds no state of its own beyond the boot ID and a counter; the ring and the delivery window
+// belong to the caller. The host fleet generator runs one of these per virtual
+// device, so what it puts on the broker is exactly what the firmware sends.
+template <class Ring>
+class SampleUplink {
+private:
+  PubSubClient& _client;
+  MqttLink& _link;
+  Ring& _ring;
+  DeliveryWindow& _window;
+  uint32_t _bootId = 0;  // Random per power-up, tags batches so receivers can tell reboots apart
+  uint32_t _rejectedAcks = 0;  // Malformed, or for another boot
+
+public:
+  SampleUplink(PubSubClient& client, MqttLink& link, Ring& ring, DeliveryWindow& window)
+    : _client(client), _link(link), _ring(ring), _window(window) {}
+
+  void begin(uint32_t bootId) { _bootId = bootId; }
+  uint32_t bootId() const { return _bootId; }
+
+  // Epoch time in ms at which a sample was latched, or 0 while NTP has not synced yet
+  static uint64_t sampleEpochMs(const Sample& sample) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    if (tv.tv_sec < 1600000000) return 0;  // Clock still at its power-on default
+    uint64_t nowMs = (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    return nowMs - (millis() - sample.ms);
+  }
+
+  // Publish the latest sample as text on the temperature topic; true if it went out
+  // Without acks (window 0) this is how samples are delivered, the live value for
+  // dashboards included, once deliver() has streamed any backlog. With acks every
+  // sample goes out in a batch and nothing is sent here, so no sample is sent twice.
+  bool publishLatest() {
+    if (_window.enabled() || !_client.connected() || _ring.size() == 0) {
+      return false;  // Batches carry the samples, or keep buffering until the broker is reachable
+    }
+
+    if (_ring.size() > 1) {
+      return false;  // Backlog first so the text topic stays in order
+    }
+
+    char buf[16];
+    dtostrf(sampleToCelsius(_ring.at(_ring.head() - 1).value), 0, 1, buf);
+    if (!_client.publish(_link.topics().telemetry(TOPIC_TEMPERATURE), buf)) return false;
+    _ring.consume(_ring.head());
+    return true;
+  }
+
+  // Stream buffered samples as batches while the delivery window has room
+  // Samples leave the ring only once acknowledged (or immediately with window 0).
+  // Returns the number of batches written.
+  uint32_t deliver() {
+    uint32_t batches = 0;
+    _window.checkTimeout(millis());
+
+    while (_window.canSend()) {
+      uint32_t first = _window.nextToSend(_ring.tail());
+      uint32_t pending = _ring.head() - first;
+      if (pending == 0) break;
+      uint32_t count = (pending > SAMPLE_BATCH_MAX) ? SAMPLE_BATCH_MAX : pending;
+      if (!_link.publishBatch(_ring, _bootId, first, count, sampleEpochMs(_ring.at(first)))) break;
+      _window.sent(first + count, millis());
+      batches++;
+    }
+    _ring.consume(_window.acked());
+    return batches;
+  }
+
+  // Cumulative ack from the receiver, the payload of sensor/<id>/set/ack (SampleCodec.h)
+  // Acks for another boot, e.g. queued by the broker before a reboot, are ignored.
+  bool ack(const char* payload) {
+    uint32_t bootId, next;
+    if (!parseSampleAck(payload, bootId, next) || bootId != _bootId) {
+      _rejectedAcks++;
+      return false;
+    }
+    _ring.consume(_window.ack(next, millis()));
+    return true;
+  }
+
+  uint32_t rejectedAcks() const { return _rejectedAcks; }
+
+  // Resend whatever was in flight when the link dropped
+  void reconnected() {
+    _window.rewind();
+  }
+};
+
+#endif // SAMPLE_UPLINK_H
@@ -0,0 +1,76 @@
+#ifndef SLIDING_MIN_MAX_H
+#define SLIDING_MIN_MAX_H
+
+#include <stdint.h>
+#include "SampleRing.h"
+
+// History of the last WINDOW samples with O(1) minimum and maximum
+// Besides the values themselves, two monotonic deques of history slots are
+// kept: along the max deque values strictly decrease, along the min deque they
+// strictly increase. A new value first pops every entry it dominates off the
+// back, so the front is always the extreme of the window; the front is dropped
+// once it slides out. Each value is pushed and popped at most once per deque,
+// which makes push() amortised constant time instead of a rescan of the window.
+// SAMPLE_FAULT values are kept in the history but never become min or max.
+template <uint8_t WINDOW>
+class SlidingMinMax {
+private:
+  // Ring of history slots, oldest at the front
+  struct SlotDeque {
+    uint8_t items[WINDOW];
+    uint8_t head = 0;
+    uint8_t size = 0;
+
+    uint8_t front() const { return items[head]; }
+    uint8_t back() const { return items[(head + size - 1) % WINDOW]; }
+    void popFront() { head = (head + 1) % WINDOW; size--; }
+    void popBack() { size--; }
+    void pushBack(uint8_t slot) { items[(head + size++) % WINDOW] = slot; }
+  };
+
+  int16_t _values[WINDOW];
+  uint8_t _next = 0;     // Slot the next value goes to
+  uint8_t _count = 0;    // Values in the window, up to WINDOW
+  SlotDeque _maxQ;
+  SlotDeque _minQ;
+
+public:
+  void push(int16_t value) {
+    uint8_t slot = _next;
+    _next = (_next + 1) % WINDOW;
+    if (_count < WINDOW) _count++;
+
+    // The slot about to be overwritten holds the value sliding out of the window;
+    // if it is still an extreme it sits at the front of its deque
+    if (_maxQ.size && _maxQ.front() == slot) _maxQ.popFront();
+    if (_minQ.size && _minQ.front() == slot) _minQ.popFront();
+    _values[slot] = value;
+    if (value == SAMPLE_FAULT) return;
+
+    while (_maxQ.size && _values[_maxQ.back()] <= value) _maxQ.popBack();
+    _maxQ.pushBack(slot);
+    while (_minQ.size && _values[_minQ.back()] >= value) _minQ.popBack();
+    _minQ.pushBack(slot);
+  }
+
+  // Value `age` samples back; 0 is the newest. age must be below count()
+  int16_t recent(uint8_t age) const {
+    return _values[(_next + WINDOW - 1 - age) % WINDOW];
+  }
+
+  uint8_t count() const { return _count; }
+
+  // False while the window holds no valid value; min() and max() are meaningless then
+  bool valid() const { return _maxQ.size > 0; }
+  int16_t min() const { return _values[_minQ.front()]; }
+  int16_t max() const { return _values[_maxQ.front()]; }
+
+  void clear() {
+    _next = 0;
+    _count = 0;
+    _maxQ.size = 0;
+    _minQ.size = 0;
+  }
+};
+
+#endif // SLIDING_MIN_MAX_H
@@ -0,0 +1,28 @@
+#ifndef SPLASH_DECODER_H
+#define SPLASH_DECODER_H
+
+#include <Arduino.h>
+#include "splashAnimation.h"
+
+// Streaming decoder for the splash animation generated by tools/splash_encode.py
+// Each frame is an RLE-coded XOR delta against the previous frame, laid out in
+// framebuffer order, so decoding applies it in place: skip tokens leave bytes
+// untouched and literal tokens XOR stream bytes into the buffer. The buffer must
+// hold frame n-1 (or be cleared for frame 0); nothing is decompressed elsewhere.
+inline void decodeSplashFrame(uint8_t* buffer, uint8_t frame) {
+  uint16_t i = pgm_read_word(&splashFrameOffsets[frame]);
+  uint16_t end = pgm_read_word(&splashFrameOffsets[frame + 1]);
+  uint16_t pos = 0;
+  while (i < end) {
+    uint8_t token = pgm_read_byte(&splashStream[i++]);
+    if (token < 0x80) {
+      pos += token + 1;  // Unchanged bytes
+      continue;
+    }
+    for (uint8_t n = (token & 0x7F) + 1; n > 0; n--) {
+      buffer[pos++] ^= pgm_read_byte(&splashStream[i++]);
+    }
+  }
+}
+
+#endif // SPLASH_DECODER_H
@@ -0,0 +1,72 @@
+#ifndef TRIGGER_OUTPUT_H
+#define TRIGGER_OUTPUT_H
+
+#include <Arduino.h>
+#include <Ticker.h>
+
+#define TRIGGER_PULSE_MAX 60000  // ms; widths are stored in 16 bits
+
+enum TriggerMode {
+  TRIGGER_OFF,    // Pin held low
+  TRIGGER_LEVEL,  // Pin high while the alarm condition holds
+  TRIGGER_PULSE   // Fixed-width high pulse when the alarm condition starts
+};
+
+// Hardware trigger output for external equipment such as a PLC input
+// Driven straight from the alarm evaluation of each fresh sample, so the edge
+// follows the sensor read by a few microseconds instead of an MQTT round trip.
+// In pulse mode the falling edge is timed by a one-shot SDK timer, which keeps
+// the pulse width independent of how long loop() takes.
+class TriggerOutput {
+private:
+  uint8_t _pin;
+  TriggerMode _mode = TRIGGER_LEVEL;
+  uint16_t _pulseWidth = 100;  // ms
+  bool _active = false;        // Last alarm condition seen
+  Ticker _pulseEnd;
+
+  static void endPulse(uint8_t pin) {
+    digitalWrite(pin, LOW);
+  }
+
+public:
+  TriggerOutput(uint8_t pin) : _pin(pin) {}
+
+  void begin() {
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, LOW);  // Inactive
+  }
+
+  // Feed the current alarm condition; returns true if this produced a pin edge
+  bool update(bool active) {
+    if (active == _active) return false;
+    _active = active;
+
+    switch (_mode) {
+      case TRIGGER_LEVEL:
+        digitalWrite(_pin, active ? HIGH : LOW);
+        return true;
+      case TRIGGER_PULSE:
+        if (!active) return false;
+        digitalWrite(_pin, HIGH);
+        _pulseEnd.once_ms(_pulseWidth, endPulse, _pin);
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Pulse widths above TRIGGER_PULSE_MAX are clamped by the caller
+  void setMode(TriggerMode mode, uint16_t pulseWidth = 100) {
+    _pulseEnd.detach();
+    _mode = mode;
+    _pulseWidth = pulseWidth;
+    // Re-sync the pin with the current condition in the new mode
+    digitalWrite(_pin, (_mode == TRIGGER_LEVEL && _active) ? HIGH : LOW);
+  }
+
+  TriggerMode getMode() { return _mode; }
+  uint16_t getPulseWidth() { return _pulseWidth; }
+};
+
+#endif // TRIGGER_OUTPUT_H
@@ -1,8 +1,11 @@
+#include "Features.h"
+
+// Only built with the display; see Features.h
+#if FEATURE_DISPLAY
 #include "display_helper.h"
-#include "NetworkManager.h"
 
 // External variables defined elsewhere
-extern GyverOLED<SSD1306_128x32, OLED_BUFFER> display;
+extern OledDisplay display;
 extern int currentX; // Current cursor position X
 extern int currentY; // Current cursor position Y
 extern int currentScale; // Current text scale
@@ -89,10 +92,7 @@ void drawTemperatureScreen(double temperature, double setpoint, bool buzzerEnabl
   Serial.print("DEBUG: Drawing temperature screen with temp=");
   Serial.println(temperature);
   
-  // Ensure the display is initialized properly before clearing
-  display.clear();   // Clear the buffer
-  display.update();  // Initial update to ensure the display is clear
-  display.clear();   // Clear again for good measure
+  display.clear();   // Clear the buffer; the compositor sends only what changed
   
   // Draw vertical divider in the middle of the screen
   display.line(SCREEN_WIDTH/2, 0, SCREEN_WIDTH/2, SCREEN_HEIGHT-1, 1);
@@ -190,6 +190,7 @@ void drawTemperatureScreen(double temperature, double setpoint, bool buzzerEnabl
     display.print("NRM");
   }
   
+#if FEATURE_MQTT
   // Connection status indicators in the corners
   // WiFi indicator (bottom left)
   display.setCursor(2, SCREEN_HEIGHT-8);  if (networkManager.isConnected()) {
@@ -230,7 +231,12 @@ void drawTemperatureScreen(double temperature, double setpoint, bool buzzerEnabl
     display.line(SCREEN_WIDTH-3, 1, SCREEN_WIDTH-5, 3, 1);   // Right diagonal
     display.line(SCREEN_WIDTH-7, 1, SCREEN_WIDTH-5, 3, 1);   // Left diagonal
   }
+#endif
   
   // Update the display
-  display.update();
+#ifndef OLED_TILE_RENDER
+  oledCompositor.flush();
+#endif  // Without a framebuffer the drawing above already went to the panel
 }
+
+#endif // FEATURE_DISPLAY
@@ -2,9 +2,16 @@
 #define DISPLAY_HELPER_H
 
 #include <Arduino.h>
+#include "Features.h"
+
+// Only built with the display; see Features.h. Headless builds have no GyverOLED.
+#if FEATURE_DISPLAY
 #include <GyverOLED.h>
+#include "OledCompositor.h"
+#if FEATURE_MQTT
 #include <PubSubClient.h>
 #include "NetworkManager.h"
+#endif
 
 // These definitions should match those in main.cpp
 #ifndef SCREEN_WIDTH
@@ -14,13 +21,28 @@
 #define SCREEN_HEIGHT 32
 #endif
 
+// Render mode, chosen at compile time:
+// - default: GyverOLED keeps a 512-byte framebuffer and OledCompositor sends what changed
+// - OLED_TILE_RENDER: no framebuffer; OledTileRenderer draws the widgets one page at a
+//   time and GyverOLED's own drawing calls go straight to the panel
+#ifdef OLED_TILE_RENDER
+typedef GyverOLED<SSD1306_128x32, OLED_NO_BUFFER> OledDisplay;
+#else
+typedef GyverOLED<SSD1306_128x32, OLED_BUFFER> OledDisplay;
+#endif
+
 // Forward declarations for external variables needed by helper functions
-extern GyverOLED<SSD1306_128x32, OLED_BUFFER> display;
+extern OledDisplay display;
+#ifndef OLED_TILE_RENDER
+extern OledCompositor<OledDisplay> oledCompositor;
+#endif
+#if FEATURE_MQTT
 extern PubSubClient mqttClient;
 extern NetworkManager networkManager;
 extern unsigned long lastMqttUpload;
 extern unsigned long lastMqttDownload;
 extern const unsigned long mqttActivityIndicatorDuration;
+#endif
 
 // Text handling function declarations
 void setTextCursor(int x, int y);
@@ -32,4 +54,6 @@ void displayTemperature(double value, int x, int y, int scale, bool addDegreeSym
 // This helper function will directly handle temperature display in the left half of the screen
 void drawTemperatureScreen(double temperature, double setpoint, bool buzzerEnabled, unsigned long silenceUntil, String mode);
 
+#endif // FEATURE_DISPLAY
+
 #endif // DISPLAY_HELPER_H
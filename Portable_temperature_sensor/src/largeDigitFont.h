@@ -0,0 +1,34 @@
+#ifndef LARGE_DIGIT_FONT_H
+#define LARGE_DIGIT_FONT_H
+
+#include <Arduino.h>
+
+// Large digits for the temperature readout, 10x16 pixels on a 12-pixel pitch
+// The classic 5x7 glyphs doubled in both directions, the same shapes GyverOLED
+// draws at setScale(2), pre-rendered so no scaling happens at runtime.
+// Each glyph is stored column by column in SSD1306 page format: for every
+// column the byte for the upper page, then the byte for the lower page.
+#define LARGE_DIGIT_WIDTH 10
+#define LARGE_DIGIT_PITCH 12
+#define LARGE_DIGIT_PAGES 2
+#define LARGE_DIGIT_BYTES (LARGE_DIGIT_WIDTH * LARGE_DIGIT_PAGES)
+#define LARGE_DIGIT_CHARS "0123456789.-C "
+
+const uint8_t largeDigitFont[][LARGE_DIGIT_BYTES] PROGMEM = {
+  {0xfc, 0x0f, 0xfc, 0x0f, 0x03, 0x33, 0x03, 0x33, 0xc3, 0x30, 0xc3, 0x30, 0x33, 0x30, 0x33, 0x30, 0xfc, 0x0f, 0xfc, 0x0f},  // '0'
+  {0x00, 0x00, 0x00, 0x00, 0x0c, 0x30, 0x0c, 0x30, 0xff, 0x3f, 0xff, 0x3f, 0x00, 0x30, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00},  // '1'
+  {0x0c, 0x30, 0x0c, 0x30, 0x03, 0x3c, 0x03, 0x3c, 0x03, 0x33, 0x03, 0x33, 0xc3, 0x30, 0xc3, 0x30, 0x3c, 0x30, 0x3c, 0x30},  // '2'
+  {0x03, 0x0c, 0x03, 0x0c, 0x03, 0x30, 0x03, 0x30, 0x33, 0x30, 0x33, 0x30, 0xcf, 0x30, 0xcf, 0x30, 0x03, 0x0f, 0x03, 0x0f},  // '3'
+  {0xc0, 0x03, 0xc0, 0x03, 0x30, 0x03, 0x30, 0x03, 0x0c, 0x03, 0x0c, 0x03, 0xff, 0x3f, 0xff, 0x3f, 0x00, 0x03, 0x00, 0x03},  // '4'
+  {0x3f, 0x0c, 0x3f, 0x0c, 0x33, 0x30, 0x33, 0x30, 0x33, 0x30, 0x33, 0x30, 0x33, 0x30, 0x33, 0x30, 0xc3, 0x0f, 0xc3, 0x0f},  // '5'
+  {0xf0, 0x0f, 0xf0, 0x0f, 0xcc, 0x30, 0xcc, 0x30, 0xc3, 0x30, 0xc3, 0x30, 0xc3, 0x30, 0xc3, 0x30, 0x00, 0x0f, 0x00, 0x0f},  // '6'
+  {0x03, 0x00, 0x03, 0x00, 0x03, 0x3f, 0x03, 0x3f, 0xc3, 0x00, 0xc3, 0x00, 0x33, 0x00, 0x33, 0x00, 0x0f, 0x00, 0x0f, 0x00},  // '7'
+  {0x3c, 0x0f, 0x3c, 0x0f, 0xc3, 0x30, 0xc3, 0x30, 0xc3, 0x30, 0xc3, 0x30, 0xc3, 0x30, 0xc3, 0x30, 0x3c, 0x0f, 0x3c, 0x0f},  // '8'
+  {0x3c, 0x00, 0x3c, 0x00, 0xc3, 0x30, 0xc3, 0x30, 0xc3, 0x30, 0xc3, 0x30, 0xc3, 0x0c, 0xc3, 0x0c, 0xfc, 0x03, 0xfc, 0x03},  // '9'
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x3c, 0x00, 0x3c, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // '.'
+  {0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00, 0xc0, 0x00},  // '-'
+  {0xfc, 0x0f, 0xfc, 0x0f, 0x03, 0x30, 0x03, 0x30, 0x03, 0x30, 0x03, 0x30, 0x03, 0x30, 0x03, 0x30, 0x0c, 0x0c, 0x0c, 0x0c},  // 'C'
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ' '
+};
+
+#endif // LARGE_DIGIT_FONT_H
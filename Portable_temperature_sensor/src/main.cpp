@@ -1,13 +1,33 @@
 #include <Arduino.h>
+#include "Features.h"  // Subsystems in this build; each #if below drops one of them
+#if FEATURE_MQTT
 #include <ESP8266WiFi.h>
 #include <PubSubClient.h>
+#endif
+#if FEATURE_EXT_SERIAL
 #include <SoftwareSerial.h>
+#endif
 #include <time.h>
+#include <sys/time.h>
 #include <max6675.h>
-#include <GyverOLED.h>
+#if FEATURE_MQTT
 #include "NetworkManager.h"
+#include "MqttLink.h"
+#include "DeliveryWindow.h"
+#include "SampleUplink.h"
+#endif
+#include "SampleRing.h"
+#include "AlarmEngine.h"
+#include "TriggerOutput.h"
+#if FEATURE_DISPLAY
+#include <GyverOLED.h>
+#include "PageCanvas.h"
+#include "OledWidgets.h"
+#include "OledTileRenderer.h"
 #include "display_helper.h"
-#include "splashScreen.h"
+#include "SplashDecoder.h"
+#endif
+#include "BootSequence.h"
 
 /*
 HARDWARE CONNECTIONS:
@@ -37,7 +57,9 @@ Power Requirements:
 // External communication port (separate from debug serial)
 const int SOFT_RX = 13;  // GPIO13 (D7)
 const int SOFT_TX = 15;  // GPIO15 (D8)
+#if FEATURE_EXT_SERIAL
 SoftwareSerial softSerial(SOFT_RX, SOFT_TX);
+#endif
 
 // MAX6675 thermocouple interface pins
 const int thermoDO = 12;   // Data out (SO/MISO)
@@ -48,7 +70,9 @@ MAX6675 thermocouple(thermoCLK, thermoCS, thermoDO);
 // Output pins
 const int buzzerPin = 0;     // Alarm buzzer
 const int interruptPin = 2;  // External trigger signal
+TriggerOutput triggerOutput(interruptPin);  // Driven by the setpoint alarm, see acquireSample()
 
+#if FEATURE_MQTT
 // Wi-Fi & MQTT configuration (fill these in)
 const char* ssid         = "********";        // FIXME: replace with your wifi SSID
 const char* password     = "********";        // FIXME: replace with your wifi password
@@ -60,7 +84,10 @@ const char* mqtt_pass    = "***test***";      // FIXME: replace with your mqtt p
 WiFiClient espClient;
 PubSubClient mqttClient(espClient);
 NetworkManager networkManager(ssid, password);
+MqttLink mqttLink(mqttClient, mqtt_user, mqtt_pass);
+#endif
 
+#if FEATURE_DISPLAY
 // OLED display definitions (I2C PCB: SDA=GPIO4, SCL=GPIO5)
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 32
@@ -68,21 +95,58 @@ NetworkManager networkManager(ssid, password);
 #define OLED_BLACK 0  // Color constant for drawing in black
 int currentX, currentY, currentScale; // Track cursor position and text scale
 
-// Initialize OLED display with SSD1306 driver (128x32 resolution)
-// using buffered mode for smoother updates, at I2C address 0x3C
-GyverOLED<SSD1306_128x32, OLED_BUFFER> display(0x3C);
+// Initialize OLED display with SSD1306 driver (128x32 resolution) at I2C address 0x3C
+// Buffered by default; building with OLED_TILE_RENDER drops the framebuffer, see display_helper.h
+OledDisplay display(0x3C);
+#ifdef OLED_TILE_RENDER
+// Composes the widgets one page at a time into a 128-byte tile and sends it from there
+OledTileRenderer<OledDisplay> oledRenderer(display);
+uint8_t* splashBuffer = NULL;  // Heap frame for the splash deltas, freed once the splash has played
+#else
+// Sends only changed regions of the buffer; drawing code never calls display.update()
+OledCompositor<OledDisplay> oledCompositor(display);
+// Byte-level access to the framebuffer for the pre-rendered font blitter
+PageCanvas oledCanvas = { display._oled_buffer, OLED_PAGES, 0, OLED_PAGES - 1 };
+#endif
+
+// Measurement screen layout; subsystems set widget values, mainScreen.render() draws what changed
+TemperatureWidget temperatureWidget(0, 96, 0);   // Pages 0-1, room for "1023.75C"
+SparklineWidget<30> trendWidget(97, 0);          // Last 30 display intervals, columns 97-126
+DividerWidget dividerWidget(0, 126, 2, 0);       // Row 16
+SetpointWidget setpointWidget(0, 71, 3);
+ModeWidget modeWidget(72, 101, 3);
+BuzzerWidget buzzerWidget(102, 126, 3);
+#if FEATURE_MQTT
+LinkStatusWidget linkStatusWidget(127, 0);       // Rows 0, 4 and 8 of the right column
+#endif
+#if FEATURE_BATTERY
+BatteryWidget batteryWidget(127, 2);             // Rows 19, 23, 27 and 31 of the right column
+#endif
+Widget* const mainWidgets[] = {
+  &temperatureWidget, &trendWidget, &dividerWidget, &setpointWidget, &modeWidget, &buzzerWidget,
+#if FEATURE_MQTT
+  &linkStatusWidget,
+#endif
+#if FEATURE_BATTERY
+  &batteryWidget,
+#endif
+};
+WidgetScreen mainScreen(mainWidgets, sizeof(mainWidgets) / sizeof(mainWidgets[0]));
 
 // OLED Display Settings
 unsigned long mainDisplayUpdateInterval = 1000; // Update display every 1 second
 unsigned long mainLastDisplayUpdateInterval = 0;
+#endif
 
+#if FEATURE_BATTERY
 // Battery voltage monitoring 
 float batteryVoltage = 0.0; // Battery voltage in volts
 int batteryPercentage = 0.0; // Battery percentage (0-100%)
 unsigned long lastBatteryUpdate = 0;
 const unsigned long batteryUpdateInterval = 1000; // Update battery status every 1 seconds
-bool batteryIndicatorToggle = false; // Flag to toggle battery indicator on display
+#endif
 
+#if FEATURE_MQTT
 // WiFi and MQTT state tracking
 bool mqttWasConnected = false;
 unsigned long lastDisplayUpdate = 0;
@@ -93,6 +157,7 @@ bool updateDisplayStatus = false;
 const char* ntpServer = "pool.ntp.org";
 const long  gmtOffset_sec = 19800;  // GMT +5:30 for IST // FIXME: Update gmt offset of your location
 const int   daylightOffset_sec = 0;
+#endif
 String outputMode = "normal";  // Default output mode
 
 // Data configuration
@@ -100,42 +165,108 @@ unsigned long sendInterval  = 1000; // ms between sends
 double        thresholdTemp = 80.00;   // °C setpoint
 unsigned long lastSendTime  = 0;
 
+// Acquisition: the MAX6675 needs ~220ms per conversion, reading faster restarts it
+const unsigned long samplePeriod = 250; // ms between thermocouple reads
+unsigned long lastSampleTime = 0;
+
 // Buzzer control
 bool buzzerEnabled = true;        // Global flag to enable/disable buzzer
 unsigned long buzzerSilenceUntil = 0;  // Timestamp until when the buzzer should be silenced
+int buzzerFrequency = 0;          // Tone currently playing, 0 when silent
+
+// Alarm evaluation on every fresh sample
+AlarmEngine alarmEngine;
+const int alarmTones[ALARM_LEVELS] = {1000, 1500, 2000}; // Hz per threshold level
+const int rateOfRiseTone = 2500;                         // Hz for the rate-of-rise alarm
+unsigned long sampleReadMicros = 0;   // micros() when the last MAX6675 read returned
+unsigned long sampleReadGap = 0;      // us from the read before it; a crossing can wait this long to be seen
+unsigned long alarmLatency = 0;       // us from the end of the read to the last buzzer edge
+unsigned long maxAlarmLatency = 0;
+unsigned long alarmReadGap = 0;       // sampleReadGap of the read behind the last buzzer edge
+unsigned long maxAlarmReadGap = 0;
+unsigned long triggerLatency = 0;     // us from the end of the read to the last trigger pin edge
+unsigned long maxTriggerLatency = 0;
 
+#if FEATURE_MQTT
 // MQTT activity tracking
 unsigned long lastMqttUpload = 0;    // Last time data was uploaded
 unsigned long lastMqttDownload = 0;  // Last time data was downloaded
 const unsigned long mqttActivityIndicatorDuration = 100; // How long to show upload/download activity (ms)
 
+// Samples waiting for MQTT delivery; a backlog builds up while the broker is unreachable
+#define SAMPLE_RING_CAPACITY 512  // Power of two, 8 bytes per sample
+SampleRing<SAMPLE_RING_CAPACITY> sampleRing;
+DeliveryWindow deliveryWindow;  // Acknowledged batch delivery, see DeliveryWindow.h
+SampleUplink<SampleRing<SAMPLE_RING_CAPACITY>> sampleUplink(mqttClient, mqttLink, sampleRing, deliveryWindow);
+#endif
+
+// Boot screens run from loop() alongside sampling and networking, see BootSequence.h
+BootSequence bootSequence;
+#if FEATURE_DISPLAY
+const unsigned long bootHoldTime = 1000;  // ms the last splash frame stays up
+const unsigned long bootInfoTime = 1500;  // ms the version screen stays up
+uint8_t splashFrame = 0;                  // Next splash frame to decode
+unsigned long splashFrameTime = 0;        // millis() when the last frame was decoded
+unsigned long splashDecodeTotal = 0;      // us spent decoding, for the per-frame report
+unsigned long splashDecodeMax = 0;
+uint8_t welcomeTones = 0;                 // Splash tones played so far
+#endif
+
+// Loop period since the last stats report, to compare build variants
+unsigned long loopCount = 0;
+unsigned long loopMicrosTotal = 0;
+unsigned long loopMicrosMax = 0;
+
+#define FIRMWARE_VERSION "1.1.0"
+
 // Global variables
 static double tempValue = 0;
-bool otherUpdate = true;
 
 // Forward declarations
+#if FEATURE_MQTT
 void mqttCallback(char* topic, byte* payload, unsigned int length);
 bool mqttReconnect(int maxAttempts = 3);
-void playBuzzerAlarm(double temperature, double threshold); // Control buzzer based on temperature
+#endif
+void networkBegin(); // Start WiFi association, NTP and the MQTT client
+void networkService(); // Keep WiFi and MQTT up and deliver buffered samples (non-blocking)
+void acquireSample(); // Read the thermocouple and evaluate alarms
+bool updateBuzzer(); // Drive the buzzer from the alarm state, only on transitions
 void updateNetworkDisplay(); // Update network status on display
-void logodisplay(); // Display logo on OLED
-void displayUpdate(); // Update display with temperature and settings
+void updateSettingsDisplay(); // Show the current setpoint, output mode and buzzer state
+void bootUpdate(); // Step the boot screens (non-blocking)
+void bootMilestone(BootMilestone milestone); // Record and report a boot milestone
+void displayUpdate(); // Update the temperature and trend on the display
+void displayService(); // Draw and send this loop's display changes within the I2C budget
+unsigned int displayRam(); // RAM held by the display driver and renderer
 void serialHandler(); // Handle incoming serial data
+void serialOutput(double tempC); // Send a reading to the external device
 void batteryMonitor(); // Monitor battery voltage
+void queueSample(unsigned long now, double tempC); // Buffer a reading for MQTT delivery
+void publishSamples(); // Publish the latest sample over MQTT
+void deliverSamples(); // Stream buffered samples as batches within the delivery window
+void printStats(); // Print runtime statistics
+void printBuild(); // Print the feature set and image size
 
 void setup() {  
   // Initialize both serial ports
   Serial.begin(115200);     // Hardware Serial for debug
+#if FEATURE_EXT_SERIAL
   softSerial.begin(9600);   // Software Serial for communication with external device
+#endif
   Serial.println("Debug: Serial ports initialized");
+
+  // Start WiFi association first; it runs in the background while the splash plays
+  networkBegin();
   
   // Configure output pins for buzzer and interrupt signals
   pinMode(buzzerPin, OUTPUT);
-  pinMode(interruptPin, OUTPUT);
-  digitalWrite(interruptPin, LOW); // Initialize interrupt signal as inactive
+  triggerOutput.begin();          // Initialize interrupt signal as inactive
   
   noTone(buzzerPin);              // Initialize buzzer in silent state
-  // MAX6675 automatically initializes when the object is created
+  alarmEngine.setThreshold(1, sampleFromCelsius(thresholdTemp));
+  // MAX6675 automatically initializes when the object is created and starts its
+  // first conversion at power-up; loop() reads it once a full sample period has passed
+#if FEATURE_DISPLAY
   // I2C init for OLED
   Wire.begin(4, 5);
   Wire.setClock(400000);  // Set I2C clock speed to 400kHz (fast mode)
@@ -145,63 +276,60 @@ void setup() {
   display.autoPrintln(true);      // Enable automatic line breaks
   display.invertText(false);      // Ensure text isn't inverted (text is white on black background)
   display.textMode(BUF_REPLACE);  // Ensure text writes in replace mode (not overlaid)
-
-  logodisplay();  // Display animated logo on OLED
-
-  // Initialize network manager (non-blocking)
-  networkManager.begin();
-  networkManager.startConnection();  // Define version and device info
-  const String VERSION = "1.1.0";
-  const String DEVICE_ID = "ESP-" + String(ESP.getChipId(), HEX);
-
-  // Show startup message
-  display.clear();
-  display.setScale(2);
-  display.setCursor(57, 0);
-  display.print("MEL");
-  display.setScale(1);
-  display.setCursor(0, 2);
-  display.print("Temp Sensor v");
-  display.print(VERSION);
-  display.setCursor(0, 3); // line 1 (GyverOLED uses line-based cursor position)
-  display.print("ID: ");
-  display.print(DEVICE_ID);
-  display.update(); // update display (equivalent to display.display())
+#ifndef OLED_TILE_RENDER
+  oledCompositor.invalidate();    // Panel content is unknown after init
+#endif
+#endif
 
   // Print startup info to Serial  
   Serial.println("\n=========================");
-  Serial.println("Temperature Sensor v" + VERSION);
-  Serial.println("Device ID: " + DEVICE_ID);
+  Serial.println("Temperature Sensor v" + String(FIRMWARE_VERSION));
+  Serial.printf("Device ID: ESP-%x\n", ESP.getChipId());
   Serial.println("Sensor: MAX6675 (Digital)");
+#if FEATURE_MQTT
   Serial.println("Connecting to WiFi: " + String(ssid));
   Serial.println("MQTT Server: " + String(mqtt_server) + ":" + String(mqtt_port));
-  
-  // Test MAX6675 reading
-  float initialTemp = thermocouple.readCelsius();
-  Serial.print("Initial temperature reading: ");
-  Serial.print(initialTemp);
-  Serial.println("°C");
+  Serial.println("MQTT Client ID: " + String(mqttLink.getClientId()));
+#endif
+#if FEATURE_DISPLAY
+#ifdef OLED_TILE_RENDER
+  Serial.printf("Display: tile render, %u bytes RAM\n", displayRam());
+#else
+  Serial.printf("Display: buffered render, %u bytes RAM\n", displayRam());
+#endif
+#endif
+  printBuild();
   Serial.println("=========================");
-  
+
+  bootSequence.begin(millis());  // Splash starts on the first loop()
+  if (!featureDisplay) bootSequence.finish(millis());  // No boot screens to show
+}
+
+#if FEATURE_MQTT
+// Start WiFi association, NTP and the MQTT client; the connections come up in loop()
+void networkBegin() {
+  networkManager.begin();
+  networkManager.startConnection();
+
   // Configure time (it will sync once WiFi is available)
   configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
-  
+
   // MQTT setup (connection will happen in loop)
   mqttClient.setServer(mqtt_server, mqtt_port);
   mqttClient.setCallback(mqttCallback);
-
-  delay(1500);
-  display.clear();
-  display.line(0,16,128,16,OLED_WHITE);
-  display.update(); // Clear display after startup message
+  mqttLink.begin(ESP.getChipId());  // Stable client ID so the broker keeps our session
+  sampleUplink.begin(ESP.random());  // Boot ID tags batches so receivers can tell reboots apart
 }
+#else
+void networkBegin() {}
+#endif
 
+#if FEATURE_DISPLAY && FEATURE_MQTT
 // Update network status display without blocking
-// Shows connection status and activity indicators through small dots on display
+// Sets the link indicators on the status widget; blinking is done by toggling them
 void updateNetworkDisplay() {
   // MQTT upload activity indicator in top-right corner (data sent to broker)
-  if (millis() - lastMqttUpload < mqttActivityIndicatorDuration) {display.dot(127, 0, OLED_WHITE); display.update(127, 0, 127, 0);} 
-  else {display.dot(127, 0, OLED_BLACK);  display.update(127, 0, 127, 0);} 
+  linkStatusWidget.setUpload(millis() - lastMqttUpload < mqttActivityIndicatorDuration);
 
   // Return if it's not time for the next status update
   if (millis() - lastDisplayUpdate < displayUpdateInterval) {
@@ -212,36 +340,23 @@ void updateNetworkDisplay() {
 
   ConnectionState state = networkManager.getState();
   bool mqttConnected = mqttClient.connected();
-  
-  // Make sure we're not overlapping with other display operations
-  display.textMode(BUF_REPLACE);  // Ensure text writes in replace mode (not overlaid)
 
-  // Draw the status indicators one by one
-  // MQTT status indicator
-  if (mqttConnected) {
-    display.dot(127, 4, OLED_WHITE);  // MQTT dot
-  } else if (state == CONN_CONNECTED) {
-    // MQTT disconnected but WiFi connected - blink
-    if (!updateDisplayStatus) display.dot(127, 4, OLED_BLACK); 
-    else display.dot(127, 4, OLED_WHITE); 
-  } else if ((state == CONN_DISCONNECTED) || (state == CONN_CONNECTION_FAILED)) display.dot(127, 4, OLED_BLACK);
-
-  // WiFi status indicator
-  if (state == CONN_CONNECTED) {
-    display.dot(127, 8, OLED_WHITE);  // WiFi dot
-  } else if (state == CONN_CONNECTING) {
-    // Blinking WiFi indicator 
-    if (!updateDisplayStatus) display.dot(127, 8, OLED_BLACK); 
-    else display.dot(127, 8, OLED_WHITE); 
-  } else if ((state == CONN_DISCONNECTED) || (state == CONN_CONNECTION_FAILED)) display.dot(127, 8, OLED_BLACK);
-
-  // Use partial update to only refresh the status indicator area
-  display.update(127, 4, 127, 8);  // Update only the status indicator region
-  
+  // MQTT status indicator: on when connected, blinking while WiFi is up but MQTT is not
+  if (mqttConnected) linkStatusWidget.setMqtt(true);
+  else if (state == CONN_CONNECTED) linkStatusWidget.setMqtt(updateDisplayStatus);
+  else if ((state == CONN_DISCONNECTED) || (state == CONN_CONNECTION_FAILED)) linkStatusWidget.setMqtt(false);
+
+  // WiFi status indicator: on when connected, blinking while connecting
+  if (state == CONN_CONNECTED) linkStatusWidget.setWifi(true);
+  else if (state == CONN_CONNECTING) linkStatusWidget.setWifi(updateDisplayStatus);
+  else if ((state == CONN_DISCONNECTED) || (state == CONN_CONNECTION_FAILED)) linkStatusWidget.setWifi(false);
 }
+#else
+void updateNetworkDisplay() {}
+#endif
 
+#if FEATURE_MQTT
 // Non-blocking MQTT reconnect helper
-#define CLIENT_ID_LEN 24
 bool mqttReconnect(int maxAttempts) {
   if (!networkManager.isConnected()) {
     return false;  // Can't connect to MQTT without WiFi
@@ -261,12 +376,8 @@ bool mqttReconnect(int maxAttempts) {
         Serial.print("Debug: MQTT attempt ");
         Serial.println(attempts + 1);
         
-        char clientId[CLIENT_ID_LEN];
-        snprintf(clientId, CLIENT_ID_LEN, "NodeMCU-%lu", millis());
-        if (mqttClient.connect(clientId, mqtt_user, mqtt_pass)) {
-          mqttClient.subscribe("sensor/interval");
-          mqttClient.subscribe("sensor/setpoint");
-          mqttClient.subscribe("sensor/buzzer");  // Add buzzer control topic
+        if (mqttLink.connect()) {
+          sampleUplink.reconnected();  // Resend whatever was in flight when the link dropped
           attempts = 0;  // Reset counter on success
           return true;
         } else {
@@ -290,17 +401,52 @@ bool mqttReconnect(int maxAttempts) {
   
   return false;
 }
+#endif
 
 // Main program loop - handles network, display, serial commands, and sensor readings
 // Uses non-blocking approach to ensure responsive operation
 void loop() {
+  unsigned long loopStart = micros();
+
   // Core functionality handling
-  networkManager.update();    // Update network state (non-blocking)
+  networkService();           // Keep WiFi and MQTT up (non-blocking)
   updateNetworkDisplay();     // Update network status on display (non-blocking)
   serialHandler();            // Handle incoming serial data (non-blocking)
   batteryMonitor();           // Monitor battery voltage (non-blocking)
+
+  // Fresh conversion every sample period; alarms are evaluated on each one
+  unsigned long now = millis();
+  if (now - lastSampleTime >= samplePeriod) {
+    lastSampleTime = now;
+    acquireSample();
+  }
+
+  // Periodic send of the latest reading
+  if (now - lastSendTime >= sendInterval) {
+    lastSendTime = now;
+    double tempC = tempValue;
+    queueSample(now, tempC);
+    serialOutput(tempC);
+    publishSamples();  // Publish temperature and update upload indicator
+  }
+
+  if (bootSequence.done()) displayUpdate();  // Update display 
+  else bootUpdate();          // Boot screens until the measurement screen takes over
+  displayService();           // Send a time-boxed slice of what changed
+
+  unsigned long loopTime = micros() - loopStart;
+  loopMicrosTotal += loopTime;
+  if (loopTime > loopMicrosMax) loopMicrosMax = loopTime;
+  loopCount++;
+}
+
+#if FEATURE_MQTT
+// Keep WiFi and MQTT up and the delivery window full; reports link changes
+void networkService() {
+  networkManager.update();    // Update network state (non-blocking)
   // Check if WiFi just connected and print status
   if (networkManager.justConnected()) {
+    bootMilestone(BOOT_WIFI);
     Serial.println("\n=========================");
     Serial.print("WiFi CONNECTED to: ");
     Serial.println(ssid);
@@ -317,13 +463,23 @@ void loop() {
         bool justConnected = mqttReconnect(1);  // Quick single attempt
         
         // Check if MQTT just connected and print status
-        if (justConnected && !mqttWasConnected) {          Serial.println("\n=========================");
+        if (justConnected && !mqttWasConnected) {
+          bootMilestone(BOOT_MQTT);
+          Serial.println("\n=========================");
           Serial.print("MQTT CONNECTED to broker: ");
           Serial.print(mqtt_server);
           Serial.print(":");
           Serial.println(mqtt_port);
-          Serial.println("Subscribed to sensor/interval, sensor/setpoint, and sensor/buzzer");
-          Serial.println("Publishing to sensor/temperature");
+          Serial.printf("Client ID: %s (%s session)\n", mqttLink.getClientId(),
+                        mqttLink.getCleanSession() ? "clean" : "persistent");
+          Serial.printf("Connected in %lums (max %lums, connect #%u)\n", mqttLink.getLastConnectTime(),
+                        mqttLink.getMaxConnectTime(), mqttLink.getConnectCount());
+          Serial.printf("Subscribed to %s", mqttLink.topics().commandFilter(SCOPE_DEVICE));
+          if (mqttLink.topics().hasScope(SCOPE_GROUP)) {
+            Serial.printf(", %s", mqttLink.topics().commandFilter(SCOPE_GROUP));
+          }
+          Serial.printf(" and %s\n", mqttLink.topics().commandFilter(SCOPE_BROADCAST));
+          Serial.printf("Publishing to %s\n", mqttLink.topics().telemetry(TOPIC_TEMPERATURE));
           Serial.println("MQTT activity indicators: TX (↑), RX (↓) in display corners");
           Serial.println("=========================");
         }
@@ -332,6 +488,7 @@ void loop() {
       }
     } else {
       mqttClient.loop();
+      deliverSamples();  // Keep the delivery window full (non-blocking when idle)
       
       // If MQTT just became connected
       if (!mqttWasConnected) {
@@ -348,59 +505,147 @@ void loop() {
     Serial.println("=========================");
     mqttWasConnected = false;  // Reset when WiFi disconnects
   }
+}
+#else
+void networkService() {}
+#endif
 
-  // Store latest temperature reading
-  static double tempC = 0.0;
-  
-  // Periodic temperature read & send
-  unsigned long now = millis();
-  if (now - lastSendTime >= sendInterval) {
-    lastSendTime = now;
-      
-    // Read MAX6675 temperature
-    tempC = thermocouple.readCelsius();  // Direct reading in Celsius
-    tempValue = tempC;
-    // Get current time (for timestamping in log mode)
-    time_t now;
-    struct tm timeinfo;
-    time(&now);
-    localtime_r(&now, &timeinfo);
-
-    // Format and send output based on mode    
-    if (outputMode.equals("log")) {
-      softSerial.printf("%02d,%02d,%04d,%02d,%02d,%02d,%.2f\n",
-                        timeinfo.tm_mday,
-                        timeinfo.tm_mon + 1,
-                        timeinfo.tm_year + 1900,
-                        timeinfo.tm_hour,
-                        timeinfo.tm_min,
-                        timeinfo.tm_sec,
-                        tempC);
-    } else if(outputMode.equals("normal")) {
-      softSerial.printf("%.2f\n", tempC);
-    }    
-    
-    if (networkManager.isConnected() && mqttClient.connected()) {
-      char buf[16];
-      dtostrf(tempC, 0, 1, buf);
-      
-      // Publish temperature and update upload indicator      
-      if (mqttClient.publish("sensor/temperature", buf)) {
-        lastMqttUpload = millis(); // Mark upload activity time
-      }    
+#if FEATURE_EXT_SERIAL
+// Send a reading to the external device in the current output mode
+void serialOutput(double tempC) {
+  // Get current time (for timestamping in log mode)
+  time_t now;
+  struct tm timeinfo;
+  time(&now);
+  localtime_r(&now, &timeinfo);
+
+  // Format and send output based on mode    
+  if (outputMode.equals("log")) {
+    softSerial.printf("%02d,%02d,%04d,%02d,%02d,%02d,%.2f\n",
+                      timeinfo.tm_mday,
+                      timeinfo.tm_mon + 1,
+                      timeinfo.tm_year + 1900,
+                      timeinfo.tm_hour,
+                      timeinfo.tm_min,
+                      timeinfo.tm_sec,
+                      tempC);
+  } else if(outputMode.equals("normal")) {
+    softSerial.printf("%.2f\n", tempC);
+  }    
+}
+#else
+void serialOutput(double) {}
+#endif
+
+#if FEATURE_MQTT
+// Buffer a reading for MQTT delivery; it stays in the ring until delivered
+void queueSample(unsigned long now, double tempC) {
+  sampleRing.push(now, sampleFromCelsius(tempC));
+}
+
+// Publish the latest sample as text on the temperature topic, see SampleUplink.h
+void publishSamples() {
+  if (!networkManager.isConnected()) return;  // Keep buffering until the broker is reachable
+
+  if (sampleUplink.publishLatest()) {
+    lastMqttUpload = millis(); // Mark upload activity time
+    bootMilestone(BOOT_FIRST_PUBLISH);
+  }
+}
+
+// Stream buffered samples as batches while the delivery window has room
+void deliverSamples() {
+  if (sampleUplink.deliver() > 0) {
+    lastMqttUpload = millis();
+    bootMilestone(BOOT_FIRST_PUBLISH);
+  }
+}
+#else
+void queueSample(unsigned long, double) {}
+void publishSamples() {}
+#endif
+
+// Print runtime statistics to the debug serial
+void printStats() {
+  Serial.println("\n=========================");
+  printBuild();
+  Serial.printf("Loop: %lu loops, period %luus avg, %luus max\n", loopCount,
+                loopCount ? loopMicrosTotal / loopCount : 0, loopMicrosMax);
+  loopCount = 0;  // Fresh figures for the next report
+  loopMicrosTotal = 0;
+  loopMicrosMax = 0;
+#if FEATURE_MQTT
+  Serial.printf("MQTT: connect %lums (max %lums), connects %u\n", mqttLink.getLastConnectTime(),
+                mqttLink.getMaxConnectTime(), mqttLink.getConnectCount());
+  Serial.printf("Ring: %u/%u pending, %u dropped\n", sampleRing.size(), sampleRing.capacity(), sampleRing.dropped());
+  Serial.printf("Delivery: window %u, in flight %u, batches %u, acks %u (%u rejected), retransmits %u\n",
+                deliveryWindow.getSize(), deliveryWindow.inFlight(), deliveryWindow.batchesSent(),
+                deliveryWindow.acksReceived(), sampleUplink.rejectedAcks(), deliveryWindow.retransmits());
+  Serial.printf("Ack RTT: last %ums, max %ums\n", deliveryWindow.lastAckRtt(), deliveryWindow.maxAckRtt());
+#endif
+  if (triggerOutput.getMode() == TRIGGER_PULSE) {
+    Serial.printf("Trigger: pulse %ums, read-to-edge %luus (max %luus)\n",
+                  triggerOutput.getPulseWidth(), triggerLatency, maxTriggerLatency);
+  } else {
+    Serial.printf("Trigger: %s, read-to-edge %luus (max %luus)\n",
+                  triggerOutput.getMode() == TRIGGER_OFF ? "off" : "level", triggerLatency, maxTriggerLatency);
+  }
+#if FEATURE_DISPLAY
+#ifdef OLED_TILE_RENDER
+  Serial.printf("OLED: tile render, %u bytes RAM; last frame %u bytes in %u windows, latency %luus (max %luus)\n",
+                displayRam(), oledRenderer.getLastFrameBytes(), oledRenderer.getLastFrameWindows(),
+                oledRenderer.getLastFrameLatency(), oledRenderer.getMaxFrameLatency());
+  Serial.printf("OLED: widget compose %luus (max %luus); %lu bytes over %lu frames\n",
+                oledRenderer.getLastComposeMicros(), oledRenderer.getMaxComposeMicros(),
+                (unsigned long)oledRenderer.getTotalBytes(), (unsigned long)oledRenderer.getFrames());
+  Serial.printf("OLED: I2C budget %luus per loop, max used %luus, %lu loops over budget\n", oledRenderer.getBudget(),
+                oledRenderer.getMaxServiceMicros(), (unsigned long)oledRenderer.getOverruns());
+#else
+  Serial.printf("OLED: buffered render, %u bytes RAM; last frame %u bytes in %u windows, latency %luus (max %luus)\n",
+                displayRam(), oledCompositor.getLastFrameBytes(), oledCompositor.getLastFrameWindows(),
+                oledCompositor.getLastFrameLatency(), oledCompositor.getMaxFrameLatency());
+  Serial.printf("OLED: %lu bytes over %lu frames\n",
+                (unsigned long)oledCompositor.getTotalBytes(), (unsigned long)oledCompositor.getFrames());
+  Serial.printf("OLED: I2C budget %luus per loop, max used %luus, %lu loops over budget\n", oledCompositor.getBudget(),
+                oledCompositor.getMaxServiceMicros(), (unsigned long)oledCompositor.getOverruns());
+#endif
+#endif
+  Serial.print("Boot:");
+  for (uint8_t i = 0; i < BOOT_MILESTONE_COUNT; i++) {
+    BootMilestone milestone = (BootMilestone)i;
+    if (bootSequence.milestone(milestone)) {
+      Serial.printf(" %s %lums", BootSequence::milestoneName(milestone), bootSequence.milestone(milestone));
+    } else {
+      Serial.printf(" %s -", BootSequence::milestoneName(milestone));
     }
-      // Control buzzer and interrupt pin based on temperature    
-    playBuzzerAlarm(tempC, thresholdTemp);
   }
+  Serial.println();
+  // read-to-buzzer leaves out the wait for the read; the crossing came after the previous read
+  Serial.printf("Alarm: level %u, rate-of-rise %s (%.2f°C/s), read-to-buzzer %luus (max %luus), "
+                "previous read %lums before that (max %lums)\n",
+                alarmEngine.level(), alarmEngine.rateOfRise() ? "on" : "off", alarmEngine.slope() * 0.25,
+                alarmLatency, maxAlarmLatency, alarmReadGap / 1000, maxAlarmReadGap / 1000);
+  Serial.println("=========================");
+}
 
-  displayUpdate();            // Update display 
+// Print the subsystems compiled into this image, its flash size and the free heap
+void printBuild() {
+  Serial.printf("Build: display %s, ext serial %s, mqtt %s, battery %s\n",
+                featureDisplay ? "on" : "off", featureExtSerial ? "on" : "off",
+                featureMqtt ? "on" : "off", featureBattery ? "on" : "off");
+  Serial.printf("Sketch: %u bytes flash, free heap %u bytes\n", ESP.getSketchSize(), ESP.getFreeHeap());
 }
 
 // Handle incoming serial commands from both software and hardware serial
 void serialHandler() {
+#if FEATURE_EXT_SERIAL
   if (softSerial.available() || Serial.available()) {
     // Read from Software Serial if available, else from Hardware Serial
     String cmd = (softSerial.available()) ? softSerial.readStringUntil('\n') : Serial.readStringUntil('\n');
+#else
+  if (Serial.available()) {
+    String cmd = Serial.readStringUntil('\n');
+#endif
     cmd.trim(); 
     Serial.print("Command:");
     Serial.println(cmd);   
@@ -416,10 +661,26 @@ void serialHandler() {
     else if (cmd.startsWith("interval")) {
       unsigned long v = cmd.substring(9).toInt();
       if (v > 0) {
+        if (v < samplePeriod) {
+          Serial.printf("Debug: Interval %lums clamped to %lums\n", v, samplePeriod);
+          v = samplePeriod;  // Shorter intervals would resend the same reading
+        }
         sendInterval = v;
         Serial.printf("Debug: Interval set to %lums\n", sendInterval);
       }    
     } 
+#if FEATURE_DISPLAY
+    else if (cmd.startsWith("oledbudget")) {
+      unsigned long v = cmd.substring(11).toInt();
+      if (v > 0) {
+#ifdef OLED_TILE_RENDER
+        oledRenderer.setBudget(v);
+#else
+        oledCompositor.setBudget(v);
+#endif
+        Serial.printf("Debug: oled I2C budget set to %luus per loop\n", v);
+      }
+    }
     else if (cmd.startsWith("oled")) {
       unsigned long v = cmd.substring(5).toInt();
       if (v > 0) {
@@ -427,76 +688,186 @@ void serialHandler() {
         Serial.printf("Debug: oled update interval set to %lums\n", mainDisplayUpdateInterval);
       }
     } 
+#endif
     else if (cmd.startsWith("setpoint")) {
       double v = cmd.substring(9).toFloat();
-      thresholdTemp = v;
-      Serial.printf("Debug: Setpoint set to %.1f°C\n", thresholdTemp);    
+      if (sampleCelsiusInRange(v)) {
+        thresholdTemp = v;
+        alarmEngine.setThreshold(1, sampleFromCelsius(thresholdTemp));
+        Serial.printf("Debug: Setpoint set to %.1f°C\n", thresholdTemp);
+      } else {
+        Serial.printf("Debug: Setpoint %.2f°C rejected (0 to %.2f°C)\n", v, SAMPLE_CELSIUS_MAX);
+      }
     } 
     else if (cmd.startsWith("buzzer")) {
       unsigned int v = cmd.substring(7).toInt();
       Serial.println("Debug: Buzzer command received: " + String(v));
       buzzerEnabled = (v==1?true:false);
       if (buzzerEnabled) Serial.println("Debug: Buzzer enabled");
-      else 
-      {
-        noTone(buzzerPin);  // Ensure buzzer is silent
-        Serial.println("Debug: Buzzer disabled");
-      }
+      else Serial.println("Debug: Buzzer disabled");
+      updateBuzzer();  // Apply immediately instead of waiting for the next sample
     } 
     else if (cmd.startsWith("silence")) {      
       unsigned long duration = cmd.substring(8).toInt();
       buzzerSilenceUntil = millis() + duration * 1000UL; // Convert seconds to seconds 
       Serial.printf("Debug: Buzzer silenced for %luS\n", duration);
+      updateBuzzer();
     } 
+    else if (cmd.startsWith("alarm")) {
+      // alarm <level 2-3> <temp|off>; level 1 is the setpoint
+      int level = cmd.substring(6, 7).toInt();
+      String arg = cmd.substring(8);
+      if (level >= 2 && level <= ALARM_LEVELS) {
+        if (arg.equals("off")) {
+          alarmEngine.setThreshold(level, ALARM_LEVEL_OFF);
+          Serial.printf("Debug: Alarm level %d set to off\n", level);
+        } else if (sampleCelsiusInRange(arg.toFloat())) {
+          alarmEngine.setThreshold(level, sampleFromCelsius(arg.toFloat()));
+          Serial.printf("Debug: Alarm level %d set to %s\n", level, arg.c_str());
+        } else {
+          Serial.printf("Debug: Alarm level %d threshold '%s' rejected (0 to %.2f°C or off)\n", level, arg.c_str(),
+                        SAMPLE_CELSIUS_MAX);
+        }
+      }
+    }
+    else if (cmd.startsWith("trigger")) {
+      // trigger off | trigger level | trigger pulse <ms>
+      String arg = cmd.substring(8);
+      if (arg.equals("off")) triggerOutput.setMode(TRIGGER_OFF);
+      else if (arg.equals("level")) triggerOutput.setMode(TRIGGER_LEVEL);
+      else if (arg.startsWith("pulse")) {
+        long width = arg.substring(6).toInt();
+        if (width <= 0) width = 100;
+        if (width > TRIGGER_PULSE_MAX) {
+          Serial.printf("Debug: Pulse width %ldms clamped to %dms\n", width, TRIGGER_PULSE_MAX);
+          width = TRIGGER_PULSE_MAX;
+        }
+        triggerOutput.setMode(TRIGGER_PULSE, width);
+        arg = "pulse " + String(triggerOutput.getPulseWidth()) + "ms";
+      }
+      Serial.printf("Debug: Trigger output %s\n", arg.c_str());
+    }
+    else if (cmd.startsWith("hysteresis")) {
+      double v = cmd.substring(11).toFloat();
+      if (sampleCelsiusInRange(v)) {
+        alarmEngine.setHysteresis(sampleFromCelsius(v));
+        Serial.printf("Debug: Alarm hysteresis set to %.2f°C\n", v);
+      } else {
+        Serial.printf("Debug: Hysteresis %.2f°C rejected (0 to %.2f°C)\n", v, SAMPLE_CELSIUS_MAX);
+      }
+    }
+    else if (cmd.startsWith("ror")) {
+      double v = cmd.substring(4).toFloat();
+      if (sampleCelsiusInRange(v)) {
+        alarmEngine.setRateOfRiseLimit(sampleFromCelsius(v));
+        Serial.printf("Debug: Rate-of-rise limit set to %.2f°C/s (0 = off)\n", v);
+      } else {
+        Serial.printf("Debug: Rate-of-rise limit %.2f°C/s rejected (0 to %.2f°C/s)\n", v, SAMPLE_CELSIUS_MAX);
+      }
+    }
+#if FEATURE_MQTT
+    else if (cmd.startsWith("cleansession")) {
+      unsigned int v = cmd.substring(13).toInt();
+      mqttLink.setCleanSession(v == 1);
+      Serial.printf("Debug: MQTT clean session %s (applies on next connect)\n", (v == 1 ? "on" : "off"));
+    }
+    else if (cmd.startsWith("group")) {
+      String group = cmd.substring(6);
+      group.trim();
+      if (mqttLink.setGroup(group.c_str())) {
+        Serial.printf("Debug: Command group set to '%s'\n", mqttLink.topics().getGroup());
+      } else {
+        Serial.printf("Debug: Invalid group '%s' (max %d chars, no '/', '+' or '#')\n", group.c_str(), MQTT_ID_LEN - 1);
+      }
+    }
+    else if (cmd.startsWith("window")) {
+      unsigned int v = cmd.substring(7).toInt();
+      deliveryWindow.setSize(v > DELIVERY_WINDOW_MAX ? DELIVERY_WINDOW_MAX : v);
+      deliveryWindow.rewind();
+      Serial.printf("Debug: Delivery window set to %u batches\n", deliveryWindow.getSize());
+    }
+#endif
+    else if (cmd == "stats") {
+      printStats();
+    }
     else if (cmd == "reset") {
       Serial.println("Debug: Reset requested (display functionality removed)");
     }
-    otherUpdate = true;
+    updateSettingsDisplay();
   }
 }
 
-// Update OLED display with current temperature and status information
+#if FEATURE_DISPLAY
+// Update the temperature and its trend on the display once per display interval
 void displayUpdate() {
   if((millis() - mainLastDisplayUpdateInterval) > mainDisplayUpdateInterval) {
     mainLastDisplayUpdateInterval = millis();
-    
-    // First update the top part (temperature)
-    display.textMode(BUF_REPLACE);
-    display.clear(0, 0, 126, 15);
-    display.setScale(2);
-    display.setCursor(0, 0);
-    display.printf("%.2fC", tempValue);
-    display.update(0, 0, 126, 15);
-    
-    // Then update the bottom part if needed
-    if(otherUpdate) {
-      otherUpdate = false;
+    temperatureWidget.setTemperature(tempValue);
+    trendWidget.push(sampleFromCelsius(tempValue));  // Scrolls the sparkline by one column
+  }
+}
 
-      display.rect(0, 17, 126, 31, OLED_BLACK);
-      display.setScale(1);
-      display.setCursor(0, 3);
-      display.printf("SET:%0.2fC", thresholdTemp);
-      display.setCursor(72, 3);
-      display.printf("|%s |%s", (outputMode.equals("log")?"LOG":"NRM"), (buzzerEnabled?"ON":"OFF"));
-      display.update(0, 17, 126, 31);
-    }
+// Show the current setpoint, output mode and buzzer state; unchanged values are not redrawn
+void updateSettingsDisplay() {
+  setpointWidget.setSetpoint(thresholdTemp);
+  modeWidget.setLogMode(outputMode.equals("log"));
+  buzzerWidget.setEnabled(buzzerEnabled);
+}
+#else
+void displayUpdate() {}
+void updateSettingsDisplay() {}
+#endif
+
+// Read a fresh MAX6675 conversion and evaluate the alarms on it
+// Runs every sample period independent of the send interval, so the time from a
+// threshold crossing to the buzzer edge is bounded by one conversion period.
+void acquireSample() {
+  tempValue = thermocouple.readCelsius();  // Direct reading in Celsius
+  unsigned long now = micros();
+  sampleReadGap = sampleReadMicros != 0 ? now - sampleReadMicros : 0;
+  sampleReadMicros = now;
+  if (!isnan(tempValue) && !bootSequence.milestone(BOOT_FIRST_SAMPLE)) {
+    bootMilestone(BOOT_FIRST_SAMPLE);
+    lastSendTime = millis() - sendInterval;  // Queue and publish it this loop instead of waiting out the interval
+  }
+  alarmEngine.update(millis(), sampleFromCelsius(tempValue));
+
+  // Hardware trigger first: it is the latency-critical output
+  if (triggerOutput.update(alarmEngine.tripped(1))) {  // Setpoint only; levels 2-3 only change the buzzer
+    triggerLatency = micros() - sampleReadMicros;
+    if (triggerLatency > maxTriggerLatency) maxTriggerLatency = triggerLatency;
+  }
+
+  if (updateBuzzer()) {
+    alarmLatency = micros() - sampleReadMicros;
+    if (alarmLatency > maxAlarmLatency) maxAlarmLatency = alarmLatency;
+    alarmReadGap = sampleReadGap;
+    if (alarmReadGap > maxAlarmReadGap) maxAlarmReadGap = alarmReadGap;
   }
 }
 
-// Controls buzzer based on temperature threshold
-// Generates variable pitch based on how much temperature exceeds threshold
-void playBuzzerAlarm(double temperature, double threshold) {
-  if (buzzerEnabled && temperature > threshold) {
-    // Map temp to frequency range (1000-2000Hz): higher temp = higher pitch
-    int freq = map(temperature, threshold + 5, 100, 1000, 2000);
-    tone(buzzerPin, freq);
-  } else {
-    noTone(buzzerPin);
+// Drive the buzzer from the alarm state; returns true if the buzzer changed
+// tone() is only called on transitions so a running waveform is never restarted.
+// Pitch rises with the alarm level; rate-of-rise has its own, highest tone.
+bool updateBuzzer() {
+  int frequency = 0;
+  bool silenced = (long)(buzzerSilenceUntil - millis()) > 0;
+  if (buzzerEnabled && !silenced) {
+    if (alarmEngine.rateOfRise()) frequency = rateOfRiseTone;
+    else if (alarmEngine.level() > 0) frequency = alarmTones[alarmEngine.level() - 1];
   }
+
+  if (frequency == buzzerFrequency) return false;
+  if (frequency > 0) tone(buzzerPin, frequency);
+  else noTone(buzzerPin);
+  buzzerFrequency = frequency;
+  return true;
 }
 
+#if FEATURE_MQTT
 // MQTT message callback - processes incoming commands from broker
-// Handles settings updates (interval, setpoint) and buzzer control commands
+// Handles settings updates (interval, setpoint, group, window) and buzzer control commands
+// Commands arrive on sensor/<id>/set/<cmd>, sensor/group/<group>/set/<cmd> or sensor/all/set/<cmd>
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
   // Mark activity time for download indicator on display
   lastMqttDownload = millis();
@@ -514,39 +885,84 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
     message += c;
   }
   Serial.println();
-    // Handle specific topics
-  if (String(topic).equals("sensor/interval")) {
+
+  // Resolve the command name from our device, group or broadcast namespace
+  CommandScope scope;
+  const char* commandName = mqttLink.topics().matchCommand(topic, &scope);
+  if (commandName == NULL) {
+    return;  // Not addressed to this device
+  }
+  String command(commandName);
+
+  // Delivery acks carry the boot ID and the next sequence number the receiver expects
+  if (command.equals("ack")) {
+    if (scope == SCOPE_DEVICE) {
+      sampleUplink.ack(message.c_str());
+    }
+    return;  // Not a settings change, skip the display refresh
+  }
+
+  // Handle specific commands
+  if (command.equals("interval")) {
     unsigned long interval = message.toInt();
     if (interval > 0) {
+      if (interval < samplePeriod) {
+        Serial.printf("Send interval %lu ms clamped to %lu ms\n", interval, samplePeriod);
+        interval = samplePeriod;  // No new reading to send more often than that
+      }
       sendInterval = interval;
       Serial.printf("Send interval updated to %lu ms\n", sendInterval);
     }
   }
-  else if (String(topic).equals("sensor/setpoint")) {
+  else if (command.equals("setpoint")) {
     double setpoint = message.toFloat();
-    thresholdTemp = setpoint;
-    Serial.printf("Temperature setpoint updated to %.1f°C\n", thresholdTemp);
-    } else if (String(topic).equals("sensor/buzzer")){
+    if (sampleCelsiusInRange(setpoint)) {
+      thresholdTemp = setpoint;
+      alarmEngine.setThreshold(1, sampleFromCelsius(thresholdTemp));
+      Serial.printf("Temperature setpoint updated to %.1f°C\n", thresholdTemp);
+    } else {
+      Serial.printf("Setpoint %.2f°C ignored (0 to %.2f°C)\n", setpoint, SAMPLE_CELSIUS_MAX);
+    }
+  }
+  else if (command.equals("group")) {
+    // Publish retained to make membership survive reboots
+    if (mqttLink.setGroup(message.c_str())) {
+      Serial.printf("Command group set to '%s'\n", mqttLink.topics().getGroup());
+    } else {
+      Serial.printf("Invalid group '%s' ignored (max %d chars, no '/', '+' or '#')\n", message.c_str(), MQTT_ID_LEN - 1);
+    }
+  }
+  else if (command.equals("window")) {
+    // Acked batch delivery is opt-in; publish retained so it holds across reboots
+    long v = message.toInt();
+    deliveryWindow.setSize(v < 0 ? 0 : (v > DELIVERY_WINDOW_MAX ? DELIVERY_WINDOW_MAX : v));
+    deliveryWindow.rewind();
+    Serial.printf("Delivery window set to %u batches\n", deliveryWindow.getSize());
+  }
+  else if (command.equals("buzzer")) {
     // Buzzer control message - format: "on", "off", "silence <seconds>"
     if (message.equals("on")) {
       buzzerEnabled = true;
+      updateBuzzer();
       Serial.println("Buzzer enabled");
     } else if (message.equals("off")) {
       buzzerEnabled = false;
-      noTone(buzzerPin);
+      updateBuzzer();
       Serial.println("Buzzer disabled");
     } else if (message.startsWith("silence")) {
       int seconds = message.substring(8).toInt();
       if (seconds > 0) {
         buzzerSilenceUntil = millis() + seconds * 1000UL;
         Serial.printf("Buzzer silenced for %d seconds\n", seconds);
-        noTone(buzzerPin);  // Immediately silence
+        updateBuzzer();  // Immediately silence
       }
     }
   }
-  otherUpdate = true;
+  updateSettingsDisplay();
 }
+#endif
 
+#if FEATURE_BATTERY
 // Battery monitoring function for Wemos D1 Mini with battery shield
 void batteryMonitor() {
   // The Wemos D1 Mini battery shield connects the battery to the A0 pin through a voltage divider
@@ -593,6 +1009,7 @@ void batteryMonitor() {
   batteryVoltage = voltage;  // Store battery voltage for display
   batteryPercentage = percentage;  // Store battery percentage for display
   
+#if FEATURE_MQTT
   // Report battery data via MQTT if connected
   if (networkManager.isConnected() && mqttClient.connected()) {
     char battVoltage[8];
@@ -600,108 +1017,140 @@ void batteryMonitor() {
     dtostrf(voltage, 1, 2, battVoltage);
     dtostrf(percentage, 1, 0, battPercent);
     
-    mqttClient.publish("sensor/battery/voltage", battVoltage);
-    mqttClient.publish("sensor/battery/percentage", battPercent);
+    mqttClient.publish(mqttLink.topics().telemetry(TOPIC_BATTERY_VOLTAGE), battVoltage);
+    mqttClient.publish(mqttLink.topics().telemetry(TOPIC_BATTERY_PERCENTAGE), battPercent);
   }
+#endif
 
+#if FEATURE_DISPLAY
+  batteryWidget.setPercentage(batteryPercentage);
+#endif
+}
+#else
+void batteryMonitor() {}
+#endif
 
-  switch (batteryPercentage) {
-  case 10 ... 25:
-    // Low battery warning
-    display.dot(127, 19, OLED_BLACK);
-    display.dot(127, 23, OLED_BLACK);
-    display.dot(127, 27, OLED_BLACK);
-    display.dot(127, 31, OLED_WHITE);
-    display.update(127, 19, 127, 31); // Update only the battery indicator area
-    break;
-
-  case 26 ... 50:
-    // Medium battery warning
-    display.dot(127, 19, OLED_BLACK);
-    display.dot(127, 23, OLED_BLACK);
-    display.dot(127, 27, OLED_WHITE);
-    display.dot(127, 31, OLED_WHITE);
-    display.update(127, 19, 127, 31); // Update only the battery indicator area
-    break;
-
-  case 51 ... 75:
-    // High battery warning
-    display.dot(127, 19, OLED_BLACK);
-    display.dot(127, 23, OLED_WHITE);
-    display.dot(127, 27, OLED_WHITE);
-    display.dot(127, 31, OLED_WHITE);
-    display.update(127, 19, 127, 31); // Update only the battery indicator area
-    break;  
-  
-  case 76 ... 100:
-    // Full battery warning
-    display.dot(127, 19, OLED_WHITE);
-    display.dot(127, 23, OLED_WHITE);
-    display.dot(127, 27, OLED_WHITE);
-    display.dot(127, 31, OLED_WHITE);
-    display.update(127, 19, 127, 31); // Update only the battery indicator area
-    break;
-  
-  default:
-    batteryIndicatorToggle = !batteryIndicatorToggle; // Toggle battery indicator
-    display.dot(127, 19, OLED_BLACK);
-    display.dot(127, 23, OLED_BLACK);
-    display.dot(127, 27, OLED_BLACK);
-    display.dot(127, 31, (batteryIndicatorToggle ? OLED_WHITE : OLED_BLACK));
-    display.update(127, 19, 127, 31); // Update only the battery indicator area
-    break;
-  }
+#if FEATURE_DISPLAY
+
+// Draw and send this loop's display changes within the I2C budget
+// Buffered: repaint dirty widgets into the framebuffer, then let the compositor send
+// what changed. Tile render: the renderer draws and sends the dirty pages itself.
+// Boot screens draw for themselves, so widgets are only rendered once they are over.
+void displayService() {
+#ifdef OLED_TILE_RENDER
+  if (bootSequence.done()) oledRenderer.update(mainScreen);
+#else
+  if (bootSequence.done()) mainScreen.render(oledCanvas);
+  oledCompositor.update();
+#endif
 }
 
-// Animated splash screen implementation using frames stored in splashScreen.h
-void logodisplay() {
-    // Array of logo frames
-    const unsigned char* frames[] = {
-        logoFrames00, logoFrames01, logoFrames02, logoFrames03, 
-        logoFrames04, logoFrames05, logoFrames06, logoFrames07,
-        logoFrames08, logoFrames09, logoFrames10, logoFrames11,
-        logoFrames12, logoFrames13, logoFrames14, logoFrames15,
-        logoFrames16, logoFrames17, logoFrames18, logoFrames19,
-        logoFrames20, logoFrames21, logoFrames22, logoFrames23,
-        logoFrames24, logoFrames25, logoFrames26, logoFrames27,
-        logoFrames28, logoFrames29, logoFrames30, logoFrames31,
-        logoFrames32, logoFrames33, logoFrames34, logoFrames35,
-        logoFrames36, logoFrames37, logoFrames38, logoFrames39,
-        logoFrames40, logoFrames41, logoFrames42, logoFrames43,
-        logoFrames44, logoFrames45, logoFrames46, logoFrames47,
-        logoFrames48, logoFrames49, logoFrames50, logoFrames51,
-        logoFrames52, logoFrames53, logoFrames54, logoFrames55,
-        logoFrames56, logoFrames57, logoFrames58, logoFrames59,
-        logoFrames60
-    };
-    
-    const int totalFrames = sizeof(frames) / sizeof(frames[0]);
-    const int frameDelay = 16; // Delay between frames in milliseconds
-    
-  // Play startup sound (if buzzer is enabled)
-  if (buzzerEnabled) {
-    // Play short welcome tone
-    tone(buzzerPin, 1000, 50); 
-    delay(100);
-    tone(buzzerPin, 1500, 50);
-  }
-  
-  // Display each frame of the animation
-  for(int i = 0; i < totalFrames; i++) {
-      display.clear();                    // Clear the display buffer
-      display.drawBitmap(0, 0, frames[i], 128, 32, OLED_WHITE); // Draw the current frame
-      display.update();                   // Update the display
-      delay(frameDelay);   
-    
-    // Optional: Play a beep on certain frames for audio feedback
-    if (buzzerEnabled && i == totalFrames - 1) {
-      // Hold the final frame briefly before continuing
-      delay(1000);
-      tone(buzzerPin, 2000, 50);  // Final frame beep
+// RAM held by the display driver (including any framebuffer) and its renderer
+unsigned int displayRam() {
+#ifdef OLED_TILE_RENDER
+  return sizeof(display) + sizeof(oledRenderer);
+#else
+  return sizeof(display) + sizeof(oledCompositor);
+#endif
+}
+
+// Step the boot screens; called from loop() until the measurement screen is up
+// Each splash frame is decoded once the previous one is on the panel and its frame
+// time has passed, so the animation never holds up sampling or networking.
+void bootUpdate() {
+  unsigned long now = millis();
+  unsigned long elapsed = bootSequence.elapsed(now);
+
+  switch (bootSequence.stage()) {
+    case BOOT_SPLASH: {
+      // Welcome tones, unless an alarm already owns the buzzer
+      if (buzzerEnabled && buzzerFrequency == 0 && welcomeTones < 2 && elapsed >= welcomeTones * 100UL) {
+        tone(buzzerPin, welcomeTones == 0 ? 1000 : 1500, 50);
+        welcomeTones++;
+      }
+      if (splashFrame > 0 && now - splashFrameTime < SPLASH_FRAME_DELAY) break;
+#ifdef OLED_TILE_RENDER
+      // The deltas need the previous frame, so the splash borrows a frame from the heap
+      if (splashBuffer == NULL && splashFrame < SPLASH_FRAME_COUNT) {
+        splashBuffer = (uint8_t*)calloc(OLED_FRAME_SIZE, 1);
+        if (splashBuffer == NULL) splashFrame = SPLASH_FRAME_COUNT;  // No RAM to spare: skip the animation
+      }
+      uint8_t* frame = splashBuffer;
+#else
+      if (oledCompositor.busy()) break;  // Previous frame still going out
+      uint8_t* frame = display._oled_buffer;
+#endif
+      if (splashFrame < SPLASH_FRAME_COUNT) {
+        unsigned long start = micros();
+        decodeSplashFrame(frame, splashFrame);  // Apply the frame delta in place
+        unsigned long decodeTime = micros() - start;
+        splashDecodeTotal += decodeTime;
+        if (decodeTime > splashDecodeMax) splashDecodeMax = decodeTime;
+#ifdef OLED_TILE_RENDER
+        oledRenderer.sendFrame(frame);
+#endif
+        splashFrame++;
+        splashFrameTime = now;
+        break;
+      }
+#ifdef OLED_TILE_RENDER
+      free(splashBuffer);
+      splashBuffer = NULL;
+#endif
+      Serial.printf("Debug: Splash decode %luus/frame avg, %luus max, played in %lums\n",
+                    splashDecodeTotal / SPLASH_FRAME_COUNT, splashDecodeMax, elapsed);
+      bootSequence.advance(now);
+      break;
     }
+
+    case BOOT_HOLD:
+      if (elapsed < bootHoldTime) break;
+      if (buzzerEnabled && buzzerFrequency == 0) tone(buzzerPin, 2000, 50);  // Final frame beep
+
+      // Show startup message
+      display.clear();
+      display.setScale(2);
+      display.setCursor(57, 0);
+      display.print("MEL");
+      display.setScale(1);
+      display.setCursor(0, 2);
+      display.print("Temp Sensor v");
+      display.print(FIRMWARE_VERSION);
+      display.setCursor(0, 3); // line 1 (GyverOLED uses line-based cursor position)
+      display.printf("ID: ESP-%x", ESP.getChipId());
+      bootSequence.advance(now);
+      break;
+
+    case BOOT_INFO:
+      if (elapsed < bootInfoTime) break;
+      display.clear();
+      temperatureWidget.setTemperature(tempValue);  // Show the reading now, not at the next display interval
+      updateSettingsDisplay();
+      mainScreen.invalidate();  // Paint the whole measurement screen over the boot screen
+#ifndef OLED_TILE_RENDER
+      // From now on a widget's changes reach the panel in one loop, so a reading is
+      // never shown half updated; boot screens are whole frames and keep the budget
+      for (uint8_t i = 0; i < mainScreen.count(); i++) {
+        const Widget& widget = mainScreen.widget(i);
+        oledCompositor.addRegion(widget.x0(), widget.x1(), widget.page0(), widget.page1());
+      }
+#endif
+      bootSequence.advance(now);
+      bootMilestone(BOOT_UI_READY);
+      break;
+
+    default:
+      break;
   }
-  
-  // Clear display before moving to the next screen
-  display.clear();
-  display.update();
-}
\ No newline at end of file
+}
+#else
+void displayService() {}
+void bootUpdate() {}
+#endif
+
+// Record a boot milestone and report it the first time it is reached
+void bootMilestone(BootMilestone milestone) {
+  if (bootSequence.mark(milestone, millis())) {
+    Serial.printf("Debug: Boot %s at %lums\n", BootSequence::milestoneName(milestone), bootSequence.milestone(milestone));
+  }
+}
@@ -0,0 +1,57 @@
+#ifndef SMALL_FONT_H
+#define SMALL_FONT_H
+
+#include <Arduino.h>
+
+// Small text for the status line, 5x7 pixels on a 6-pixel pitch
+// The classic 5x7 glyphs GyverOLED draws at setScale(1), limited to the characters
+// the widgets use. One byte per column in SSD1306 page format, bit 0 at the top.
+#define SMALL_FONT_WIDTH 5
+#define SMALL_FONT_PITCH 6
+#define SMALL_FONT_CHARS " -.:|0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+
+const uint8_t smallFont[][SMALL_FONT_WIDTH] PROGMEM = {
+  {0x00, 0x00, 0x00, 0x00, 0x00},  // ' '
+  {0x08, 0x08, 0x08, 0x08, 0x08},  // '-'
+  {0x00, 0x60, 0x60, 0x00, 0x00},  // '.'
+  {0x00, 0x36, 0x36, 0x00, 0x00},  // ':'
+  {0x00, 0x00, 0x7f, 0x00, 0x00},  // '|'
+  {0x3e, 0x51, 0x49, 0x45, 0x3e},  // '0'
+  {0x00, 0x42, 0x7f, 0x40, 0x00},  // '1'
+  {0x42, 0x61, 0x51, 0x49, 0x46},  // '2'
+  {0x21, 0x41, 0x45, 0x4b, 0x31},  // '3'
+  {0x18, 0x14, 0x12, 0x7f, 0x10},  // '4'
+  {0x27, 0x45, 0x45, 0x45, 0x39},  // '5'
+  {0x3c, 0x4a, 0x49, 0x49, 0x30},  // '6'
+  {0x01, 0x71, 0x09, 0x05, 0x03},  // '7'
+  {0x36, 0x49, 0x49, 0x49, 0x36},  // '8'
+  {0x06, 0x49, 0x49, 0x29, 0x1e},  // '9'
+  {0x7e, 0x11, 0x11, 0x11, 0x7e},  // 'A'
+  {0x7f, 0x49, 0x49, 0x49, 0x36},  // 'B'
+  {0x3e, 0x41, 0x41, 0x41, 0x22},  // 'C'
+  {0x7f, 0x41, 0x41, 0x22, 0x1c},  // 'D'
+  {0x7f, 0x49, 0x49, 0x49, 0x41},  // 'E'
+  {0x7f, 0x09, 0x09, 0x09, 0x01},  // 'F'
+  {0x3e, 0x41, 0x49, 0x49, 0x7a},  // 'G'
+  {0x7f, 0x08, 0x08, 0x08, 0x7f},  // 'H'
+  {0x00, 0x41, 0x7f, 0x41, 0x00},  // 'I'
+  {0x20, 0x40, 0x41, 0x3f, 0x01},  // 'J'
+  {0x7f, 0x08, 0x14, 0x22, 0x41},  // 'K'
+  {0x7f, 0x40, 0x40, 0x40, 0x40},  // 'L'
+  {0x7f, 0x02, 0x0c, 0x02, 0x7f},  // 'M'
+  {0x7f, 0x04, 0x08, 0x10, 0x7f},  // 'N'
+  {0x3e, 0x41, 0x41, 0x41, 0x3e},  // 'O'
+  {0x7f, 0x09, 0x09, 0x09, 0x06},  // 'P'
+  {0x3e, 0x41, 0x51, 0x21, 0x5e},  // 'Q'
+  {0x7f, 0x09, 0x19, 0x29, 0x46},  // 'R'
+  {0x46, 0x49, 0x49, 0x49, 0x31},  // 'S'
+  {0x01, 0x01, 0x7f, 0x01, 0x01},  // 'T'
+  {0x3f, 0x40, 0x40, 0x40, 0x3f},  // 'U'
+  {0x1f, 0x20, 0x40, 0x20, 0x1f},  // 'V'
+  {0x3f, 0x40, 0x38, 0x40, 0x3f},  // 'W'
+  {0x63, 0x14, 0x08, 0x14, 0x63},  // 'X'
+  {0x07, 0x08, 0x70, 0x08, 0x07},  // 'Y'
+  {0x61, 0x51, 0x49, 0x45, 0x43},  // 'Z'
+};
+
+#endif // SMALL_FONT_H
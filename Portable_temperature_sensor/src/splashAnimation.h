@@ -0,0 +1,301 @@
+#ifndef SPLASH_ANIMATION_H
+#define SPLASH_ANIMATION_H
+
+#include <Arduino.h>
+
+// Generated by tools/splash_encode.py from assets/splashScreen.h - do not edit
+// 61 frames, 31232 bytes raw, 4548 bytes encoded (stream + offsets)
+// Format: see tools/splash_encode.py and SplashDecoder.h
+#define SPLASH_FRAME_COUNT 61
+#define SPLASH_FRAME_DELAY 16  // ms between frames
+
+const uint16_t splashFrameOffsets[SPLASH_FRAME_COUNT + 1] PROGMEM = {
+  0, 72, 92, 95, 117, 139, 156, 179, 199, 253, 284, 324,
+  384, 416, 461, 513, 569, 645, 725, 803, 881, 979, 1091, 1202,
+  1310, 1447, 1570, 1706, 1832, 1967, 2113, 2232, 2363, 2489, 2616, 2741,
+  2855, 2976, 3089, 3196, 3304, 3403, 3505, 3589, 3665, 3730, 3825, 3907,
+  3970, 4045, 4097, 4153, 4200, 4228, 4257, 4307, 4342, 4365, 4379, 4390,
+  4401, 4424,
+};
+
+const uint8_t splashStream[] PROGMEM = {
+  0x7f, 0x4c, 0x81, 0x0f, 0xf0, 0x00, 0x8b, 0x80, 0x1f, 0xf8, 0x01, 0x80, 0x1f, 0xf8, 0x01, 0x80,
+  0x1f, 0xf8, 0x01, 0x00, 0x81, 0x0f, 0xf0, 0x14, 0x97, 0x3c, 0xc0, 0x03, 0x3c, 0x7e, 0xe0, 0x07,
+  0x7e, 0x7e, 0xe0, 0x07, 0x7e, 0x7e, 0xe0, 0x07, 0x7e, 0x7e, 0xe0, 0x07, 0x7e, 0x3c, 0xc0, 0x03,
+  0x3c, 0x14, 0x81, 0x0f, 0xf0, 0x00, 0x8b, 0x80, 0x1f, 0xf8, 0x01, 0x80, 0x1f, 0xf8, 0x01, 0x80,
+  0x1f, 0xf8, 0x01, 0x00, 0x81, 0x0f, 0xf0, 0x7f, 0x7f, 0x48, 0x81, 0x06, 0x60, 0x38, 0x87, 0x42,
+  0x20, 0x04, 0x42, 0x24, 0x40, 0x02, 0x24, 0x10, 0x81, 0x06, 0x60, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f,
+  0x48, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x4c, 0x81, 0x09, 0x90, 0x00, 0x83,
+  0x80, 0x10, 0x08, 0x01, 0x7f, 0x7f, 0x5c, 0x81, 0x09, 0x90, 0x10, 0x83, 0x18, 0x80, 0x01, 0x18,
+  0x13, 0x83, 0x18, 0x80, 0x01, 0x18, 0x24, 0x81, 0x09, 0x90, 0x7f, 0x7f, 0x57, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x4f, 0x83, 0x80, 0x10, 0x08, 0x01, 0x22, 0x80, 0x06, 0x7f, 0x7f, 0x5c, 0x81, 0x06,
+  0x60, 0x10, 0x87, 0x24, 0x40, 0x02, 0x24, 0x42, 0x20, 0x04, 0x42, 0x38, 0x81, 0x06, 0x60, 0x23,
+  0x80, 0x04, 0x7f, 0x7f, 0x44, 0x81, 0x06, 0x60, 0x38, 0x87, 0x42, 0x20, 0x04, 0x42, 0x24, 0x40,
+  0x02, 0x24, 0x10, 0x81, 0x06, 0x60, 0x7f, 0x7f, 0x44, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x0c, 0x81, 0x08, 0x80, 0x10, 0x83, 0x18, 0x80, 0x01, 0x18, 0x13, 0x83, 0x18, 0x80,
+  0x01, 0x18, 0x10, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x0c, 0x81, 0x08, 0x80,
+  0x1f, 0x80, 0x02, 0x02, 0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f, 0x7f, 0x53, 0x83,
+  0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x01, 0x10, 0x14, 0x83, 0x42, 0x20, 0x04, 0x42, 0x33, 0x83,
+  0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x01, 0x10, 0x1f, 0x80, 0x05, 0x7f, 0x7f, 0x40, 0x81, 0x06,
+  0x60, 0x15, 0x81, 0x06, 0x60, 0x10, 0x83, 0x24, 0x40, 0x02, 0x24, 0x0b, 0x87, 0x42, 0x20, 0x04,
+  0x42, 0x24, 0x40, 0x02, 0x24, 0x10, 0x81, 0x06, 0x60, 0x15, 0x81, 0x06, 0x60, 0x27, 0x80, 0x01,
+  0x02, 0x80, 0x02, 0x7f, 0x7f, 0x40, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07,
+  0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x10, 0x83, 0x18, 0x80, 0x01, 0x18, 0x13,
+  0x83, 0x18, 0x80, 0x01, 0x18, 0x10, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07,
+  0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x1f, 0x80, 0x02, 0x12, 0x80, 0x04, 0x7f,
+  0x7f, 0x54, 0x81, 0x06, 0x60, 0x10, 0x87, 0x24, 0x40, 0x02, 0x24, 0x42, 0x20, 0x04, 0x42, 0x38,
+  0x81, 0x06, 0x60, 0x1f, 0x80, 0x05, 0x0e, 0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f,
+  0x7f, 0x3c, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x09, 0x80, 0x08, 0x28, 0x87,
+  0x42, 0x20, 0x04, 0x42, 0x3c, 0xc0, 0x03, 0x3c, 0x10, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x2c, 0x81, 0x3e, 0xf8, 0x03, 0x80, 0x01, 0x16, 0x80, 0x02, 0x7f, 0x7f, 0x4b, 0x81,
+  0x80, 0x10, 0x00, 0x80, 0x01, 0x00, 0x81, 0x0f, 0xf0, 0x10, 0x87, 0x3c, 0xc0, 0x03, 0x3c, 0x42,
+  0x20, 0x04, 0x42, 0x33, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x0f, 0xf0, 0x1d, 0x82, 0xc1,
+  0x04, 0x01, 0x00, 0x82, 0x7e, 0xf8, 0x02, 0x02, 0x80, 0x01, 0x0e, 0x80, 0x01, 0x06, 0x80, 0x04,
+  0x7f, 0x7f, 0x38, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x1f, 0x83, 0x18, 0x80,
+  0x01, 0x18, 0x0f, 0x87, 0x42, 0x20, 0x04, 0x42, 0x3c, 0xc0, 0x03, 0x3c, 0x10, 0x81, 0x0f, 0xf0,
+  0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x34, 0x82, 0x01, 0x04, 0x05, 0x00, 0x81, 0x3e, 0xf8, 0x03,
+  0x80, 0x01, 0x12, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f, 0x7f, 0x34, 0x81, 0x06, 0x60, 0x10, 0x83,
+  0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x0f, 0xf0, 0x10, 0x87, 0x24, 0x40, 0x02, 0x24, 0x42, 0x20,
+  0x04, 0x42, 0x07, 0x87, 0x42, 0x20, 0x04, 0x42, 0x24, 0x40, 0x02, 0x24, 0x10, 0x81, 0x06, 0x60,
+  0x10, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x0f, 0xf0, 0x21, 0x82, 0xff, 0xfc, 0x01, 0x04,
+  0x82, 0x41, 0x04, 0x03, 0x00, 0x81, 0x3e, 0xf8, 0x0f, 0x80, 0x01, 0x02, 0x80, 0x01, 0x02, 0x80,
+  0x02, 0x02, 0x80, 0x04, 0x7f, 0x7f, 0x34, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01,
+  0x07, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x10, 0x83, 0x18, 0x80, 0x01, 0x18,
+  0x13, 0x83, 0x18, 0x80, 0x01, 0x18, 0x10, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01,
+  0x07, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x29, 0x82, 0x7f, 0xfc, 0x01, 0x00,
+  0x82, 0x80, 0x02, 0x04, 0x00, 0x82, 0x41, 0x04, 0x03, 0x00, 0x82, 0x3c, 0xf8, 0x01, 0x12, 0x80,
+  0x01, 0x02, 0x80, 0x02, 0x7f, 0x7f, 0x30, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01,
+  0x10, 0x81, 0x06, 0x60, 0x10, 0x87, 0x24, 0x40, 0x02, 0x24, 0x42, 0x20, 0x04, 0x42, 0x07, 0x87,
+  0x42, 0x20, 0x04, 0x42, 0x3c, 0xc0, 0x03, 0x3c, 0x10, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x10, 0x81, 0x06, 0x60, 0x2d, 0x82, 0xff, 0xfe, 0x01, 0x00, 0x82, 0x80, 0x02, 0x04,
+  0x00, 0x82, 0x43, 0x04, 0x03, 0x01, 0x81, 0xf8, 0x01, 0x0a, 0x80, 0x01, 0x06, 0x80, 0x01, 0x02,
+  0x80, 0x06, 0x7f, 0x7f, 0x2c, 0x81, 0x06, 0x60, 0x10, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81,
+  0x0f, 0xf0, 0x10, 0x87, 0x3c, 0xc0, 0x03, 0x3c, 0x42, 0x20, 0x04, 0x42, 0x07, 0x87, 0x42, 0x20,
+  0x04, 0x42, 0x24, 0x40, 0x02, 0x24, 0x10, 0x81, 0x06, 0x60, 0x10, 0x83, 0x80, 0x10, 0x08, 0x01,
+  0x00, 0x81, 0x0f, 0xf0, 0x35, 0x82, 0xff, 0xfe, 0x01, 0x00, 0x82, 0x80, 0x02, 0x04, 0x00, 0x82,
+  0x7f, 0x04, 0x03, 0x01, 0x81, 0xf8, 0x01, 0x06, 0x80, 0x01, 0x0a, 0x80, 0x01, 0x02, 0x80, 0x06,
+  0x7f, 0x7f, 0x2c, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x10, 0x87, 0x3c, 0xc0, 0x03, 0x3c, 0x42, 0x20, 0x04, 0x42,
+  0x0f, 0x83, 0x18, 0x80, 0x01, 0x18, 0x10, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01,
+  0x07, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x1c, 0x84, 0xc0, 0x81, 0x03, 0x07,
+  0xc0, 0x00, 0x81, 0x01, 0x06, 0x18, 0x82, 0xff, 0xfe, 0x01, 0x00, 0x82, 0x80, 0x02, 0x04, 0x00,
+  0x82, 0x7f, 0x04, 0x03, 0x00, 0x82, 0x3c, 0xf8, 0x01, 0x0a, 0x80, 0x01, 0x06, 0x80, 0x01, 0x02,
+  0x80, 0x06, 0x7f, 0x7f, 0x28, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83,
+  0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x01, 0x81, 0x06, 0x60, 0x0c, 0x83, 0x18, 0x80,
+  0x01, 0x18, 0x0f, 0x87, 0x42, 0x20, 0x04, 0x42, 0x3c, 0xc0, 0x03, 0x3c, 0x10, 0x81, 0x0f, 0xf0,
+  0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90,
+  0x01, 0x81, 0x06, 0x60, 0x18, 0x80, 0x80, 0x00, 0x81, 0x03, 0x06, 0x04, 0x83, 0x81, 0x02, 0x01,
+  0xc0, 0x00, 0x81, 0x01, 0x06, 0x18, 0x82, 0xff, 0xfe, 0x01, 0x00, 0x80, 0x80, 0x00, 0x80, 0x04,
+  0x00, 0x82, 0x43, 0x04, 0x03, 0x00, 0x82, 0x3e, 0xf8, 0x01, 0x06, 0x80, 0x01, 0x0a, 0x80, 0x01,
+  0x02, 0x80, 0x06, 0x7f, 0x24, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x09, 0x80,
+  0x08, 0x05, 0x81, 0x06, 0x60, 0x10, 0x87, 0x24, 0x40, 0x02, 0x24, 0x42, 0x20, 0x04, 0x42, 0x07,
+  0x87, 0x42, 0x20, 0x04, 0x42, 0x3c, 0xc0, 0x03, 0x3c, 0x10, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80,
+  0x10, 0x08, 0x01, 0x09, 0x80, 0x08, 0x05, 0x81, 0x06, 0x60, 0x18, 0x80, 0x80, 0x00, 0x83, 0x01,
+  0x02, 0x40, 0x81, 0x00, 0x80, 0x01, 0x08, 0x81, 0x81, 0x02, 0x00, 0x80, 0xc0, 0x00, 0x81, 0x03,
+  0x06, 0x02, 0x80, 0x04, 0x14, 0x82, 0xff, 0xfc, 0x01, 0x02, 0x80, 0x04, 0x00, 0x82, 0x41, 0x04,
+  0x07, 0x00, 0x82, 0x3e, 0xf8, 0x01, 0x02, 0x80, 0x01, 0x0e, 0x80, 0x01, 0x02, 0x80, 0x06, 0x02,
+  0x80, 0x04, 0x7f, 0x20, 0x81, 0x06, 0x60, 0x10, 0x81, 0x80, 0x10, 0x00, 0x80, 0x01, 0x00, 0x81,
+  0x0f, 0xf0, 0x10, 0x87, 0x3c, 0xc0, 0x03, 0x3c, 0x42, 0x20, 0x04, 0x42, 0x07, 0x87, 0x42, 0x20,
+  0x04, 0x42, 0x24, 0x40, 0x02, 0x24, 0x10, 0x81, 0x06, 0x60, 0x10, 0x81, 0x80, 0x10, 0x00, 0x80,
+  0x01, 0x00, 0x81, 0x0f, 0xf0, 0x1c, 0x83, 0x40, 0x3e, 0xf8, 0x04, 0x02, 0x80, 0x01, 0x0a, 0x82,
+  0x01, 0x40, 0x81, 0x00, 0x81, 0x01, 0xc0, 0x00, 0x81, 0x03, 0x02, 0x01, 0x81, 0x01, 0x04, 0x14,
+  0x82, 0x7f, 0xfc, 0x01, 0x00, 0x82, 0x80, 0xfc, 0x01, 0x00, 0x82, 0x41, 0x04, 0x07, 0x00, 0x81,
+  0x3e, 0xf8, 0x03, 0x80, 0x01, 0x0e, 0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f, 0x1c,
+  0x81, 0x06, 0x60, 0x01, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83, 0x80,
+  0x10, 0x08, 0x01, 0x00, 0x81, 0x0f, 0xf0, 0x10, 0x87, 0x3c, 0xc0, 0x03, 0x3c, 0x42, 0x20, 0x04,
+  0x42, 0x07, 0x8b, 0x42, 0x20, 0x04, 0x42, 0x24, 0x40, 0x02, 0x24, 0x18, 0x80, 0x01, 0x18, 0x0c,
+  0x81, 0x06, 0x60, 0x01, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83, 0x80,
+  0x10, 0x08, 0x01, 0x00, 0x81, 0x0f, 0xf0, 0x20, 0x87, 0xc0, 0x41, 0x05, 0x07, 0x40, 0xff, 0xfa,
+  0x02, 0x00, 0x80, 0x01, 0x00, 0x80, 0x01, 0x07, 0x80, 0x40, 0x03, 0x80, 0x81, 0x00, 0x81, 0x01,
+  0xc0, 0x00, 0x81, 0x02, 0x02, 0x01, 0x81, 0x01, 0x04, 0x14, 0x80, 0xff, 0x02, 0x82, 0x7f, 0xfc,
+  0x01, 0x00, 0x82, 0x41, 0x04, 0x07, 0x00, 0x82, 0x7e, 0xf8, 0x02, 0x02, 0x80, 0x01, 0x0e, 0x80,
+  0x01, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f, 0x1c, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x07, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x10, 0x87, 0x18, 0x80,
+  0x01, 0x18, 0x42, 0x20, 0x04, 0x42, 0x0f, 0x83, 0x18, 0x80, 0x01, 0x18, 0x10, 0x81, 0x09, 0x90,
+  0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90,
+  0x25, 0x86, 0x7f, 0xfc, 0x01, 0x80, 0x81, 0x05, 0x05, 0x00, 0x82, 0xfe, 0xfa, 0x02, 0x00, 0x80,
+  0x01, 0x00, 0x80, 0x01, 0x0c, 0x80, 0x81, 0x00, 0x81, 0x01, 0xc0, 0x00, 0x82, 0x02, 0x02, 0x40,
+  0x00, 0x81, 0x01, 0x04, 0x18, 0x82, 0x7f, 0xfc, 0x01, 0x00, 0x82, 0x81, 0x04, 0x05, 0x00, 0x82,
+  0x7e, 0xf8, 0x02, 0x02, 0x80, 0x01, 0x06, 0x80, 0x01, 0x06, 0x80, 0x01, 0x02, 0x80, 0x02, 0x02,
+  0x80, 0x04, 0x7f, 0x18, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83, 0x80,
+  0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x01, 0x81, 0x06, 0x60, 0x0c, 0x87, 0x18, 0x80, 0x01,
+  0x18, 0x24, 0x40, 0x02, 0x24, 0x0b, 0x87, 0x42, 0x20, 0x04, 0x42, 0x3c, 0xc0, 0x03, 0x3c, 0x10,
+  0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00,
+  0x81, 0x09, 0x90, 0x01, 0x81, 0x06, 0x60, 0x29, 0x8a, 0xff, 0xfc, 0x01, 0xc0, 0x81, 0x07, 0x05,
+  0x80, 0xfe, 0xfe, 0x02, 0x00, 0x80, 0x01, 0x00, 0x80, 0x01, 0x07, 0x80, 0x40, 0x03, 0x80, 0x81,
+  0x00, 0x85, 0x01, 0x80, 0x80, 0x02, 0x02, 0x40, 0x00, 0x81, 0x01, 0x04, 0x18, 0x82, 0xff, 0xfc,
+  0x01, 0x00, 0x82, 0x81, 0x06, 0x05, 0x00, 0x82, 0x7e, 0xfc, 0x02, 0x02, 0x80, 0x01, 0x02, 0x80,
+  0x01, 0x0a, 0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f, 0x14, 0x81, 0x06, 0x60, 0x00,
+  0x83, 0x80, 0x10, 0x08, 0x01, 0x10, 0x81, 0x06, 0x60, 0x10, 0x87, 0x24, 0x40, 0x02, 0x24, 0x42,
+  0x20, 0x04, 0x42, 0x07, 0x87, 0x42, 0x20, 0x04, 0x42, 0x24, 0x40, 0x02, 0x24, 0x10, 0x81, 0x06,
+  0x60, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x10, 0x81, 0x06, 0x60, 0x19, 0x81, 0x11, 0xf8, 0x00,
+  0x83, 0x80, 0xfd, 0xfe, 0x01, 0x10, 0x8a, 0xff, 0xfe, 0x01, 0x40, 0x81, 0x03, 0x05, 0x80, 0xfe,
+  0xfe, 0x02, 0x00, 0x80, 0x01, 0x00, 0x80, 0x01, 0x03, 0x80, 0x40, 0x07, 0x80, 0x01, 0x00, 0x85,
+  0x01, 0xc0, 0x80, 0x02, 0x02, 0x40, 0x00, 0x81, 0x01, 0x04, 0x18, 0x82, 0xff, 0xfe, 0x01, 0x00,
+  0x82, 0x81, 0x02, 0x05, 0x00, 0x82, 0x7e, 0xfc, 0x02, 0x02, 0x80, 0x01, 0x02, 0x80, 0x01, 0x0a,
+  0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f, 0x10, 0x81, 0x06, 0x60, 0x01, 0x81, 0x09,
+  0x90, 0x0c, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x0f, 0xf0, 0x10, 0x87, 0x3c, 0xc0, 0x03,
+  0x3c, 0x42, 0x20, 0x04, 0x42, 0x0b, 0x87, 0x24, 0x40, 0x02, 0x24, 0x18, 0x80, 0x01, 0x18, 0x0c,
+  0x81, 0x06, 0x60, 0x01, 0x81, 0x09, 0x90, 0x0c, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x0f,
+  0xf0, 0x1d, 0x81, 0x16, 0xf8, 0x01, 0x81, 0x86, 0x02, 0x00, 0x83, 0x80, 0xfd, 0xfe, 0x01, 0x10,
+  0x86, 0xff, 0xfe, 0x01, 0x40, 0x81, 0x03, 0x05, 0x00, 0x82, 0xfe, 0xfe, 0x02, 0x00, 0x80, 0x01,
+  0x00, 0x80, 0x01, 0x0b, 0x81, 0x40, 0x01, 0x00, 0x81, 0x01, 0x80, 0x00, 0x82, 0x02, 0x02, 0x40,
+  0x00, 0x81, 0x01, 0x04, 0x18, 0x82, 0xff, 0xfe, 0x01, 0x00, 0x82, 0x81, 0x02, 0x05, 0x00, 0x82,
+  0x7e, 0xfc, 0x02, 0x0e, 0x80, 0x01, 0x02, 0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f,
+  0x10, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83, 0x80, 0x10, 0x08, 0x01,
+  0x00, 0x81, 0x09, 0x90, 0x10, 0x83, 0x18, 0x80, 0x01, 0x18, 0x0f, 0x87, 0x42, 0x20, 0x04, 0x42,
+  0x18, 0x80, 0x01, 0x18, 0x10, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83,
+  0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x1d, 0x80, 0x0c, 0x02, 0x80, 0x09, 0x01, 0x83,
+  0x80, 0x4c, 0x84, 0x01, 0x00, 0x81, 0x86, 0x02, 0x00, 0x83, 0x80, 0xfd, 0xfe, 0x01, 0x10, 0x86,
+  0xff, 0xfe, 0x01, 0xc0, 0x81, 0x01, 0x05, 0x00, 0x82, 0xfe, 0xfa, 0x02, 0x00, 0x80, 0x01, 0x00,
+  0x80, 0x01, 0x0c, 0x80, 0x81, 0x00, 0x81, 0x01, 0x80, 0x00, 0x82, 0x02, 0x02, 0x40, 0x00, 0x81,
+  0x01, 0x04, 0x18, 0x82, 0xff, 0xfe, 0x01, 0x00, 0x80, 0x81, 0x00, 0x80, 0x05, 0x00, 0x82, 0x7e,
+  0xf8, 0x02, 0x02, 0x80, 0x01, 0x06, 0x80, 0x01, 0x06, 0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x80,
+  0x04, 0x7f, 0x0c, 0x81, 0x06, 0x60, 0x15, 0x81, 0x06, 0x60, 0x10, 0x87, 0x24, 0x40, 0x02, 0x24,
+  0x42, 0x20, 0x04, 0x42, 0x07, 0x87, 0x42, 0x20, 0x04, 0x42, 0x24, 0x40, 0x02, 0x24, 0x10, 0x81,
+  0x06, 0x60, 0x15, 0x81, 0x06, 0x60, 0x1d, 0x80, 0x10, 0x06, 0x81, 0x39, 0x78, 0x00, 0x83, 0x80,
+  0x4c, 0x04, 0x01, 0x00, 0x81, 0x86, 0x02, 0x00, 0x83, 0x80, 0x78, 0xfe, 0x01, 0x10, 0x89, 0xff,
+  0xfc, 0x01, 0xc0, 0x01, 0x05, 0x05, 0x40, 0xbe, 0xfa, 0x03, 0x80, 0x01, 0x08, 0x80, 0x80, 0x02,
+  0x80, 0x81, 0x00, 0x81, 0x01, 0x80, 0x00, 0x81, 0x02, 0x02, 0x01, 0x81, 0x01, 0x04, 0x18, 0x82,
+  0xff, 0xfc, 0x01, 0x00, 0x82, 0x01, 0x04, 0x05, 0x00, 0x81, 0x3e, 0xf8, 0x03, 0x80, 0x01, 0x0e,
+  0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f, 0x0c, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80,
+  0x10, 0x08, 0x01, 0x07, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x10, 0x87, 0x3c,
+  0xc0, 0x03, 0x3c, 0x42, 0x20, 0x04, 0x42, 0x0f, 0x83, 0x18, 0x80, 0x01, 0x18, 0x10, 0x81, 0x09,
+  0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x07, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09,
+  0x90, 0x21, 0x80, 0x1c, 0x02, 0x80, 0x12, 0x06, 0x81, 0x30, 0xf8, 0x02, 0x81, 0x04, 0x01, 0x00,
+  0x81, 0x01, 0x02, 0x00, 0x83, 0x80, 0xfc, 0xfc, 0x01, 0x13, 0x83, 0x80, 0x41, 0x05, 0x07, 0x00,
+  0x81, 0xbf, 0xfa, 0x07, 0x80, 0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x02, 0x80, 0x81, 0x00,
+  0x81, 0x01, 0xc0, 0x01, 0x80, 0x02, 0x02, 0x80, 0x04, 0x1c, 0x82, 0x41, 0x04, 0x07, 0x00, 0x81,
+  0x3e, 0xf8, 0x13, 0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f, 0x08, 0x81, 0x0f, 0xf0,
+  0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x10, 0x81, 0x06, 0x60, 0x20, 0x87, 0x42, 0x20, 0x04, 0x42,
+  0x3c, 0xc0, 0x03, 0x3c, 0x10, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x10, 0x81,
+  0x06, 0x60, 0x21, 0x80, 0x18, 0x02, 0x80, 0x04, 0x02, 0x80, 0x12, 0x02, 0x80, 0x09, 0x01, 0x82,
+  0x80, 0x7c, 0xf8, 0x01, 0x80, 0x02, 0x00, 0x80, 0x01, 0x00, 0x80, 0x01, 0x12, 0x82, 0x7f, 0xfc,
+  0x01, 0x00, 0x81, 0x80, 0x02, 0x00, 0x83, 0xc0, 0x41, 0x04, 0x03, 0x00, 0x82, 0x81, 0xf8, 0x01,
+  0x02, 0x80, 0x01, 0x03, 0x81, 0x40, 0x80, 0x02, 0x80, 0x80, 0x02, 0x81, 0x81, 0x02, 0x00, 0x80,
+  0xc0, 0x00, 0x81, 0x01, 0x02, 0x18, 0x82, 0x7f, 0xfc, 0x01, 0x00, 0x81, 0x80, 0x02, 0x01, 0x82,
+  0x41, 0x04, 0x03, 0x02, 0x80, 0x01, 0x16, 0x80, 0x02, 0x7f, 0x17, 0x83, 0x80, 0x10, 0x08, 0x01,
+  0x00, 0x81, 0x0f, 0xf0, 0x10, 0x87, 0x3c, 0xc0, 0x03, 0x3c, 0x42, 0x20, 0x04, 0x42, 0x33, 0x83,
+  0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x0f, 0xf0, 0x25, 0x80, 0x04, 0x02, 0x80, 0x18, 0x02, 0x80,
+  0x04, 0x02, 0x80, 0x02, 0x02, 0x80, 0x09, 0x01, 0x82, 0x80, 0x7c, 0xfc, 0x01, 0x80, 0x86, 0x01,
+  0x83, 0x80, 0xfd, 0xfe, 0x01, 0x10, 0x82, 0xff, 0xfe, 0x01, 0x00, 0x82, 0x80, 0x03, 0x04, 0x00,
+  0x82, 0x7e, 0x06, 0x02, 0x00, 0x80, 0x01, 0x00, 0x80, 0x01, 0x03, 0x80, 0x40, 0x03, 0x80, 0x80,
+  0x04, 0x80, 0x01, 0x01, 0x80, 0x02, 0x00, 0x80, 0x40, 0x00, 0x81, 0x01, 0x04, 0x18, 0x82, 0xff,
+  0xfe, 0x01, 0x00, 0x82, 0x80, 0x02, 0x04, 0x00, 0x82, 0x7e, 0xfc, 0x02, 0x02, 0x80, 0x01, 0x0a,
+  0x80, 0x01, 0x02, 0x80, 0x01, 0x06, 0x80, 0x04, 0x7f, 0x04, 0x81, 0x0f, 0xf0, 0x00, 0x83, 0x80,
+  0x10, 0x08, 0x01, 0x33, 0x87, 0x42, 0x20, 0x04, 0x42, 0x24, 0x40, 0x02, 0x24, 0x10, 0x81, 0x0f,
+  0xf0, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x38, 0x80, 0x10, 0x02, 0x80, 0x18, 0x02, 0x80, 0x18,
+  0x02, 0x80, 0x10, 0x09, 0x83, 0x80, 0x48, 0x04, 0x01, 0x00, 0x81, 0x86, 0x02, 0x00, 0x83, 0x80,
+  0xfc, 0xfc, 0x01, 0x10, 0x81, 0x80, 0x02, 0x00, 0x83, 0xc0, 0x01, 0x01, 0x05, 0x00, 0x81, 0xbe,
+  0xfa, 0x03, 0x80, 0x01, 0x04, 0x80, 0x80, 0x06, 0x80, 0x81, 0x00, 0x81, 0x01, 0x80, 0x00, 0x81,
+  0x02, 0x02, 0x02, 0x80, 0x04, 0x18, 0x81, 0x80, 0x02, 0x01, 0x80, 0x01, 0x00, 0x80, 0x05, 0x00,
+  0x81, 0x3e, 0xf8, 0x03, 0x80, 0x01, 0x06, 0x80, 0x01, 0x02, 0x80, 0x01, 0x02, 0x80, 0x01, 0x02,
+  0x80, 0x02, 0x02, 0x80, 0x04, 0x7f, 0x13, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90,
+  0x10, 0x83, 0x18, 0x80, 0x01, 0x18, 0x13, 0x83, 0x18, 0x80, 0x01, 0x18, 0x1f, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x29, 0x80, 0x02, 0x02, 0x80, 0x04, 0x02, 0x80, 0x08, 0x02,
+  0x80, 0x04, 0x02, 0x80, 0x12, 0x02, 0x80, 0x09, 0x02, 0x81, 0x34, 0xf8, 0x03, 0x80, 0x01, 0x00,
+  0x81, 0x01, 0x02, 0x11, 0x82, 0x7f, 0xfc, 0x01, 0x00, 0x80, 0x80, 0x01, 0x83, 0xc0, 0x40, 0x04,
+  0x03, 0x00, 0x80, 0x81, 0x06, 0x80, 0x80, 0x00, 0x80, 0x01, 0x08, 0x80, 0x80, 0x01, 0x80, 0xc0,
+  0x00, 0x81, 0x01, 0x02, 0x18, 0x82, 0x7f, 0xfc, 0x01, 0x00, 0x80, 0x80, 0x02, 0x82, 0x40, 0x04,
+  0x03, 0x0e, 0x80, 0x01, 0x0a, 0x80, 0x02, 0x7f, 0x00, 0x81, 0x06, 0x60, 0x15, 0x81, 0x06, 0x60,
+  0x10, 0x87, 0x24, 0x40, 0x02, 0x24, 0x42, 0x20, 0x04, 0x42, 0x07, 0x87, 0x42, 0x20, 0x04, 0x42,
+  0x24, 0x40, 0x02, 0x24, 0x10, 0x81, 0x06, 0x60, 0x15, 0x81, 0x06, 0x60, 0x2d, 0x80, 0x10, 0x02,
+  0x80, 0x10, 0x02, 0x80, 0x18, 0x0a, 0x80, 0x09, 0x01, 0x82, 0x80, 0x4c, 0x04, 0x01, 0x81, 0x86,
+  0x02, 0x00, 0x83, 0x80, 0x7c, 0xfe, 0x01, 0x10, 0x82, 0xff, 0xfc, 0x01, 0x00, 0x82, 0x01, 0x01,
+  0x04, 0x00, 0x81, 0x3e, 0xfa, 0x01, 0x80, 0x80, 0x00, 0x80, 0x01, 0x02, 0x80, 0x01, 0x08, 0x80,
+  0x01, 0x00, 0x80, 0x01, 0x01, 0x80, 0x02, 0x02, 0x81, 0x01, 0x04, 0x18, 0x82, 0xff, 0xfc, 0x01,
+  0x00, 0x80, 0x01, 0x00, 0x80, 0x04, 0x00, 0x81, 0x3e, 0xf8, 0x03, 0x80, 0x01, 0x16, 0x80, 0x04,
+  0x7f, 0x00, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x09, 0x80, 0x08, 0x01, 0x81,
+  0x09, 0x90, 0x10, 0x83, 0x18, 0x80, 0x01, 0x18, 0x13, 0x83, 0x18, 0x80, 0x01, 0x18, 0x10, 0x81,
+  0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x0c, 0x81, 0x09, 0x90, 0x2d, 0x80, 0x09, 0x02,
+  0x80, 0x02, 0x02, 0x80, 0x04, 0x02, 0x80, 0x18, 0x02, 0x80, 0x04, 0x02, 0x80, 0x12, 0x06, 0x81,
+  0x30, 0xf8, 0x03, 0x80, 0x01, 0x00, 0x80, 0x81, 0x16, 0x81, 0x80, 0x02, 0x00, 0x83, 0xc0, 0x40,
+  0x04, 0x03, 0x00, 0x80, 0x01, 0x06, 0x80, 0x80, 0x09, 0x81, 0x40, 0x81, 0x01, 0x80, 0xc0, 0x01,
+  0x80, 0x02, 0x1c, 0x81, 0x80, 0x02, 0x01, 0x82, 0x40, 0x04, 0x03, 0x12, 0x80, 0x01, 0x06, 0x80,
+  0x02, 0x7f, 0x0f, 0x81, 0x80, 0x10, 0x00, 0x80, 0x01, 0x13, 0x81, 0x04, 0x40, 0x00, 0x84, 0x04,
+  0x42, 0x20, 0x04, 0x42, 0x33, 0x83, 0x80, 0x10, 0x08, 0x01, 0x30, 0x81, 0x30, 0xf8, 0x05, 0x80,
+  0x10, 0x06, 0x80, 0x18, 0x0a, 0x80, 0x01, 0x01, 0x82, 0x80, 0x4c, 0x04, 0x01, 0x81, 0x86, 0x02,
+  0x00, 0x83, 0x80, 0x7c, 0xfc, 0x01, 0x11, 0x81, 0xfe, 0x01, 0x00, 0x85, 0x01, 0x01, 0x04, 0x40,
+  0x3e, 0xfa, 0x03, 0x80, 0x01, 0x00, 0x80, 0x80, 0x06, 0x80, 0x80, 0x04, 0x80, 0x01, 0x01, 0x80,
+  0x02, 0x02, 0x81, 0x01, 0x04, 0x19, 0x81, 0xfe, 0x01, 0x00, 0x80, 0x01, 0x00, 0x80, 0x04, 0x00,
+  0x81, 0x3e, 0xf8, 0x03, 0x80, 0x01, 0x0e, 0x80, 0x01, 0x06, 0x80, 0x04, 0x7c, 0x81, 0x06, 0x60,
+  0x15, 0x81, 0x06, 0x60, 0x10, 0x80, 0x20, 0x00, 0x81, 0x02, 0x20, 0x0b, 0x87, 0x42, 0x20, 0x04,
+  0x42, 0x24, 0x40, 0x02, 0x24, 0x10, 0x81, 0x06, 0x60, 0x15, 0x81, 0x06, 0x60, 0x2c, 0x81, 0x80,
+  0x4c, 0x02, 0x80, 0x09, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x06, 0x80, 0x04, 0x02, 0x80, 0x12,
+  0x02, 0x80, 0x08, 0x02, 0x81, 0x30, 0xf8, 0x03, 0x80, 0x01, 0x00, 0x81, 0x81, 0x02, 0x11, 0x80,
+  0xff, 0x02, 0x81, 0x80, 0x02, 0x00, 0x85, 0xc0, 0x40, 0x04, 0x03, 0x40, 0x81, 0x04, 0x80, 0x01,
+  0x04, 0x80, 0x80, 0x01, 0x80, 0x40, 0x03, 0x80, 0x80, 0x01, 0x80, 0x80, 0x1b, 0x80, 0xff, 0x02,
+  0x81, 0x80, 0x02, 0x01, 0x82, 0x40, 0x04, 0x03, 0x7c, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x37, 0x83, 0x18, 0x80, 0x01, 0x18, 0x10, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x41, 0x81, 0x04, 0x01, 0x0c, 0x80, 0x18, 0x02, 0x80, 0x18, 0x0f, 0x80, 0x04, 0x01,
+  0x81, 0x80, 0x02, 0x02, 0x81, 0xfc, 0x01, 0x10, 0x81, 0x80, 0x02, 0x00, 0x86, 0x40, 0x01, 0x01,
+  0x04, 0x40, 0x3e, 0xfa, 0x03, 0x80, 0x01, 0x0c, 0x80, 0x01, 0x00, 0x81, 0x01, 0x40, 0x01, 0x80,
+  0x02, 0x02, 0x80, 0x04, 0x18, 0x81, 0x80, 0x02, 0x01, 0x80, 0x01, 0x02, 0x81, 0x3e, 0xf8, 0x0b,
+  0x80, 0x01, 0x06, 0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04, 0x7f, 0x0b, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x10, 0x83, 0x18, 0x80, 0x01, 0x18, 0x37, 0x83, 0x80, 0x10,
+  0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x35, 0x81, 0x38, 0xf8, 0x05, 0x80, 0x10, 0x02, 0x80, 0x04,
+  0x06, 0x80, 0x04, 0x02, 0x80, 0x02, 0x02, 0x80, 0x09, 0x01, 0x82, 0x80, 0x4c, 0x80, 0x01, 0x80,
+  0x06, 0x01, 0x82, 0x80, 0xfd, 0x02, 0x11, 0x82, 0x7f, 0xfc, 0x01, 0x04, 0x80, 0x40, 0x00, 0x80,
+  0x02, 0x00, 0x80, 0x01, 0x00, 0x80, 0x01, 0x0f, 0x80, 0x40, 0x00, 0x80, 0x02, 0x02, 0x80, 0x01,
+  0x19, 0x82, 0x7f, 0xfc, 0x01, 0x02, 0x80, 0x04, 0x00, 0x80, 0x40, 0x00, 0x80, 0x02, 0x02, 0x80,
+  0x01, 0x7f, 0x10, 0x81, 0x06, 0x60, 0x10, 0x87, 0x24, 0x40, 0x02, 0x24, 0x42, 0x20, 0x04, 0x42,
+  0x38, 0x81, 0x06, 0x60, 0x31, 0x80, 0x86, 0x01, 0x82, 0x80, 0x44, 0x04, 0x01, 0x80, 0x09, 0x02,
+  0x80, 0x02, 0x06, 0x80, 0x08, 0x06, 0x80, 0x10, 0x06, 0x81, 0x30, 0x78, 0x03, 0x80, 0x01, 0x18,
+  0x83, 0x80, 0x02, 0x02, 0x80, 0x00, 0x81, 0x04, 0x01, 0x00, 0x80, 0x80, 0x11, 0x81, 0x40, 0x80,
+  0x01, 0x80, 0xc0, 0x01, 0x80, 0x02, 0x1c, 0x82, 0x80, 0x02, 0x02, 0x01, 0x81, 0x04, 0x01, 0x0a,
+  0x80, 0x01, 0x0e, 0x80, 0x02, 0x78, 0x81, 0x06, 0x60, 0x38, 0x87, 0x42, 0x20, 0x04, 0x42, 0x24,
+  0x40, 0x02, 0x24, 0x10, 0x81, 0x06, 0x60, 0x4a, 0x80, 0x02, 0x03, 0x80, 0x01, 0x0c, 0x80, 0x10,
+  0x02, 0x80, 0x18, 0x0f, 0x80, 0x04, 0x02, 0x80, 0x02, 0x16, 0x84, 0x02, 0x02, 0x40, 0x01, 0x01,
+  0x01, 0x81, 0x3e, 0xf8, 0x0c, 0x80, 0x40, 0x03, 0x80, 0x01, 0x00, 0x80, 0x01, 0x21, 0x81, 0x02,
+  0x02, 0x00, 0x80, 0x01, 0x02, 0x81, 0x3e, 0xf8, 0x03, 0x80, 0x01, 0x02, 0x80, 0x01, 0x0a, 0x80,
+  0x01, 0x7f, 0x7f, 0x18, 0x81, 0x80, 0x02, 0x05, 0x81, 0x30, 0xf8, 0x05, 0x80, 0x10, 0x12, 0x80,
+  0x09, 0x01, 0x81, 0x80, 0x4c, 0x02, 0x80, 0x86, 0x01, 0x83, 0x80, 0x7c, 0xfc, 0x01, 0x11, 0x81,
+  0xfc, 0x01, 0x02, 0x80, 0x04, 0x01, 0x80, 0x02, 0x03, 0x80, 0x01, 0x00, 0x80, 0x80, 0x0f, 0x80,
+  0x02, 0x02, 0x81, 0x01, 0x04, 0x19, 0x81, 0xfc, 0x01, 0x02, 0x80, 0x04, 0x0a, 0x80, 0x01, 0x12,
+  0x80, 0x04, 0x78, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x37, 0x83, 0x18, 0x80,
+  0x01, 0x18, 0x10, 0x81, 0x09, 0x90, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x44, 0x82, 0x7d, 0xfc,
+  0x01, 0x00, 0x80, 0x04, 0x02, 0x80, 0x08, 0x02, 0x80, 0x09, 0x02, 0x80, 0x02, 0x02, 0x80, 0x04,
+  0x06, 0x80, 0x04, 0x02, 0x80, 0x02, 0x06, 0x81, 0x30, 0xf8, 0x05, 0x81, 0x81, 0x02, 0x11, 0x80,
+  0xff, 0x02, 0x81, 0x80, 0x02, 0x01, 0x84, 0x40, 0x04, 0x02, 0x40, 0x01, 0x02, 0x80, 0x80, 0x05,
+  0x80, 0x40, 0x0a, 0x80, 0x40, 0x1b, 0x80, 0xff, 0x02, 0x81, 0x80, 0x02, 0x01, 0x82, 0x40, 0x04,
+  0x02, 0x7f, 0x07, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x10, 0x83, 0x18, 0x80,
+  0x01, 0x18, 0x37, 0x83, 0x80, 0x10, 0x08, 0x01, 0x00, 0x81, 0x09, 0x90, 0x34, 0x80, 0x80, 0x03,
+  0x80, 0x82, 0x01, 0x82, 0x80, 0x44, 0x04, 0x0d, 0x80, 0x08, 0x06, 0x80, 0x10, 0x0c, 0x80, 0x01,
+  0x19, 0x80, 0x02, 0x00, 0x80, 0xc0, 0x01, 0x82, 0x01, 0x40, 0x80, 0x10, 0x80, 0x01, 0x00, 0x80,
+  0x80, 0x01, 0x80, 0x80, 0x01, 0x80, 0x02, 0x1d, 0x80, 0x02, 0x03, 0x80, 0x01, 0x0e, 0x80, 0x01,
+  0x0a, 0x80, 0x02, 0x7f, 0x7f, 0x1d, 0x80, 0x02, 0x03, 0x80, 0x01, 0x0c, 0x80, 0x10, 0x13, 0x80,
+  0x04, 0x02, 0x80, 0x02, 0x16, 0x80, 0x02, 0x01, 0x81, 0x01, 0x01, 0x01, 0x81, 0x3c, 0xf8, 0x04,
+  0x80, 0x40, 0x06, 0x81, 0x40, 0x80, 0x00, 0x80, 0x01, 0x00, 0x80, 0x01, 0x00, 0x80, 0x01, 0x21,
+  0x80, 0x02, 0x01, 0x80, 0x01, 0x02, 0x81, 0x3c, 0xf8, 0x03, 0x80, 0x01, 0x06, 0x80, 0x01, 0x06,
+  0x80, 0x01, 0x7f, 0x0c, 0x81, 0x06, 0x60, 0x10, 0x87, 0x24, 0x40, 0x02, 0x24, 0x42, 0x20, 0x04,
+  0x42, 0x38, 0x81, 0x06, 0x60, 0x41, 0x81, 0x30, 0xf8, 0x0d, 0x80, 0x18, 0x12, 0x80, 0x84, 0x01,
+  0x83, 0x80, 0xfc, 0xfc, 0x01, 0x10, 0x81, 0x80, 0x02, 0x03, 0x80, 0x04, 0x00, 0x81, 0x02, 0x02,
+  0x04, 0x80, 0x40, 0x02, 0x80, 0x40, 0x02, 0x81, 0x40, 0x80, 0x0c, 0x80, 0x04, 0x18, 0x81, 0x80,
+  0x02, 0x03, 0x80, 0x04, 0x00, 0x80, 0x02, 0x04, 0x80, 0x01, 0x16, 0x80, 0x04, 0x74, 0x81, 0x06,
+  0x60, 0x51, 0x81, 0x06, 0x60, 0x52, 0x80, 0x02, 0x0d, 0x80, 0x10, 0x12, 0x80, 0x01, 0x01, 0x81,
+  0x80, 0x4c, 0x02, 0x80, 0x02, 0x02, 0x80, 0x80, 0x12, 0x82, 0x80, 0xfc, 0x01, 0x07, 0x80, 0x40,
+  0x01, 0x80, 0x01, 0x03, 0x80, 0x40, 0x0c, 0x80, 0x02, 0x1d, 0x82, 0x80, 0xfc, 0x01, 0x0a, 0x80,
+  0x01, 0x7f, 0x2f, 0x87, 0x42, 0x20, 0x04, 0x42, 0x24, 0x40, 0x02, 0x24, 0x64, 0x80, 0x80, 0x12,
+  0x80, 0x04, 0x0a, 0x80, 0x02, 0x02, 0x80, 0x08, 0x03, 0x80, 0x80, 0x05, 0x81, 0x81, 0x02, 0x11,
+  0x80, 0xff, 0x06, 0x80, 0x40, 0x00, 0x82, 0x02, 0x40, 0x01, 0x17, 0x80, 0x01, 0x19, 0x80, 0xff,
+  0x06, 0x80, 0x40, 0x00, 0x80, 0x02, 0x06, 0x80, 0x01, 0x7f, 0x7f, 0x1c, 0x82, 0x81, 0xfc, 0x01,
+  0x00, 0x80, 0x04, 0x02, 0x80, 0x08, 0x02, 0x80, 0x08, 0x02, 0x80, 0x02, 0x0a, 0x80, 0x04, 0x0a,
+  0x81, 0x30, 0x78, 0x1d, 0x80, 0x80, 0x03, 0x80, 0x04, 0x14, 0x80, 0x40, 0x02, 0x80, 0x40, 0x1f,
+  0x80, 0x80, 0x03, 0x80, 0x04, 0x07, 0x80, 0x01, 0x7f, 0x7f, 0x1c, 0x80, 0xfc, 0x05, 0x81, 0x80,
+  0x44, 0x02, 0x80, 0x01, 0x3b, 0x80, 0x02, 0x00, 0x80, 0x80, 0x16, 0x81, 0x40, 0x80, 0x01, 0x80,
+  0x80, 0x20, 0x80, 0x02, 0x7f, 0x7f, 0x1b, 0x80, 0x80, 0x03, 0x80, 0x82, 0x1a, 0x80, 0x10, 0x0c,
+  0x80, 0x01, 0x1e, 0x80, 0x01, 0x00, 0x80, 0x80, 0x11, 0x80, 0x40, 0x02, 0x80, 0x40, 0x25, 0x80,
+  0x01, 0x74, 0x81, 0x01, 0x10, 0x00, 0x83, 0x80, 0x10, 0x08, 0x01, 0x4c, 0x81, 0x01, 0x10, 0x00,
+  0x83, 0x80, 0x10, 0x08, 0x01, 0x51, 0x80, 0x02, 0x02, 0x80, 0x04, 0x0d, 0x80, 0x08, 0x2f, 0x80,
+  0x02, 0x13, 0x80, 0x01, 0x03, 0x80, 0x40, 0x02, 0x80, 0x40, 0x01, 0x80, 0x02, 0x1d, 0x80, 0x02,
+  0x1f, 0x80, 0x02, 0x74, 0x81, 0x08, 0x80, 0x3c, 0x83, 0x18, 0x80, 0x01, 0x18, 0x10, 0x81, 0x08,
+  0x80, 0x69, 0x80, 0x10, 0x2f, 0x80, 0x02, 0x00, 0x80, 0x40, 0x0b, 0x80, 0x80, 0x04, 0x80, 0x01,
+  0x04, 0x80, 0x81, 0x23, 0x80, 0x02, 0x7f, 0x7f, 0x26, 0x80, 0x01, 0x25, 0x80, 0x02, 0x19, 0x80,
+  0x01, 0x01, 0x80, 0x40, 0x07, 0x80, 0x80, 0x0a, 0x80, 0x80, 0x26, 0x80, 0x01, 0x7f, 0x7f, 0x6b,
+  0x80, 0x40, 0x00, 0x80, 0xf8, 0x3e, 0x80, 0xf8, 0x0b, 0x80, 0x01, 0x7f, 0x59, 0x80, 0x08, 0x7f,
+  0x27, 0x80, 0x01, 0x36, 0x80, 0x01, 0x7f, 0x59, 0x80, 0x08, 0x7f, 0x20, 0x80, 0x40, 0x45, 0x80,
+  0x01, 0x7f, 0x59, 0x80, 0x08, 0x7f, 0x17, 0x80, 0x01, 0x02, 0x80, 0x01, 0x03, 0x80, 0x40, 0x05,
+  0x80, 0x01, 0x32, 0x80, 0x01, 0x0a, 0x80, 0x01,
+};
+
+#endif // SPLASH_ANIMATION_H
@@ -0,0 +1,189 @@
+// Threshold, hysteresis and rate-of-rise alarms (src/AlarmEngine.h)
+// Run with: platformio test -e native -f test_alarm
+#include <Arduino.h>
+#include <unity.h>
+#include "AlarmEngine.h"
+
+#define PERIOD 1000  // ms between samples in these tests
+
+static AlarmEngine alarms;
+static uint32_t now;
+
+// Feed one sample a period after the previous one; true if the alarm state changed
+static bool feed(int16_t value) {
+  now += PERIOD;
+  return alarms.update(now, value);
+}
+
+void setUp() {
+  alarms = AlarmEngine();
+  now = 0;
+}
+
+void tearDown() {}
+
+void test_threshold_trips_above_setpoint() {
+  alarms.setThreshold(1, 320);
+  TEST_ASSERT_FALSE(feed(300));
+  TEST_ASSERT_FALSE(feed(320));  // At the setpoint is not above it
+  TEST_ASSERT_EQUAL_UINT8(0, alarms.level());
+  TEST_ASSERT_TRUE(feed(321));
+  TEST_ASSERT_EQUAL_UINT8(1, alarms.level());
+  TEST_ASSERT_TRUE(alarms.active());
+  TEST_ASSERT_FALSE(feed(330));  // No change, nothing to report
+}
+
+void test_hysteresis_holds_until_below_band() {
+  alarms.setThreshold(1, 320);
+  alarms.setHysteresis(4);
+  feed(321);
+  TEST_ASSERT_FALSE(feed(319));
+  TEST_ASSERT_FALSE(feed(316));  // threshold - hysteresis still holds
+  TEST_ASSERT_EQUAL_UINT8(1, alarms.level());
+  TEST_ASSERT_TRUE(feed(315));
+  TEST_ASSERT_EQUAL_UINT8(0, alarms.level());
+  TEST_ASSERT_FALSE(feed(320));  // Re-arming needs the setpoint to be exceeded again
+  TEST_ASSERT_TRUE(feed(321));
+}
+
+void test_no_hysteresis_clears_at_setpoint() {
+  alarms.setThreshold(1, 320);
+  alarms.setHysteresis(-3);  // Clamped to 0
+  TEST_ASSERT_EQUAL_INT16(0, alarms.getHysteresis());
+  feed(321);
+  TEST_ASSERT_FALSE(feed(320));
+  TEST_ASSERT_TRUE(feed(319));
+}
+
+void test_levels_step_up_and_down() {
+  alarms.setThreshold(1, 320);
+  alarms.setThreshold(2, 400);
+  alarms.setHysteresis(4);
+  TEST_ASSERT_TRUE(feed(401));
+  TEST_ASSERT_EQUAL_UINT8(2, alarms.level());
+  TEST_ASSERT_FALSE(feed(397));
+  TEST_ASSERT_EQUAL_UINT8(2, alarms.level());
+  TEST_ASSERT_TRUE(feed(395));
+  TEST_ASSERT_EQUAL_UINT8(1, alarms.level());
+  TEST_ASSERT_TRUE(feed(200));
+  TEST_ASSERT_EQUAL_UINT8(0, alarms.level());
+}
+
+void test_levels_out_of_range_are_ignored() {
+  alarms.setThreshold(0, 1);
+  alarms.setThreshold(ALARM_LEVELS + 1, 1);
+  TEST_ASSERT_EQUAL_INT16(ALARM_LEVEL_OFF, alarms.getThreshold(0));
+  TEST_ASSERT_EQUAL_INT16(ALARM_LEVEL_OFF, alarms.getThreshold(ALARM_LEVELS + 1));
+  alarms.setThreshold(1, ALARM_LEVEL_OFF);
+  TEST_ASSERT_FALSE(feed(4000));
+  TEST_ASSERT_FALSE(alarms.active());
+}
+
+void test_fault_keeps_the_last_decision() {
+  alarms.setThreshold(1, 320);
+  feed(321);
+  TEST_ASSERT_FALSE(feed(SAMPLE_FAULT));
+  TEST_ASSERT_EQUAL_UINT8(1, alarms.level());
+  TEST_ASSERT_TRUE(feed(100));
+}
+
+// Limits from the operator are range-checked in °C before they become 16-bit quarter degrees
+void test_limits_outside_max6675_range_are_rejected() {
+  TEST_ASSERT_TRUE(sampleCelsiusInRange(0));
+  TEST_ASSERT_TRUE(sampleCelsiusInRange(80));
+  TEST_ASSERT_TRUE(sampleCelsiusInRange(SAMPLE_CELSIUS_MAX));
+  TEST_ASSERT_FALSE(sampleCelsiusInRange(-0.25));
+  TEST_ASSERT_FALSE(sampleCelsiusInRange(1024));
+  TEST_ASSERT_FALSE(sampleCelsiusInRange(8191.75));  // Would convert to ALARM_LEVEL_OFF
+  TEST_ASSERT_FALSE(sampleCelsiusInRange(10000));    // Would wrap to a negative threshold
+  TEST_ASSERT_FALSE(sampleCelsiusInRange(NAN));
+  TEST_ASSERT_EQUAL_INT16(ALARM_LEVEL_OFF, sampleFromCelsius(8191.75));
+}
+
+// The highest accepted setpoint still compares as a temperature
+void test_highest_setpoint_trips() {
+  alarms.setThreshold(1, sampleFromCelsius(SAMPLE_CELSIUS_MAX));
+  TEST_ASSERT_TRUE(alarms.getThreshold(1) < ALARM_LEVEL_OFF);
+  TEST_ASSERT_FALSE(feed(sampleFromCelsius(20)));
+  TEST_ASSERT_FALSE(feed(sampleFromCelsius(SAMPLE_CELSIUS_MAX)));
+  TEST_ASSERT_TRUE(feed(sampleFromCelsius(SAMPLE_CELSIUS_MAX) + 1));
+}
+
+// Slope over ALARM_ROR_HISTORY samples, tripping at the limit and clearing under half of it
+void test_rate_of_rise_trips_and_clears() {
+  alarms.setThreshold(1, ALARM_LEVEL_OFF);
+  alarms.setRateOfRiseLimit(8);  // 2 °C/s
+  TEST_ASSERT_FALSE(feed(100));
+  TEST_ASSERT_FALSE(feed(110));
+  TEST_ASSERT_FALSE(feed(120));
+  TEST_ASSERT_FALSE(feed(130));  // Not enough history for a slope yet
+  TEST_ASSERT_TRUE(feed(140));
+  TEST_ASSERT_EQUAL_INT32(10, alarms.slope());
+  TEST_ASSERT_TRUE(alarms.rateOfRise());
+  TEST_ASSERT_EQUAL_UINT8(0, alarms.level());
+
+  TEST_ASSERT_FALSE(feed(145));  // Slope 8
+  TEST_ASSERT_FALSE(feed(145));  // 6, still at least half the limit
+  TEST_ASSERT_TRUE(feed(145));   // 3
+  TEST_ASSERT_EQUAL_INT32(3, alarms.slope());
+  TEST_ASSERT_FALSE(alarms.rateOfRise());
+}
+
+void test_rate_of_rise_below_limit() {
+  alarms.setRateOfRiseLimit(8);
+  for (int16_t v = 100; v < 170; v += 7) TEST_ASSERT_FALSE(feed(v));
+  TEST_ASSERT_EQUAL_INT32(7, alarms.slope());
+}
+
+void test_rate_of_rise_disabled() {
+  alarms.setRateOfRiseLimit(0);
+  for (int16_t v = 0; v < 200; v += 40) TEST_ASSERT_FALSE(feed(v));
+  TEST_ASSERT_FALSE(alarms.rateOfRise());
+}
+
+// A gap in the data restarts the slope: a full history is needed again
+void test_fault_restarts_rate_of_rise() {
+  alarms.setRateOfRiseLimit(8);
+  for (int16_t v = 100; v <= 130; v += 10) feed(v);
+  TEST_ASSERT_TRUE(feed(140));
+  TEST_ASSERT_FALSE(feed(SAMPLE_FAULT));
+  TEST_ASSERT_TRUE(alarms.rateOfRise());  // Kept until valid data returns
+
+  // Flat after the gap: held while the history fills, cleared by the first new slope
+  for (int i = 0; i < ALARM_ROR_HISTORY; i++) TEST_ASSERT_FALSE(feed(200));
+  TEST_ASSERT_TRUE(alarms.rateOfRise());
+  TEST_ASSERT_TRUE(feed(200));
+  TEST_ASSERT_EQUAL_INT32(0, alarms.slope());
+  TEST_ASSERT_FALSE(alarms.rateOfRise());
+}
+
+// A slope from before a gap must not trip the alarm once the history is refilled
+void test_stale_slope_does_not_trip() {
+  for (int16_t v = 100; v <= 140; v += 10) feed(v);
+  TEST_ASSERT_EQUAL_INT32(10, alarms.slope());
+  feed(SAMPLE_FAULT);
+  alarms.setRateOfRiseLimit(8);
+  for (int i = 0; i < ALARM_ROR_HISTORY; i++) TEST_ASSERT_FALSE(feed(200));
+  TEST_ASSERT_FALSE(feed(200));
+  TEST_ASSERT_FALSE(alarms.rateOfRise());
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_threshold_trips_above_setpoint);
+  RUN_TEST(test_hysteresis_holds_until_below_band);
+  RUN_TEST(test_no_hysteresis_clears_at_setpoint);
+  RUN_TEST(test_levels_step_up_and_down);
+  RUN_TEST(test_levels_out_of_range_are_ignored);
+  RUN_TEST(test_fault_keeps_the_last_decision);
+  RUN_TEST(test_limits_outside_max6675_range_are_rejected);
+  RUN_TEST(test_highest_setpoint_trips);
+  RUN_TEST(test_rate_of_rise_trips_and_clears);
+  RUN_TEST(test_rate_of_rise_below_limit);
+  RUN_TEST(test_rate_of_rise_disabled);
+  RUN_TEST(test_fault_restarts_rate_of_rise);
+  RUN_TEST(test_stale_slope_does_not_trip);
+  return UNITY_END();
+}
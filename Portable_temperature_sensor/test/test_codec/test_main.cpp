@@ -0,0 +1,162 @@
+// Batch payloads and acks (src/SampleCodec.h)
+// Run with: platformio test -e native -f test_codec
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "SampleCodec.h"
+
+#define BOOT_ID 0xB0070001
+
+struct VectorSink {
+  std::vector<uint8_t> bytes;
+  void put(uint8_t b) { bytes.push_back(b); }
+};
+
+typedef SampleRing<16> Ring;
+
+// Encode [first, first + count) of the ring; the size must be what sampleBatchSize() predicted
+static std::vector<uint8_t> encode(const Ring& ring, uint32_t first, uint32_t count, uint64_t epochMs) {
+  VectorSink sink;
+  encodeSampleBatch(sink, ring, BOOT_ID, first, count, epochMs);
+  TEST_ASSERT_EQUAL_UINT32(sink.bytes.size(), sampleBatchSize(ring, BOOT_ID, first, count, epochMs));
+  return sink.bytes;
+}
+
+// Decoding gives back the header and the samples, times relative to the first
+static void assertRoundTrip(const Ring& ring, uint32_t first, uint32_t count) {
+  std::vector<uint8_t> payload = encode(ring, first, count, 1788220800000ULL);
+  SampleBatchHeader header;
+  Sample out[16];
+  TEST_ASSERT_TRUE(decodeSampleBatch(payload.data(), payload.size(), header, out, 16));
+  TEST_ASSERT_EQUAL_UINT32(BOOT_ID, header.bootId);
+  TEST_ASSERT_EQUAL_UINT32(first, header.first);
+  TEST_ASSERT_EQUAL_UINT32(count, header.count);
+  TEST_ASSERT_EQUAL_UINT64(1788220800000ULL, header.firstEpochMs);
+  for (uint32_t i = 0; i < count; i++) {
+    TEST_ASSERT_EQUAL_UINT32(ring.at(first + i).ms - ring.at(first).ms, out[i].ms);
+    TEST_ASSERT_EQUAL_INT16(ring.at(first + i).value, out[i].value);
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_zigzag_round_trip() {
+  const int32_t values[] = { 0, 1, -1, 2, -2, 32767, -32768, 65535, -65535, INT32_MAX, INT32_MIN };
+  for (int32_t v : values) TEST_ASSERT_EQUAL_INT32(v, zigzagDecode(zigzagEncode(v)));
+  TEST_ASSERT_EQUAL_UINT32(1, zigzagEncode(-1));
+  TEST_ASSERT_EQUAL_UINT32(2, zigzagEncode(1));
+}
+
+void test_batch_round_trip() {
+  Ring ring;
+  const int16_t values[] = { 100, 101, 99, 99, SAMPLE_FAULT, 102, -40, 4000 };
+  for (uint8_t i = 0; i < 8; i++) ring.push(1000 + i * 250 + (i % 3), values[i]);
+  assertRoundTrip(ring, 0, 8);
+  assertRoundTrip(ring, 3, 4);
+  assertRoundTrip(ring, 7, 1);
+}
+
+void test_empty_batch() {
+  Ring ring;
+  std::vector<uint8_t> payload = encode(ring, 5, 0, 0);
+  SampleBatchHeader header;
+  Sample out[1];
+  TEST_ASSERT_TRUE(decodeSampleBatch(payload.data(), payload.size(), header, out, 1));
+  TEST_ASSERT_EQUAL_UINT32(5, header.first);
+  TEST_ASSERT_EQUAL_UINT32(0, header.count);
+}
+
+// millis() wraps after 49.7 days; deltas are taken modulo 2^32
+void test_millis_wrap_around() {
+  Ring ring;
+  ring.push(0xFFFFFC18, 100);  // 1 s before the wrap
+  ring.push(0xFFFFFFFF, 101);
+  ring.push(0x000003E8, 102);  // 1 s after it
+  ring.push(0x000007D0, 103);
+  assertRoundTrip(ring, 0, 4);
+
+  std::vector<uint8_t> payload = encode(ring, 0, 4, 0);
+  SampleBatchHeader header;
+  Sample out[4];
+  TEST_ASSERT_TRUE(decodeSampleBatch(payload.data(), payload.size(), header, out, 4));
+  TEST_ASSERT_EQUAL_UINT32(999, out[1].ms);
+  TEST_ASSERT_EQUAL_UINT32(2000, out[2].ms);
+}
+
+// Value deltas span the whole int16_t range, faults included
+void test_value_extremes() {
+  Ring ring;
+  ring.push(0, INT16_MAX);
+  ring.push(1, SAMPLE_FAULT);
+  ring.push(2, INT16_MAX);
+  ring.push(3, 0);
+  ring.push(4, SAMPLE_FAULT);
+  assertRoundTrip(ring, 0, 5);
+}
+
+// Ring positions keep counting past the capacity; a batch may cross the wrap of the slots
+void test_ring_wrap_around() {
+  Ring ring;
+  for (uint32_t i = 0; i < 40; i++) ring.push(i * 1000, (int16_t)(i * 3 - 50));
+  TEST_ASSERT_EQUAL_UINT32(40, ring.head());
+  TEST_ASSERT_EQUAL_UINT32(24, ring.tail());
+  TEST_ASSERT_EQUAL_UINT32(24, ring.dropped());
+  assertRoundTrip(ring, ring.tail(), ring.size());
+  assertRoundTrip(ring, 30, 10);
+}
+
+void test_rejects_damaged_payloads() {
+  Ring ring;
+  for (uint8_t i = 0; i < 4; i++) ring.push(i * 250, 100 + i);
+  std::vector<uint8_t> payload = encode(ring, 0, 4, 0);
+  SampleBatchHeader header;
+  Sample out[4];
+
+  for (size_t length = 0; length < payload.size(); length++) {
+    TEST_ASSERT_FALSE(decodeSampleBatch(payload.data(), length, header, out, 4));
+  }
+  std::vector<uint8_t> longer = payload;
+  longer.push_back(0);
+  TEST_ASSERT_FALSE(decodeSampleBatch(longer.data(), longer.size(), header, out, 4));
+  std::vector<uint8_t> version = payload;
+  version[2] = SAMPLE_BATCH_VERSION + 1;
+  TEST_ASSERT_FALSE(decodeSampleBatch(version.data(), version.size(), header, out, 4));
+  TEST_ASSERT_FALSE(decodeSampleBatch(payload.data(), payload.size(), header, out, 3));  // No room
+}
+
+void test_ack_round_trip() {
+  char buf[SAMPLE_ACK_LEN];
+  TEST_ASSERT_EQUAL_INT(21, formatSampleAck(buf, sizeof(buf), UINT32_MAX, UINT32_MAX));
+  uint32_t bootId, next;
+  TEST_ASSERT_TRUE(parseSampleAck(buf, bootId, next));
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, bootId);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, next);
+
+  formatSampleAck(buf, sizeof(buf), BOOT_ID, 1234);
+  TEST_ASSERT_TRUE(parseSampleAck(buf, bootId, next));
+  TEST_ASSERT_EQUAL_UINT32(BOOT_ID, bootId);
+  TEST_ASSERT_EQUAL_UINT32(1234, next);
+}
+
+void test_ack_rejects_malformed() {
+  uint32_t bootId, next;
+  const char* bad[] = { "", "1234", ":5", "7:", "7:5x", "7 :5", "-1:5", "7:4294967296", "4294967296:5", "7:5:6" };
+  for (const char* payload : bad) TEST_ASSERT_FALSE_MESSAGE(parseSampleAck(payload, bootId, next), payload);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_zigzag_round_trip);
+  RUN_TEST(test_batch_round_trip);
+  RUN_TEST(test_empty_batch);
+  RUN_TEST(test_millis_wrap_around);
+  RUN_TEST(test_value_extremes);
+  RUN_TEST(test_ring_wrap_around);
+  RUN_TEST(test_rejects_damaged_payloads);
+  RUN_TEST(test_ack_round_trip);
+  RUN_TEST(test_ack_rejects_malformed);
+  return UNITY_END();
+}
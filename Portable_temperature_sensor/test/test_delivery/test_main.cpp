@@ -0,0 +1,206 @@
+// Acknowledged delivery out of the sample ring (src/DeliveryWindow.h, src/SampleUplink.h)
+// Run with: platformio test -e native -f test_delivery
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <unity.h>
+#include "DeliveryWindow.h"
+#include "SampleRing.h"
+#include "SampleUplink.h"
+
+#define BATCH 4  // Samples per batch in these tests
+
+typedef SampleRing<64> Ring;
+
+static Ring ring;
+static DeliveryWindow window;
+
+// What SampleUplink::deliver() does, with every publish succeeding; returns the batch starts
+static uint8_t deliver(uint32_t now, uint32_t* starts = NULL) {
+  uint8_t batches = 0;
+  window.checkTimeout(now);
+  while (window.canSend()) {
+    uint32_t first = window.nextToSend(ring.tail());
+    uint32_t pending = ring.head() - first;
+    if (pending == 0) break;
+    uint32_t count = pending > BATCH ? BATCH : pending;
+    if (starts) starts[batches] = first;
+    window.sent(first + count, now);
+    batches++;
+  }
+  ring.consume(window.acked());
+  return batches;
+}
+
+static void fill(uint32_t samples) {
+  for (uint32_t i = 0; i < samples; i++) ring.push(ring.head() * 250, (int16_t)ring.head());
+}
+
+void setUp() {
+  ring = Ring();
+  window = DeliveryWindow();
+}
+
+void tearDown() {}
+
+void test_no_acks_releases_on_send() {
+  fill(10);
+  TEST_ASSERT_FALSE(window.enabled());
+  TEST_ASSERT_EQUAL_UINT8(3, deliver(0));
+  TEST_ASSERT_EQUAL_UINT32(10, window.acked());
+  TEST_ASSERT_EQUAL_UINT32(0, ring.size());
+  TEST_ASSERT_EQUAL_UINT8(0, window.inFlight());
+}
+
+void test_window_bounds_batches_in_flight() {
+  window.setSize(2);
+  fill(20);
+  uint32_t starts[DELIVERY_WINDOW_MAX];
+  TEST_ASSERT_EQUAL_UINT8(2, deliver(0, starts));
+  TEST_ASSERT_EQUAL_UINT32(0, starts[0]);
+  TEST_ASSERT_EQUAL_UINT32(4, starts[1]);
+  TEST_ASSERT_FALSE(window.canSend());
+  TEST_ASSERT_EQUAL_UINT32(20, ring.size());  // Nothing leaves the ring before its ack
+
+  ring.consume(window.ack(4, 100));
+  TEST_ASSERT_EQUAL_UINT32(16, ring.size());
+  TEST_ASSERT_EQUAL_UINT8(1, window.inFlight());
+  TEST_ASSERT_EQUAL_UINT32(100, window.lastAckRtt());
+  TEST_ASSERT_EQUAL_UINT8(1, deliver(200, starts));
+  TEST_ASSERT_EQUAL_UINT32(8, starts[0]);
+}
+
+void test_setsize_is_capped() {
+  window.setSize(200);
+  TEST_ASSERT_EQUAL_UINT8(DELIVERY_WINDOW_MAX, window.getSize());
+}
+
+void test_cumulative_ack_releases_several_batches() {
+  window.setSize(4);
+  fill(16);
+  deliver(0);
+  TEST_ASSERT_EQUAL_UINT8(4, window.inFlight());
+  ring.consume(window.ack(12, 50));
+  TEST_ASSERT_EQUAL_UINT8(1, window.inFlight());
+  TEST_ASSERT_EQUAL_UINT32(12, ring.tail());
+  TEST_ASSERT_EQUAL_UINT32(1, window.acksReceived());
+}
+
+// An ack inside a batch releases the samples before it but keeps the batch in flight
+void test_partial_ack() {
+  window.setSize(2);
+  fill(8);
+  deliver(0);
+  ring.consume(window.ack(2, 10));
+  TEST_ASSERT_EQUAL_UINT32(2, ring.tail());
+  TEST_ASSERT_EQUAL_UINT8(2, window.inFlight());
+}
+
+void test_stale_and_bogus_acks_are_ignored() {
+  window.setSize(2);
+  fill(8);
+  deliver(0);
+  ring.consume(window.ack(4, 10));
+
+  // Duplicate and older acks, e.g. redelivered by the broker
+  TEST_ASSERT_EQUAL_UINT32(4, window.ack(4, 20));
+  TEST_ASSERT_EQUAL_UINT32(4, window.ack(1, 20));
+  // Past anything sent
+  TEST_ASSERT_EQUAL_UINT32(4, window.ack(9, 20));
+  TEST_ASSERT_EQUAL_UINT32(4, window.ack(0x80000004, 20));
+  TEST_ASSERT_EQUAL_UINT32(1, window.acksReceived());
+  TEST_ASSERT_EQUAL_UINT8(1, window.inFlight());
+  ring.consume(window.acked());
+  TEST_ASSERT_EQUAL_UINT32(4, ring.tail());
+}
+
+// After a reconnect everything unacknowledged is sent again, from the oldest sample on
+void test_go_back_n_on_reconnect() {
+  window.setSize(3);
+  fill(12);
+  deliver(0);
+  ring.consume(window.ack(4, 10));
+  window.rewind();
+  TEST_ASSERT_EQUAL_UINT8(0, window.inFlight());
+  TEST_ASSERT_EQUAL_UINT32(1, window.retransmits());
+
+  uint32_t starts[DELIVERY_WINDOW_MAX];
+  TEST_ASSERT_EQUAL_UINT8(2, deliver(20, starts));
+  TEST_ASSERT_EQUAL_UINT32(4, starts[0]);
+  TEST_ASSERT_EQUAL_UINT32(8, starts[1]);
+
+  // Nothing outstanding: a rewind is not a retransmit
+  ring.consume(window.ack(12, 30));
+  window.rewind();
+  TEST_ASSERT_EQUAL_UINT32(1, window.retransmits());
+  TEST_ASSERT_EQUAL_UINT8(0, deliver(40));
+}
+
+void test_go_back_n_on_ack_timeout() {
+  window.setSize(2);
+  fill(8);
+  deliver(1000);
+  TEST_ASSERT_EQUAL_UINT8(0, deliver(1000 + DELIVERY_ACK_TIMEOUT));  // Not yet
+  uint32_t starts[DELIVERY_WINDOW_MAX];
+  TEST_ASSERT_EQUAL_UINT8(2, deliver(1001 + DELIVERY_ACK_TIMEOUT, starts));
+  TEST_ASSERT_EQUAL_UINT32(0, starts[0]);
+  TEST_ASSERT_EQUAL_UINT32(1, window.retransmits());
+}
+
+// The timeout holds across the wrap of millis()
+void test_timeout_across_millis_wrap() {
+  window.setSize(1);
+  fill(4);
+  deliver(0xFFFFFF00);
+  TEST_ASSERT_EQUAL_UINT8(0, deliver(0x00000100));
+  TEST_ASSERT_EQUAL_UINT8(1, deliver(0xFFFFFF01 + DELIVERY_ACK_TIMEOUT));
+}
+
+// Samples the ring overwrote while unacknowledged are skipped, not resent
+void test_ring_overrun_moves_the_cursor() {
+  window.setSize(1);
+  fill(4);
+  deliver(0);
+  fill(70);  // Laps the 64-sample ring
+  TEST_ASSERT_EQUAL_UINT32(10, ring.tail());
+  window.rewind();
+  uint32_t starts[DELIVERY_WINDOW_MAX];
+  TEST_ASSERT_EQUAL_UINT8(1, deliver(10, starts));
+  TEST_ASSERT_EQUAL_UINT32(10, starts[0]);
+}
+
+// An ack the broker kept from before a reboot must not release the new boot's samples
+void test_acks_for_another_boot_are_rejected() {
+  WiFiClient wifi;
+  PubSubClient client(wifi);
+  MqttLink link(client, "", "");
+  SampleUplink<Ring> uplink(client, link, ring, window);
+  uplink.begin(0xB0070002);
+  window.setSize(2);
+  fill(8);
+  deliver(0);
+
+  TEST_ASSERT_FALSE(uplink.ack("2953248769:8"));  // 0xB0070001, the previous boot
+  TEST_ASSERT_FALSE(uplink.ack("8"));
+  TEST_ASSERT_EQUAL_UINT32(2, uplink.rejectedAcks());
+  TEST_ASSERT_EQUAL_UINT32(0, ring.tail());
+  TEST_ASSERT_TRUE(uplink.ack("2953248770:8"));
+  TEST_ASSERT_EQUAL_UINT32(8, ring.tail());
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_no_acks_releases_on_send);
+  RUN_TEST(test_window_bounds_batches_in_flight);
+  RUN_TEST(test_setsize_is_capped);
+  RUN_TEST(test_cumulative_ack_releases_several_batches);
+  RUN_TEST(test_partial_ack);
+  RUN_TEST(test_stale_and_bogus_acks_are_ignored);
+  RUN_TEST(test_go_back_n_on_reconnect);
+  RUN_TEST(test_go_back_n_on_ack_timeout);
+  RUN_TEST(test_timeout_across_millis_wrap);
+  RUN_TEST(test_ring_overrun_moves_the_cursor);
+  RUN_TEST(test_acks_for_another_boot_are_rejected);
+  return UNITY_END();
+}
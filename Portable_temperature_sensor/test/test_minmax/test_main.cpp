@@ -0,0 +1,128 @@
+// Windowed minimum and maximum for the sparkline scale (src/SlidingMinMax.h)
+// Run with: platformio test -e native -f test_minmax
+#include <Arduino.h>
+#include <unity.h>
+#include "SlidingMinMax.h"
+
+#define WINDOW 8
+
+typedef SlidingMinMax<WINDOW> MinMax;
+
+// Rescan of the last WINDOW of the `pushed` values, as the sparkline did before the deques
+static bool scan(const int16_t* values, uint32_t pushed, int16_t& lo, int16_t& hi) {
+  bool any = false;
+  uint32_t first = pushed > WINDOW ? pushed - WINDOW : 0;
+  for (uint32_t i = first; i < pushed; i++) {
+    if (values[i] == SAMPLE_FAULT) continue;
+    if (!any || values[i] < lo) lo = values[i];
+    if (!any || values[i] > hi) hi = values[i];
+    any = true;
+  }
+  return any;
+}
+
+static void assertMatchesScan(const int16_t* values, uint32_t n) {
+  MinMax window;
+  for (uint32_t i = 0; i < n; i++) {
+    window.push(values[i]);
+    int16_t lo = 0, hi = 0;
+    bool any = scan(values, i + 1, lo, hi);
+    char message[32];
+    snprintf(message, sizeof(message), "after %u values", (unsigned)(i + 1));
+    TEST_ASSERT_EQUAL_MESSAGE(any, window.valid(), message);
+    if (any) {
+      TEST_ASSERT_EQUAL_MESSAGE(lo, window.min(), message);
+      TEST_ASSERT_EQUAL_MESSAGE(hi, window.max(), message);
+    }
+    TEST_ASSERT_EQUAL_UINT8(i + 1 < WINDOW ? i + 1 : WINDOW, window.count());
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_empty_is_invalid() {
+  MinMax window;
+  TEST_ASSERT_FALSE(window.valid());
+  TEST_ASSERT_EQUAL_UINT8(0, window.count());
+}
+
+// The extreme slides out of the window and the next one takes over
+void test_extremes_slide_out() {
+  MinMax window;
+  const int16_t values[] = { 50, 10, 40, 30, 20, 35, 25, 45 };
+  for (int16_t v : values) window.push(v);
+  TEST_ASSERT_EQUAL_INT16(10, window.min());
+  TEST_ASSERT_EQUAL_INT16(50, window.max());
+  window.push(33);  // 50 leaves
+  TEST_ASSERT_EQUAL_INT16(45, window.max());
+  window.push(33);  // 10 leaves
+  TEST_ASSERT_EQUAL_INT16(20, window.min());
+}
+
+void test_monotonic_runs() {
+  int16_t rising[40], falling[40];
+  for (int i = 0; i < 40; i++) {
+    rising[i] = (int16_t)(i * 5 - 100);
+    falling[i] = (int16_t)(100 - i * 5);
+  }
+  assertMatchesScan(rising, 40);
+  assertMatchesScan(falling, 40);
+}
+
+void test_equal_values() {
+  const int16_t values[] = { 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 3, 7, 7, 7, 7, 7, 7, 7, 7, 7 };
+  assertMatchesScan(values, sizeof(values) / sizeof(values[0]));
+}
+
+// Faults are kept in the history but never become an extreme
+void test_faults_are_skipped() {
+  const int16_t values[] = { SAMPLE_FAULT, 100, SAMPLE_FAULT, 90, 110, SAMPLE_FAULT, SAMPLE_FAULT, SAMPLE_FAULT,
+                             SAMPLE_FAULT, SAMPLE_FAULT, SAMPLE_FAULT, SAMPLE_FAULT, SAMPLE_FAULT, SAMPLE_FAULT,
+                             SAMPLE_FAULT, 80, SAMPLE_FAULT, INT16_MAX, -32767 };
+  assertMatchesScan(values, sizeof(values) / sizeof(values[0]));
+
+  MinMax window;
+  for (int i = 0; i < WINDOW; i++) window.push(SAMPLE_FAULT);
+  TEST_ASSERT_FALSE(window.valid());
+  TEST_ASSERT_EQUAL_INT16(SAMPLE_FAULT, window.recent(0));
+}
+
+void test_random_walk_matches_rescan() {
+  static int16_t values[2000];
+  uint32_t rng = 12345;
+  int16_t level = 0;
+  for (int i = 0; i < 2000; i++) {
+    rng = rng * 1103515245 + 12345;
+    level += (int16_t)((rng >> 16) % 9) - 4;
+    values[i] = ((rng >> 8) % 50 == 0) ? SAMPLE_FAULT : level;
+  }
+  assertMatchesScan(values, 2000);
+}
+
+void test_recent_and_clear() {
+  MinMax window;
+  for (int16_t v = 1; v <= 11; v++) window.push(v);
+  TEST_ASSERT_EQUAL_INT16(11, window.recent(0));
+  TEST_ASSERT_EQUAL_INT16(4, window.recent(WINDOW - 1));
+  window.clear();
+  TEST_ASSERT_FALSE(window.valid());
+  TEST_ASSERT_EQUAL_UINT8(0, window.count());
+  window.push(-5);
+  TEST_ASSERT_EQUAL_INT16(-5, window.min());
+  TEST_ASSERT_EQUAL_INT16(-5, window.max());
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_is_invalid);
+  RUN_TEST(test_extremes_slide_out);
+  RUN_TEST(test_monotonic_runs);
+  RUN_TEST(test_equal_values);
+  RUN_TEST(test_faults_are_skipped);
+  RUN_TEST(test_random_walk_matches_rescan);
+  RUN_TEST(test_recent_and_clear);
+  return UNITY_END();
+}
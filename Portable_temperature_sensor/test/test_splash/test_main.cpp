@@ -0,0 +1,62 @@
+// Splash decoder against the uncompressed asset the stream is generated from
+// Run with: platformio test -e native -f test_splash
+#include <Arduino.h>
+#include <unity.h>
+#include "OledCompositor.h"  // Panel geometry
+#include "SplashDecoder.h"
+#include "../../assets/splashScreen.h"
+
+#define CANARY 0xA5  // Fills the bytes after the frame; the decoder must not touch them
+
+// What drawBitmap(0, 0, frame, 128, 32, OLED_WHITE) left in a cleared framebuffer
+// before the animation was delta coded: the bitmap inverted, moved from page rows
+// into GyverOLED's column-major order
+static void drawnFrame(const unsigned char* bitmap, uint8_t* out) {
+  for (uint8_t page = 0; page < OLED_PAGES; page++) {
+    for (uint8_t x = 0; x < OLED_COLUMNS; x++) {
+      out[x * OLED_PAGES + page] = pgm_read_byte(&bitmap[page * OLED_COLUMNS + x]) ^ 0xFF;
+    }
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_frame_count_matches_asset() {
+  TEST_ASSERT_EQUAL_INT(logoFramesallArray_LEN, SPLASH_FRAME_COUNT);
+}
+
+void test_offsets_cover_the_stream() {
+  TEST_ASSERT_EQUAL_UINT16(0, splashFrameOffsets[0]);
+  for (uint8_t frame = 0; frame < SPLASH_FRAME_COUNT; frame++) {
+    TEST_ASSERT_TRUE(splashFrameOffsets[frame] <= splashFrameOffsets[frame + 1]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(sizeof(splashStream), splashFrameOffsets[SPLASH_FRAME_COUNT]);
+}
+
+// Played in order from a cleared buffer, as bootUpdate() does
+void test_every_frame_is_bit_exact() {
+  static uint8_t buffer[OLED_FRAME_SIZE + 16];
+  static uint8_t expected[OLED_FRAME_SIZE];
+  memset(buffer, 0, OLED_FRAME_SIZE);
+  memset(buffer + OLED_FRAME_SIZE, CANARY, sizeof(buffer) - OLED_FRAME_SIZE);
+
+  for (uint8_t frame = 0; frame < SPLASH_FRAME_COUNT; frame++) {
+    decodeSplashFrame(buffer, frame);
+    drawnFrame(logoFramesallArray[frame], expected);
+    char message[24];
+    snprintf(message, sizeof(message), "frame %u", frame);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(expected, buffer, OLED_FRAME_SIZE, message);
+    TEST_ASSERT_EACH_EQUAL_HEX8(CANARY, buffer + OLED_FRAME_SIZE, sizeof(buffer) - OLED_FRAME_SIZE);
+  }
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_frame_count_matches_asset);
+  RUN_TEST(test_offsets_cover_the_stream);
+  RUN_TEST(test_every_frame_is_bit_exact);
+  return UNITY_END();
+}
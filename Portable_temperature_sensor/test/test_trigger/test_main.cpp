@@ -0,0 +1,83 @@
+// Trigger output driven by the setpoint alarm (src/TriggerOutput.h, src/AlarmEngine.h)
+// Run with: platformio test -e native -f test_trigger
+#include <Arduino.h>
+#include <unity.h>
+#include "AlarmEngine.h"
+#include "TriggerOutput.h"
+
+#define PIN 2        // GPIO2 (D4), as on the board
+#define PERIOD 250   // ms between samples, one MAX6675 conversion
+
+static AlarmEngine alarms;
+static TriggerOutput trigger(PIN);
+static uint32_t now;
+
+// What acquireSample() does with a fresh sample; returns the pin level afterwards
+static int feed(double celsius) {
+  now += PERIOD;
+  NativeHal::advance(PERIOD * 1000ULL);
+  alarms.update(now, sampleFromCelsius(celsius));
+  trigger.update(alarms.tripped(1));
+  return digitalRead(PIN);
+}
+
+void setUp() {
+  alarms = AlarmEngine();
+  alarms.setThreshold(1, sampleFromCelsius(80));
+  trigger.setMode(TRIGGER_LEVEL);
+  trigger.update(false);
+  trigger.begin();
+  now = 0;
+}
+
+void tearDown() {}
+
+void test_level_follows_setpoint_with_hysteresis() {
+  TEST_ASSERT_EQUAL_INT(LOW, feed(80));
+  TEST_ASSERT_EQUAL_INT(HIGH, feed(80.25));
+  TEST_ASSERT_EQUAL_INT(HIGH, feed(79));     // Setpoint - 1 °C hysteresis still holds
+  TEST_ASSERT_EQUAL_INT(LOW, feed(78.75));
+}
+
+// Levels 2 and 3 change the buzzer, never the trigger
+void test_higher_levels_do_not_drive_the_trigger() {
+  alarms.setThreshold(2, sampleFromCelsius(60));  // Below the setpoint
+  TEST_ASSERT_EQUAL_INT(LOW, feed(70));
+  TEST_ASSERT_EQUAL_UINT8(2, alarms.level());
+  TEST_ASSERT_FALSE(alarms.tripped(1));
+
+  alarms.setThreshold(1, ALARM_LEVEL_OFF);  // Setpoint off: level 2 alone trips
+  TEST_ASSERT_EQUAL_INT(LOW, feed(100));
+  TEST_ASSERT_TRUE(alarms.tripped(2));
+}
+
+// Above the setpoint, level 2 or 3 coming and going leaves the pin alone
+void test_trigger_holds_while_levels_change_above_setpoint() {
+  alarms.setThreshold(2, sampleFromCelsius(100));
+  TEST_ASSERT_EQUAL_INT(HIGH, feed(90));
+  TEST_ASSERT_EQUAL_INT(HIGH, feed(110));
+  TEST_ASSERT_EQUAL_UINT8(2, alarms.level());
+  TEST_ASSERT_EQUAL_INT(HIGH, feed(90));
+  TEST_ASSERT_EQUAL_INT(LOW, feed(20));
+}
+
+void test_pulse_on_setpoint_crossing_only() {
+  trigger.setMode(TRIGGER_PULSE, 100);
+  alarms.setThreshold(2, sampleFromCelsius(60));
+  TEST_ASSERT_EQUAL_INT(LOW, feed(70));      // Level 2 only: no pulse
+  TEST_ASSERT_EQUAL_INT(HIGH, feed(85));
+  NativeHal::advance(100 * 1000ULL);         // The SDK timer ends the pulse
+  TEST_ASSERT_EQUAL_INT(LOW, digitalRead(PIN));
+  TEST_ASSERT_EQUAL_INT(LOW, feed(90));      // Still above: no second pulse
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_level_follows_setpoint_with_hysteresis);
+  RUN_TEST(test_higher_levels_do_not_drive_the_trigger);
+  RUN_TEST(test_trigger_holds_while_levels_change_above_setpoint);
+  RUN_TEST(test_pulse_on_setpoint_crossing_only);
+  return UNITY_END();
+}
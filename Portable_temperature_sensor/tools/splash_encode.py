@@ -0,0 +1,165 @@
+"""Encode the splash animation into a compact delta stream.
+
+Reads the uncompressed frames from assets/splashScreen.h and writes
+src/splashAnimation.h. Each frame is stored as the XOR difference to the
+previous frame, in GyverOLED framebuffer order, run-length encoded:
+
+    0x00-0x7F  skip n+1 unchanged bytes
+    0x80-0xFF  XOR the next (n & 0x7F)+1 stream bytes into the buffer
+
+The first frame is diffed against a cleared buffer. Frames are stored inverted
+(the animation is drawn with drawBitmap(..., OLED_WHITE), which inverts), so
+decoding straight into a cleared framebuffer reproduces the original output.
+The encoder decodes its own output and fails unless every frame is bit-exact.
+
+Runs as a PlatformIO pre-build script (see platformio.ini) and regenerates the
+header only when the asset is newer; it can also be run by hand.
+"""
+
+import os
+import re
+import sys
+
+WIDTH = 128
+PAGES = 4
+FRAME_SIZE = WIDTH * PAGES
+FRAME_DELAY_MS = 16
+MAX_RUN = 128
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = os.path.join(PROJECT_DIR, "assets", "splashScreen.h")
+OUTPUT = os.path.join(PROJECT_DIR, "src", "splashAnimation.h")
+
+
+def read_frames(path):
+    """Return the frames in playback order as lists of bytes in source (page-row) order.
+
+    The arrays are not defined in numeric order in the asset, so frames are
+    sorted by the number in their name, which is the order they are played in.
+    """
+    text = open(path).read()
+    frames = {}
+    for match in re.finditer(r"logoFrames(\d+)\s*\[\]\s*PROGMEM\s*=\s*\{([^}]*)\}", text):
+        number = int(match.group(1))
+        data = [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]{2}", match.group(2))]
+        if len(data) != FRAME_SIZE:
+            sys.exit("splash_encode: frame %d has %d bytes, expected %d" % (number, len(data), FRAME_SIZE))
+        frames[number] = data
+    if sorted(frames) != list(range(len(frames))) or not frames:
+        sys.exit("splash_encode: frames in " + path + " are not numbered 0..n-1")
+    return [frames[n] for n in sorted(frames)]
+
+
+def to_buffer(frame):
+    """Convert a drawBitmap frame to inverted, column-major framebuffer order."""
+    buf = [0] * FRAME_SIZE
+    for page in range(PAGES):
+        for x in range(WIDTH):
+            buf[x * PAGES + page] = frame[page * WIDTH + x] ^ 0xFF
+    return buf
+
+
+def encode_delta(prev, cur):
+    out = []
+    i = 0
+    while i < FRAME_SIZE:
+        if prev[i] == cur[i]:
+            run = 1
+            while i + run < FRAME_SIZE and run < MAX_RUN and prev[i + run] == cur[i + run]:
+                run += 1
+            if i + run < FRAME_SIZE:  # A trailing skip is implied by the end of the frame
+                out.append(run - 1)
+            i += run
+        else:
+            run = 1
+            while i + run < FRAME_SIZE and run < MAX_RUN and prev[i + run] != cur[i + run]:
+                run += 1
+            out.append(0x80 | (run - 1))
+            out.extend(prev[i + k] ^ cur[i + k] for k in range(run))
+            i += run
+    return out
+
+
+def decode_delta(buf, stream):
+    pos = 0
+    i = 0
+    while i < len(stream):
+        token = stream[i]
+        i += 1
+        if token < 0x80:
+            pos += token + 1
+        else:
+            for _ in range((token & 0x7F) + 1):
+                buf[pos] ^= stream[i]
+                pos += 1
+                i += 1
+
+
+def encode(frames):
+    buffers = [to_buffer(f) for f in frames]
+    stream = []
+    offsets = []
+    prev = [0] * FRAME_SIZE
+    for buf in buffers:
+        offsets.append(len(stream))
+        stream.extend(encode_delta(prev, buf))
+        prev = buf
+    offsets.append(len(stream))
+
+    # Round trip: every decoded frame must equal what drawBitmap produced
+    check = [0] * FRAME_SIZE
+    for n, buf in enumerate(buffers):
+        decode_delta(check, stream[offsets[n]:offsets[n + 1]])
+        if check != buf:
+            sys.exit("splash_encode: frame %d does not round-trip" % n)
+    return stream, offsets
+
+
+def write_header(path, stream, offsets, raw_size):
+    lines = [
+        "#ifndef SPLASH_ANIMATION_H",
+        "#define SPLASH_ANIMATION_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "// Generated by tools/splash_encode.py from assets/splashScreen.h - do not edit",
+        "// %d frames, %d bytes raw, %d bytes encoded (stream + offsets)"
+        % (len(offsets) - 1, raw_size, len(stream) + 2 * len(offsets)),
+        "// Format: see tools/splash_encode.py and SplashDecoder.h",
+        "#define SPLASH_FRAME_COUNT %d" % (len(offsets) - 1),
+        "#define SPLASH_FRAME_DELAY %d  // ms between frames" % FRAME_DELAY_MS,
+        "",
+        "const uint16_t splashFrameOffsets[SPLASH_FRAME_COUNT + 1] PROGMEM = {",
+    ]
+    for i in range(0, len(offsets), 12):
+        lines.append("  " + ", ".join("%d" % v for v in offsets[i:i + 12]) + ",")
+    lines.append("};")
+    lines.append("")
+    lines.append("const uint8_t splashStream[] PROGMEM = {")
+    for i in range(0, len(stream), 16):
+        lines.append("  " + ", ".join("0x%02x" % v for v in stream[i:i + 16]) + ",")
+    lines.append("};")
+    lines.append("")
+    lines.append("#endif // SPLASH_ANIMATION_H")
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def main():
+    if os.path.exists(OUTPUT) and os.path.getmtime(OUTPUT) >= os.path.getmtime(SOURCE):
+        return
+    frames = read_frames(SOURCE)
+    stream, offsets = encode(frames)
+    raw_size = len(frames) * FRAME_SIZE
+    write_header(OUTPUT, stream, offsets, raw_size)
+    print("splash_encode: %d frames, %d -> %d bytes (%.1f%%)"
+          % (len(frames), raw_size, len(stream) + 2 * len(offsets),
+             100.0 * (len(stream) + 2 * len(offsets)) / raw_size))
+
+
+main()